@@ -0,0 +1,31 @@
+#version 330 core
+
+// Chunk meshes have UV coordinates in block units so that one merged quad can cover many blocks.
+// Block textures are 3x3 cube atlases laid out like cube.obj, so the tile is picked by face normal
+// and repeated once per block.
+
+in vec2 UVCoord;
+in vec3 Normal;
+
+out vec3 FragColor;
+
+uniform sampler2D Texture;
+
+const float TILE = 1.0 / 3.0;
+
+vec2 tileOrigin(vec3 n)
+{
+    if (n.y > 0.5)  return vec2(TILE, TILE);        // Top
+    if (n.y < -0.5) return vec2(0.0, TILE);         // Bottom
+    if (n.x > 0.5)  return vec2(0.0, 0.0);          // Right
+    if (n.x < -0.5) return vec2(2.0 * TILE, TILE);  // Left
+    if (n.z > 0.5)  return vec2(2.0 * TILE, 0.0);   // Front
+    return vec2(TILE, 0.0);                         // Back
+}
+
+void main()
+{
+    vec2 uv = tileOrigin(Normal) + fract(UVCoord) * TILE;
+    // Use derivatives of the continuous coordinates so mipmap selection does not jump at block edges
+    FragColor = textureGrad(Texture, uv, dFdx(UVCoord) * TILE, dFdy(UVCoord) * TILE).rgb;
+}
@@ -0,0 +1,157 @@
+#############################################################################################
+#
+# This script decodes binary log files written by Blocker's LogWriter into the same
+# text lines the text log files have, i.e. 'yyyy-mm-dd hh:mm:ss LEVEL - message'
+#
+# This software asks for two parameters
+#   1. Path to binary log file
+#   2. Path to output text file, optional. Lines are printed if not given
+#
+# User may give these parameters as command line parameters in that order or
+# otherwise the software asks for the input file during run time.
+#
+# File layout, all values little endian:
+#   Header: 'BLOCKLOG', uint32 version, int64 numerator and int64 denominator of tick in seconds
+#   Records start with a type byte:
+#     1 Logger name:  uint16 id, uint16 length, name
+#     2 String:       uint32 id, uint32 length, text
+#     3 Message:      int64 ticks, uint16 logger, uint8 level, uint32 length, text
+#     4 Formatted:    int64 ticks, uint16 logger, uint8 level, uint32 function string id,
+#                     uint32 format string id, uint32 length, encoded arguments
+#   Arguments start with a type byte: 1 int64, 2 uint64, 3 double, 4 uint32 length and text
+#
+#############################################################################################
+
+import struct
+import sys
+import time
+
+LEVELS = ['DEBUG', 'INFO ', 'WARN ', 'ERROR', 'FATAL']
+MAGIC = b'BLOCKLOG'
+VERSION = 1
+
+def die(complaint):
+    print(complaint)
+    sys.exit(1)
+
+#Class to read values from the bytes of a file or a record
+class Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def left(self):
+        return len(self.data) - self.pos
+
+    def read(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.left() < size:
+            raise EOFError()
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return values if len(values) > 1 else values[0]
+
+    def bytes(self, size):
+        if self.left() < size:
+            raise EOFError()
+        value = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return value
+
+#Renders argument the same way utility::toStr and utility::toHex do
+def render_arg(args, hexadecimal):
+    kind = args.read('<B')
+    if kind == 1:
+        value = args.read('<q')
+        return '0x%x' % (value & 0xFFFFFFFFFFFFFFFF) if hexadecimal else str(value)
+    if kind == 2:
+        value = args.read('<Q')
+        return '0x%x' % value if hexadecimal else str(value)
+    if kind == 3:
+        return '%f' % args.read('<d')
+    if kind == 4:
+        return args.bytes(args.read('<I')).decode('utf-8', 'replace')
+    raise EOFError()
+
+#Replaces {} and {x} placeholders with arguments like logFormat::render
+def render(fmt, data):
+    args = Reader(data)
+    output = []
+    i = 0
+    args_left = True
+    while i < len(fmt):
+        plain = fmt.startswith('{}', i)
+        hexadecimal = fmt.startswith('{x}', i)
+        if (plain or hexadecimal) and args_left:
+            try:
+                output.append(render_arg(args, hexadecimal))
+                i += 2 if plain else 3
+                continue
+            except EOFError:
+                args_left = False
+        output.append(fmt[i])
+        i += 1
+    return ''.join(output)
+
+def decode(data, out):
+    reader = Reader(data)
+    if reader.bytes(len(MAGIC)) != MAGIC:
+        die('Not a binary log file')
+    version, numerator, denominator = reader.read('<Iqq')
+    if version != VERSION:
+        die('Unsupported binary log version ' + str(version))
+
+    loggers = {}
+    strings = {}
+    cached_second = None
+    cached_datetime = ''
+    while reader.left() > 0:
+        kind = reader.read('<B')
+        if kind == 1:
+            logger, length = reader.read('<HH')
+            loggers[logger] = reader.bytes(length).decode('utf-8', 'replace')
+            continue
+        if kind == 2:
+            sid, length = reader.read('<II')
+            strings[sid] = reader.bytes(length).decode('utf-8', 'replace')
+            continue
+        if kind not in (3, 4):
+            die('Unknown record type ' + str(kind) + ' at byte ' + str(reader.pos - 1))
+
+        ticks, logger, level = reader.read('<qHB')
+        if kind == 4:
+            function, fmt = reader.read('<II')
+        payload = reader.bytes(reader.read('<I'))
+        if kind == 3:
+            text = payload.decode('utf-8', 'replace')
+        else:
+            text = strings.get(function, '?') + '(): ' + render(strings.get(fmt, ''), payload)
+
+        # Records of the same second share the formatted time
+        second = ticks * numerator // denominator
+        if second != cached_second:
+            cached_second = second
+            cached_datetime = time.strftime('%Y-%m-%d %H:%M:%S', time.localtime(second))
+        level_name = LEVELS[level] if level < len(LEVELS) else '?????'
+        out.write(cached_datetime + ' ' + level_name + ' - ' + text + '\n')
+
+#Main function for this script
+def main(args):
+    path = args[1] if len(args) > 1 else input('Path to binary log file: ')
+    try:
+        with open(path, 'rb') as f:
+            data = f.read()
+    except (IOError, OSError):
+        die('Could not open file ' + path)
+
+    try:
+        if len(args) > 2:
+            with open(args[2], 'w') as out:
+                decode(data, out)
+        else:
+            decode(data, sys.stdout)
+    except EOFError:
+        die('File ends in the middle of a record, e.g. program was stopped while writing')
+
+if (__name__ == '__main__'):
+    main(sys.argv)
@@ -18,7 +18,7 @@ public:
 	long vGetCreateTime() const override final;
 
 	// Implemented by subclasses
-	std::string vGetEventName() const override = 0;
+	const std::string& vGetEventName() const override = 0;
 
 protected:
 	long m_createTimestamp; //!< Timestamp in milliseconds when event was created
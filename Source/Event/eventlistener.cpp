@@ -5,7 +5,11 @@
 #include "Event/eventManager.h"
 #include "Utility/locator.h"
 
-EventListener::EventListener() : m_listenerId(Locator::getEventManager()->registerListener()) {}
+EventListener::EventListener() : EventListener(false) {}
+
+EventListener::EventListener(const bool threadSafe)
+	: m_listenerId(threadSafe ? Locator::getEventManager()->registerThreadSafeListener()
+		: Locator::getEventManager()->registerListener()) {}
 
 EventListener::~EventListener()
 {
@@ -24,7 +28,7 @@ bool EventListener::registerForEvent(const EventType evtType, std::function<void
 bool EventListener::unregisterForEvent(const EventType evtType)
 {
 	if (Locator::getEventManager()->removeListener(evtType, m_listenerId)) {
-		std::remove(m_eventsListened.begin(), m_eventsListened.end(), evtType);
+		m_eventsListened.erase(std::remove(m_eventsListened.begin(), m_eventsListened.end(), evtType), m_eventsListened.end());
 		return true;
 	}
 	return false;
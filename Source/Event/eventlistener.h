@@ -15,7 +15,15 @@ public:
 	EventListener();
 
 	/**
-	 * \brief Destructor. Removes its delegates from event manager.
+	 * \brief Constructor. Creates valid event listener by getting ListenerId from event manager.
+	 * \param threadSafe True if delegates may be called on dispatch workers, concurrently with each other and
+	 *	with immediately triggered events. Each delegate still gets queued events in order
+	 */
+	explicit EventListener(const bool threadSafe);
+
+	/**
+	 * \brief Destructor. Removes its delegates from event manager and waits for those still running on
+	 *	dispatch workers, see EventManager::removeListener
 	 */
 	~EventListener();
 
@@ -1,87 +1,159 @@
 #include "Event/eventmanager.h"
 
 #include <algorithm>
+#include <iterator>
+#include <thread>
 
 #include "Utility/contract.h"
+#include "Utility/locator.h"
 #include "Utility/utility.h"
 
-EventManager::EventManager() : m_nextListenerID(0), m_log("EventManager") {}
+namespace {
+	thread_local bool inStrand = false;							//!< True while the thread runs a strand on a dispatch worker
+	thread_local const ListenerEntry* runningStrand = nullptr;	//!< Entry whose strand the thread runs, nullptr if none
+}
+
+EventManager::EventManager()
+	: EventManager(static_cast<unsigned int>(std::max(0, Locator::getConfig()->get("EventDispatchThreads", 0)))) {}
+
+EventManager::EventManager(unsigned int dispatchThreads)
+	: m_nextListenerID(0), m_listenerTable(std::make_shared<ListenerTable>()), m_pools(), m_lanes(),
+	m_threadSafeListeners(), m_tableMtx(), m_updateMtx(),
+	m_log("EventManager"), m_dispatchPool(dispatchThreads > 0 ? std::make_unique<ThreadPool>(dispatchThreads) : nullptr)
+{
+	for (auto& pool : m_pools)
+		pool.store(nullptr, std::memory_order_relaxed);
+}
 
-EventManager::~EventManager() {}
+EventManager::~EventManager()
+{
+	// Workers only run strands that have already been called, wait for them before destroying events
+	m_dispatchPool.reset();
+
+	// Events left in the queue are destroyed without triggering them
+	for (auto& lane : m_lanes) {
+		for (auto i = lane.batchIndex; i < lane.batch.size(); ++i)
+			destroy(lane.batch[i]);
+		while (PooledEvent* node = lane.queue.tryPop())
+			destroy(node);
+	}
+
+	for (auto& pool : m_pools)
+		delete pool.load();
+}
 
 ListenerId EventManager::registerListener() { return m_nextListenerID++; }
 
+ListenerId EventManager::registerThreadSafeListener()
+{
+	const ListenerId listener = m_nextListenerID++;
+	std::lock_guard<std::mutex> lock(m_tableMtx);
+	m_threadSafeListeners.insert(listener);
+	return listener;
+}
+
 bool EventManager::addListener(const EventType evtType, const ListenerId listener, const EventDelegate evtDelegate)
 {
-	REQUIRE(evtDelegate);
-	if (!evtDelegate) {
+	auto entry = std::make_shared<ListenerEntry>();
+	entry->listener = listener;
+	entry->typeIndex = eventTypeIndex<EventDataPtr>();
+	entry->evtDelegate = evtDelegate;
+	entry->active = true;
+	return addEntry(evtType, std::move(entry));
+}
+
+bool EventManager::addEntry(const EventType evtType, std::shared_ptr<ListenerEntry> entry)
+{
+	REQUIRE(entry->evtDelegate || entry->typedDelegate);
+	if (!entry->evtDelegate && !entry->typedDelegate) {
 		m_log.error("addListener", "Attempted to add uncallable event delegate for " 
 			+ utility::toHex(evtType));
 		return false;
 	}
 
-	std::lock_guard<std::mutex> lock(m_mapMtx);
-
 	// Lambda function to compare delegate targets
-	const auto compare = [listener](auto rhs) { return listener == std::get<0>(rhs); };
-
-	auto it = m_eventListenerMap.find(evtType);
-	if (it == m_eventListenerMap.end()) {
-		// New event type
-		m_eventListenerMap.emplace(evtType, EventListenerVector({std::make_tuple(listener, evtDelegate)}));
-	}
-	else {
-		// Event type already exists, make sure that the delegate does not already exist
-		if (std::any_of(it->second.begin(), it->second.end(), compare)) {
-			m_log.warn("addListener", "Attempted to add listener " + utility::toStr(listener)
-				+ " twice for event type " + utility::toHex(evtType));
-			return false;
+	const ListenerId listener = entry->listener;
+	const auto compare = [listener](const auto& rhs) { return listener == rhs->listener; };
+
+	{
+		// Writers are serialized, so the table cannot change between reading and publishing
+		std::lock_guard<std::mutex> lock(m_tableMtx);
+		const auto table = getListenerTable();
+		entry->threadSafe = m_threadSafeListeners.count(listener) > 0;
+		entry->strandState = ListenerEntry::IDLE;
+
+		ListenerList listeners;
+		const auto existing = table->find(evtType);
+		if (existing != nullptr) {
+			// Event type already exists, make sure that the delegate does not already exist
+			if (std::any_of(existing->begin(), existing->end(), compare)) {
+				m_log.warn("addListener", "Attempted to add listener " + utility::toStr(listener)
+					+ " twice for event type " + utility::toHex(evtType));
+				return false;
+			}
+			listeners = *existing;
 		}
-		// Existing event type but it doesnt have this listener
-		it->second.emplace_back(listener, evtDelegate);
+		listeners.push_back(std::move(entry));
+		std::atomic_store(&m_listenerTable, std::shared_ptr<const ListenerTable>(
+			std::make_shared<ListenerTable>(*table, evtType, std::move(listeners))));
+
+		ENSURE(getListenerTable()->find(evtType) != nullptr);
+		ENSURE(std::count_if(getListenerTable()->find(evtType)->begin(), getListenerTable()->find(evtType)->end(), compare) == 1);
 	}
 
 	m_log.info("addListener", "Added new listener " + utility::toStr(listener)
 		+ " for event type " + utility::toHex(evtType) + " and a delegate for it");
-
-	ENSURE(m_eventListenerMap.find(evtType) != m_eventListenerMap.end());
-	ENSURE(std::count_if(m_eventListenerMap[evtType].begin(), m_eventListenerMap[evtType].end(), compare) == 1);
-
 	return true;
 }
 
 bool EventManager::removeListener(const EventType evtType, const ListenerId listener)
 {
-	std::lock_guard<std::mutex> lock(m_mapMtx);
-
-	auto it = m_eventListenerMap.find(evtType);
-	if (it == m_eventListenerMap.end()) {
-		m_log.warn("removeListener", "Attempted to remove non-existing event type " + utility::toHex(evtType));
-		return false;
-	}
-
 	// Lambda to compare items in vector
-	const auto compare = [listener](auto rhs) { return listener == std::get<0>(rhs); };
+	const auto compare = [listener](const auto& rhs) { return listener == rhs->listener; };
 
-	// Event type found, remove the delegate
-	const auto del_it = std::find_if(it->second.begin(), it->second.end(), compare);
-	if (del_it == it->second.end()) {
-		m_log.warn("removeListener", "Attempted to delete non-existing delegate from " + utility::toHex(evtType));
-		return false;
-	}
-	m_log.info("removeListener", "Removing listener " + utility::toStr(listener) + " from event " + utility::toHex(evtType));
-	it->second.erase(del_it);
+	std::shared_ptr<ListenerEntry> removed;
+	{
+		std::lock_guard<std::mutex> lock(m_tableMtx);
+		const auto table = getListenerTable();
 
-	ENSURE(std::count_if(m_eventListenerMap[evtType].begin(), m_eventListenerMap[evtType].end(), compare) == 0);
+		const auto existing = table->find(evtType);
+		if (existing == nullptr) {
+			m_log.warn("removeListener", "Attempted to remove non-existing event type " + utility::toHex(evtType));
+			return false;
+		}
+
+		// Event type found, remove the delegate
+		const auto del_it = std::find_if(existing->begin(), existing->end(), compare);
+		if (del_it == existing->end()) {
+			m_log.warn("removeListener", "Attempted to delete non-existing delegate from " + utility::toHex(evtType));
+			return false;
+		}
+		m_log.info("removeListener", "Removing listener " + utility::toStr(listener) + " from event " + utility::toHex(evtType));
+
+		// Dispatches holding the old table skip the delegate from now on
+		removed = *del_it;
+		removed->active = false;
+		ListenerList listeners;
+		std::copy_if(existing->begin(), existing->end(), std::back_inserter(listeners), [&compare](const auto& rhs) { return !compare(rhs); });
+
+		// Event type is left out of the new table if no listeners are active for it
+		if (listeners.empty()) {
+			m_log.info("removeListener", "Removing event type " + utility::toHex(evtType)
+				+ " because there are no delegates left after remove");
+		}
+		std::atomic_store(&m_listenerTable, std::shared_ptr<const ListenerTable>(
+			std::make_shared<ListenerTable>(*table, evtType, std::move(listeners))));
 
-	// Erase event type if no listeners are active for it
-	if (it->second.empty()) {
-		m_log.info("removeListener", "Removing event type " + utility::toHex(evtType)
-			+ " because there are no delegates left after remove");
-		m_eventListenerMap.erase(it);
+		ENSURE(getListenerTable()->find(evtType) == nullptr || std::count_if(getListenerTable()->find(evtType)->begin(),
+			getListenerTable()->find(evtType)->end(), compare) == 0);
 	}
 
-	ENSURE(std::all_of(m_eventListenerMap.begin(), m_eventListenerMap.end(), [](auto pair) { return !pair.second.empty(); }));
+	// Strand that checked active before it was cleared may still be calling the delegate on a worker. Table lock is
+	// not held while waiting, so the delegate can still add and remove listeners
+	if (removed->threadSafe && removed.get() != runningStrand) {
+		std::unique_lock<std::mutex> lock(removed->strandMtx);
+		removed->strandStopped.wait(lock, [&removed]() { return removed->strandState != ListenerEntry::RUNNING; });
+	}
 	return true;
 }
 
@@ -93,25 +165,7 @@ void EventManager::triggerEvent(EventDataPtr pEvent)
 		return;
 	}
 
-	std::lock_guard<std::mutex> lock(m_mapMtx);
-
-	const EventType evtType = pEvent->vGetEventType();
-	auto it = m_eventListenerMap.find(evtType);
-	if (it == m_eventListenerMap.end()) {
-		m_log.warn("triggerEvent", "Attempting to trigger event type " + utility::toHex(evtType) + " with no delegates");
-		return;
-	}
-
-	// Lambda to execute delegates, before calling make sure the delegate is still callable
-	const auto execute = [pEvent](auto tuple) {
-		auto func = std::get<1>(tuple);
-		if (func)
-			func(pEvent);
-	};
-
-	// Execute all delegates for the event type
-	m_log.debug("triggerEvent", "Executing delegates for event type " + utility::toHex(evtType));
-	std::for_each(it->second.begin(), it->second.end(), execute);
+	trigger(pEvent->vGetEventType(), eventTypeIndex<EventDataPtr>(), &pEvent);
 }
 
 bool EventManager::queueEvent(EventDataPtr pEvent)
@@ -122,14 +176,20 @@ bool EventManager::queueEvent(EventDataPtr pEvent)
 		return false;
 	}
 
-	std::lock_guard<std::mutex> lock(m_queueMtx);
-
-	m_log.info("queueEvent", "Adding event " + utility::toHex(pEvent->vGetEventType()) + " to event queue");
-	m_eventQueue.emplace(pEvent);
+	return queuePriorityEvent(std::move(pEvent), NORMAL);
+}
 
-	ENSURE(m_eventQueue.back() == pEvent);
+bool EventManager::queuePriorityEvent(EventDataPtr pEvent, const EVENT_PRIORITY priority)
+{
+	REQUIRE(pEvent != nullptr);
+	if (!pEvent) {
+		m_log.error("queueEvent", "Attempting to queue nullptr event");
+		return false;
+	}
 
-	return true;
+	const EventType evtType = pEvent->vGetEventType();
+	EventPool<EventDataPtr>* pool = getPool<EventDataPtr>();
+	return enqueue(pool != nullptr ? pool->emplace(evtType, std::move(pEvent)) : nullptr, priority);
 }
 
 void EventManager::onUpdate(int msToProcess)
@@ -140,25 +200,263 @@ void EventManager::onUpdate(int msToProcess)
 		return;
 	}
 
-	std::lock_guard<std::mutex> lock(m_queueMtx);
+	// Only consumers wait here, producers keep queueing while events are triggered
+	std::lock_guard<std::mutex> lock(m_updateMtx);
+	const long long startTime = utility::steadyTimeUs();
+	const long long budgetUs = static_cast<long long>(msToProcess) * 1000;
 
 	m_log.debug("onUpdate", "Processing events from event queue");
-	// Process events from queue until queue is empty or all the time given to process is used
-	int elapsedMs = 0;
-	const int startTime = utility::timestampMs();
-	while (!m_eventQueue.empty() && elapsedMs < msToProcess) {
-		// Get first event from queue and trigger it
-		triggerEvent(m_eventQueue.front());
-		m_eventQueue.pop();
 
-		// Calculate the time used processing events
-		elapsedMs = utility::deltaTimeMs(startTime);
+	// Every lane is taken before any event is triggered, so events queued by delegates wait for the next call
+	for (auto& lane : m_lanes)
+		fillBatch(lane);
+
+	// One table for the whole batch
+	const auto table = getListenerTable();
+	std::atomic<unsigned int> pending(0);
+	const bool parallel = isParallel();
+	const unsigned int maxPending = parallel ? m_dispatchPool->getThreadCount() * DELIVERIES_PER_THREAD : 0;
+
+	// Process lanes from the highest until all are empty or all the time given to process is used
+	std::array<std::size_t, PRIORITY_COUNT> firstIndex;
+	long long elapsedUs = 0;
+	for (std::size_t priority = 0; priority < m_lanes.size(); ++priority) {
+		Lane& lane = m_lanes[priority];
+		firstIndex[priority] = lane.batchIndex;
+		while (lane.batchIndex < lane.batch.size() && elapsedUs < budgetUs) {
+			// Get first event from batch and trigger it
+			PooledEvent* node = lane.batch[lane.batchIndex++];
+			--lane.length;
+			dispatch(node->evtType, node->typeIndex, node->payload, *table, parallel ? &pending : nullptr);
+			if (parallel && pending.load(std::memory_order_acquire) > maxPending)
+				waitFor(pending, *table, maxPending / 2);
+
+			// Calculate the time used processing events
+			elapsedUs = utility::steadyTimeUs() - startTime;
+		}
+	}
+
+	// Events are destroyed once every strand has called its delegate with them
+	if (parallel)
+		waitFor(pending, *table, 0);
+	unsigned int eventsLeft = 0;
+	for (std::size_t priority = 0; priority < m_lanes.size(); ++priority) {
+		Lane& lane = m_lanes[priority];
+		for (auto i = firstIndex[priority]; i < lane.batchIndex; ++i)
+			destroy(lane.batch[i]);
+		lane.triggered += lane.batchIndex - firstIndex[priority];
+		lane.deferred += lane.batch.size() - lane.batchIndex;
+
+		// Events queued meanwhile are taken too, so that the front of the batch is the oldest event waiting
+		fillBatch(lane);
+		lane.oldestQueueTime = lane.batch.empty() ? -1 : lane.batch.front()->queueTime;
+		eventsLeft += lane.length.load();
 	}
-	m_log.debug("onUpdate", utility::toStr(m_eventQueue.size()) + " events left after processing events");
+	m_log.debug("onUpdate", "{} events left after processing events", eventsLeft);
 }
 
 unsigned int EventManager::getQueueLength()
 {
-	std::lock_guard<std::mutex> lock(m_queueMtx);
-	return m_eventQueue.size();
+	unsigned int length = 0;
+	for (const auto& lane : m_lanes)
+		length += lane.length.load();
+	return length;
+}
+
+void EventManager::setLaneLimit(const EVENT_PRIORITY priority, const unsigned int maxQueued)
+{
+	REQUIRE(priority >= 0 && priority < PRIORITY_COUNT);
+	if (priority < 0 || priority >= PRIORITY_COUNT) {
+		m_log.error("setLaneLimit", "Invalid priority " + utility::toStr(priority));
+		return;
+	}
+	m_lanes[priority].limit = maxQueued;
+}
+
+EventManager::Stats EventManager::getStats() const
+{
+	Stats stats;
+	const long long now = utility::steadyTimeUs();
+	for (std::size_t priority = 0; priority < m_lanes.size(); ++priority) {
+		const Lane& lane = m_lanes[priority];
+		const long long oldest = lane.oldestQueueTime.load();
+		stats[priority].queued = lane.length.load();
+		stats[priority].oldestAgeUs = oldest >= 0 ? now - oldest : 0;
+		stats[priority].triggered = lane.triggered.load();
+		stats[priority].deferred = lane.deferred.load();
+		stats[priority].dropped = lane.dropped.load();
+	}
+	return stats;
+}
+
+std::shared_ptr<const ListenerTable> EventManager::getListenerTable() const
+{
+	return std::atomic_load(&m_listenerTable);
+}
+
+bool EventManager::enqueue(PooledEvent* node, const EVENT_PRIORITY priority)
+{
+	REQUIRE(priority >= 0 && priority < PRIORITY_COUNT);
+	if (priority < 0 || priority >= PRIORITY_COUNT) {
+		m_log.error("queueEvent", "Invalid priority " + utility::toStr(priority));
+		if (node != nullptr)
+			destroy(node);
+		return false;
+	}
+
+	Lane& lane = m_lanes[priority];
+	if (node == nullptr) {
+		++lane.dropped;
+		m_log.error("queueEvent", "Too many events queued, event dropped");
+		return false;
+	}
+
+	// Limit is not exact when producers race, the lane may go over it by the count of producers
+	const unsigned int limit = lane.limit.load(std::memory_order_relaxed);
+	if (limit > 0 && lane.length.load(std::memory_order_relaxed) >= limit) {
+		++lane.dropped;
+		destroy(node);
+		return false;
+	}
+
+	// Counted first, so that the length is never lower than the events onUpdate can see
+	node->queueTime = utility::steadyTimeUs();
+	++lane.length;
+	lane.queue.push(node);
+	return true;
+}
+
+void EventManager::fillBatch(Lane& lane)
+{
+	// Swap buffers by taking the events queued so far behind those left from the last update.
+	// Length counts an event before it is pushed, so popping stops at events that are not visible yet
+	lane.batch.erase(lane.batch.begin(), lane.batch.begin() + lane.batchIndex);
+	lane.batchIndex = 0;
+	for (auto count = lane.length.load() - lane.batch.size(); count > 0; --count) {
+		PooledEvent* node = lane.queue.tryPop();
+		if (node == nullptr)
+			break;
+		lane.batch.push_back(node);
+	}
+}
+
+void EventManager::destroy(PooledEvent* node)
+{
+	m_pools[node->typeIndex].load(std::memory_order_acquire)->destroy(node);
+}
+
+void EventManager::trigger(const EventType evtType, const uint32_t typeIndex, const void* evt)
+{
+	// Table is held for the whole dispatch, delegates may publish new tables meanwhile
+	const auto table = getListenerTable();
+	if (!isParallel()) {
+		dispatch(evtType, typeIndex, evt, *table, nullptr);
+		return;
+	}
+
+	std::atomic<unsigned int> pending(0);
+	dispatch(evtType, typeIndex, evt, *table, &pending);
+	waitFor(pending, *table, 0);
+}
+
+bool EventManager::isParallel() const
+{
+	return m_dispatchPool != nullptr && !inStrand;
+}
+
+void EventManager::dispatch(const EventType evtType, const uint32_t typeIndex, const void* evt,
+	const ListenerTable& table, std::atomic<unsigned int>* pending)
+{
+	const auto listeners = table.find(evtType);
+	if (listeners == nullptr) {
+		m_log.warn("dispatch", "Attempting to trigger event type {x} with no delegates", evtType);
+		return;
+	}
+
+	// Execute all delegates for the event type, before calling make sure the delegate is still active
+	m_log.debug("dispatch", "Executing delegates for event type {x}", evtType);
+	for (const auto& entry : *listeners) {
+		if (!entry->active || entry->typeIndex != typeIndex)
+			continue;
+
+		if (pending == nullptr || !entry->threadSafe) {
+			if (entry->evtDelegate)
+				entry->evtDelegate(*static_cast<const EventDataPtr*>(evt));
+			else if (entry->typedDelegate)
+				entry->typedDelegate(evt);
+			continue;
+		}
+
+		// Counted before the strand can see the delivery, and strand is submitted only when it was idle
+		++*pending;
+		bool submit = false;
+		{
+			std::lock_guard<std::mutex> lock(entry->strandMtx);
+			entry->strand.push_back(Delivery{ evt, pending });
+			if (entry->strandState == ListenerEntry::IDLE) {
+				entry->strandState = ListenerEntry::QUEUED;
+				submit = true;
+			}
+		}
+		if (submit) {
+			std::shared_ptr<ListenerEntry> strandEntry = entry;
+			m_dispatchPool->submit([strandEntry]() { runStrand(*strandEntry); });
+		}
+	}
+}
+
+void EventManager::waitFor(const std::atomic<unsigned int>& pending, const ListenerTable& table, unsigned int limit)
+{
+	while (pending.load(std::memory_order_acquire) > limit) {
+		// Take strands still waiting for a worker, yield only when every strand is taken
+		bool ran = false;
+		table.forEach([&ran](EventType, const ListenerList& listeners) {
+			for (const auto& entry : listeners) {
+				if (entry->threadSafe && runStrand(*entry))
+					ran = true;
+			}
+		});
+		if (!ran)
+			std::this_thread::yield();
+	}
+}
+
+bool EventManager::runStrand(ListenerEntry& entry)
+{
+	{
+		std::lock_guard<std::mutex> lock(entry.strandMtx);
+		if (entry.strandState != ListenerEntry::QUEUED)
+			return false;
+		entry.strandState = ListenerEntry::RUNNING;
+	}
+
+	// Events triggered by the delegate are dispatched serially, waiting for strands here could deadlock
+	const bool wasInStrand = inStrand;
+	const ListenerEntry* const wasRunningStrand = runningStrand;
+	inStrand = true;
+	runningStrand = &entry;
+	for (;;) {
+		Delivery delivery;
+		{
+			std::lock_guard<std::mutex> lock(entry.strandMtx);
+			if (entry.strand.empty()) {
+				entry.strandState = ListenerEntry::IDLE;
+				entry.strandStopped.notify_all();
+				break;
+			}
+			delivery = entry.strand.front();
+			entry.strand.pop_front();
+		}
+
+		if (entry.active) {
+			if (entry.evtDelegate)
+				entry.evtDelegate(*static_cast<const EventDataPtr*>(delivery.evt));
+			else if (entry.typedDelegate)
+				entry.typedDelegate(delivery.evt);
+		}
+		delivery.pending->fetch_sub(1, std::memory_order_release);
+	}
+	inStrand = wasInStrand;
+	runningStrand = wasRunningStrand;
+	return true;
 }
@@ -1,26 +1,84 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <functional>
-#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "Event/eventpool.h"
+#include "Event/listenertable.h"
 #include "interfaces.h"
 #include "Utility/logger.h"
+#include "Utility/mpscqueue.h"
+#include "Utility/threadpool.h"
 
 // This class is accessed through Service Locator pattern (Locator class), DO NOT CONSTRUCT EXPLICITLY
 // All functions are thread safe
 // Allows objects to have only one delegate per event type
+// Queueing never blocks, events from any thread go to a lock-free queue that onUpdate drains in batches
+//
+// Queue has a lane per priority. onUpdate triggers every event of a higher lane before any of a lower lane,
+// so a flood of low priority events cannot delay e.g. input, and the time given to it is measured with a
+// steady clock in microseconds. Lanes can be limited to a count of waiting events, and each lane keeps
+// counters that getStats returns
+//
+// Besides shared IEvent objects, events can be any C++ type T with a static EventType eventType member.
+// Typed events are constructed in place in a pool of their type and delegates get them by const reference,
+// so queueing them does not allocate once the pool has grown large enough. Shared events are stored in
+// the same way as typed events of type EventDataPtr, and all events are triggered in one queue order.
+// Typed delegates are called only for events of the C++ type they were added for
+//
+// Listeners are kept in an immutable table that is published atomically. Dispatch reads the table without
+// locking or copying delegates, and adding or removing a listener builds and publishes a new table.
+// Delegates are called without holding any lock, so they may queue and trigger events and add and remove
+// listeners. Events are dispatched to the table taken when triggerEvent is called or when onUpdate starts:
+// listeners added during dispatch get later events, and removed listeners are skipped if they have not
+// been called yet
+//
+// Dispatch is serial unless EventDispatchThreads in config is above 0. Then delegates of listeners registered
+// with registerThreadSafeListener run on dispatch workers, each through its own strand so that it gets
+// events in order, while other delegates run on the dispatching thread. Dispatching thread takes waiting
+// strands itself instead of idling, and triggerEvent and onUpdate return only after every delegate has been
+// called. Events triggered by delegates running on workers are dispatched serially on that worker. Removing a
+// thread safe delegate waits for the call in progress on a worker, so its owner can be destroyed right after
 class EventManager : public IEventManager {
 public:
+	// Lanes of the queue, higher lanes are triggered first
+	enum EVENT_PRIORITY {
+		HIGH,			//!< Events that must not wait, e.g. input
+		NORMAL,			//!< Default lane of queueEvent and emplaceEvent
+		LOW,			//!< Events that can wait or be dropped, e.g. statistics
+		PRIORITY_COUNT
+	};
+
+	// Counters of one lane
+	struct LaneStats {
+		unsigned int queued;			//!< Events waiting in the lane
+		long long oldestAgeUs;			//!< Age in microseconds of the oldest event the last onUpdate left waiting,
+										//!< 0 if it left none
+		unsigned long long triggered;	//!< Events triggered since construction
+		unsigned long long deferred;	//!< Events left waiting when onUpdate ran out of time, counted on every
+										//!< onUpdate that leaves them
+		unsigned long long dropped;		//!< Events not queued because the lane or the pool of their type was full
+	};
+
+	using Stats = std::array<LaneStats, PRIORITY_COUNT>;
 
 	/**
-	 * \brief EventManager
+	 * \brief EventManager. Count of dispatch workers is read from config
 	 */
 	EventManager();
 
+	/**
+	 * \brief EventManager
+	 * \param dispatchThreads Count of workers running thread safe delegates, 0 to dispatch serially
+	 */
+	explicit EventManager(unsigned int dispatchThreads);
+
 	/**
 	 * \brief ~EventManager
 	 */
@@ -32,46 +90,134 @@ public:
 	 */
 	ListenerId registerListener() override;
 
+	/**
+	 * \brief Used to get listener ID for a listener whose delegates may be called on dispatch workers,
+	 *	concurrently with other delegates and with triggerEvent calls. DO NOT EXPLICITLY CALL! EventListener
+	 *	class calls this in its builder. Thread safe
+	 * \return Unique ListenerId (int)
+	 */
+	ListenerId registerThreadSafeListener() override;
+
 	/**
 	 * \brief Used to add listeners for certain events. Allows objects to have only one listener delegate per event type. Thread safe
 	 * \param evtType Event GUID
 	 * \param listener ListenerID assigned by registerListener(). Used to identify listener
 	 * \param evtDelegate Function object called when event launches
 	 * \pre evtDelegate
-	 * \post m_eventListenerMap.find(evtType) != m_eventListenerMap.end()
-	 * \post std::count_if(m_eventListenerMap[evtType].begin(), m_eventListenerMap[evtType].end(), compare) == 1
+	 * \post getListenerTable()->find(evtType) != nullptr
+	 * \post std::count_if(getListenerTable()->find(evtType)->begin(), getListenerTable()->find(evtType)->end(), compare) == 1
 	 * \return True if successful, otherwise false
 	 */
 	bool addListener(const EventType evtType, const ListenerId listener, const EventDelegate evtDelegate) override;
 
 	/**
-	 * \brief Used to remove object's listener delegate for certain event type. Thread safe
+	 * \brief Used to add listener for typed events. Same rules as with addListener, the listener can have one
+	 *	delegate per event type whether it is typed or not. Thread safe
+	 * \param listener ListenerID assigned by registerListener(). Used to identify listener
+	 * \param evtDelegate Function object called with the event when event of type T launches
+	 * \pre evtDelegate
+	 * \return True if successful, otherwise false
+	 */
+	template<typename T>
+	bool addTypedListener(const ListenerId listener, std::function<void(const T&)> evtDelegate)
+	{
+		auto entry = std::make_shared<ListenerEntry>();
+		entry->listener = listener;
+		entry->typeIndex = eventTypeIndex<T>();
+		if (evtDelegate) {
+			entry->typedDelegate = [evtDelegate](const void* evt) { evtDelegate(*static_cast<const T*>(evt)); };
+		}
+		entry->active = true;
+		return addEntry(T::eventType, std::move(entry));
+	}
+
+	/**
+	 * \brief Used to remove object's listener delegate for certain event type. Thread safe. The delegate is not
+	 *	called after this returns: if it is running on a dispatch worker, waits until it returns, unless called
+	 *	by that delegate itself. Two thread safe delegates must not remove each other while both may be running
 	 * \param evtType Event GUID
 	 * \param listener ListenerID assigned by registerListener(). Used to identify listener
-	 * \post std::count_if(m_eventListenerMap[evtType].begin(), m_eventListenerMap[evtType].end(), compare) == 0
-	 * \post std::all_of(m_eventListenerMap.begin(), m_eventListenerMap.end(), [](auto pair) { return !pair.second.empty(); })
+	 * \post getListenerTable()->find(evtType) == nullptr || std::count_if(getListenerTable()->find(evtType)->begin(),
+	 *	getListenerTable()->find(evtType)->end(), compare) == 0
 	 * \return True if successful, otherwise false
 	 */
 	bool removeListener(const EventType evtType, const ListenerId listener) override;
 
 	/**
-	 * \brief Triggers event listeners immediately by forwarding event to them. Thread safe
+	 * \brief Triggers event listeners immediately by forwarding event to them. Thread safe, delegates are
+	 *	called on the calling thread without holding locks
 	 * \param pEvent Event being triggered
 	 * \pre pEvent != nullptr
 	 */
 	void triggerEvent(EventDataPtr pEvent) override;
 
 	/**
-	 * \brief Used to place event in the queue. If event is not valid, it is not placed in the queue. Thread safe
+	 * \brief Used to place event in the queue. If event is not valid, it is not placed in the queue. Thread safe,
+	 *	does not wait for other producers or for onUpdate
 	 * \param pEvent Event being placed in the queue
 	 * \pre pEvent != nullptr
-	 * \post m_eventQueue.back() == pEvent
+	 * \post pEvent is triggered by onUpdate after events queued before it by the same thread
 	 * \return True if event was valid to be placed in a queue, otherwise false
 	 */
 	bool queueEvent(EventDataPtr pEvent) override;
 
 	/**
-	 * \brief Processes event queue until the queue is empty or the function has run out of time given to it. Thread safe
+	 * \brief Used to place event in a lane of the queue, same as queueEvent. Thread safe
+	 * \param pEvent Event being placed in the queue
+	 * \param priority Lane of the event
+	 * \pre pEvent != nullptr
+	 * \pre priority >= 0 && priority < PRIORITY_COUNT
+	 * \post pEvent is triggered by onUpdate after events queued before it in the same lane by the same thread
+	 * \return True if event was placed in the queue, otherwise false
+	 */
+	bool queuePriorityEvent(EventDataPtr pEvent, const EVENT_PRIORITY priority);
+
+	/**
+	 * \brief Triggers typed event immediately, same as triggerEvent. Thread safe
+	 * \param evt Event being triggered
+	 */
+	template<typename T>
+	void triggerTypedEvent(const T& evt)
+	{
+		trigger(T::eventType, eventTypeIndex<T>(), &evt);
+	}
+
+	/**
+	 * \brief Used to construct typed event in the queue, same as queueEvent. Thread safe, does not wait
+	 *	for other producers or for onUpdate and allocates only when the pool of T grows
+	 * \param args Arguments to the constructor of T
+	 * \post Event is triggered by onUpdate after events queued before it by the same thread
+	 * \return True if event was placed in the queue, false if too many events of T are queued
+	 */
+	template<typename T, typename... Args>
+	bool emplaceEvent(Args&&... args)
+	{
+		return emplacePriorityEvent<T>(NORMAL, std::forward<Args>(args)...);
+	}
+
+	/**
+	 * \brief Used to construct typed event in a lane of the queue, same as emplaceEvent. Thread safe
+	 * \param priority Lane of the event
+	 * \param args Arguments to the constructor of T
+	 * \pre priority >= 0 && priority < PRIORITY_COUNT
+	 * \post Event is triggered by onUpdate after events queued before it in the same lane by the same thread
+	 * \return True if event was placed in the queue, false if the lane or the pool of T is full
+	 */
+	template<typename T, typename... Args>
+	bool emplacePriorityEvent(const EVENT_PRIORITY priority, Args&&... args)
+	{
+		EventPool<T>* pool = getPool<T>();
+		return enqueue(pool != nullptr ? pool->emplace(T::eventType, std::forward<Args>(args)...) : nullptr, priority);
+	}
+
+	/**
+	 * \brief Processes event queue until the queue is empty or the function has run out of time given to it.
+	 *	Events queued before the call are taken from the queue at once and triggered lane by lane, highest
+	 *	first, in queue order within a lane. Events queued during processing, e.g. by delegates, are left for
+	 *	the next call. Events not triggered in time are triggered first in their lane on the next call. With
+	 *	dispatch workers, a limited count of deliveries is handed to workers ahead of the dispatching thread, so
+	 *	that their work counts toward the time as well.
+	 *	Thread safe, concurrent calls are processed one after another and producers are not blocked
 	 * \param msToProcess Time in milliseconds to process queue
 	 * \pre msToProcess >= 0
 	 */
@@ -83,13 +229,161 @@ public:
 	 */
 	unsigned int getQueueLength() override;
 
+	/**
+	 * \brief Used to limit the count of events waiting in a lane. Queueing to a full lane fails and counts the
+	 *	event as dropped. Thread safe
+	 * \param priority Lane
+	 * \param maxQueued Most events waiting in the lane, 0 for no limit
+	 * \pre priority >= 0 && priority < PRIORITY_COUNT
+	 */
+	void setLaneLimit(const EVENT_PRIORITY priority, const unsigned int maxQueued);
+
+	/**
+	 * \brief Used to get counters of every lane. Thread safe
+	 * \return Counters indexed with EVENT_PRIORITY
+	 */
+	Stats getStats() const;
+
 protected: // Protected for testing purposes
+	// Queue and counters of one priority
+	struct Lane {
+		Lane() : queue(), length(0), batch(), batchIndex(0), limit(0), oldestQueueTime(-1), triggered(0),
+			deferred(0), dropped(0) {}
+
+		IntrusiveMpscQueue<PooledEvent> queue;			//!< Queue for events, popped only under m_updateMtx
+		std::atomic<unsigned int> length;				//!< Events queued but not yet triggered
+		std::vector<PooledEvent*> batch;				//!< Events taken from queue for processing, front buffer of
+														//!< the queue
+		std::size_t batchIndex;							//!< Next event to trigger in batch
+		std::atomic<unsigned int> limit;				//!< Most events waiting, 0 for no limit
+		std::atomic<long long> oldestQueueTime;			//!< Queue time of the oldest event left by the last onUpdate,
+														//!< -1 if none was left
+		std::atomic<unsigned long long> triggered;		//!< See LaneStats
+		std::atomic<unsigned long long> deferred;		//!< See LaneStats
+		std::atomic<unsigned long long> dropped;		//!< See LaneStats
+	};
+
+	static const uint32_t MAX_EVENT_TYPES = 256;						//!< Limit of C++ types of queued events
+	static const unsigned int DELIVERIES_PER_THREAD = 16;				//!< Deliveries onUpdate lets wait per dispatch
+																		//!< worker before it helps them finish
+
 	std::atomic<int> m_nextListenerID;									//!< ID given to next registering listener
-	std::map<const EventType, EventListenerVector> m_eventListenerMap;	//!< Map tracking which delegates listen to which events
-	std::queue<EventDataPtr> m_eventQueue;								//!< Queue for events
-	std::mutex m_mapMtx;												//!< Mutex used when accessing m_eventListenerMap
-	std::mutex m_queueMtx;												//!< Mutex used when accessing m_eventQueue
+	std::shared_ptr<const ListenerTable> m_listenerTable;				//!< Table tracking which delegates listen to which
+																		//!< events. Accessed only with atomic load and store
+	std::array<std::atomic<EventPoolBase*>, MAX_EVENT_TYPES> m_pools;	//!< Storage of queued events, indexed with
+																		//!< eventTypeIndex and created on first use
+	std::array<Lane, PRIORITY_COUNT> m_lanes;							//!< Queue lanes indexed with EVENT_PRIORITY
+	std::unordered_set<ListenerId> m_threadSafeListeners;				//!< Listeners whose delegates may run on workers,
+																		//!< guarded by m_tableMtx
+	std::mutex m_tableMtx;												//!< Mutex serializing writers of m_listenerTable
+	std::mutex m_updateMtx;												//!< Mutex serializing consumers in onUpdate
 	Logger m_log;														//!< Used to write to log
+	std::unique_ptr<ThreadPool> m_dispatchPool;							//!< Workers running thread safe delegates,
+																		//!< nullptr if dispatch is serial
+
+	/**
+	 * \brief Used to get the current listener table. Thread safe, does not lock
+	 * \return Table, stays valid while held even if a new table is published
+	 */
+	std::shared_ptr<const ListenerTable> getListenerTable() const;
+
+	/**
+	 * \brief Used to get the pool of typed events, creating it on first use. Thread safe
+	 * \return Pool, nullptr if there are more than MAX_EVENT_TYPES event types
+	 */
+	template<typename T>
+	EventPool<T>* getPool()
+	{
+		const uint32_t index = eventTypeIndex<T>();
+		if (index >= MAX_EVENT_TYPES)
+			return nullptr;
+
+		EventPoolBase* pool = m_pools[index].load(std::memory_order_acquire);
+		if (pool == nullptr) {
+			// Threads racing to create the pool keep the one stored first
+			EventPoolBase* created = new EventPool<T>();
+			if (m_pools[index].compare_exchange_strong(pool, created, std::memory_order_acq_rel))
+				pool = created;
+			else
+				delete created;
+		}
+		return static_cast<EventPool<T>*>(pool);
+	}
+
+	/**
+	 * \brief Used to add delegate to the listener table
+	 * \param evtType Event GUID
+	 * \param entry Delegate and its listener
+	 * \pre entry->evtDelegate || entry->typedDelegate
+	 * \post getListenerTable()->find(evtType) != nullptr
+	 * \post std::count_if(getListenerTable()->find(evtType)->begin(), getListenerTable()->find(evtType)->end(), compare) == 1
+	 * \return True if successful, otherwise false
+	 */
+	bool addEntry(const EventType evtType, std::shared_ptr<ListenerEntry> entry);
+
+	/**
+	 * \brief Used to place constructed event in the queue
+	 * \param node Event in its pool, nullptr if it could not be constructed
+	 * \param priority Lane of the event
+	 * \return True if event was placed in the queue, otherwise false
+	 */
+	bool enqueue(PooledEvent* node, const EVENT_PRIORITY priority);
+
+	/**
+	 * \brief Used to move events queued so far behind those left in the batch of a lane. Caller must hold
+	 *	m_updateMtx
+	 * \param lane Lane
+	 */
+	static void fillBatch(Lane& lane);
+
+	/**
+	 * \brief Used to destroy queued event
+	 * \param node Event in its pool
+	 */
+	void destroy(PooledEvent* node);
+
+	/**
+	 * \brief Used to call delegates of event and wait for those running on workers
+	 * \param evtType Event GUID
+	 * \param typeIndex C++ type of event, see dispatch
+	 * \param evt Event being triggered
+	 */
+	void trigger(const EventType evtType, const uint32_t typeIndex, const void* evt);
+
+	/**
+	 * \brief Used to test if delegates called by this thread may be handed to dispatch workers
+	 * \return True if there are workers and this thread is not running a delegate on a worker
+	 */
+	bool isParallel() const;
+
+	/**
+	 * \brief Used to call delegates of event. Thread safe delegates are handed to their strands when pending
+	 *	is given, others are called at once
+	 * \param evtType Event GUID
+	 * \param typeIndex C++ type of event, only delegates added for it are called. Shared events have the index
+	 *	of EventDataPtr
+	 * \param evt Event being triggered, must stay valid until pending is 0
+	 * \param table Listener table, must be held by caller until pending is 0
+	 * \param pending Counter of deliveries handed to strands, nullptr to call every delegate at once
+	 */
+	void dispatch(const EventType evtType, const uint32_t typeIndex, const void* evt, const ListenerTable& table,
+		std::atomic<unsigned int>* pending);
+
+	/**
+	 * \brief Used to wait until deliveries handed to strands have been called, running waiting strands of table
+	 *	on the calling thread meanwhile
+	 * \param pending Counter of deliveries given to dispatch
+	 * \param table Listener table given to dispatch
+	 * \param limit Deliveries that may still be waiting on return
+	 */
+	static void waitFor(const std::atomic<unsigned int>& pending, const ListenerTable& table, unsigned int limit);
+
+	/**
+	 * \brief Used to call the waiting deliveries of a strand, unless another thread already runs it
+	 * \param entry Delegate owning the strand
+	 * \return True if strand was run, otherwise false
+	 */
+	static bool runStrand(ListenerEntry& entry);
 };
 
 // Null class for Service Locator
@@ -98,6 +392,7 @@ public:
 	NullEventManager() {}
 	~NullEventManager() {}
 	ListenerId registerListener() override { return 0; };
+	ListenerId registerThreadSafeListener() override { return 0; };
 	bool addListener(const EventType, const ListenerId, const EventDelegate) override { return false; }
 	bool removeListener(const EventType, const ListenerId) override { return false; }
 	void triggerEvent(EventDataPtr) override {}
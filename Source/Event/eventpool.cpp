@@ -0,0 +1,7 @@
+#include "Event/eventpool.h"
+
+uint32_t nextEventTypeIndex()
+{
+	static std::atomic<uint32_t> nextIndex(0);
+	return nextIndex++;
+}
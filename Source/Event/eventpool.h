@@ -0,0 +1,207 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "interfaces.h"
+
+// Header of an event stored in an EventPool. Links the event into the queue of EventManager
+struct PooledEvent {
+	PooledEvent() : next(nullptr), payload(nullptr), queueTime(0), evtType(0), typeIndex(0), slotIndex(0), freeNext(0) {}
+
+	std::atomic<PooledEvent*> next;		//!< Node queued after this one
+	void* payload;						//!< Storage of the event in the same slot
+	long long queueTime;				//!< utility::steadyTimeUs when the event was queued
+	EventType evtType;					//!< Event GUID of the stored event
+	uint32_t typeIndex;					//!< Index of the pool and C++ type of the event, see eventTypeIndex
+	uint32_t slotIndex;					//!< Index of the slot in its pool
+	std::atomic<uint32_t> freeNext;		//!< Next free slot while the slot is in the free list
+};
+
+/**
+ * \brief Used to get a small unique index for a C++ event type. Same type always gets the same index
+ * \return Index, counting from 0 in the order types are first used
+ */
+uint32_t nextEventTypeIndex();
+
+/**
+ * \brief Used to get the index of C++ event type, used to find its pool and the delegates expecting it
+ * \return Index, same for every call with the same type
+ */
+template<typename T>
+uint32_t eventTypeIndex()
+{
+	static const uint32_t index = nextEventTypeIndex();
+	return index;
+}
+
+// Type independent part of EventPool, lets EventManager destroy events without knowing their type
+class EventPoolBase {
+public:
+	virtual ~EventPoolBase() {}
+
+	/**
+	 * \brief Used to destroy the stored event and give its slot back to the pool. Thread safe
+	 * \param node Node returned by emplace of the same pool, holding a constructed event
+	 */
+	virtual void destroy(PooledEvent* node) = 0;
+};
+
+// Storage for events of one C++ type, reused without allocating once enough slots exist
+//
+// Slots are allocated in blocks that are never freed or moved before the pool is destroyed, so a slot can be
+// found from its index without locking. Free slots form a lock-free stack of indices, where the head carries
+// a counter of pops so that a slot popped and pushed back meanwhile cannot be mistaken for the old head.
+// Only growing the pool takes a lock
+template<typename T>
+class EventPool : public EventPoolBase {
+public:
+	static const uint32_t BLOCK_SIZE = 1024;	//!< Slots allocated at once
+	static const uint32_t MAX_BLOCKS = 1024;	//!< Limit of blocks, so at most this many times BLOCK_SIZE events
+												//!< of one type exist at once
+
+	/**
+	 * \brief Constructor. Creates empty pool, the first block is allocated on first acquire
+	 */
+	EventPool() : m_freeHead(NONE), m_blockCount(0), m_growMtx()
+	{
+		for (auto& block : m_blocks)
+			block.store(nullptr, std::memory_order_relaxed);
+	}
+
+	/**
+	 * \brief Destructor. Every acquired slot must have been destroyed
+	 */
+	~EventPool()
+	{
+		for (auto& block : m_blocks)
+			delete[] block.load(std::memory_order_relaxed);
+	}
+
+	EventPool(const EventPool&) = delete;
+	EventPool& operator=(const EventPool&) = delete;
+
+	/**
+	 * \brief Used to take a free slot and construct event in it. Thread safe, does not lock unless the pool grows
+	 * \param evtType Event GUID stored in node
+	 * \param args Arguments to the constructor of T
+	 * \return Node of the event, nullptr if the pool is full
+	 */
+	template<typename... Args>
+	PooledEvent* emplace(EventType evtType, Args&&... args)
+	{
+		Slot* slot = acquire();
+		if (slot == nullptr)
+			return nullptr;
+		new (slot->header.payload) T(std::forward<Args>(args)...);
+		slot->header.evtType = evtType;
+		return &slot->header;
+	}
+
+	/**
+	 * \brief Used to destroy the stored event and give its slot back to the pool. Thread safe
+	 * \param node Node returned by emplace of this pool
+	 */
+	void destroy(PooledEvent* node) override
+	{
+		static_cast<T*>(node->payload)->~T();
+		release(node->slotIndex);
+	}
+
+private:
+	static const uint32_t NONE = 0xFFFFFFFF;	//!< Index of no slot
+
+	// One event and its header
+	struct Slot {
+		PooledEvent header;												//!< Queue link and bookkeeping
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;	//!< Raw storage of the event
+	};
+
+	std::atomic<uint64_t> m_freeHead;							//!< Pop counter in high and slot index in low bits
+	std::array<std::atomic<Slot*>, MAX_BLOCKS> m_blocks;		//!< Allocated blocks, filled from the front
+	uint32_t m_blockCount;										//!< Count of allocated blocks, guarded by m_growMtx
+	std::mutex m_growMtx;										//!< Mutex used when allocating a block
+
+	/**
+	 * \brief Used to find slot from its index
+	 * \param index Index of an allocated slot
+	 * \return Slot
+	 */
+	Slot* slotAt(uint32_t index) const
+	{
+		return &m_blocks[index / BLOCK_SIZE].load(std::memory_order_acquire)[index % BLOCK_SIZE];
+	}
+
+	/**
+	 * \brief Used to pop a free slot, growing the pool if none is free
+	 * \return Slot, nullptr if the pool is full
+	 */
+	Slot* acquire()
+	{
+		uint64_t head = m_freeHead.load(std::memory_order_acquire);
+		for (;;) {
+			const uint32_t index = static_cast<uint32_t>(head);
+			if (index == NONE) {
+				if (!grow())
+					return nullptr;
+				head = m_freeHead.load(std::memory_order_acquire);
+				continue;
+			}
+
+			// Next may be stale if another thread took the slot meanwhile, then the counter makes the swap fail
+			Slot* slot = slotAt(index);
+			const uint64_t next = ((head >> 32) + 1) << 32 | slot->header.freeNext.load(std::memory_order_relaxed);
+			if (m_freeHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+				return slot;
+		}
+	}
+
+	/**
+	 * \brief Used to push slot to the free stack
+	 * \param index Index of the slot
+	 */
+	void release(uint32_t index)
+	{
+		Slot* slot = slotAt(index);
+		uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+		uint64_t next;
+		do {
+			slot->header.freeNext.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+			next = (head & 0xFFFFFFFF00000000ull) | index;
+		} while (!m_freeHead.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	/**
+	 * \brief Used to allocate a block and push its slots to the free stack, unless another thread already freed
+	 *	slots while waiting for the lock
+	 * \return True if free slots may exist, false if the pool is full
+	 */
+	bool grow()
+	{
+		std::lock_guard<std::mutex> lock(m_growMtx);
+		if (static_cast<uint32_t>(m_freeHead.load(std::memory_order_acquire)) != NONE)
+			return true;
+		if (m_blockCount == MAX_BLOCKS)
+			return false;
+
+		const uint32_t first = m_blockCount * BLOCK_SIZE;
+		Slot* block = new Slot[BLOCK_SIZE];
+		for (uint32_t i = 0; i < BLOCK_SIZE; ++i) {
+			block[i].header.payload = &block[i].storage;
+			block[i].header.typeIndex = eventTypeIndex<T>();
+			block[i].header.slotIndex = first + i;
+		}
+		m_blocks[m_blockCount++].store(block, std::memory_order_release);
+
+		// Pushed last to first, so that slots are handed out in memory order
+		for (uint32_t i = BLOCK_SIZE; i > 0; --i)
+			release(first + i - 1);
+		return true;
+	}
+};
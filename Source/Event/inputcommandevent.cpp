@@ -1,11 +1,14 @@
 #include "Event/inputcommandevent.h"
 
+#include <utility>
+
 // 32bit GUID created with visual studio Tools->Create GUID->DEFINE GUID 
 const EventType InputCommandEvent::eventType(0xf894bb78);
 const std::string InputCommandEvent::m_eventName("Input Command");
 
-InputCommandEvent::InputCommandEvent(std::string key) : m_pressedKey(key) {}
+InputCommandEvent::InputCommandEvent(std::string key) : m_pressedKey(std::move(key)) {}
 
 EventType InputCommandEvent::vGetEventType() const { return eventType; }
 
-std::string InputCommandEvent::vGetEventName() const { return m_eventName; }
+const std::string& InputCommandEvent::vGetEventName() const { return m_eventName; }
+
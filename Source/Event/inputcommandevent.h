@@ -26,9 +26,10 @@ public:
 	 * \brief Used to get event name in plain text
 	 * \return Event name in plain text
 	 */
-	std::string vGetEventName() const override final;
+	const std::string& vGetEventName() const override final;
 
 private:
 	static const std::string m_eventName;	//!< Event name in plain text
 	const std::string m_pressedKey;			//!< Key pressed. Event payload
 };
+
@@ -0,0 +1,56 @@
+#include "Event/listenertable.h"
+
+#include "Utility/contract.h"
+
+ListenerTable::ListenerTable() : m_slots(1), m_size(0) {}
+
+ListenerTable::ListenerTable(const ListenerTable& table, EventType evtType, ListenerList listeners)
+	: m_slots(), m_size(0)
+{
+	const std::size_t count = table.size() + 1;
+	std::size_t capacity = 1;
+	while (capacity < count * 2) { capacity *= 2; }
+	m_slots.resize(capacity);
+
+	table.forEach([this, evtType](EventType type, const ListenerList& list) {
+		if (type != evtType)
+			insert(type, list);
+	});
+	if (!listeners.empty())
+		insert(evtType, std::move(listeners));
+
+	ENSURE(m_size * 2 <= m_slots.size());
+}
+
+const ListenerList* ListenerTable::find(EventType evtType) const
+{
+	const std::size_t mask = m_slots.size() - 1;
+	for (std::size_t i = slotIndex(evtType);; i = (i + 1) & mask) {
+		const auto& slot = m_slots[i];
+		if (slot.listeners.empty())
+			return nullptr;
+		if (slot.evtType == evtType)
+			return &slot.listeners;
+	}
+}
+
+std::size_t ListenerTable::size() const { return m_size; }
+
+void ListenerTable::insert(EventType evtType, ListenerList listeners)
+{
+	REQUIRE(!listeners.empty());
+	REQUIRE(m_size < m_slots.size());
+
+	const std::size_t mask = m_slots.size() - 1;
+	std::size_t i = slotIndex(evtType);
+	while (!m_slots[i].listeners.empty()) { i = (i + 1) & mask; }
+	m_slots[i] = Slot{ evtType, std::move(listeners) };
+	++m_size;
+}
+
+std::size_t ListenerTable::slotIndex(EventType evtType) const
+{
+	// Event types are GUID fragments, multiplicative mixing spreads them over the low bits
+	const uint32_t mixed = evtType * 0x9E3779B1u;
+	return static_cast<std::size_t>(mixed ^ (mixed >> 16)) & (m_slots.size() - 1);
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "interfaces.h"
+
+// Delegate of typed event, called with pointer to the event of the C++ type the delegate was added for
+using TypedDelegate = std::function<void(const void*)>;
+
+// Event waiting in the strand of a thread safe delegate
+struct Delivery {
+	const void* evt;					//!< Event, pointer to EventDataPtr for shared delegates
+	std::atomic<unsigned int>* pending;	//!< Deliveries left of the dispatch, decremented after the call
+};
+
+// Delegate of one listener, shared by every table that contains it
+//
+// Thread safe delegates have a strand, a queue of deliveries that is run by one thread at a time in queue
+// order, so the delegate gets events in order even though it runs on dispatch workers
+struct ListenerEntry {
+	enum STRAND_STATE {
+		IDLE,		//!< No deliveries waiting
+		QUEUED,		//!< Deliveries waiting, strand not running
+		RUNNING		//!< A thread is calling the delegate
+	};
+
+	ListenerId listener;					//!< Listener owning the delegate
+	uint32_t typeIndex;						//!< C++ type of events the delegate takes, see eventTypeIndex
+	EventDelegate evtDelegate;				//!< Function object called when shared event launches, empty for typed delegate
+	TypedDelegate typedDelegate;			//!< Function object called when typed event launches, empty for shared delegate
+	std::atomic<bool> active;				//!< Cleared on removal, so that dispatch running on an old table skips it
+	bool threadSafe;						//!< True if delegate may run on dispatch workers
+	std::mutex strandMtx;					//!< Mutex used when accessing strand and strandState
+	std::deque<Delivery> strand;			//!< Deliveries waiting for the delegate
+	STRAND_STATE strandState;				//!< State of strand
+	std::condition_variable strandStopped;	//!< Notified when strandState leaves RUNNING
+};
+
+using ListenerList = std::vector<std::shared_ptr<ListenerEntry>>;
+
+// Immutable hash table from event type to the delegates listening to it
+//
+// Open addressing with linear probing in a flat array that is kept at most half full, so a lookup touches
+// one or two adjacent slots. Table is never changed after construction, changes build a new table that
+// shares the entries, so any number of threads can read a table while a new one is built
+class ListenerTable {
+public:
+
+	/**
+	 * \brief Constructor. Creates empty table
+	 */
+	ListenerTable();
+
+	/**
+	 * \brief Constructor. Creates copy of table with listeners of one event type replaced
+	 * \param table Table to be copied
+	 * \param evtType Event type to be replaced
+	 * \param listeners New listeners of evtType, empty removes the event type
+	 */
+	ListenerTable(const ListenerTable& table, EventType evtType, ListenerList listeners);
+
+	/**
+	 * \brief Used to find listeners of event type
+	 * \param evtType Event type
+	 * \return Pointer to listeners, nullptr if event type has none. Valid while table exists
+	 */
+	const ListenerList* find(EventType evtType) const;
+
+	/**
+	 * \brief Used to get the count of event types with listeners
+	 * \return Count of event types
+	 */
+	std::size_t size() const;
+
+	/**
+	 * \brief Calls function for every event type in table
+	 * \param func Callable with signature void(EventType evtType, const ListenerList& listeners)
+	 */
+	template<typename Func>
+	void forEach(Func&& func) const
+	{
+		for (const auto& slot : m_slots) {
+			if (!slot.listeners.empty())
+				func(slot.evtType, slot.listeners);
+		}
+	}
+
+private:
+	// Slot of the flat array, unused when it has no listeners
+	struct Slot {
+		EventType evtType;		//!< Event type
+		ListenerList listeners;	//!< Delegates of the event type
+	};
+
+	std::vector<Slot> m_slots;	//!< Power of two sized slot array
+	std::size_t m_size;			//!< Count of used slots
+
+	/**
+	 * \brief Used to add event type that is not in table yet. Slot array must have a free slot
+	 * \param evtType Event type
+	 * \param listeners Listeners of event type, not empty
+	 */
+	void insert(EventType evtType, ListenerList listeners);
+
+	/**
+	 * \brief Used to get first slot to probe for event type
+	 * \param evtType Event type
+	 * \return Index to slot array
+	 */
+	std::size_t slotIndex(EventType evtType) const;
+};
@@ -4,10 +4,12 @@
 
 #include "Renderer/renderer.h"
 #include "Utility/config.h"
+#include "Utility/contract.h"
 #include "Utility/locator.h"
+#include "World/worldquery.h"
 
 GameManager::GameManager() 
-	: m_renderer(nullptr), m_player(), m_log("GameManager"), m_world(nullptr) {}
+	: m_renderer(nullptr), m_player(), m_log("GameManager"), m_world(nullptr), m_breakHeld(false), m_placeHeld(false) {}
 
 bool GameManager::start()
 {
@@ -23,6 +25,7 @@ bool GameManager::start()
 		);
 
 		m_world = std::make_unique<WorldManager>();
+		m_player.setWorld(&m_world->getWorld());
 		m_log.info("start", "Finished setting up game manager");
 
 		m_renderer->vStartMainLoop(); //Start main loop
@@ -35,5 +38,38 @@ bool GameManager::start()
 void GameManager::onUpdate(const float deltatime)
 {
 	m_player.onUpdate(*m_renderer.get(), deltatime);
+	editTargetBlock();
 	m_world->onUpdate(m_player, *m_renderer.get(), deltatime);
 }
+
+void GameManager::editTargetBlock()
+{
+	REQUIRE(m_world != nullptr);
+	const bool breakPressed = m_renderer->vMouseButtonPressed(GLFW_MOUSE_BUTTON_LEFT);
+	const bool placePressed = m_renderer->vMouseButtonPressed(GLFW_MOUSE_BUTTON_RIGHT);
+	const bool breakClicked = breakPressed && !m_breakHeld;
+	const bool placeClicked = placePressed && !m_placeHeld;
+	m_breakHeld = breakPressed;
+	m_placeHeld = placePressed;
+
+	worldQuery::RaycastHit hit;
+	if ((!breakClicked && !placeClicked) || !m_player.getTargetBlock(hit))
+		return;
+
+	if (breakClicked) {
+		m_world->setBlock(hit.block, AIR);
+		return;
+	}
+
+	// New block goes against the face that was hit, but not where the player stands
+	if (hit.normal == glm::ivec3(0))
+		return;
+	const glm::vec3 pos(hit.block + hit.normal);
+	const AABB block{ pos - glm::vec3(0.5f), pos + glm::vec3(0.5f) };
+	const AABB player = m_player.getBounds();
+	const bool overlapsPlayer = block.min.x < player.max.x && block.max.x > player.min.x
+		&& block.min.y < player.max.y && block.max.y > player.min.y
+		&& block.min.z < player.max.z && block.max.z > player.min.z;
+	if (!overlapsPlayer)
+		m_world->setBlock(hit.block + hit.normal, hit.type);
+}
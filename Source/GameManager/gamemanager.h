@@ -34,4 +34,13 @@ private:
 	Player m_player;						//!< Player
 	Logger m_log;							//!< Logger object used to write log entries
 	std::unique_ptr<WorldManager> m_world;	//!< Holds data of objects in the world
+	bool m_breakHeld;						//!< True while the break button was pressed on the last update
+	bool m_placeHeld;						//!< True while the place button was pressed on the last update
+
+	/**
+	 * \brief Used to break the block under the crosshair on left click and place one against it on right click.
+	 *	A held button edits one block only
+	 * \pre m_world != nullptr
+	 */
+	void editTargetBlock();
 };
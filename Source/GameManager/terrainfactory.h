@@ -1,23 +1,15 @@
 #pragma once
 
-#include <memory>
+#include <string>
 
-#include "Object/terrain.h"
-#include "Renderer/modelmanager.h"
-
-enum TERRAIN_TYPE { GRASS };
+#include "World/chunk.h"
 
 namespace terrainFactory {
 
-	std::unique_ptr<Terrain> createCube(const TERRAIN_TYPE type, const Transform& transform, ModelManager& modelManager);
-
 	/**
-	 * \brief createCube
-	 * \param objects
-	 * \param count
-	 * \param modelManager
-	 * \post !objects.empty()
-	 * \return
+	 * \brief Used to get texture filename of terrain type
+	 * \param type Terrain type
+	 * \return Texture filename without filepath, empty string if type has no texture
 	 */
-	bool initializeWorld(std::vector<std::unique_ptr<Terrain>>& objects, const unsigned int count, ModelManager& modelManager);
+	std::string getTextureFilename(const TERRAIN_TYPE type);
 }
@@ -1,18 +1,256 @@
 #include "GameManager/worldmanager.h"
 
+#include <algorithm>
+#include <chrono>
+
+#pragma warning (push, 2)  // Temporarily set warning level 2
+#include <3rdParty/glm/gtc/matrix_transform.hpp>
+#pragma warning (pop)      // Restore back
+
 #include "GameManager/terrainfactory.h"
+#include "Utility/config.h"
+#include "Utility/contract.h"
+#include "Utility/locator.h"
+#include "Utility/utility.h"
+
+namespace {
+
+	// Two chunks per index cell keeps the cell count low while queries near the player stay tight
+	const int CHUNK_INDEX_CELL_SIZE = Chunk::SIZE * 2;
+
+	/**
+	 * \brief Used to read terrain generator settings from config
+	 * \return Settings with defaults for values missing from config
+	 */
+	TerrainGenerator::Settings loadGeneratorSettings()
+	{
+		TerrainGenerator::Settings settings;
+		settings.seed = static_cast<uint32_t>(Locator::getConfig()->get("WorldSeed", static_cast<int>(settings.seed)));
+		return settings;
+	}
+
+	/**
+	 * \brief Used to read chunk streaming settings from config
+	 * \param threadCount Count of worker threads, limits tasks in flight so that queues stay short
+	 * \return Settings with defaults for values missing from config
+	 */
+	ChunkStreamer::Settings loadStreamerSettings(unsigned int threadCount)
+	{
+		const int loadRadius = std::max(0, Locator::getConfig()->get("StreamRadius", 8));
+		const int unloadRadius = std::max(loadRadius, Locator::getConfig()->get("UnloadRadius", loadRadius + 2));
+		return ChunkStreamer::Settings{ loadRadius, unloadRadius, threadCount * 2, threadCount * 4 };
+	}
+
+	/**
+	 * \brief Used to read level of detail rings from config
+	 * \return Chunk distance where levels 1, 2 and 3 start, increasing
+	 */
+	LodRings::Distances loadLodDistances()
+	{
+		const auto distances = Locator::getConfig()->get("LodDistances", glm::vec3(3.0f, 6.0f, 12.0f));
+		LodRings::Distances result;
+		int previous = 0;
+		for (std::size_t i = 0; i < result.size(); ++i) {
+			result[i] = std::max(previous, static_cast<int>(distances[static_cast<int>(i)]));
+			previous = result[i];
+		}
+		return result;
+	}
+
+	/**
+	 * \brief Used to open storage of the save named in config
+	 * \return Storage, nullptr if SaveName is empty
+	 */
+	std::unique_ptr<WorldStorage> createStorage()
+	{
+		const auto name = Locator::getConfig()->get("SaveName", std::string("world"));
+		if (name.empty())
+			return nullptr;
+		return std::make_unique<WorldStorage>(
+			Locator::getConfig()->get("DataPath", std::string("../Data/")) + "Saves/" + name + "/");
+	}
+
+} // anonymous namespace
+
+WorldManager::WorldManager()
+	: m_world(), m_generator(loadGeneratorSettings()), m_storage(createStorage()),
+	m_threadPool(static_cast<unsigned int>(std::max(0, Locator::getConfig()->get("WorkerThreads", 0)))),
+	m_modelManager(m_threadPool), m_blockTextures(), m_chunkModels(), 
+	m_streamer(m_world, m_generator, m_threadPool, m_storage.get(), loadStreamerSettings(m_threadPool.getThreadCount())),
+	m_streamChanges(), m_uploadsPerFrame(static_cast<unsigned int>(std::max(1, Locator::getConfig()->get("ChunkUploadsPerFrame", 8)))),
+	m_streamingStats(), m_lastStatsLog(utility::timestampMs()),
+	m_chunkIndex(static_cast<float>(CHUNK_INDEX_CELL_SIZE)), m_nearbyChunks(),
+	m_viewDistance(Locator::getConfig()->get("ViewDistance", 500.0f)),
+	m_frustum(), m_visibleChunkCount(0), m_lodRings(loadLodDistances()), m_log("WorldManager")
+{
+
+	// Request textures once per block type so that rendering does not need to look them up by filename.
+	// Chunks are drawn with the placeholder texture until they are loaded
+	for (BlockId id = GRASS; id < TERRAIN_TYPE_COUNT; ++id) {
+		const auto type = static_cast<TERRAIN_TYPE>(id);
+		m_blockTextures[id] = m_modelManager.requestTexture(terrainFactory::getTextureFilename(type));
+	}
 
-WorldManager::WorldManager() : m_modelManager()
+	m_log.info("WorldManager", "Streaming world with seed " + utility::toStr(m_generator.getSettings().seed)
+		+ " on " + utility::toStr(m_threadPool.getThreadCount()) + " worker threads"
+		+ (m_storage ? ", saving to " + m_storage->getDirectory() : std::string(", saving disabled")));
+}
+
+WorldManager::~WorldManager()
 {
-	terrainFactory::initializeWorld(m_objects, 20000, m_modelManager);
+	if (!m_streamer.saveAll())
+		m_log.error("~WorldManager", "Could not save " + utility::toStr(m_streamer.getStats().failedSaves) + " world columns");
 }
 
 void WorldManager::onUpdate(Player& player, IRenderer& renderer, const float deltatime)
 {
-	(void)player;
-	for (unsigned int x = 0; x < m_objects.size(); ++x) {
-		// tee joukko virtual array kokonaisuus eli joukko pienempi arrayta joita vaihdetaan lennosta
-		m_objects[x]->onUpdate(renderer, deltatime);
+	(void)deltatime;
+
+	// Streaming only polls workers, chunks that are not ready yet are picked up on later updates
+	m_streamer.update(player.transform.position, m_streamChanges);
+	applyStreamChanges();
+	m_modelManager.update();
+	uploadChunkMeshes();
+
+	// Only look at chunks within view distance and skip those completely outside of the view
+	m_nearbyChunks.clear();
+	m_chunkIndex.querySphere(player.transform.position, m_viewDistance, m_nearbyChunks);
+	m_frustum.update(renderer.vGetViewProjectionMatrix());
+	m_visibleChunkCount = 0;
+	m_lodRings.setCenter(player.transform.position);
+
+	// One draw per block type per visible chunk
+	const auto shader = renderer.vGetChunkShaderProgram();
+	for (const auto& coord : m_nearbyChunks) {
+		const auto it = m_chunkModels.find(coord);
+		if (it == m_chunkModels.end() || !m_frustum.isVisible(World::getChunkBounds(coord)))
+			continue;
+		++m_visibleChunkCount;
+
+		const int lod = m_lodRings.select(coord);
+		unsigned int vertices = 0;
+		shader->use();
+		shader->setMat4("model", glm::translate(glm::mat4(), glm::vec3(World::toWorldPos(coord))));
+		for (const auto& chunkModel : it->second[lod]) {
+			const auto& texture = m_blockTextures[chunkModel.type];
+			chunkModel.model->draw(*shader, texture != nullptr ? texture->textureId : 0);
+			vertices += chunkModel.vertexCount;
+		}
+		m_lodRings.countDrawn(lod, vertices);
+	}
+}
+
+void WorldManager::setBlock(const glm::ivec3& pos, BlockId id)
+{
+	REQUIRE(id < TERRAIN_TYPE_COUNT);
+	m_world.setBlock(pos, id);
+
+	// Blocks on chunk borders hide or reveal faces of the neighbouring chunk too
+	const auto coord = World::toChunkCoord(pos);
+	const auto local = World::toLocalPos(pos);
+	updateChunkIndex(coord);
+	m_streamer.markModified(coord);
+	m_streamer.markDirty(coord);
+	for (int d = 0; d < 3; ++d) {
+		auto neighbour = coord;
+		if (local[d] == 0)
+			--neighbour[d];
+		else if (local[d] == Chunk::SIZE - 1)
+			++neighbour[d];
+		else
+			continue;
+		m_streamer.markDirty(neighbour);
 	}
 }
 
+const World& WorldManager::getWorld() const { return m_world; }
+
+unsigned int WorldManager::getVisibleChunkCount() const { return m_visibleChunkCount; }
+
+const WorldManager::ChunkIndex& WorldManager::getChunkIndex() const { return m_chunkIndex; }
+
+const WorldManager::LodStats& WorldManager::getLodStats() const { return m_lodRings.getStats(); }
+
+WorldManager::StreamingStats WorldManager::getStreamingStats() const
+{
+	auto stats = m_streamingStats;
+	stats.pipeline = m_streamer.getStats();
+	return stats;
+}
+
+void WorldManager::applyStreamChanges()
+{
+	for (const auto& coord : m_streamChanges.loaded) { updateChunkIndex(coord); }
+	for (const auto& coord : m_streamChanges.unloaded) {
+		updateChunkIndex(coord);
+		m_chunkModels.erase(coord);
+	}
+}
+
+void WorldManager::uploadChunkMeshes()
+{
+	const auto start = std::chrono::steady_clock::now();
+	unsigned int uploads = 0;
+	ChunkStreamer::MeshResult result;
+	while (uploads < m_uploadsPerFrame && m_streamer.popMesh(result)) {
+		uploadChunkMesh(result);
+		++uploads;
+	}
+	const auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start);
+	m_streamingStats.uploadsLastFrame = uploads;
+	m_streamingStats.uploadMsLastFrame = elapsed.count();
+
+	// Log summary now and then, every frame would flood the log
+	if (utility::deltaTimeMs(m_lastStatsLog) >= 5000) {
+		m_lastStatsLog = utility::timestampMs();
+		m_log.debug("uploadChunkMeshes", [this]() {
+			const auto stats = getStreamingStats();
+			return "Streaming: " + utility::toStr(stats.pipeline.loadedColumns) + " columns loaded, "
+				+ utility::toStr(stats.pipeline.pendingColumns) + " generating, "
+				+ utility::toStr(stats.pipeline.dirtyChunks + stats.pipeline.pendingMeshes) + " meshing, "
+				+ utility::toStr(stats.pipeline.readyMeshes) + " waiting upload, "
+				+ utility::toStr(stats.pipeline.pendingSaves) + " saving, "
+				+ utility::toStr(stats.pipeline.failedSaves) + " failed saves. Latency avg "
+				+ utility::toStr(stats.averageLatencyMs) + " ms, max " + utility::toStr(stats.maxLatencyMs) + " ms";
+		});
+	}
+}
+
+void WorldManager::uploadChunkMesh(ChunkStreamer::MeshResult& result)
+{
+	if (result.meshes[0].empty()) {
+		m_chunkModels.erase(result.coord);
+		return;
+	}
+
+	LodModels lodModels;
+	for (int lod = 0; lod < chunkMesher::LOD_COUNT; ++lod) {
+		auto& chunkModels = lodModels[lod];
+		chunkModels.reserve(result.meshes[lod].size());
+		for (auto& data : result.meshes[lod]) {
+			const auto vertexCount = static_cast<unsigned int>(data.vertices.size());
+			std::vector<Mesh> meshes;
+			meshes.emplace_back(std::move(data.vertices), std::move(data.indices));
+			chunkModels.push_back(ChunkModel{ data.type, std::make_unique<Model>(std::move(meshes)), vertexCount });
+		}
+	}
+	m_chunkModels[result.coord] = std::move(lodModels);
+
+	// First upload of requested chunk is when it becomes visible
+	if (result.requestTime >= 0) {
+		auto& stats = m_streamingStats;
+		const auto latency = static_cast<float>(utility::deltaTimeMs(result.requestTime));
+		const auto samples = static_cast<float>(stats.latencySamples);
+		stats.averageLatencyMs = (stats.averageLatencyMs * samples + latency) / (samples + 1.0f);
+		stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency);
+		++stats.latencySamples;
+	}
+}
+
+void WorldManager::updateChunkIndex(const ChunkCoord& coord)
+{
+	if (m_world.getChunk(coord) != nullptr)
+		m_chunkIndex.set(coord, World::getChunkBounds(coord));
+	else
+		m_chunkIndex.remove(coord);
+}
@@ -1,29 +1,153 @@
 #pragma once
 
+#include <array>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "Object/player.h"
-#include "Object/terrain.h"
+#include "Renderer/frustum.h"
 #include "Renderer/modelmanager.h"
+#include "Utility/logger.h"
+#include "Utility/threadpool.h"
+#include "World/chunkstreamer.h"
+#include "World/lodrings.h"
+#include "World/spatialgrid.h"
+#include "World/terraingenerator.h"
+#include "World/world.h"
+#include "World/worldstorage.h"
 
 class WorldManager {
 public:
+	using ChunkIndex = SpatialGrid<ChunkCoord, ChunkCoordHash>;
+
+	// Counters of chunk streaming
+	struct StreamingStats {
+		ChunkStreamer::Stats pipeline;	//!< Counters of generation and meshing
+		unsigned int uploadsLastFrame;	//!< Chunk meshes uploaded on the last update
+		float uploadMsLastFrame;		//!< Time spent uploading meshes on the last update
+		unsigned int latencySamples;	//!< Count of chunks that have become visible after request
+		float averageLatencyMs;			//!< Average time from column request to first upload of chunk
+		float maxLatencyMs;				//!< Longest time from column request to first upload of chunk
+	};
+
+	using LodStats = LodRings::Stats; //!< Counters of chunks drawn on the last update, indexed with level of detail
 
 	/**
-	 * \brief WorldManager
+	 * \brief Constructor. Requests block textures. World is streamed in around the player on updates, from the
+	 *	save named SaveName in config where it has been saved and from the generator elsewhere
 	 */
 	WorldManager();
-	~WorldManager() = default;
 
 	/**
-	 * \brief onUpdate
-	 * \param player
-	 * \param renderer
-	 * \param deltatime
+	 * \brief Destructor. Saves loaded chunks that were edited or have not been saved yet
+	 */
+	~WorldManager();
+
+	/**
+	 * \brief Called on every frame to update and render the world. Advances chunk streaming around the player
+	 *	without waiting for it, uploads loaded assets and at most ChunkUploadsPerFrame finished chunk meshes and draws
+	 *	the chunks within view distance of the player and inside the view frustum. Level of detail of each chunk is
+	 *	selected by its distance in chunks from the player's chunk, with ring limits from LodDistances in config
+	 * \param player Player in the world
+	 * \param renderer Renderer used to draw the world
+	 * \param deltatime Time in seconds since last frame
 	 */
 	void onUpdate(Player& player, IRenderer& renderer, const float deltatime);
 
+	/**
+	 * \brief Used to change block in the world. Affected chunk meshes are rebuilt on next update
+	 * \param pos Block position in world
+	 * \param id Block id to be set
+	 * \pre id < TERRAIN_TYPE_COUNT
+	 */
+	void setBlock(const glm::ivec3& pos, BlockId id);
+
+	/**
+	 * \brief Used to access world block storage
+	 * \return Reference to world
+	 */
+	const World& getWorld() const;
+
+	/**
+	 * \brief Used to get the count of chunks drawn on the last update
+	 * \return Count of chunks that passed frustum culling
+	 */
+	unsigned int getVisibleChunkCount() const;
+
+	/**
+	 * \brief Used to access spatial index of the allocated chunks, e.g. for box, sphere and ray queries.
+	 *	Index is kept up to date when blocks are changed with setBlock
+	 * \return Reference to index with chunk bounds keyed by chunk coordinates
+	 */
+	const ChunkIndex& getChunkIndex() const;
+
+	/**
+	 * \brief Used to get counters of chunk streaming
+	 * \return Counters at the time of call
+	 */
+	StreamingStats getStreamingStats() const;
+
+	/**
+	 * \brief Used to get chunk and vertex counts drawn per level of detail ring on the last update
+	 * \return Counters of the last update
+	 */
+	const LodStats& getLodStats() const;
+
 private:
-	std::vector<std::unique_ptr<Terrain>> m_objects;	//!< Objects in 3d world
-	ModelManager m_modelManager;						//!< Used to get references to textures and models
+	// Drawable mesh of one block type inside one chunk
+	struct ChunkModel {
+		BlockId type;					//!< Block type, selects the texture
+		std::unique_ptr<Model> model;	//!< Uploaded mesh
+		unsigned int vertexCount;		//!< Vertices in mesh
+	};
+
+	// Drawable meshes of one chunk, indexed with level of detail
+	using LodModels = std::array<std::vector<ChunkModel>, chunkMesher::LOD_COUNT>;
+
+	// Texture handles indexed with block type
+	using BlockTextures = std::array<std::shared_ptr<const ModelManager::TextureHandle>, TERRAIN_TYPE_COUNT>;
+
+	World m_world;																//!< Block storage of the 3d world
+	TerrainGenerator m_generator;												//!< Generator of world terrain
+	std::unique_ptr<WorldStorage> m_storage;									//!< Saved chunks, nullptr if saving is disabled
+	ThreadPool m_threadPool;													//!< Worker threads for chunk generation and assets
+	ModelManager m_modelManager;												//!< Used to get references to textures and models
+	BlockTextures m_blockTextures;												//!< Texture of each block type, nullptr if none
+	std::unordered_map<ChunkCoord, LodModels, ChunkCoordHash> m_chunkModels;	//!< Meshes of visible chunks
+	ChunkStreamer m_streamer;													//!< Loads and meshes chunks around the player
+	ChunkStreamer::Changes m_streamChanges;										//!< Reused output of streamer update
+	unsigned int m_uploadsPerFrame;												//!< Budget of chunk mesh uploads per update
+	StreamingStats m_streamingStats;											//!< Upload and latency counters
+	int m_lastStatsLog;															//!< Timestamp of last streaming stats log
+	ChunkIndex m_chunkIndex;													//!< Spatial index of allocated chunks
+	std::vector<ChunkCoord> m_nearbyChunks;										//!< Reused result buffer of chunk queries
+	float m_viewDistance;														//!< Distance up to which chunks are drawn
+	Frustum m_frustum;															//!< View frustum of the current frame
+	unsigned int m_visibleChunkCount;											//!< Chunks drawn on the last update
+	LodRings m_lodRings;														//!< Level of detail selection around
+																				//!< the player and draw counters
+	Logger m_log;																//!< Logger
+
+	/**
+	 * \brief Used to apply chunks loaded and unloaded by streamer to models and spatial index
+	 */
+	void applyStreamChanges();
+
+	/**
+	 * \brief Used to upload finished chunk meshes within the per frame budget
+	 */
+	void uploadChunkMeshes();
+
+	/**
+	 * \brief Used to replace uploaded meshes of one chunk
+	 * \param result Finished mesh data from streamer
+	 */
+	void uploadChunkMesh(ChunkStreamer::MeshResult& result);
+
+	/**
+	 * \brief Used to add, or remove when it no longer exists, chunk in spatial index
+	 * \param coord Chunk coordinates
+	 */
+	void updateChunkIndex(const ChunkCoord& coord);
 };
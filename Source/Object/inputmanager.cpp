@@ -94,8 +94,12 @@ void InputManager::updatePosition(Player& player, IRenderer& renderer, const flo
 	if (renderer.vKeyPressed(static_cast<int>('D')))
 		m_tempPosition += player.transform.getDirectionRight() * multiplier;
 
-	// Test if tempPosition is legit
-	// TODO: actually test it
+	// Test if tempPosition is legit by sweeping player's box towards it, movement stops at solid blocks
+	const auto world = player.getWorld();
+	if (world != nullptr) {
+		const auto sweep = worldQuery::sweep(*world, player.getBounds(), m_tempPosition - player.transform.position);
+		m_tempPosition = player.transform.position + sweep.motion;
+	}
 
 	player.transform.position = std::move(m_tempPosition);
 }
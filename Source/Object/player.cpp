@@ -1,15 +1,30 @@
 #include "Object/player.h"
 
-Player::Player() : Object(), m_camera(), m_input() {}
+#include "Utility/config.h"
+#include "Utility/locator.h"
+
+namespace {
+
+	// Player box around the eye position
+	const float HALF_WIDTH = 0.3f;
+	const float EYE_HEIGHT = 1.6f;
+	const float HEAD_HEIGHT = 0.2f;
+
+} // anonymous namespace
+
+Player::Player() : Object(), m_camera(), m_input(), m_world(nullptr), m_reach(Locator::getConfig()->get("BlockReach", 8.0f)) {}
 
 Player::Player(const Transform& transform)
-	: Object(transform), m_camera(transform), m_input() {}
+	: Object(transform), m_camera(transform), m_input(), m_world(nullptr), 
+	m_reach(Locator::getConfig()->get("BlockReach", 8.0f)) {}
 
 Player & Player::operator=(Player && other) noexcept
 {
 	transform = std::move(other.transform);
 	m_camera.transform = std::move(other.m_camera.transform);
 	m_input = std::move(other.m_input);
+	m_world = other.m_world;
+	m_reach = other.m_reach;
 	return *this;
 }
 
@@ -20,5 +35,33 @@ void Player::onUpdate(IRenderer& renderer, const float deltatime)
 	// Update camera
 	m_camera.onUpdate(transform);
 	// Set the view matrix
-	renderer.vGetShaderProgram()->setMat4("view", m_camera.getViewMatrix());
+	renderer.vSetViewMatrix(m_camera.getViewMatrix());
+}
+
+void Player::setWorld(const World* world)
+{
+	m_world = world;
+}
+
+const World* Player::getWorld() const
+{
+	return m_world;
+}
+
+AABB Player::getBounds() const
+{
+	const auto& pos = transform.position;
+	return AABB{
+		glm::vec3(pos.x - HALF_WIDTH, pos.y - EYE_HEIGHT, pos.z - HALF_WIDTH),
+		glm::vec3(pos.x + HALF_WIDTH, pos.y + HEAD_HEIGHT, pos.z + HALF_WIDTH)
+	};
+}
+
+bool Player::getTargetBlock(worldQuery::RaycastHit& hit) const
+{
+	if (m_world == nullptr)
+		return false;
+	// Transform calculates its directions lazily, so a copy is asked to keep the camera untouched
+	Transform eye = m_camera.transform;
+	return worldQuery::raycast(*m_world, eye.position, eye.getDirectionForward(), m_reach, hit);
 }
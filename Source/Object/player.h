@@ -5,6 +5,8 @@
 #include "Object/camera.h"
 #include "Object/object.h"
 #include "Object/transform.h"
+#include "Utility/aabb.h"
+#include "World/worldquery.h"
 
 class Player : public Object{
 public:
@@ -33,7 +35,34 @@ public:
 	 */
 	void onUpdate(IRenderer& renderer, const float deltatime) override;
 
+	/**
+	 * \brief Used to set the world player moves in. Movement is not collision tested until world is set
+	 * \param world World used for collision and block picking, not owned by player
+	 */
+	void setWorld(const World* world);
+
+	/**
+	 * \brief Used to access the world player moves in
+	 * \return Pointer to world, nullptr if not set. Does not pass ownership
+	 */
+	const World* getWorld() const;
+
+	/**
+	 * \brief Used to get the collision box of the player. Transform position is at eye height
+	 * \return Bounding box in world coordinates
+	 */
+	AABB getBounds() const;
+
+	/**
+	 * \brief Used to find the block under the crosshair
+	 * \param hit Output, set only when a block is found
+	 * \return True if a block is within reach, otherwise false
+	 */
+	bool getTargetBlock(worldQuery::RaycastHit& hit) const;
+
 private:
 	Camera m_camera;		//!< First person camera
 	InputManager m_input;	//!< Used to manage mouse and key input
+	const World* m_world;	//!< World used for collision, nullptr if not set
+	float m_reach;			//!< Maximum distance of block picking
 };
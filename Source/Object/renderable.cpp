@@ -5,8 +5,14 @@
 #include <3rdParty/glm/gtc/matrix_transform.hpp>
 #pragma warning (pop)      // Restore back
 
-Renderable::Renderable(std::shared_ptr<Model> model, unsigned int textureId) 
-	: m_model(model), m_textureId(textureId) {}
+#include "Utility/contract.h"
+
+Renderable::Renderable(std::shared_ptr<const ModelManager::ModelHandle> model,
+	std::shared_ptr<const ModelManager::TextureHandle> texture)
+	: m_model(std::move(model)), m_texture(std::move(texture))
+{
+	REQUIRE(m_model != nullptr && m_texture != nullptr);
+}
 
 void Renderable::onUpdate(IRenderer& renderer, Transform& transform) const
 {
@@ -14,5 +20,5 @@ void Renderable::onUpdate(IRenderer& renderer, Transform& transform) const
 	trans = trans * transform.getRotationMatrix();
 	const auto shader = renderer.vGetShaderProgram();
 	shader->setMat4("model", trans);
-	m_model->draw(*shader, m_textureId);
+	m_model->model->draw(*shader, m_texture->textureId);
 }
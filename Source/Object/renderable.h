@@ -2,16 +2,19 @@
 
 #include "interfaces.h"
 #include "Object/transform.h"
+#include "Renderer/modelmanager.h"
 
 class Renderable {
 public:
 
 	/**
-	 * \brief Constructor
-	 * \param model Pointer to model object holding the vertex data
-	 * \param textureId OpenGL id for the texture
+	 * \brief Constructor. Placeholders of the handles are drawn until the model and texture are loaded
+	 * \param model Handle to model holding the vertex data
+	 * \param texture Handle to texture
+	 * \pre model != nullptr && texture != nullptr
 	 */
-	Renderable(std::shared_ptr<Model> model, unsigned int textureId);
+	Renderable(std::shared_ptr<const ModelManager::ModelHandle> model,
+		std::shared_ptr<const ModelManager::TextureHandle> texture);
 
 	~Renderable() = default;
 
@@ -23,6 +26,6 @@ public:
 	void onUpdate(IRenderer& renderer, Transform& transform) const;
 
 private:
-	std::shared_ptr<Model> m_model;	//!< Pointer to the model holding the vertex data
-	unsigned int m_textureId;		//!< OpenGL texture id
+	std::shared_ptr<const ModelManager::ModelHandle> m_model;		//!< Handle to the model holding the vertex data
+	std::shared_ptr<const ModelManager::TextureHandle> m_texture;	//!< Handle to the texture
 };
@@ -1,10 +1,12 @@
 #include "terrain.h"
 
-Terrain::Terrain(std::shared_ptr<Model> model, unsigned int textureId) 
-	: Object(), m_renderable(model, textureId) {}
+Terrain::Terrain(std::shared_ptr<const ModelManager::ModelHandle> model,
+	std::shared_ptr<const ModelManager::TextureHandle> texture)
+	: Object(), m_renderable(std::move(model), std::move(texture)) {}
 
-Terrain::Terrain(std::shared_ptr<Model> model, unsigned int textureId, const Transform& transform)
-	: Object(transform), m_renderable(model, textureId) {}
+Terrain::Terrain(std::shared_ptr<const ModelManager::ModelHandle> model,
+	std::shared_ptr<const ModelManager::TextureHandle> texture, const Transform& transform)
+	: Object(transform), m_renderable(std::move(model), std::move(texture)) {}
 
 void Terrain::onUpdate(IRenderer& renderer, const float deltatime)
 {
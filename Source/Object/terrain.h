@@ -8,19 +8,20 @@ public:
 
 	/**
 	 * \brief Constructor with default starting transform
-	 * \param model
-	 * \param textureId
+	 * \param model Handle to model
+	 * \param texture Handle to texture
 	 */
-	Terrain(std::shared_ptr<Model> model, unsigned int textureId);
+	Terrain(std::shared_ptr<const ModelManager::ModelHandle> model,
+		std::shared_ptr<const ModelManager::TextureHandle> texture);
 
 	/**
 	 * \brief Constructor with custom starting transform
-	 * \param model
-	 * \param textureId
+	 * \param model Handle to model
+	 * \param texture Handle to texture
 	 * \param transform
 	 */
-	Terrain(std::shared_ptr<Model> model, unsigned int textureId,
-		const Transform& transform);
+	Terrain(std::shared_ptr<const ModelManager::ModelHandle> model,
+		std::shared_ptr<const ModelManager::TextureHandle> texture, const Transform& transform);
 
 	~Terrain() = default;
 
@@ -1,11 +1,176 @@
 #include "Renderer/bmp.h"
 
+#include <atomic>
 #include <fstream>
+#include <limits>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define BMP_X86
+#include <tmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BMP_TARGET(isa)
+#else
+#define BMP_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
 
 #include "Renderer/fileloader.h"
 #include "Utility/contract.h"
 #include "Utility/utility.h"
 
+namespace {
+
+	// Function decoding one row of BGR pixels
+	using RowDecoder = void(*)(const uint8_t* source, uint8_t* destination, int width);
+
+	// Row decoders picked for the processor
+	struct RowDecoders {
+		RowDecoder rgb;		//!< Writes 3 bytes per pixel
+		RowDecoder rgba;	//!< Writes 4 bytes per pixel, alpha is opaque
+	};
+
+	/**
+	 * \brief Used to get size of a row in file, rows are padded to multiple of 4 bytes
+	 * \param width Image width in pixels
+	 * \return Count of bytes in one row including padding
+	 */
+	std::size_t rowBytes(int width)
+	{
+		return (static_cast<std::size_t>(width) * 3 + 3) & ~static_cast<std::size_t>(3);
+	}
+
+	/**
+	 * \brief Used to get size of a decoded row without padding
+	 * \param width Image width in pixels
+	 * \param channels Bytes per pixel
+	 * \return Count of bytes in one decoded row
+	 */
+	std::size_t rowPixels(int width, int channels)
+	{
+		return static_cast<std::size_t>(width) * static_cast<std::size_t>(channels);
+	}
+
+	/**
+	 * \brief Used to decode pixels of a row from BGR to RGB one at a time
+	 * \param source First BGR pixel
+	 * \param destination First RGB pixel
+	 * \param width Count of pixels
+	 */
+	void decodeRgb(const uint8_t* source, uint8_t* destination, int width)
+	{
+		for (int x = 0; x < width; ++x, source += 3, destination += 3) {
+			destination[0] = source[2];
+			destination[1] = source[1];
+			destination[2] = source[0];
+		}
+	}
+
+	/**
+	 * \brief Used to decode pixels of a row from BGR to RGBA one at a time
+	 * \param source First BGR pixel
+	 * \param destination First RGBA pixel
+	 * \param width Count of pixels
+	 */
+	void decodeRgba(const uint8_t* source, uint8_t* destination, int width)
+	{
+		for (int x = 0; x < width; ++x, source += 3, destination += 4) {
+			destination[0] = source[2];
+			destination[1] = source[1];
+			destination[2] = source[0];
+			destination[3] = 255;
+		}
+	}
+
+#ifdef BMP_X86
+
+	/**
+	 * \brief Used to decode row from BGR to RGB four pixels per step. Every step loads and stores 16 bytes of
+	 *	which 12 are used, the 4 extra bytes are overwritten by the next step or by the scalar tail
+	 * \param source First BGR pixel
+	 * \param destination First RGB pixel
+	 * \param width Count of pixels
+	 */
+	BMP_TARGET("ssse3")
+	void decodeRgbSsse3(const uint8_t* source, uint8_t* destination, int width)
+	{
+		const __m128i order = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15);
+		int x = 0;
+		// 16 bytes from pixel x stay within the row while 6 pixels are left
+		for (; x + 6 <= width; x += 4) {
+			const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x * 3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + x * 3), _mm_shuffle_epi8(pixels, order));
+		}
+		decodeRgb(source + x * 3, destination + x * 3, width - x);
+	}
+
+	/**
+	 * \brief Used to decode row from BGR to RGBA four pixels per step
+	 * \param source First BGR pixel
+	 * \param destination First RGBA pixel
+	 * \param width Count of pixels
+	 */
+	BMP_TARGET("ssse3")
+	void decodeRgbaSsse3(const uint8_t* source, uint8_t* destination, int width)
+	{
+		const __m128i order = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+		const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+		int x = 0;
+		for (; x + 6 <= width; x += 4) {
+			const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x * 3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + x * 4),
+				_mm_or_si128(_mm_shuffle_epi8(pixels, order), alpha));
+		}
+		decodeRgba(source + x * 3, destination + x * 4, width - x);
+	}
+
+	/**
+	 * \brief Used to test if processor supports SSSE3
+	 * \return True if SSSE3 can be used, otherwise false
+	 */
+	bool hasSsse3()
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 1);
+		return (info[2] & (1 << 9)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("ssse3") != 0;
+#endif
+	}
+
+#endif
+
+	/**
+	 * \brief Used to get flag telling if rows are decoded with SSSE3, set from processor support on first call
+	 * \return Flag, true when SSSE3 is used
+	 */
+	std::atomic<bool>& ssse3Enabled()
+	{
+#ifdef BMP_X86
+		static std::atomic<bool> enabled(hasSsse3());
+#else
+		static std::atomic<bool> enabled(false);
+#endif
+		return enabled;
+	}
+
+	/**
+	 * \brief Used to get the row decoders picked for the processor. Thread safe
+	 * \return Row decoders
+	 */
+	RowDecoders rowDecoders()
+	{
+#ifdef BMP_X86
+		if (ssse3Enabled())
+			return RowDecoders{ decodeRgbSsse3, decodeRgbaSsse3 };
+#endif
+		return RowDecoders{ decodeRgb, decodeRgba };
+	}
+
+} // anonymous namespace
+
 BMP::BMP(StaticSafeLogger& log) : m_fileheader(nullptr), m_infoheader(nullptr), m_data(nullptr), m_log(&log) {}
 
 BMP::~BMP() {}
@@ -28,17 +193,11 @@ bool BMP::vLoadFile(std::ifstream& stream)
 		return false;
 	}
 
-	// Allocate byte memory that will hold the two headers
-	auto header = std::make_unique<uint8_t[]>(sizeof(BITMAPFILEHEADER));
-	auto info = std::make_unique<uint8_t[]>(sizeof(BITMAPINFOHEADER));
-
-	// Read file into header buffers
-	stream.read(reinterpret_cast<char*>(header.get()), sizeof(BITMAPFILEHEADER));
-	stream.read(reinterpret_cast<char*>(info.get()), sizeof(BITMAPINFOHEADER));
-
-	// Construct headers
-	m_fileheader = std::unique_ptr<BITMAPFILEHEADER>(reinterpret_cast<BITMAPFILEHEADER*>(header.release()));
-	m_infoheader = std::unique_ptr<BITMAPINFOHEADER>(reinterpret_cast<BITMAPINFOHEADER*>(info.release()));
+	// Read file into headers
+	m_fileheader = std::make_unique<BITMAPFILEHEADER>();
+	m_infoheader = std::make_unique<BITMAPINFOHEADER>();
+	stream.read(reinterpret_cast<char*>(m_fileheader.get()), sizeof(BITMAPFILEHEADER));
+	stream.read(reinterpret_cast<char*>(m_infoheader.get()), sizeof(BITMAPINFOHEADER));
 
 	// Check if the file is a BMP file
 	if (m_fileheader->bfType != BF_TYPE_MB) {
@@ -56,6 +215,15 @@ bool BMP::vLoadFile(std::ifstream& stream)
 		return false;
 	}
 
+	// Top down images with negative height are not supported
+	if (m_infoheader->biWidth <= 0 || m_infoheader->biHeight <= 0) {
+		m_log->error("vLoadFile", "Cannot read file, because image size is " + utility::toStr(m_infoheader->biWidth)
+			+ "x" + utility::toStr(m_infoheader->biHeight));
+		m_fileheader = nullptr;
+		m_infoheader = nullptr;
+		return false;
+	}
+
 	// Check if the header shows the size of the image
 	// If the size in header is zero, use calculated value based on offset to data and file size
 	unsigned int imageSize = m_infoheader->biSizeImage;
@@ -65,14 +233,44 @@ bool BMP::vLoadFile(std::ifstream& stream)
 		m_infoheader->biSizeImage = imageSize;
 	}
 
+	// Decoded rows of 4 bytes per pixel have to fit the int stride of vDecodeTo
+	if (m_infoheader->biWidth > std::numeric_limits<int>::max() / 4) {
+		m_log->error("vLoadFile", "Cannot read file, because image width is " + utility::toStr(m_infoheader->biWidth));
+		m_fileheader = nullptr;
+		m_infoheader = nullptr;
+		return false;
+	}
+
+	// Decoding reads every padded row, so they all have to be in the file. The file size check comes first so
+	// that the product of row size and height cannot overflow
+	const std::size_t rowSize = rowBytes(m_infoheader->biWidth);
+	const auto fileSize = static_cast<std::size_t>(static_cast<std::streamoff>(size));
+	const std::size_t dataSize = m_fileheader->bfOffBits > fileSize ? 0 : fileSize - m_fileheader->bfOffBits;
+	const auto height = static_cast<std::size_t>(m_infoheader->biHeight);
+	const std::size_t pixelSize = height > dataSize / rowSize ? 0 : rowSize * height;
+	if (pixelSize == 0 || imageSize < pixelSize) {
+		m_log->error("vLoadFile", "Cannot read file, because it is smaller than its " + utility::toStr(m_infoheader->biWidth)
+			+ "x" + utility::toStr(m_infoheader->biHeight) + " pixels");
+		m_fileheader = nullptr;
+		m_infoheader = nullptr;
+		return false;
+	}
+
 	// Allocate pixel memory
-	m_data = std::make_unique<uint8_t[]>(imageSize);
+	m_data = std::make_unique<uint8_t[]>(pixelSize);
 
 	// Go to where image data starts
 	stream.seekg(m_fileheader->bfOffBits);
 
 	// Read image data
-	stream.read(reinterpret_cast<char*>(m_data.get()), imageSize);
+	stream.read(reinterpret_cast<char*>(m_data.get()), pixelSize);
+	if (!stream) {
+		m_log->error("vLoadFile", "Could not read image data");
+		m_fileheader = nullptr;
+		m_infoheader = nullptr;
+		m_data = nullptr;
+		return false;
+	}
 
 	ENSURE(m_fileheader != nullptr);
 	ENSURE(m_infoheader != nullptr);
@@ -93,26 +291,53 @@ std::unique_ptr<uint8_t[]> BMP::vDecode()
 		return nullptr;
 	}
 
-	// Allocate memory for copy of data
-	const unsigned int width = m_infoheader->biWidth;
-	const unsigned int height = m_infoheader->biHeight;
-	const unsigned int imageSize = width * height * 3;
+	// vLoadFile checked that the pixels are in the file, so the decoded size does not overflow
+	const std::size_t stride = static_cast<std::size_t>(m_infoheader->biWidth) * 3;
+	auto decode = std::make_unique<uint8_t[]>(stride * static_cast<std::size_t>(m_infoheader->biHeight));
+	if (!vDecodeTo(decode.get(), static_cast<int>(stride), 3))
+		return nullptr;
+	return decode;
+}
 
-	auto decode = std::make_unique<uint8_t[]>(imageSize); // Create pointer to copied data
-	unsigned int pad = 4 - m_infoheader->biWidth % 4; // Padding bytes count
-	if (pad == 4) pad = 0;
+bool BMP::vDecodeTo(uint8_t* destination, int stride, int channels)
+{
+	REQUIRE(m_fileheader != nullptr);
+	REQUIRE(m_infoheader != nullptr);
+	REQUIRE(m_data != nullptr);
+	REQUIRE(destination != nullptr);
+	REQUIRE(channels == 3 || channels == 4);
+	REQUIRE(stride >= 0);
+	REQUIRE(m_infoheader == nullptr || static_cast<std::size_t>(stride) >= rowPixels(m_infoheader->biWidth, channels));
 
-	// Copy data
-	for (unsigned int i = 0, row = 0, w = width * 3; row < height; ++row) {
-		for (unsigned int j = 0; j < w; j += 3 , i += 3) {
-			// 3 bytes per pixel
-			// Change BGR format to RGB and ignore padding
-			decode[i] = std::move(m_data[i + 2 + row * pad]);
-			decode[i + 1] = std::move(m_data[i + 1 + row * pad]);
-			decode[i + 2] = std::move(m_data[i + row * pad]);
-		}
+	if (m_fileheader == nullptr || m_infoheader == nullptr || m_data == nullptr) {
+		m_log->error("vDecodeTo", "BMP not properly initialized before calling decode");
+		return false;
 	}
-	return std::move(decode);
+	if (destination == nullptr || (channels != 3 && channels != 4) || stride < 0
+		|| static_cast<std::size_t>(stride) < rowPixels(m_infoheader->biWidth, channels)) {
+		m_log->error("vDecodeTo", "Cannot decode to buffer with " + utility::toStr(channels) + " channels and stride "
+			+ utility::toStr(stride));
+		return false;
+	}
+
+	const int width = m_infoheader->biWidth;
+	const int height = m_infoheader->biHeight;
+	const std::size_t rowSize = rowBytes(width);
+	const RowDecoder decodeRow = channels == 4 ? rowDecoders().rgba : rowDecoders().rgb;
+
+	// Rows stay in file order, bottom row first like OpenGL expects
+	const uint8_t* source = m_data.get();
+	for (int row = 0; row < height; ++row, source += rowSize, destination += stride)
+		decodeRow(source, destination, width);
+	return true;
+}
+
+bool BMP::setSsse3(bool enabled)
+{
+#ifdef BMP_X86
+	ssse3Enabled() = enabled && hasSsse3();
+#endif
+	return ssse3Enabled();
 }
 
 int BMP::vGetHeight() const
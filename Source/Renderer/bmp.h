@@ -36,7 +36,9 @@ struct BITMAPINFOHEADER {			 /* BMP file info structure */
 	unsigned int   biClrImportant;   //!< Number of important colors
 };
 
-// Class used to load BMP files and decode them to RGB byte array
+// Class used to load BMP files and decode them to RGB or RGBA byte array
+//
+// Rows are decoded four pixels at a time with SSSE3 when the processor supports it, otherwise one pixel at a time
 class BMP : public IImageType {
 public:
 
@@ -71,6 +73,29 @@ public:
 	 */
 	std::unique_ptr<uint8_t[]> vDecode() override;
 
+	/**
+	 * \brief Decode image straight into caller's buffer. Rows are written bottom row first like in the file
+	 * \param destination Buffer of at least stride * height bytes
+	 * \param stride Count of bytes from start of one row to start of the next, bytes between rows are not written
+	 * \param channels 3 to write RGB, 4 to write RGBA with opaque alpha
+	 * \pre m_fileheader != nullptr
+	 * \pre m_infoheader != nullptr
+	 * \pre m_data != nullptr
+	 * \pre destination != nullptr
+	 * \pre channels == 3 || channels == 4
+	 * \pre stride >= width * channels
+	 * \return true if successful, otherwise false and destination is not changed
+	 */
+	bool vDecodeTo(uint8_t* destination, int stride, int channels) override;
+
+	/**
+	 * \brief Used to turn SSSE3 row decoding on or off for all BMP objects, e.g. to compare it with one pixel at a
+	 *	time decoding. SSSE3 is on by default when the processor supports it
+	 * \param enabled True to use SSSE3 if the processor supports it, false to decode one pixel at a time
+	 * \return True if SSSE3 is used after the call, otherwise false
+	 */
+	static bool setSsse3(bool enabled);
+
 	/**
 	 * \brief Get image height in pixels
 	 * \pre m_infoheader != nullptr
@@ -88,6 +113,6 @@ public:
 private:
 	std::unique_ptr<BITMAPFILEHEADER> m_fileheader; //!< Pointer to file header object
 	std::unique_ptr<BITMAPINFOHEADER> m_infoheader; //!< Pointer to info header object
-	std::unique_ptr<uint8_t[]> m_data;				//!< Pointer to image payload BGR byte array
+	std::unique_ptr<uint8_t[]> m_data;				//!< Pointer to image payload BGR byte array, rows padded to 4 bytes
 	StaticSafeLogger* m_log;						//!< Pointer to fileloader logging, is not managed here
 };
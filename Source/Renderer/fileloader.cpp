@@ -2,16 +2,21 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
-#include <sstream>
+#include <limits>
 
 #pragma warning (push, 2)  // Temporarily set warning level 2
 #include <3rdParty/glm/glm.hpp>
 #pragma warning (pop)      // Restore back
 
 #include "Renderer/bmp.h"
+#include "Renderer/meshcache.h"
 #include "Utility/contract.h"
 #include "Utility/locator.h"
+#include "Utility/mappedfile.h"
 #include "Utility/staticsafelogger.h"
 #include "Utility/utility.h"
 
@@ -85,6 +90,515 @@ namespace fileloader {
 		}
 
 
+
+		/**
+		* \brief Used to skip spaces, tabs and carriage returns
+		* \param p Position in buffer
+		* \param end End of buffer
+		* \return First position that is not blank, end if none
+		*/
+		const char* skipBlanks(const char* p, const char* end)
+		{
+			while (p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+				++p;
+			return p;
+		}
+
+		/**
+		* \brief Used to test if the rest of row has no data
+		* \param p Position in buffer, after blanks
+		* \param end End of buffer
+		* \return True if row ends or a comment starts at p, otherwise false
+		*/
+		bool isRowEnd(const char* p, const char* end)
+		{
+			return p == end || *p == '\n' || *p == '#';
+		}
+
+		/**
+		* \brief Used to find the start of next line
+		* \param p Position in buffer
+		* \param end End of buffer
+		* \return Position after next line feed, end if none
+		*/
+		const char* nextLine(const char* p, const char* end)
+		{
+			const void* lineFeed = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+			return lineFeed == nullptr ? end : static_cast<const char*>(lineFeed) + 1;
+		}
+
+		/**
+		* \brief Used to parse integer like std::from_chars, i.e. without locale, allocation or skipping blanks
+		* \param p Position of number in buffer
+		* \param end End of buffer
+		* \param value Output, set only if a number was parsed
+		* \return Position after number, nullptr if there was no number
+		*/
+		const char* parseInt(const char* p, const char* end, long long& value)
+		{
+			const bool negative = p != end && *p == '-';
+			if (negative || (p != end && *p == '+'))
+				++p;
+
+			const char* digits = p;
+			long long result = 0;
+			while (p != end && *p >= '0' && *p <= '9' && result < 100000000000000000LL)
+				result = result * 10 + (*p++ - '0');
+			if (p == digits)
+				return nullptr;
+
+			value = negative ? -result : result;
+			return p;
+		}
+
+		/**
+		* \brief Used to test if buffer continues with word, ignoring case
+		* \param p Position in buffer
+		* \param end End of buffer
+		* \param word Lower case word
+		* \return True if word starts at p, otherwise false
+		*/
+		bool startsWithWord(const char* p, const char* end, const char* word)
+		{
+			for (; *word != '\0'; ++p, ++word) {
+				if (p == end || std::tolower(static_cast<unsigned char>(*p)) != *word)
+					return false;
+			}
+			return true;
+		}
+
+		/**
+		* \brief Used to parse floating point number like std::from_chars, i.e. without locale, allocation or
+		*	skipping blanks. Numbers with at most 15 significant digits and small exponents, i.e. every number
+		*	exporters write, are converted exactly with one multiplication or division. Longer mantissas and larger
+		*	exponents are scaled in double, whose rounding error is far below float precision
+		* \param p Position of number in buffer
+		* \param end End of buffer
+		* \param value Output, set only if a number was parsed
+		* \return Position after number, nullptr if there was no number
+		*/
+		const char* parseFloat(const char* p, const char* end, float& value)
+		{
+			// Exact powers of ten in double
+			static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+			const bool negative = p != end && *p == '-';
+			if (negative || (p != end && *p == '+'))
+				++p;
+
+			long long mantissa = 0;
+			int digits = 0;
+			int exponent = 0;
+			bool any = false;
+			for (; p != end && *p >= '0' && *p <= '9'; ++p, any = true) {
+				if (digits == 0 && *p == '0')
+					continue; // Leading zeros are not significant
+				if (digits < 18) {
+					mantissa = mantissa * 10 + (*p - '0');
+					++digits;
+				}
+				else {
+					++exponent;
+				}
+			}
+			if (p != end && *p == '.') {
+				for (++p; p != end && *p >= '0' && *p <= '9'; ++p, any = true) {
+					if (digits == 0 && *p == '0') {
+						--exponent;
+						continue;
+					}
+					if (digits < 18) {
+						mantissa = mantissa * 10 + (*p - '0');
+						++digits;
+						--exponent;
+					}
+				}
+			}
+			if (!any) {
+				// Infinity and not a number, as written by printf
+				const bool infinity = startsWithWord(p, end, "inf");
+				if (!infinity && !startsWithWord(p, end, "nan"))
+					return nullptr;
+				const float special = infinity ? std::numeric_limits<float>::infinity()
+					: std::numeric_limits<float>::quiet_NaN();
+				value = negative ? -special : special;
+				return p + (startsWithWord(p, end, "infinity") ? 8 : 3);
+			}
+			if (p != end && (*p == 'e' || *p == 'E')) {
+				long long written = 0;
+				const char* after = parseInt(p + 1, end, written);
+				if (after != nullptr) {
+					exponent += static_cast<int>(std::max(-1000LL, std::min(1000LL, written)));
+					p = after;
+				}
+			}
+
+			double result = static_cast<double>(mantissa);
+			if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+				result = exponent < 0 ? result / powers[-exponent] : result * powers[exponent];
+			}
+			else if (mantissa != 0) {
+				// Mantissa is below 1e18, so results out of float range stay out of it in double
+				result *= std::pow(10.0, exponent);
+			}
+			value = static_cast<float>(negative ? -result : result);
+			return p;
+		}
+
+		/**
+		* \brief Used to parse floats separated by blanks
+		* \param p Position in buffer
+		* \param end End of buffer
+		* \param values Output, count floats
+		* \param count Count of floats to parse
+		* \return Position after last float, nullptr if a float was missing
+		*/
+		const char* parseFloats(const char* p, const char* end, float* values, int count)
+		{
+			for (int i = 0; i < count && p != nullptr; ++i)
+				p = parseFloat(skipBlanks(p, end), end, values[i]);
+			return p;
+		}
+
+		const unsigned int NONE = 0xFFFFFFFF;	//!< Index of uv or normal that face corner does not give
+
+		// Indices of position, uv and normal of one face corner, counting from 0
+		struct Corner {
+			unsigned int position;
+			unsigned int uv;
+			unsigned int normal;
+		};
+
+		// Hash table from corners to vertex indices, so that each unique corner becomes one vertex
+		//
+		// Open addressing with linear probing over a power of two table, sized by reset for the count of corners
+		// so it never grows. Corners of a mesh are mostly unique up to sharing between adjacent faces, so the
+		// table stays at most half full
+		class VertexCache {
+		public:
+			VertexCache() : m_mask(0), m_slots() {}
+
+			/**
+			* \brief Used to empty the table and size it for corners, memory of earlier sizes is reused
+			* \param corners Count of corners that will be inserted
+			*/
+			void reset(std::size_t corners)
+			{
+				std::size_t size = 16;
+				while (size < corners * 2)
+					size *= 2;
+				m_mask = size - 1;
+				m_slots.assign(size, Slot{ Corner{ 0, 0, 0 }, EMPTY });
+			}
+
+			/**
+			* \brief Used to find vertex of corner, adding it if it is new
+			* \param corner Corner of a face
+			* \param next Vertex index given to the corner if it is new
+			* \return Vertex index of corner, equal to next if the corner was added
+			*/
+			unsigned int insert(const Corner& corner, unsigned int next)
+			{
+				std::size_t i = hash(corner) & m_mask;
+				for (;; i = (i + 1) & m_mask) {
+					Slot& slot = m_slots[i];
+					if (slot.vertex == EMPTY) {
+						slot.corner = corner;
+						slot.vertex = next;
+						return next;
+					}
+					if (slot.corner.position == corner.position && slot.corner.uv == corner.uv
+						&& slot.corner.normal == corner.normal)
+						return slot.vertex;
+				}
+			}
+
+		private:
+			static const unsigned int EMPTY = 0xFFFFFFFF;	//!< Vertex of a free slot
+
+			// Corner and its vertex
+			struct Slot {
+				Corner corner;
+				unsigned int vertex;
+			};
+
+			std::size_t m_mask;			//!< Table size minus one
+			std::vector<Slot> m_slots;	//!< Table
+
+			static std::size_t hash(const Corner& corner)
+			{
+				uint64_t h = corner.position * 0x9E3779B97F4A7C15ull;
+				h ^= (corner.uv + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2));
+				h ^= (corner.normal * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2));
+				return static_cast<std::size_t>(h ^ (h >> 29));
+			}
+		};
+
+		/**
+		* \brief Used to parse one index of a face corner and check that it refers to read data
+		* \param p Position of index in buffer
+		* \param end End of buffer
+		* \param count Count of elements read so far
+		* \param index Output, index counting from 0
+		* \return Position after index, nullptr if index is not valid
+		*/
+		const char* parseIndex(const char* p, const char* end, unsigned int count, unsigned int& index)
+		{
+			long long value = 0;
+			p = parseInt(p, end, value);
+			// Indices in .obj start from 1, negative indices count back from the last element read
+			if (p == nullptr || value == 0 || value > count || -value > count)
+				return nullptr;
+			index = static_cast<unsigned int>(value > 0 ? value - 1 : count + value);
+			return p;
+		}
+
+		/**
+		* \brief Used to parse face corner v, v/vt, v//vn or v/vt/vn
+		* \param p Position of corner in buffer
+		* \param end End of buffer
+		* \param counts Counts of positions, uvs and normals read so far
+		* \param corner Output, indices counting from 0, NONE for uv and normal that are not given
+		* \return Position after corner, nullptr if corner is not valid
+		*/
+		const char* parseCorner(const char* p, const char* end, const Corner& counts, Corner& corner)
+		{
+			corner = Corner{ 0, NONE, NONE };
+			p = parseIndex(p, end, counts.position, corner.position);
+			if (p == nullptr || p == end || *p != '/')
+				return p;
+
+			if (++p != end && *p != '/') {
+				p = parseIndex(p, end, counts.uv, corner.uv);
+				if (p == nullptr || p == end || *p != '/')
+					return p;
+			}
+			else if (p == end) {
+				return nullptr;
+			}
+			return parseIndex(p + 1, end, counts.normal, corner.normal);
+		}
+
+		/**
+		* \brief Tests if line starts with keyword followed by a blank
+		* \param line Start of line in buffer
+		* \param end End of buffer
+		* \param keyword Keyword
+		* \return True if line starts with keyword, otherwise false
+		*/
+		bool isKeyword(const char* line, const char* end, const char* keyword)
+		{
+			const std::size_t length = std::strlen(keyword);
+			return static_cast<std::size_t>(end - line) > length && std::memcmp(line, keyword, length) == 0
+				&& (line[length] == ' ' || line[length] == '\t');
+		}
+
+		/**
+		* \brief Used to compute smooth normals for positions from the faces that use them, area weighted
+		* \param positions Positions of the model
+		* \param corners Corners of the model, three per triangle
+		* \return Normal per position, zero vector for positions that are in no face
+		*/
+		std::vector<glm::vec3> computeNormals(const std::vector<glm::vec3>& positions, const std::vector<Corner>& corners)
+		{
+			std::vector<glm::vec3> normals(positions.size(), glm::vec3(0.0f));
+			for (std::size_t i = 0; i + 2 < corners.size(); i += 3) {
+				const glm::vec3& a = positions[corners[i].position];
+				const glm::vec3 normal = glm::cross(positions[corners[i + 1].position] - a, positions[corners[i + 2].position] - a);
+				for (std::size_t j = i; j < i + 3; ++j)
+					normals[corners[j].position] += normal;
+			}
+			for (glm::vec3& normal : normals) {
+				const float length = glm::length(normal);
+				if (length > 0.0f)
+					normal /= length;
+			}
+			return normals;
+		}
+
+		/**
+		* \brief Used to create mesh data from corners of one section of the file
+		* \param first First corner of the section
+		* \param last One past the last corner of the section
+		* \param positions Positions of the model
+		* \param uvs Texture coordinates of the model
+		* \param normals Normals of the model
+		* \param smoothNormals Normals computed per position, used for corners without a normal
+		* \param cache Vertex cache, reset for the section
+		* \return Vertices and indices of the mesh
+		*/
+		MeshData createMeshData(const Corner* first, const Corner* last, const std::vector<glm::vec3>& positions,
+			const std::vector<glm::vec2>& uvs, const std::vector<glm::vec3>& normals,
+			const std::vector<glm::vec3>& smoothNormals, VertexCache& cache)
+		{
+			// Process the three indexes into one, each unique corner becomes one vertex
+			MeshData mesh;
+			std::vector<Vertex>& vertices = mesh.vertices;
+			std::vector<unsigned int>& indices = mesh.wideIndices;
+			indices.reserve(static_cast<std::size_t>(last - first));
+			cache.reset(static_cast<std::size_t>(last - first));
+			for (const Corner* corner = first; corner != last; ++corner) {
+				const auto next = static_cast<unsigned int>(vertices.size());
+				const unsigned int index = cache.insert(*corner, next);
+				if (index == next) {
+					vertices.push_back(Vertex{ positions[corner->position],
+						corner->normal == NONE ? smoothNormals[corner->position] : normals[corner->normal],
+						corner->uv == NONE ? glm::vec2(0.0f) : uvs[corner->uv] });
+				}
+				indices.push_back(index); // OpenGL wants indices to start from 0
+			}
+
+			// 16-bit indices are used whenever they can address every vertex
+			if (vertices.size() <= std::numeric_limits<unsigned short>::max() + 1u) {
+				mesh.indices.resize(indices.size());
+				std::transform(indices.begin(), indices.end(), mesh.indices.begin(),
+					[](unsigned int index) { return static_cast<unsigned short>(index); });
+				indices = std::vector<unsigned int>();
+			}
+			return mesh;
+		}
+
+		/**
+		* \brief Used to map model file and compute its checksum
+		* \param file Filename of model
+		* \param source Output, mapped model file
+		* \param cachePath Output, path of the cache file of the model
+		* \param checksum Output, checksum of model file contents
+		* \return True if file was mapped and is not too big, otherwise false
+		*/
+		bool openModel(const std::string& file, MappedFile& source, std::string& cachePath, uint64_t& checksum)
+		{
+			// Map the file, only the checksum needs its contents when the cache is up to date
+			const std::string dataPath = Locator::getConfig()->get("DataPath", std::string("../Data/"));
+			if (!source.open(dataPath + "Models/" + file)) {
+				g_log.error("loadModel", "Could not load file: " + file);
+				return false;
+			}
+			if (source.getSize() > static_cast<std::size_t>(Locator::getConfig()->get("MaxByteFileSizeToLoad", 5120000))) {
+				g_log.error("loadModel", "File is too big: " + utility::toStr(source.getSize()) + " bytes");
+				return false;
+			}
+
+			// Parsed meshes are cached until the source file changes
+			cachePath = dataPath + "Cache/Models/" + file + ".mesh";
+			checksum = meshCache::checksum(source.getData(), source.getSize());
+			return true;
+		}
+
+		/**
+		* \brief Used to parse model file to mesh data and write it to the cache file
+		* \param file Filename of model
+		* \param source Mapped model file
+		* \param cachePath Path of the cache file of the model
+		* \param checksum Checksum of model file contents
+		* \param meshData Output, one mesh per object, group or material
+		* \return True if file was parsed, otherwise false
+		*/
+		bool parseModel(const std::string& file, const MappedFile& source, const std::string& cachePath, uint64_t checksum,
+			std::vector<MeshData>& meshData)
+		{
+			// Create temp vectors to read contents from file
+			std::vector<glm::vec3> tempVertices;
+			std::vector<glm::vec2> tempUVs;
+			std::vector<glm::vec3> tempNormals;
+			std::vector<Corner> corners;		// Three per triangle
+			std::vector<Corner> face;			// Corners of the face being read, reused for every face
+			std::vector<std::size_t> sections{ 0 };	// First corner of each object, group and material
+			bool normalsMissing = false;
+
+			// Loop through file, parsed straight from the mapping
+			const char* p = reinterpret_cast<const char*>(source.getData());
+			const char* const end = p + source.getSize();
+			for (int row = 1; p != end; ++row) {
+				const char* line = skipBlanks(p, end);
+				p = nextLine(line, end);
+				const char* parsed = line;
+
+				if (end - line < 2 || line[0] == '#' || line[0] == '\n') {
+					continue; // Row is empty or a comment
+				}
+				else if (line[0] == 'v' && line[1] == 't') { // uv data, v is optional
+					float v[2] = { 0.0f, 0.0f };
+					parsed = parseFloats(line + 2, end, v, 1);
+					if (parsed != nullptr && !isRowEnd(skipBlanks(parsed, end), end))
+						parsed = parseFloats(parsed, end, v + 1, 1);
+					tempUVs.emplace_back(v[0], v[1]);
+				}
+				else if (line[0] == 'v' && line[1] == 'n') { // normal data
+					float v[3];
+					parsed = parseFloats(line + 2, end, v, 3);
+					tempNormals.emplace_back(v[0], v[1], v[2]);
+				}
+				else if (line[0] == 'v' && (line[1] == ' ' || line[1] == '\t')) { // vertice data
+					float v[3];
+					parsed = parseFloats(line + 1, end, v, 3);
+					tempVertices.emplace_back(v[0], v[1], v[2]);
+				}
+				else if (line[0] == 'f' && (line[1] == ' ' || line[1] == '\t')) { // face data
+					const Corner counts{ static_cast<unsigned int>(tempVertices.size()),
+						static_cast<unsigned int>(tempUVs.size()), static_cast<unsigned int>(tempNormals.size()) };
+					face.clear();
+					parsed = skipBlanks(line + 1, end);
+					while (parsed != nullptr && !isRowEnd(parsed, end)) {
+						Corner corner;
+						parsed = parseCorner(parsed, end, counts, corner);
+						if (parsed != nullptr) {
+							face.emplace_back(corner);
+							parsed = skipBlanks(parsed, end);
+						}
+					}
+					if (face.size() < 3)
+						parsed = nullptr;
+
+					// Quads and other polygons are split into a fan of triangles around the first corner
+					for (std::size_t i = 1; parsed != nullptr && i + 1 < face.size(); ++i) {
+						corners.emplace_back(face[0]);
+						corners.emplace_back(face[i]);
+						corners.emplace_back(face[i + 1]);
+					}
+					for (const Corner& corner : face)
+						normalsMissing = normalsMissing || corner.normal == NONE;
+				}
+				else if (isKeyword(line, end, "o") || isKeyword(line, end, "g") || isKeyword(line, end, "usemtl")) {
+					// New object, group or material starts a new mesh, unless the current one has no faces yet
+					if (sections.back() != corners.size())
+						sections.push_back(corners.size());
+				}
+
+				if (parsed == nullptr) {
+					g_log.error("loadModel", "Bad row {} in file {}", row, file);
+					return false;
+				}
+			}
+			if (sections.back() != corners.size())
+				sections.push_back(corners.size());
+
+			// File has been read now
+			// Normals are computed from faces only when some corners do not give them
+			std::vector<glm::vec3> smoothNormals;
+			if (normalsMissing)
+				smoothNormals = computeNormals(tempVertices, corners);
+
+			// One mesh per section
+			meshData.clear();
+			meshData.reserve(sections.size() - 1);
+			VertexCache cache;
+			for (std::size_t i = 0; i + 1 < sections.size(); ++i) {
+				meshData.push_back(createMeshData(corners.data() + sections[i], corners.data() + sections[i + 1],
+					tempVertices, tempUVs, tempNormals, smoothNormals, cache));
+			}
+			if (meshData.empty()) {
+				g_log.error("loadModel", "No faces in file: " + file);
+				return false;
+			}
+
+			// Failing to cache only costs parsing again next time
+			if (!meshCache::save(cachePath, source.getSize(), checksum, meshData))
+				g_log.warn("loadModel", "Could not write cache file: " + cachePath);
+			return true;
+		}
+
 	} // anonymous namespace
 
 
@@ -107,9 +621,28 @@ namespace fileloader {
 		}
 
 		auto type = getImageType(file);
-		type->vLoadFile(stream);
+		if (type == nullptr || !type->vLoadFile(stream)) {
+			g_log.error("loadTexture", "Could not decode file " + file);
+			return nullptr;
+		}
 		stream.close();
-		return std::make_unique<Image>(std::move(type));
+
+		// RGBA rows are 4 byte aligned like OpenGL unpacks them by default, whatever the width
+		const int width = type->vGetWidth();
+		const int height = type->vGetHeight();
+		const std::size_t stride = static_cast<std::size_t>(width) * 4;
+		if (width <= 0 || height <= 0 || width > std::numeric_limits<int>::max() / 4
+			|| static_cast<std::size_t>(height) > std::numeric_limits<std::size_t>::max() / stride) {
+			g_log.error("loadTexture", "Could not decode file " + file + ", because image size is "
+				+ utility::toStr(width) + "x" + utility::toStr(height));
+			return nullptr;
+		}
+		auto data = std::make_unique<uint8_t[]>(stride * static_cast<std::size_t>(height));
+		if (!type->vDecodeTo(data.get(), static_cast<int>(stride), 4)) {
+			g_log.error("loadTexture", "Could not decode file " + file);
+			return nullptr;
+		}
+		return std::make_unique<Image>(std::move(data), width, height, 4);
 	}
 
 	bool loadModel(const std::string& file, std::vector<Mesh>& meshes)
@@ -119,112 +652,49 @@ namespace fileloader {
 			g_log.error("loadModel", "file parameter empty");
 			return false;
 		}
-		
-		// Open stream
-		std::ifstream stream(
-			Locator::getConfig()->get("DataPath", std::string("../Data/")) + "Models/" + file);
-		
-		// Validate stream
-		if (!validateFile(stream)) {
-			g_log.error("loadModel", "Could not load file: " + file);
+
+		MappedFile source;
+		std::string cachePath;
+		uint64_t checksum = 0;
+		if (!openModel(file, source, cachePath, checksum))
 			return false;
+		if (meshCache::load(cachePath, source.getSize(), checksum, meshes)) {
+			g_log.info("loadModel", "Loaded file " + file + " from cache");
+			return true;
 		}
 
-		// Create temp vectors to read contents from file
-		std::vector<glm::vec3> tempVertices;
-		std::vector<glm::vec2> tempUVs;
-		std::vector<glm::vec3> tempNormals;
-
-		// Vectors for indices
-		std::vector<unsigned short> vertexIndices;
-		std::vector<unsigned short> uvIndices;
-		std::vector<unsigned short> normalIndices;
-		
-		// Loop through file
-		std::string line;
-		for (int row = 1; std::getline(stream, line); ++row) {
-			if (line.length() < 2) // Row is not legit if it is shorter than 2 characters 
-				continue;
-
-			auto header = line.substr(0, 2);
-			if (header[0] == '#') 
-				continue; // Comment line, do nothing
-			
-			std::stringstream ss(line.substr(2));
-			try {
-				if (header == "vt") { // uv data
-					glm::vec2 v2;
-					ss >> v2.x;
-					ss >> v2.y;
-					tempUVs.emplace_back(std::move(v2));
-				}
-				else if (header == "vn") { // normal data
-					glm::vec3 v3;
-					ss >> v3.x;
-					ss >> v3.y;
-					ss >> v3.z;
-					tempNormals.emplace_back(std::move(v3));
-				}
-				else if (header[0] == 'v') { // vertice data
-					glm::vec3 v3;
-					ss >> v3.x;
-					ss >> v3.y;
-					ss >> v3.z;
-					tempVertices.emplace_back(std::move(v3));
-				}
-				else if (header[0] == 'f') { // face data
-					for (int i = 0; i < 3; ++i) { // For triangulated data there are 3 sets of 3 values in one row
-						unsigned short vertexId, uvId, normalId;
-						ss >> vertexId;
-						ss.ignore(1); // Ignore '/' character
-						ss >> uvId;
-						ss.ignore(1); // Ignore '/' character
-						ss >> normalId;
-
-						vertexIndices.emplace_back(vertexId);
-						uvIndices.emplace_back(uvId);
-						normalIndices.emplace_back(normalId);
-					}
-				}
-			}
-			catch(std::ios_base::failure f) {
-				g_log.error("loadModel", "Bad row " 
-					+ utility::toStr(row) + " in file " + file + ". What: " + f.what());
-				return false;
-			}
-		}
+		std::vector<MeshData> meshData;
+		if (!parseModel(file, source, cachePath, checksum, meshData))
+			return false;
 
-		// File has been read now
-		// Process the three indexes into one
-		std::vector<Vertex> vertices;
-		std::vector<unsigned short> indices;
-		for (unsigned int i = 0; i < vertexIndices.size(); ++i) {
-			Vertex vert;
-			vert.position = tempVertices[vertexIndices[i] - 1]; // indexes in .obj start from 1
-			vert.normal = tempNormals[normalIndices[i] - 1];
-			vert.uvCoord = tempUVs[uvIndices[i] - 1];
+		meshes.clear();
+		meshes.reserve(meshData.size());
+		for (MeshData& mesh : meshData) { meshes.emplace_back(std::move(mesh)); }
+		g_log.info("modelLoader", "Succesfully loaded file: " + file);
+		return true;
+	}
 
-			// Search for existing vertex
-			auto it = std::find_if(
-				vertices.begin(), 
-				vertices.end(), 
-				[vert](const auto rhs) { return rhs.isEqual(vert); });
+	bool loadModelData(const std::string& file, std::vector<MeshData>& meshData)
+	{
+		REQUIRE(!file.empty());
+		if (file.empty()) {
+			g_log.error("loadModelData", "file parameter empty");
+			return false;
+		}
 
-			if (it == vertices.end()) {
-				// No unique vertex + uv + normal combo found
-				// add it to vertices and indices
-				vertices.emplace_back(std::move(vert));
-				indices.emplace_back(static_cast<unsigned short>(vertices.size() - 1)); // OpenGL wants indices to start from 0
-			}
-			else {
-				// Unique combo found
-				// Add it to indices only
-				indices.emplace_back(static_cast<unsigned short>(std::distance(vertices.begin(), it)));
-			}
+		MappedFile source;
+		std::string cachePath;
+		uint64_t checksum = 0;
+		if (!openModel(file, source, cachePath, checksum))
+			return false;
+		if (meshCache::load(cachePath, source.getSize(), checksum, meshData)) {
+			g_log.info("loadModelData", "Loaded file " + file + " from cache");
+			return true;
 		}
-		meshes.clear();
-		meshes.emplace_back(std::move(vertices), std::move(indices));
-		g_log.info("modelLoader", "Succesfully loaded file: " + file);
+
+		if (!parseModel(file, source, cachePath, checksum, meshData))
+			return false;
+		g_log.info("loadModelData", "Succesfully loaded file: " + file);
 		return true;
 	}
 
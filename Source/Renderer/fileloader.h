@@ -11,22 +11,34 @@
 namespace fileloader {
 
 	/**
-	 * \brief Load file and get image RGB byte array
+	 * \brief Load file and get image RGB byte array. Does not touch OpenGL, so it can be called on worker threads
 	 * \param file Filename without filepath
 	 * \pre !file.empty()
-	 * \return Pointer to Image which holds image RGB byte array, width, and height
+	 * \return Pointer to Image which holds image RGBA byte array, width, and height
 	 */
 	std::unique_ptr<Image> loadTexture(const std::string& file);
 
 	/**
-	 * \brief Used to load 3D model file (.obj) and to create a 
+	 * \brief Used to load 3D model file (.obj) and to create its meshes. Faces with more than three corners are
+	 *	triangulated as fans and each object, group or material (o, g, usemtl) becomes its own mesh.
+	 *	Parsed meshes are cached under DataPath/Cache/Models/ and loaded from there until the file changes
 	 * \param file Filename of model
-	 * \param meshes Out parameter used to load data from file
+	 * \param meshes Out parameter used to load data from file, one mesh per object, group or material
 	 * \pre !file.empty()
 	 * \return True if successful, otherwise false
 	 */
 	bool loadModel(const std::string& file, std::vector<Mesh>& meshes);
 
+	/**
+	 * \brief Used to load 3D model file (.obj) like loadModel, but without uploading the meshes. Does not touch
+	 *	OpenGL, so it can be called on worker threads
+	 * \param file Filename of model
+	 * \param meshData Out parameter, one mesh per object, group or material
+	 * \pre !file.empty()
+	 * \return True if successful, otherwise false
+	 */
+	bool loadModelData(const std::string& file, std::vector<MeshData>& meshData);
+
 	/**
 	 * \brief Get byte size of file
 	 * \param stream Filestream to the file
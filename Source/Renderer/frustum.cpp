@@ -0,0 +1,132 @@
+#include "Renderer/frustum.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Utility/contract.h"
+
+void Frustum::BoxList::add(const AABB& box)
+{
+	const auto center = box.getCenter();
+	const auto extents = box.getExtents();
+	m_centerX.push_back(center.x);
+	m_centerY.push_back(center.y);
+	m_centerZ.push_back(center.z);
+	m_extentX.push_back(extents.x);
+	m_extentY.push_back(extents.y);
+	m_extentZ.push_back(extents.z);
+}
+
+void Frustum::BoxList::clear()
+{
+	m_centerX.clear();
+	m_centerY.clear();
+	m_centerZ.clear();
+	m_extentX.clear();
+	m_extentY.clear();
+	m_extentZ.clear();
+}
+
+void Frustum::BoxList::reserve(std::size_t count)
+{
+	m_centerX.reserve(count);
+	m_centerY.reserve(count);
+	m_centerZ.reserve(count);
+	m_extentX.reserve(count);
+	m_extentY.reserve(count);
+	m_extentZ.reserve(count);
+}
+
+std::size_t Frustum::BoxList::size() const { return m_centerX.size(); }
+
+Frustum::Frustum()
+{
+	// Planes facing the origin from infinitely far away contain every point
+	m_normalX.fill(0.0f);
+	m_normalY.fill(0.0f);
+	m_normalZ.fill(0.0f);
+	m_distance.fill(1.0f);
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+	update(viewProjection);
+}
+
+void Frustum::update(const glm::mat4& viewProjection)
+{
+	// Gribb-Hartmann extraction: planes are sums and differences of the fourth row and the other rows
+	// glm matrices are column major, so row i is m[0][i], m[1][i], m[2][i], m[3][i]
+	const auto& m = viewProjection;
+	for (int i = 0; i < PLANE_COUNT; ++i) {
+		const int row = i / 2;
+		const float sign = i % 2 == 0 ? 1.0f : -1.0f;
+		const glm::vec4 plane(
+			m[0][3] + sign * m[0][row],
+			m[1][3] + sign * m[1][row],
+			m[2][3] + sign * m[2][row],
+			m[3][3] + sign * m[3][row]);
+
+		const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		const float scale = length > 0.0f ? 1.0f / length : 1.0f;
+		m_normalX[i] = plane.x * scale;
+		m_normalY[i] = plane.y * scale;
+		m_normalZ[i] = plane.z * scale;
+		m_distance[i] = plane.w * scale;
+	}
+}
+
+bool Frustum::isVisible(const AABB& box) const
+{
+	const auto center = box.getCenter();
+	const auto extents = box.getExtents();
+	for (int i = 0; i < PLANE_COUNT; ++i) {
+		// Box is outside when even its corner furthest along the normal is behind the plane
+		const float distance = m_normalX[i] * center.x + m_normalY[i] * center.y + m_normalZ[i] * center.z + m_distance[i];
+		const float radius = std::abs(m_normalX[i]) * extents.x + std::abs(m_normalY[i]) * extents.y
+			+ std::abs(m_normalZ[i]) * extents.z;
+		if (distance + radius < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+unsigned int Frustum::cull(const BoxList& boxes, std::vector<unsigned char>& visibility) const
+{
+	const std::size_t count = boxes.size();
+	visibility.resize(count);
+
+	std::array<float, PLANE_COUNT> absX;
+	std::array<float, PLANE_COUNT> absY;
+	std::array<float, PLANE_COUNT> absZ;
+	for (int i = 0; i < PLANE_COUNT; ++i) {
+		absX[i] = std::abs(m_normalX[i]);
+		absY[i] = std::abs(m_normalY[i]);
+		absZ[i] = std::abs(m_normalZ[i]);
+	}
+
+	const float* cx = boxes.m_centerX.data();
+	const float* cy = boxes.m_centerY.data();
+	const float* cz = boxes.m_centerZ.data();
+	const float* ex = boxes.m_extentX.data();
+	const float* ey = boxes.m_extentY.data();
+	const float* ez = boxes.m_extentZ.data();
+	unsigned char* out = visibility.data();
+
+	// No early outs, every box runs through all planes so the loop stays free of branches
+	for (std::size_t b = 0; b < count; ++b) {
+		float outside = 0.0f;
+		for (int i = 0; i < PLANE_COUNT; ++i) {
+			const float distance = m_normalX[i] * cx[b] + m_normalY[i] * cy[b] + m_normalZ[i] * cz[b] + m_distance[i];
+			const float radius = absX[i] * ex[b] + absY[i] * ey[b] + absZ[i] * ez[b];
+			outside = std::min(outside, distance + radius);
+		}
+		out[b] = static_cast<unsigned char>(outside >= 0.0f);
+	}
+
+	unsigned int visible = 0;
+	for (std::size_t b = 0; b < count; ++b) { visible += out[b]; }
+
+	ENSURE(visibility.size() == boxes.size());
+	return visible;
+}
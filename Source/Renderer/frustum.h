@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#pragma warning (push, 2)  // Temporarily set warning level 2
+#include <3rdParty/glm/glm.hpp>
+#pragma warning (pop)      // Restore back
+
+#include "Utility/aabb.h"
+
+// View frustum as six planes extracted from combined projection and view matrix
+// Used on CPU to skip drawing of boxes that are completely outside of the view
+//
+// Planes are stored as structure of arrays and boxes are tested as center and extents, so that
+// the test is the same branchless multiply-add sequence for every plane and the batch loop
+// over boxes can be vectorized by the compiler
+// Test is conservative: box that intersects frustum corner region may be reported visible
+class Frustum {
+public:
+	static const int PLANE_COUNT = 6;
+
+	// Boxes stored as structure of arrays for batch culling
+	class BoxList {
+	public:
+		/**
+		 * \brief Used to add box to the end of the list
+		 * \param box Box to be added
+		 */
+		void add(const AABB& box);
+
+		/**
+		 * \brief Used to remove all boxes
+		 */
+		void clear();
+
+		/**
+		 * \brief Used to reserve memory for boxes
+		 * \param count Count of boxes
+		 */
+		void reserve(std::size_t count);
+
+		/**
+		 * \brief Used to get the count of boxes
+		 * \return Count of boxes
+		 */
+		std::size_t size() const;
+
+	private:
+		friend class Frustum;
+
+		std::vector<float> m_centerX;	//!< Box centers on x axis
+		std::vector<float> m_centerY;	//!< Box centers on y axis
+		std::vector<float> m_centerZ;	//!< Box centers on z axis
+		std::vector<float> m_extentX;	//!< Box half sizes on x axis
+		std::vector<float> m_extentY;	//!< Box half sizes on y axis
+		std::vector<float> m_extentZ;	//!< Box half sizes on z axis
+	};
+
+	/**
+	 * \brief Constructor. Creates frustum that contains everything
+	 */
+	Frustum();
+
+	/**
+	 * \brief Constructor. Creates frustum from matrix
+	 * \param viewProjection Projection matrix multiplied by view matrix
+	 */
+	explicit Frustum(const glm::mat4& viewProjection);
+
+	/**
+	 * \brief Used to recalculate planes, e.g. when camera has moved
+	 * \param viewProjection Projection matrix multiplied by view matrix
+	 */
+	void update(const glm::mat4& viewProjection);
+
+	/**
+	 * \brief Used to test if box is at least partly inside the frustum
+	 * \param box Box in world coordinates
+	 * \return True if box may be visible, false if it is completely outside
+	 */
+	bool isVisible(const AABB& box) const;
+
+	/**
+	 * \brief Used to test many boxes at once
+	 * \param boxes Boxes in world coordinates
+	 * \param visibility Output, resized to boxes.size(). 1 if box may be visible, otherwise 0
+	 * \return Count of visible boxes
+	 */
+	unsigned int cull(const BoxList& boxes, std::vector<unsigned char>& visibility) const;
+
+private:
+	// Plane equation is normal . p + distance >= 0 for points inside
+	std::array<float, PLANE_COUNT> m_normalX;	//!< Plane normals on x axis
+	std::array<float, PLANE_COUNT> m_normalY;	//!< Plane normals on y axis
+	std::array<float, PLANE_COUNT> m_normalZ;	//!< Plane normals on z axis
+	std::array<float, PLANE_COUNT> m_distance;	//!< Plane distances from origin
+};
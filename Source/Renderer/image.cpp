@@ -1,10 +1,7 @@
 #include "image.h"
 
-Image::Image(std::unique_ptr<uint8_t[]> data, int width, int height)
-	: m_data(std::move(data)), m_width(width), m_height(height) {}
-
-Image::Image(std::unique_ptr<IImageType> imagetype)
-	: m_data(imagetype->vDecode()), m_width(imagetype->vGetWidth()), m_height(imagetype->vGetHeight()) {}
+Image::Image(std::unique_ptr<uint8_t[]> data, int width, int height, int channels)
+	: m_data(std::move(data)), m_width(width), m_height(height), m_channels(channels) {}
 
 Image::~Image() {}
 
@@ -12,12 +9,14 @@ int Image::getWidth() const { return m_width; }
 
 int Image::getHeight() const { return m_height; }
 
+int Image::getChannels() const { return m_channels; }
+
 uint8_t* Image::getData() const { return m_data.get(); }
 
 void Image::flipVertically()
 {
 	// Create temp pointer to store the changes
-	const int width = m_width * 3; // Each pixel has RGB bytes
+	const int width = m_width * m_channels; // Each pixel has RGB or RGBA bytes
 	auto temp = std::make_unique<uint8_t[]>(width * m_height);
 
 	// Read from current data to temp in reverse row order
@@ -34,7 +33,7 @@ void Image::flipVertically()
 
 void Image::flipHorizontally()
 {
-	const int width = m_width * 3; // Each pixel has RGB (=3) bytes
+	const int width = m_width * m_channels; // Each pixel has RGB (=3) or RGBA (=4) bytes
 
 								   // Create temp pointer to store the changes
 	auto temp = std::make_unique<uint8_t[]>(width * m_height);
@@ -42,13 +41,11 @@ void Image::flipHorizontally()
 	// Process rows
 	for (int i = 0; i < m_height; ++i) {
 		// Invert bytes within one row
-		int from = (i + 1) * width - 3;
+		int from = (i + 1) * width - m_channels;
 		int to = i * width;
-		for (int j = 0; j < width; j += 3) {
-			temp[to++] = m_data[from++];
-			temp[to++] = m_data[from++];
-			temp[to++] = m_data[from++];
-			from -= 6; // Move to start of previous pixel
+		for (int j = 0; j < width; j += m_channels) {
+			for (int c = 0; c < m_channels; ++c) { temp[to++] = m_data[from++]; }
+			from -= 2 * m_channels; // Move to start of previous pixel
 		}
 	}
 	// Replace the old data with altered temp
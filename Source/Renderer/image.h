@@ -10,17 +10,12 @@ public:
 
 	/**
 	 * \brief Constructor. Creates valid object
-	 * \param data Image RGB byte array
+	 * \param data Image RGB or RGBA byte array without padding between rows
 	 * \param width Image width in pixels
 	 * \param height Image height in pixels
+	 * \param channels Bytes per pixel, 3 for RGB and 4 for RGBA
 	 */
-	Image(std::unique_ptr<uint8_t[]> data, int width, int height);
-
-	/**
-	 * \brief Constructor. Creates valid object
-	 * \param imagetype Pointer to initialized imagetype
-	 */
-	explicit Image(std::unique_ptr<IImageType> imagetype);
+	Image(std::unique_ptr<uint8_t[]> data, int width, int height, int channels);
 
 	/**
 	 * \brief Destructor
@@ -40,7 +35,13 @@ public:
 	int getHeight() const;
 
 	/**
-	 * \brief Get image RGB byte array data
+	 * \brief Used to get count of bytes per pixel
+	 * \return 3 for RGB, 4 for RGBA
+	 */
+	int getChannels() const;
+
+	/**
+	 * \brief Get image RGB or RGBA byte array data
 	 * \return raw pointer to data. Does not pass ownership.
 	 */
 	uint8_t* getData() const;
@@ -56,7 +57,8 @@ public:
 	void flipHorizontally();
 
 private:
-	std::unique_ptr<uint8_t[]> m_data;	//!< Pointer to array of image rgb bytes
+	std::unique_ptr<uint8_t[]> m_data;	//!< Pointer to array of image rgb or rgba bytes
 	const int m_width;					//!< Image pixel width
 	const int m_height;					//!< Image pixel height
+	const int m_channels;				//!< Bytes per pixel
 };
@@ -3,28 +3,87 @@
 #include <3rdParty/GL/glew.h>
 
 Mesh::Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned short>&& indices)
-	: m_vertices(vertices), m_indices(indices), m_VAO(0), m_VBO(0), m_EBO(0)
+	: m_VAO(0), m_VBO(0), m_EBO(0), m_indexCount(static_cast<unsigned int>(indices.size())),
+	m_indexType(GL_UNSIGNED_SHORT), m_vertices(std::move(vertices)), m_indices(std::move(indices)), m_wideIndices()
 {
-	setupMesh();
+	setupMesh(m_vertices.data(), m_vertices.size(), m_indices.data());
+}
+
+Mesh::Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned int>&& indices)
+	: m_VAO(0), m_VBO(0), m_EBO(0), m_indexCount(static_cast<unsigned int>(indices.size())),
+	m_indexType(GL_UNSIGNED_INT), m_vertices(std::move(vertices)), m_indices(), m_wideIndices(std::move(indices))
+{
+	setupMesh(m_vertices.data(), m_vertices.size(), m_wideIndices.data());
+}
+
+Mesh::Mesh(MeshData&& data)
+	: m_VAO(0), m_VBO(0), m_EBO(0), m_indexCount(0), m_indexType(GL_UNSIGNED_SHORT),
+	m_vertices(std::move(data.vertices)), m_indices(std::move(data.indices)), m_wideIndices(std::move(data.wideIndices))
+{
+	if (!m_wideIndices.empty())
+		m_indexType = GL_UNSIGNED_INT;
+	m_indexCount = static_cast<unsigned int>(m_wideIndices.empty() ? m_indices.size() : m_wideIndices.size());
+	setupMesh(m_vertices.data(), m_vertices.size(),
+		m_wideIndices.empty() ? static_cast<const void*>(m_indices.data()) : m_wideIndices.data());
+}
+
+Mesh::Mesh(const Vertex* vertices, std::size_t vertexCount, const void* indices, std::size_t indexCount, bool wideIndices)
+	: m_VAO(0), m_VBO(0), m_EBO(0), m_indexCount(static_cast<unsigned int>(indexCount)),
+	m_indexType(wideIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT), m_vertices(), m_indices(), m_wideIndices()
+{
+	setupMesh(vertices, vertexCount, indices);
 }
 
 Mesh::~Mesh() 
 {
-	glDeleteBuffers(1, &m_EBO);
-	glDeleteBuffers(1, &m_VBO);
-	glDeleteVertexArrays(1, &m_VAO);
+	deleteBuffers();
+}
+
+Mesh::Mesh(Mesh&& rhs) noexcept
+	: m_VAO(rhs.m_VAO), m_VBO(rhs.m_VBO), m_EBO(rhs.m_EBO),
+	m_indexCount(rhs.m_indexCount), m_indexType(rhs.m_indexType), m_vertices(std::move(rhs.m_vertices)), m_indices(std::move(rhs.m_indices)), m_wideIndices(std::move(rhs.m_wideIndices))
+{
+	rhs.m_VAO = 0;
+	rhs.m_VBO = 0;
+	rhs.m_EBO = 0;
+}
+
+Mesh& Mesh::operator=(Mesh&& rhs) noexcept
+{
+	if (this != &rhs) {
+		deleteBuffers();
+		m_VAO = rhs.m_VAO;
+		m_VBO = rhs.m_VBO;
+		m_EBO = rhs.m_EBO;
+		m_indexCount = rhs.m_indexCount;
+		m_indexType = rhs.m_indexType;
+		m_vertices = std::move(rhs.m_vertices);
+		m_indices = std::move(rhs.m_indices);
+		m_wideIndices = std::move(rhs.m_wideIndices);
+		rhs.m_VAO = 0;
+		rhs.m_VBO = 0;
+		rhs.m_EBO = 0;
+	}
+	return *this;
 }
 
 void Mesh::draw() const
 {
+	if (m_VAO == 0)
+		return;
+
 	// draw mesh
 	glBindVertexArray(m_VAO);
-	glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_SHORT, (void*)0);
+	glDrawElements(GL_TRIANGLES, m_indexCount, m_indexType, (void*)0);
 	glBindVertexArray(0);
 }
 
-void Mesh::setupMesh()
+void Mesh::setupMesh(const Vertex* vertices, std::size_t vertexCount, const void* indices)
 {
+	// Nothing to upload, leave buffer objects unallocated
+	if (vertexCount == 0 || m_indexCount == 0)
+		return;
+
 	// Generate buffer object ids
 	glGenVertexArrays(1, &m_VAO);
 	glGenBuffers(1, &m_VBO);
@@ -33,9 +92,10 @@ void Mesh::setupMesh()
 	// Bind objects
 	glBindVertexArray(m_VAO);
 	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-	glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), &m_vertices[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertices, GL_STATIC_DRAW);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned short), &m_indices[0], GL_STATIC_DRAW);
+	const std::size_t indexSize = m_indexType == GL_UNSIGNED_INT ? sizeof(unsigned int) : sizeof(unsigned short);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexCount * indexSize, indices, GL_STATIC_DRAW);
 
 	// Vertex positions
 	glEnableVertexAttribArray(0);
@@ -50,3 +110,11 @@ void Mesh::setupMesh()
 	// Unbind
 	glBindVertexArray(0);
 }
+
+void Mesh::deleteBuffers()
+{
+	// Deleting 0 is silently ignored by OpenGL
+	glDeleteBuffers(1, &m_EBO);
+	glDeleteBuffers(1, &m_VBO);
+	glDeleteVertexArrays(1, &m_VAO);
+}
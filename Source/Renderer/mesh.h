@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
 #pragma warning (push, 2)  // Temporarily set warning level 2
@@ -20,6 +21,13 @@ struct Vertex {
 	}
 };
 
+// Vertices and indices of a mesh in memory, before they are uploaded
+struct MeshData {
+	std::vector<Vertex> vertices;			//!< Vertice data
+	std::vector<unsigned short> indices;	//!< Indices to vertices, empty if wideIndices is used
+	std::vector<unsigned int> wideIndices;	//!< 32-bit indices to vertices, used when vertices do not fit 16 bits
+};
+
 class Mesh {
 public:
 
@@ -30,11 +38,51 @@ public:
 	 */
 	Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned short>&& indices);
 
+	/**
+	 * \brief Constructor for meshes with more vertices than 16-bit indices can address
+	 * \param vertices Mesh vertice data
+	 * \param indices Mesh indice data to vertices
+	 */
+	Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned int>&& indices);
+
+	/**
+	 * \brief Constructor for mesh data, uses 32-bit indices if data has them
+	 * \param data Mesh vertice and indice data
+	 */
+	explicit Mesh(MeshData&& data);
+
+	/**
+	 * \brief Constructor for data owned by the caller, e.g. a mapped file. Data is uploaded and no copy is kept
+	 * \param vertices Mesh vertice data
+	 * \param vertexCount Count of vertices
+	 * \param indices Mesh indice data to vertices, unsigned short or unsigned int
+	 * \param indexCount Count of indices
+	 * \param wideIndices True if indices are unsigned int, false if unsigned short
+	 */
+	Mesh(const Vertex* vertices, std::size_t vertexCount, const void* indices, std::size_t indexCount, bool wideIndices);
+
 	/**
 	 * \brief Destructor. Deletes buffer objects
 	 */
 	~Mesh();
 
+	// Buffer objects are owned by one mesh at a time, so allow only moving
+	Mesh(const Mesh&) = delete;
+	Mesh& operator=(const Mesh&) = delete;
+
+	/**
+	 * \brief Move constructor. Takes ownership of buffer objects
+	 * \param rhs Mesh moved from, left without buffer objects
+	 */
+	Mesh(Mesh&& rhs) noexcept;
+
+	/**
+	 * \brief Move assignment. Deletes own buffer objects and takes ownership of rhs buffer objects
+	 * \param rhs Mesh moved from, left without buffer objects
+	 * \return Reference to this
+	 */
+	Mesh& operator=(Mesh&& rhs) noexcept;
+
 	/**
 	 * \brief draw Used to draw the mesh
 	 */
@@ -44,12 +92,23 @@ private:
 	unsigned int m_VAO;
 	unsigned int m_VBO;
 	unsigned int m_EBO;
+	unsigned int m_indexCount;				//!< Count of indices uploaded to m_EBO
+	unsigned int m_indexType;				//!< GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
 
 	std::vector<Vertex> m_vertices;			//!< Vertice data
-	std::vector<unsigned short> m_indices;	//!< Indices to vertices
+	std::vector<unsigned short> m_indices;	//!< Indices to vertices, empty if m_wideIndices is used
+	std::vector<unsigned int> m_wideIndices;//!< 32-bit indices to vertices, empty if m_indices is used
 
 	/**
 	 * \brief Used to bind mesh to OpenGL
+	 * \param vertices Vertice data
+	 * \param vertexCount Count of vertices
+	 * \param indices Indice data, m_indexCount indices of m_indexType
+	 */
+	void setupMesh(const Vertex* vertices, std::size_t vertexCount, const void* indices);
+
+	/**
+	 * \brief Used to delete buffer objects
 	 */
-	void setupMesh();
+	void deleteBuffers();
 };
@@ -0,0 +1,277 @@
+#include "Renderer/meshcache.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#include "Utility/mappedfile.h"
+#include "Utility/staticsafelogger.h"
+#include "Utility/utility.h"
+
+namespace meshCache {
+
+	// Anonymous namespace to hide file layout from namespace interface
+	namespace {
+
+		const uint32_t MAGIC = 0x48534D42;	//!< "BMSH" in little endian
+		const uint32_t VERSION = 1;			//!< Incremented when layout changes
+
+		StaticSafeLogger g_log("MeshCache");
+
+		// Start of cache file
+		struct Header {
+			uint32_t magic;
+			uint32_t version;
+			uint64_t sourceSize;		//!< Size of source file in bytes
+			uint64_t sourceChecksum;	//!< Checksum of source file contents
+			uint32_t vertexSize;		//!< sizeof(Vertex) when file was written
+			uint32_t meshCount;			//!< Count of table entries
+		};
+
+		// Table entry of one mesh, entries follow the header
+		struct Entry {
+			uint32_t vertexCount;
+			uint32_t indexCount;
+			uint32_t indexSize;	//!< 2 or 4 bytes
+			uint32_t reserved;	//!< Always 0
+		};
+
+		/**
+		 * \brief Used to round byte count up so that data following it stays 4 byte aligned
+		 * \param size Count of bytes
+		 * \return size rounded up to multiple of 4
+		 */
+		std::size_t padded(std::size_t size)
+		{
+			return (size + 3) & ~static_cast<std::size_t>(3);
+		}
+
+		/**
+		 * \brief Used to rotate bits left
+		 * \param value Value to rotate
+		 * \param bits Count of bits, 1..63
+		 * \return Rotated value
+		 */
+		uint64_t rotl(uint64_t value, int bits)
+		{
+			return (value << bits) | (value >> (64 - bits));
+		}
+
+		/**
+		 * \brief Used to write raw bytes of value to stream
+		 * \param stream Output stream
+		 * \param value Value to write
+		 */
+		template<typename T>
+		void writeRaw(std::ofstream& stream, const T& value)
+		{
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		/**
+		 * \brief Used to name the file a cache is written to before it replaces the cache. Names differ between
+		 *	calls and between processes, so concurrent writers of the same cache never write the same file
+		 * \param path Path of cache file
+		 * \return Path of temporary file next to the cache file
+		 */
+		std::string temporaryPath(const std::string& path)
+		{
+			static const unsigned int process = std::random_device()();
+			static std::atomic<unsigned int> counter(0);
+			return path + "." + utility::toHex(process) + "." + utility::toStr(++counter) + ".tmp";
+		}
+
+		/**
+		 * \brief Tests that every index refers to a vertex of the mesh
+		 * \param indices Indices of mesh, 4 byte aligned
+		 * \param indexCount Count of indices
+		 * \param vertexCount Count of vertices of mesh
+		 * \return True if every index is below vertexCount, otherwise false
+		 */
+		template<typename T>
+		bool indicesInRange(const uint8_t* indices, std::size_t indexCount, uint32_t vertexCount)
+		{
+			const T* first = reinterpret_cast<const T*>(indices);
+			T largest = 0;
+			for (const T* index = first; index != first + indexCount; ++index)
+				largest = *index > largest ? *index : largest;
+			return indexCount == 0 || largest < vertexCount;
+		}
+
+		/**
+		 * \brief Used to map cache file and validate it against source and its own size
+		 * \param path Path of cache file
+		 * \param sourceSize Size of current source file in bytes
+		 * \param sourceChecksum Checksum of current source file contents
+		 * \param file Output, mapped cache file
+		 * \param entries Output, table entries of the meshes
+		 * \return Start of mesh data in file, nullptr if cache cannot be used
+		 */
+		const uint8_t* openCache(const std::string& path, uint64_t sourceSize, uint64_t sourceChecksum, MappedFile& file,
+			std::vector<Entry>& entries)
+		{
+			if (!file.open(path) || file.getSize() < sizeof(Header))
+				return nullptr;
+
+			Header header;
+			std::memcpy(&header, file.getData(), sizeof(header));
+			if (header.magic != MAGIC || header.version != VERSION || header.vertexSize != sizeof(Vertex)
+				|| header.sourceSize != sourceSize || header.sourceChecksum != sourceChecksum || header.meshCount == 0)
+				return nullptr;
+
+			const std::size_t tableEnd = sizeof(Header) + static_cast<std::size_t>(header.meshCount) * sizeof(Entry);
+			if (file.getSize() < tableEnd)
+				return nullptr;
+
+			// Validate the whole table before anything is read
+			entries.resize(header.meshCount);
+			std::memcpy(entries.data(), file.getData() + sizeof(Header), entries.size() * sizeof(Entry));
+			std::size_t end = tableEnd;
+			for (const Entry& entry : entries) {
+				if (entry.indexSize != sizeof(unsigned short) && entry.indexSize != sizeof(unsigned int))
+					return nullptr;
+				end += static_cast<std::size_t>(entry.vertexCount) * sizeof(Vertex)
+					+ padded(static_cast<std::size_t>(entry.indexCount) * entry.indexSize);
+				if (end > file.getSize())
+					return nullptr;
+			}
+			if (end != file.getSize())
+				return nullptr;
+
+			// Index past the vertices would make OpenGL read out of the vertex buffer
+			const uint8_t* data = file.getData() + tableEnd;
+			for (const Entry& entry : entries) {
+				const uint8_t* indices = data + static_cast<std::size_t>(entry.vertexCount) * sizeof(Vertex);
+				const bool valid = entry.indexSize == sizeof(unsigned int)
+					? indicesInRange<unsigned int>(indices, entry.indexCount, entry.vertexCount)
+					: indicesInRange<unsigned short>(indices, entry.indexCount, entry.vertexCount);
+				if (!valid)
+					return nullptr;
+				data = indices + padded(static_cast<std::size_t>(entry.indexCount) * entry.indexSize);
+			}
+			return file.getData() + tableEnd;
+		}
+
+	} // anonymous namespace
+
+	uint64_t checksum(const uint8_t* data, std::size_t size)
+	{
+		// Body and finalizer of MurmurHash3, one 8 byte word per step
+		const uint64_t m1 = 0x87C37B91114253D5ull;
+		const uint64_t m2 = 0x4CF5AD432745937Full;
+		uint64_t hash = size;
+		std::size_t i = 0;
+		for (; i + 8 <= size; i += 8) {
+			uint64_t word;
+			std::memcpy(&word, data + i, sizeof(word));
+			hash ^= rotl(word * m1, 31) * m2;
+			hash = rotl(hash, 27) * 5 + 0x52DCE729;
+		}
+
+		uint64_t tail = 0;
+		for (int shift = 0; i < size; ++i, shift += 8)
+			tail |= static_cast<uint64_t>(data[i]) << shift;
+		hash ^= rotl(tail * m1, 31) * m2;
+
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		hash *= 0xC4CEB9FE1A85EC53ull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+
+	bool save(const std::string& path, uint64_t sourceSize, uint64_t sourceChecksum, const std::vector<MeshData>& meshes)
+	{
+		utility::createDirectories(path);
+		const std::string temporary = temporaryPath(path);
+		std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+		if (!stream.is_open())
+			return false;
+
+		writeRaw(stream, Header{ MAGIC, VERSION, sourceSize, sourceChecksum, static_cast<uint32_t>(sizeof(Vertex)),
+			static_cast<uint32_t>(meshes.size()) });
+		for (const MeshData& mesh : meshes) {
+			const bool wide = !mesh.wideIndices.empty();
+			writeRaw(stream, Entry{ static_cast<uint32_t>(mesh.vertices.size()),
+				static_cast<uint32_t>(wide ? mesh.wideIndices.size() : mesh.indices.size()),
+				static_cast<uint32_t>(wide ? sizeof(unsigned int) : sizeof(unsigned short)), 0 });
+		}
+
+		const char padding[4] = { 0, 0, 0, 0 };
+		for (const MeshData& mesh : meshes) {
+			stream.write(reinterpret_cast<const char*>(mesh.vertices.data()), mesh.vertices.size() * sizeof(Vertex));
+			const std::size_t indexBytes = mesh.wideIndices.empty() ? mesh.indices.size() * sizeof(unsigned short)
+				: mesh.wideIndices.size() * sizeof(unsigned int);
+			stream.write(mesh.wideIndices.empty() ? reinterpret_cast<const char*>(mesh.indices.data())
+				: reinterpret_cast<const char*>(mesh.wideIndices.data()), indexBytes);
+			stream.write(padding, padded(indexBytes) - indexBytes);
+		}
+		stream.close();
+		if (!stream) {
+			std::remove(temporary.c_str());
+			return false;
+		}
+
+		// Readers map either the old or the new cache, never a missing or partial one
+		if (!utility::replaceFile(temporary, path)) {
+			g_log.error("save", "Could not replace {} with {}", path, temporary);
+			std::remove(temporary.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	bool load(const std::string& path, uint64_t sourceSize, uint64_t sourceChecksum, std::vector<Mesh>& meshes)
+	{
+		MappedFile file;
+		std::vector<Entry> entries;
+		const uint8_t* data = openCache(path, sourceSize, sourceChecksum, file, entries);
+		if (data == nullptr)
+			return false;
+
+		std::vector<Mesh> loaded;
+		loaded.reserve(entries.size());
+		for (const Entry& entry : entries) {
+			const uint8_t* indices = data + static_cast<std::size_t>(entry.vertexCount) * sizeof(Vertex);
+			loaded.emplace_back(reinterpret_cast<const Vertex*>(data), entry.vertexCount, indices, entry.indexCount,
+				entry.indexSize == sizeof(unsigned int));
+			data = indices + padded(static_cast<std::size_t>(entry.indexCount) * entry.indexSize);
+		}
+		meshes = std::move(loaded);
+		return true;
+	}
+
+	bool load(const std::string& path, uint64_t sourceSize, uint64_t sourceChecksum, std::vector<MeshData>& meshes)
+	{
+		MappedFile file;
+		std::vector<Entry> entries;
+		const uint8_t* data = openCache(path, sourceSize, sourceChecksum, file, entries);
+		if (data == nullptr)
+			return false;
+
+		// Mapping is closed when this returns, on a worker thread before the data is uploaded, so data is copied out
+		std::vector<MeshData> loaded(entries.size());
+		for (std::size_t i = 0; i < entries.size(); ++i) {
+			const Entry& entry = entries[i];
+			const Vertex* vertices = reinterpret_cast<const Vertex*>(data);
+			loaded[i].vertices.assign(vertices, vertices + entry.vertexCount);
+			data += static_cast<std::size_t>(entry.vertexCount) * sizeof(Vertex);
+
+			if (entry.indexSize == sizeof(unsigned int)) {
+				loaded[i].wideIndices.resize(entry.indexCount);
+				std::memcpy(loaded[i].wideIndices.data(), data, entry.indexCount * sizeof(unsigned int));
+			}
+			else {
+				loaded[i].indices.resize(entry.indexCount);
+				std::memcpy(loaded[i].indices.data(), data, entry.indexCount * sizeof(unsigned short));
+			}
+			data += padded(static_cast<std::size_t>(entry.indexCount) * entry.indexSize);
+		}
+		meshes = std::move(loaded);
+		return true;
+	}
+
+} // namespace meshCache
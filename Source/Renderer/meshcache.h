@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Renderer/mesh.h"
+
+// Namespace to group the binary cache of parsed models, so that a model file is parsed only once
+//
+// Cache file holds a header with the size and checksum of the source file, a table with vertex and index
+// counts of each mesh, and then vertices and indices of each mesh as they are uploaded to OpenGL. Loading
+// maps the file and uploads straight from the mapping, nothing is parsed or copied on the way.
+// Cache whose source size or checksum differs from the current source file is not loaded, so editing a model
+// invalidates its cache. Neither is a cache with an index past the vertices of its mesh. Values are in the byte
+// order of the machine, the cache is never shared between machines
+namespace meshCache {
+
+	/**
+	 * \brief Used to compute checksum of source file contents. Thread safe
+	 * \param data File contents
+	 * \param size Count of bytes
+	 * \return 64-bit checksum
+	 */
+	uint64_t checksum(const uint8_t* data, std::size_t size);
+
+	/**
+	 * \brief Used to write meshes to cache file. File is written under a temporary name unique to the call and
+	 *	moved over the cache in one step when complete, so an interrupted write never leaves a partial cache
+	 *	behind and readers never see the cache missing. Thread safe, also for the same path
+	 * \param path Path of cache file, missing directories are created
+	 * \param sourceSize Size of source file in bytes
+	 * \param sourceChecksum Checksum of source file contents
+	 * \param meshes Meshes parsed from source file
+	 * \return True if cache file was written, otherwise false
+	 */
+	bool save(const std::string& path, uint64_t sourceSize, uint64_t sourceChecksum, const std::vector<MeshData>& meshes);
+
+	/**
+	 * \brief Used to load meshes from cache file
+	 * \param path Path of cache file
+	 * \param sourceSize Size of current source file in bytes
+	 * \param sourceChecksum Checksum of current source file contents
+	 * \param meshes Output, replaced with loaded meshes when loading succeeds
+	 * \return True if cache file exists, is valid and matches source, otherwise false and meshes is not changed
+	 */
+	bool load(const std::string& path, uint64_t sourceSize, uint64_t sourceChecksum, std::vector<Mesh>& meshes);
+
+	/**
+	 * \brief Used to read meshes from cache file without uploading them. Meshes are copied out of the mapping,
+	 *	so that they outlive the file and can be uploaded later on another thread. Thread safe
+	 * \param path Path of cache file
+	 * \param sourceSize Size of current source file in bytes
+	 * \param sourceChecksum Checksum of current source file contents
+	 * \param meshes Output, replaced with read meshes when reading succeeds
+	 * \return True if cache file exists, is valid and matches source, otherwise false and meshes is not changed
+	 */
+	bool load(const std::string& path, uint64_t sourceSize, uint64_t sourceChecksum, std::vector<MeshData>& meshes);
+
+} // namespace meshCache
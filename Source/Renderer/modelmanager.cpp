@@ -1,79 +1,232 @@
-#include "Renderer/fileloader.h"
-#include "Renderer/image.h"
 #include "Renderer/modelmanager.h"
+
+#include <chrono>
+#include <exception>
+
+#include "Renderer/fileloader.h"
 #include "Utility/contract.h"
+#include "Utility/locator.h"
+
+namespace {
 
-ModelManager::ModelManager() : m_log("ModelManager") {}
+	/**
+	 * \brief Used to test if future has its value without waiting for it
+	 * \param future Valid future
+	 * \return True if value is ready, otherwise false
+	 */
+	template<typename T>
+	bool isReady(const std::future<T>& future)
+	{
+		return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}
+
+	/**
+	 * \brief Used to create texture with mipmaps
+	 * \param data RGB or RGBA byte array
+	 * \param width Width in pixels
+	 * \param height Height in pixels
+	 * \param channels 3 for RGB, 4 for RGBA
+	 * \return OpenGL texture id
+	 */
+	unsigned int createTexture(const uint8_t* data, int width, int height, int channels)
+	{
+		GLuint textureId;
+		glGenTextures(1, &textureId);
+		glBindTexture(GL_TEXTURE_2D, textureId);
+
+		// Set the texture wrapping parameters
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		// Set texture filtering parameters
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		const GLenum format = channels == 4 ? GL_RGBA : GL_RGB;
+		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		return textureId;
+	}
+
+	/**
+	 * \brief Used to create placeholder model, a unit cube centered at origin like cube.obj
+	 * \return Model with one mesh
+	 */
+	std::shared_ptr<Model> createPlaceholderModel()
+	{
+		std::vector<Vertex> vertices;
+		std::vector<unsigned short> indices;
+		for (int axis = 0; axis < 3; ++axis) {
+			for (int sign = -1; sign <= 1; sign += 2) {
+				glm::vec3 normal(0.0f);
+				normal[axis] = static_cast<float>(sign);
+
+				// Edges of the face, cross(u, v) points along normal so that triangles wind counter clockwise
+				glm::vec3 u(0.0f);
+				glm::vec3 v(0.0f);
+				u[(axis + 1) % 3] = 0.5f;
+				v[(axis + 2) % 3] = 0.5f * sign;
+
+				const glm::vec3 center = normal * 0.5f;
+				const auto first = static_cast<unsigned short>(vertices.size());
+				vertices.push_back(Vertex{ center - u - v, normal, glm::vec2(0.0f, 0.0f) });
+				vertices.push_back(Vertex{ center + u - v, normal, glm::vec2(1.0f, 0.0f) });
+				vertices.push_back(Vertex{ center + u + v, normal, glm::vec2(1.0f, 1.0f) });
+				vertices.push_back(Vertex{ center - u + v, normal, glm::vec2(0.0f, 1.0f) });
+				for (const unsigned short corner : { 0, 1, 2, 0, 2, 3 })
+					indices.push_back(static_cast<unsigned short>(first + corner));
+			}
+		}
+
+		std::vector<Mesh> meshes;
+		meshes.emplace_back(std::move(vertices), std::move(indices));
+		return std::make_shared<Model>(std::move(meshes));
+	}
+
+} // anonymous namespace
+
+ModelManager::ModelManager(ThreadPool& threadPool)
+	: m_threadPool(threadPool), m_placeholderModel(createPlaceholderModel()), m_placeholderTexture(0), m_models(),
+	m_textures(), m_modelTasks(), m_textureTasks(),
+	m_uploadMsPerFrame(Locator::getConfig()->get("AssetUploadMsPerFrame", 2.0f)), m_log("ModelManager")
+{
+	// Grey until the real texture is uploaded
+	const uint8_t grey[3] = { 128, 128, 128 };
+	m_placeholderTexture = createTexture(grey, 1, 1, 3);
+}
 
 ModelManager::~ModelManager()
 {
-	for (const auto pair : m_textureIds) {
-		glDeleteTextures(1, &pair.second);
+	for (const auto& pair : m_textures) {
+		if (pair.second->state == READY)
+			glDeleteTextures(1, &pair.second->textureId);
 	}
+	glDeleteTextures(1, &m_placeholderTexture);
 }
 
-std::shared_ptr<Model> ModelManager::getModel(const std::string & modelFilename)
+std::shared_ptr<const ModelManager::ModelHandle> ModelManager::requestModel(const std::string& modelFilename)
 {
 	REQUIRE(!modelFilename.empty());
 	if (modelFilename.empty()) {
-		m_log.error("getTextureId", "No filename provided");
+		m_log.error("requestModel", "No filename provided");
 		return nullptr;
 	}
 
 	const auto it = m_models.find(modelFilename);
-	if (it == m_models.end()) {
-		std::vector<Mesh> meshes;
-		if (!fileloader::loadModel(modelFilename, meshes)) {
-			m_log.error("getModel", "Error loading file: " + modelFilename);
-			return nullptr;
-		}
+	if (it != m_models.end())
+		return it->second;
 
-		m_log.info("getModel", "Successfully loaded file: " + modelFilename);
-		m_models[modelFilename] = std::make_shared<Model>(std::move(meshes));
-		return m_models[modelFilename];
-	}
-	return it->second;
+	// Only parsing runs on the worker, meshes are uploaded by update
+	auto handle = std::make_shared<ModelHandle>(ModelHandle{ LOADING, m_placeholderModel });
+	auto result = m_threadPool.submit([modelFilename]() {
+		std::vector<MeshData> meshes;
+		if (!fileloader::loadModelData(modelFilename, meshes))
+			meshes.clear();
+		return meshes;
+	});
+	m_modelTasks.push_back(ModelTask{ modelFilename, handle, std::move(result) });
+	m_models.emplace(modelFilename, handle);
+	return handle;
 }
 
-unsigned int ModelManager::getTextureId(const std::string & textureFilename)
+std::shared_ptr<const ModelManager::TextureHandle> ModelManager::requestTexture(const std::string& textureFilename)
 {
 	REQUIRE(!textureFilename.empty());
 	if (textureFilename.empty()) {
-		m_log.error("getTextureId", "No filename provided");
-		return 0;
+		m_log.error("requestTexture", "No filename provided");
+		return nullptr;
 	}
 
-	const auto it = m_textureIds.find(textureFilename);
-	// If texture is not loaded yet, load it
-	if (it == m_textureIds.end()) {
-		GLuint textureId;
-		glGenTextures(1, &textureId);
-		glBindTexture(GL_TEXTURE_2D, textureId);
+	const auto it = m_textures.find(textureFilename);
+	if (it != m_textures.end())
+		return it->second;
 
-		// Set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// Set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	// Only decoding runs on the worker, texture is uploaded by update
+	auto handle = std::make_shared<TextureHandle>(TextureHandle{ LOADING, m_placeholderTexture });
+	auto result = m_threadPool.submit([textureFilename]() { return fileloader::loadTexture(textureFilename); });
+	m_textureTasks.push_back(TextureTask{ textureFilename, handle, std::move(result) });
+	m_textures.emplace(textureFilename, handle);
+	return handle;
+}
 
-		// Load fileloader data
-		std::unique_ptr<Image> txrData = fileloader::loadTexture(textureFilename);
-		if (txrData == nullptr) {
-			m_log.error("getTextureId", "Error loading file: " + textureFilename);
-			return 0;
+void ModelManager::update()
+{
+	const auto start = std::chrono::steady_clock::now();
+	const auto budgetLeft = [this, &start]() {
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() < m_uploadMsPerFrame;
+	};
+
+	// First upload always fits, so that assets bigger than the budget are uploaded too
+	bool uploaded = false;
+	for (auto it = m_textureTasks.begin(); it != m_textureTasks.end() && (!uploaded || budgetLeft());) {
+		if (!isReady(it->result)) {
+			++it;
+			continue;
+		}
+		uploadTexture(*it);
+		uploaded = true;
+		it = m_textureTasks.erase(it);
+	}
+	for (auto it = m_modelTasks.begin(); it != m_modelTasks.end() && (!uploaded || budgetLeft());) {
+		if (!isReady(it->result)) {
+			++it;
+			continue;
 		}
+		uploadModel(*it);
+		uploaded = true;
+		it = m_modelTasks.erase(it);
+	}
+}
 
-		const unsigned int width = txrData->getWidth();
-		const unsigned int height = txrData->getHeight();
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, txrData->getData());
-		glGenerateMipmap(GL_TEXTURE_2D);
-		txrData.reset();
+std::size_t ModelManager::getPendingCount() const
+{
+	return m_modelTasks.size() + m_textureTasks.size();
+}
+
+void ModelManager::uploadModel(ModelTask& task)
+{
+	// Exception thrown on the worker is rethrown here, so it fails the asset instead of the render thread
+	std::vector<MeshData> meshData;
+	try {
+		meshData = task.result.get();
+	}
+	catch (const std::exception& e) {
+		m_log.error("uploadModel", "Error loading file: " + task.filename + ". Exception thrown: " + e.what());
+		task.handle->state = FAILED;
+		return;
+	}
+	if (meshData.empty()) {
+		m_log.error("uploadModel", "Error loading file: " + task.filename);
+		task.handle->state = FAILED;
+		return;
+	}
+
+	std::vector<Mesh> meshes;
+	meshes.reserve(meshData.size());
+	for (MeshData& mesh : meshData) { meshes.emplace_back(std::move(mesh)); }
+	task.handle->model = std::make_shared<Model>(std::move(meshes));
+	task.handle->state = READY;
+	m_log.info("uploadModel", "Successfully loaded file: " + task.filename);
+}
 
-		m_log.info("getTextureId", "Successfully loaded file: " + textureFilename);
-		m_textureIds[textureFilename] = textureId;
-		return m_textureIds[textureFilename];
+void ModelManager::uploadTexture(TextureTask& task)
+{
+	std::unique_ptr<Image> image;
+	try {
+		image = task.result.get();
+	}
+	catch (const std::exception& e) {
+		m_log.error("uploadTexture", "Error loading file: " + task.filename + ". Exception thrown: " + e.what());
+		task.handle->state = FAILED;
+		return;
 	}
-	// Return texture that has already been loaded
-	return it->second;
+	if (image == nullptr) {
+		m_log.error("uploadTexture", "Error loading file: " + task.filename);
+		task.handle->state = FAILED;
+		return;
+	}
+
+	task.handle->textureId = createTexture(image->getData(), image->getWidth(), image->getHeight(),
+		image->getChannels());
+	task.handle->state = READY;
+	m_log.info("uploadTexture", "Successfully loaded file: " + task.filename);
 }
@@ -1,42 +1,119 @@
 #pragma once
 
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "Renderer/image.h"
 #include "Renderer/model.h"
+#include "Utility/threadpool.h"
 
+// Loads models and textures in the background and uploads them on the render thread
+//
+// Requests return a handle right away. Files are read and decoded on worker threads, and update uploads
+// finished assets to OpenGL within a per frame time budget. Until then a handle holds a placeholder model or
+// texture, so it can be drawn from the first frame. An asset that fails to load keeps its placeholder.
+// All functions must be called on the render thread
 class ModelManager {
 public:
 
+	// Loading state of a requested asset
+	enum ASSET_STATE {
+		LOADING,	//!< Handle holds placeholder until the asset is uploaded
+		READY,		//!< Handle holds the loaded asset
+		FAILED		//!< Asset could not be loaded, handle keeps placeholder
+	};
+
+	// Requested model, changed only by update
+	struct ModelHandle {
+		ASSET_STATE state;				//!< Loading state
+		std::shared_ptr<Model> model;	//!< Loaded model, or placeholder model unless state is READY
+	};
+
+	// Requested texture, changed only by update
+	struct TextureHandle {
+		ASSET_STATE state;			//!< Loading state
+		unsigned int textureId;		//!< OpenGL id of loaded texture, or of placeholder texture unless state is READY
+	};
+
 	/**
-	 * \brief Constructor
+	 * \brief Constructor. Creates placeholder model and texture
+	 * \param threadPool Worker threads that read and decode files
 	 */
-	ModelManager();
+	explicit ModelManager(ThreadPool& threadPool);
 
 	/**
-	 * \brief ~ModelManager
+	 * \brief Destructor. Deletes loaded textures. Loads still running on workers are discarded
 	 */
 	~ModelManager();
 
+	ModelManager(const ModelManager&) = delete;
+	ModelManager& operator=(const ModelManager&) = delete;
+
 	/**
-	 * \brief Used to get pointer to 3d model
-	 * \param modelFilename
+	 * \brief Used to request 3d model. Model is loaded once, later requests get the same handle
+	 * \param modelFilename Filename of model
 	 * \pre !modelFilename.empty()
-	 * \return Pointer to model, nullptr if it could not be loaded
+	 * \return Handle to model, nullptr if filename is empty
 	 */
-	std::shared_ptr<Model> getModel(const std::string& modelFilename);
+	std::shared_ptr<const ModelHandle> requestModel(const std::string& modelFilename);
 
 	/**
-	 * \brief Used to get OpenGL id of texture
-	 * \param textureFilename Filename
+	 * \brief Used to request texture. Texture is loaded once, later requests get the same handle
+	 * \param textureFilename Filename of texture
 	 * \pre !textureFilename.empty()
-	 * \return OpenGL texture id, 0 if texture could not be loaded
+	 * \return Handle to texture, nullptr if filename is empty
+	 */
+	std::shared_ptr<const TextureHandle> requestTexture(const std::string& textureFilename);
+
+	/**
+	 * \brief Called on every frame to upload assets that workers have finished. Uploads stop for the frame once
+	 *	AssetUploadMsPerFrame from config has passed, at least one finished asset is uploaded per call
+	 */
+	void update();
+
+	/**
+	 * \brief Used to get the count of requested assets that are not uploaded yet
+	 * \return Count of models and textures loading
 	 */
-	unsigned int getTextureId(const std::string& textureFilename);
+	std::size_t getPendingCount() const;
 
 private:
-	std::map<std::string, std::shared_ptr<Model>> m_models;	//!< Map pairing filename and pointer to model
-	std::map<std::string, unsigned int> m_textureIds;		//!< Map pairing filename and texture id
-	Logger m_log;											//!< Logger
+	// Model being loaded on a worker
+	struct ModelTask {
+		std::string filename;						//!< Filename of model
+		std::shared_ptr<ModelHandle> handle;		//!< Handle given to requesters
+		std::future<std::vector<MeshData>> result;	//!< Mesh data, empty if loading failed
+	};
+
+	// Texture being loaded on a worker
+	struct TextureTask {
+		std::string filename;						//!< Filename of texture
+		std::shared_ptr<TextureHandle> handle;		//!< Handle given to requesters
+		std::future<std::unique_ptr<Image>> result;	//!< Decoded image, nullptr if loading failed
+	};
+
+	ThreadPool& m_threadPool;											//!< Workers that read and decode files
+	std::shared_ptr<Model> m_placeholderModel;							//!< Model of handles that are not ready
+	unsigned int m_placeholderTexture;									//!< Texture of handles that are not ready
+	std::map<std::string, std::shared_ptr<ModelHandle>> m_models;		//!< Map pairing filename and model handle
+	std::map<std::string, std::shared_ptr<TextureHandle>> m_textures;	//!< Map pairing filename and texture handle
+	std::vector<ModelTask> m_modelTasks;								//!< Models loading, in request order
+	std::vector<TextureTask> m_textureTasks;							//!< Textures loading, in request order
+	float m_uploadMsPerFrame;											//!< Budget of upload time per update
+	Logger m_log;														//!< Logger
+
+	/**
+	 * \brief Used to upload finished model and update its handle
+	 * \param task Finished task
+	 */
+	void uploadModel(ModelTask& task);
+
+	/**
+	 * \brief Used to upload finished texture and update its handle
+	 * \param task Finished task
+	 */
+	void uploadTexture(TextureTask& task);
 };
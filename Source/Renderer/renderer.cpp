@@ -11,7 +11,7 @@
 
 Renderer::Renderer()
 	: m_window(nullptr), m_width(0), m_height(0), m_sizeChanged(false), 
-	m_shaderProgram(nullptr), m_log("Renderer") {}
+	m_shaderProgram(nullptr), m_chunkShaderProgram(nullptr), m_projection(), m_view(), m_viewDistance(0.0f), m_log("Renderer") {}
 
 Renderer::~Renderer()
 {
@@ -68,23 +68,22 @@ bool Renderer::vInitialize(std::string&& windowName, std::function<void(float)>&
 	glCullFace(GL_BACK);
 	glEnable(GL_CULL_FACE);
 
-	// Create shader program by attaching and linking shaders to it
-	m_shaderProgram = std::make_unique<ShaderProgram>();
-	if (!m_shaderProgram->attachShader("vertex_basic.vert", GL_VERTEX_SHADER)) {
-		m_log.fatal("vInitialize", "Could not attach shader: vertex_basic.vert");
+	// Create shader programs by attaching and linking shaders to them
+	m_shaderProgram = createShaderProgram("vertex_basic.vert", "fragment_basic.frag");
+	if (m_shaderProgram == nullptr)
 		return false;
-	}
-	if (!m_shaderProgram->attachShader("fragment_basic.frag", GL_FRAGMENT_SHADER)) {
-		m_log.fatal("vInitialize", "Could not attach shader: fragment_basic.frag");
+	m_chunkShaderProgram = createShaderProgram("vertex_chunk.vert", "fragment_chunk.frag");
+	if (m_chunkShaderProgram == nullptr)
 		return false;
-	}
 
-	// Translate scene in the reverse direction of where we want to move
-	m_projection = glm::perspective(glm::radians(45.0f),
-	                                static_cast<float>(width / height), 0.1f, 100.0f);
+	// Objects further than view distance are clipped, and culled on CPU by the frustum built from projection
+	m_viewDistance = Locator::getConfig()->get("ViewDistance", 500.0f);
+	updateProjection(width, height);
 
 	ENSURE(m_shaderProgram != nullptr);
 	ENSURE(m_shaderProgram->validate());
+	ENSURE(m_chunkShaderProgram != nullptr);
+	ENSURE(m_chunkShaderProgram->validate());
 	ENSURE(m_window != nullptr);
 	m_log.info("vInitialize", "OpenGL initialized succesfully");
 
@@ -120,7 +119,7 @@ void Renderer::vStartMainLoop()
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		// Set uniforms
-		m_shaderProgram->setMat4("projection", m_projection);
+		setMat4ToAll("projection", m_projection);
 
 		m_gameLogic(deltatime);
 
@@ -199,6 +198,7 @@ void Renderer::framebufferSizeCallback(int width, int height)
 	glViewport(0, 0, width, height);
 	glfwGetFramebufferSize(m_window, &m_width, &m_height);
 	m_sizeChanged = true;
+	updateProjection(width, height);
 
 	ENSURE(m_width == width);
 	ENSURE(m_height == height);
@@ -209,6 +209,22 @@ ShaderProgram* Renderer::vGetShaderProgram() const
 	return m_shaderProgram.get();
 }
 
+ShaderProgram* Renderer::vGetChunkShaderProgram() const
+{
+	return m_chunkShaderProgram.get();
+}
+
+void Renderer::vSetViewMatrix(const glm::mat4& view)
+{
+	m_view = view;
+	setMat4ToAll("view", view);
+}
+
+glm::mat4 Renderer::vGetViewProjectionMatrix() const
+{
+	return m_projection * m_view;
+}
+
 void Renderer::vGetCursorPosition(double& x, double& y) const
 {
 	REQUIRE(m_window);
@@ -239,7 +255,50 @@ bool Renderer::vKeyPressed(int key) const
 	return glfwGetKey(m_window, key) == GLFW_PRESS;
 }
 
+bool Renderer::vMouseButtonPressed(int button) const
+{
+	REQUIRE(m_window);
+	if (!m_window) {
+		m_log.error("vMouseButtonPressed", "OpenGL not properly initialized before calling vMouseButtonPressed");
+		return false;
+	}
+	return glfwGetMouseButton(m_window, button) == GLFW_PRESS;
+}
+
 bool Renderer::vWindowSizeChanged() const
 {
 	return m_sizeChanged;
 }
+
+std::unique_ptr<ShaderProgram> Renderer::createShaderProgram(const std::string& vertexShader, const std::string& fragmentShader) const
+{
+	auto program = std::make_unique<ShaderProgram>();
+	if (!program->attachShader(vertexShader, GL_VERTEX_SHADER)) {
+		m_log.fatal("createShaderProgram", "Could not attach shader: " + vertexShader);
+		return nullptr;
+	}
+	if (!program->attachShader(fragmentShader, GL_FRAGMENT_SHADER)) {
+		m_log.fatal("createShaderProgram", "Could not attach shader: " + fragmentShader);
+		return nullptr;
+	}
+	return program;
+}
+
+void Renderer::setMat4ToAll(const std::string& name, const glm::mat4& mat) const
+{
+	// Uniforms are set to the program in use, so activate each program before setting
+	for (const auto program : { m_shaderProgram.get(), m_chunkShaderProgram.get() }) {
+		program->use();
+		program->setMat4(name, mat);
+	}
+}
+
+void Renderer::updateProjection(int width, int height)
+{
+	// Minimized window has zero size, keep the previous aspect ratio then
+	if (width <= 0 || height <= 0)
+		return;
+
+	m_projection = glm::perspective(glm::radians(45.0f),
+	                                static_cast<float>(width) / static_cast<float>(height), 0.1f, m_viewDistance);
+}
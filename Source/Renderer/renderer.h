@@ -92,11 +92,29 @@ public:
 	void framebufferSizeCallback(int width, int height);
 
 	/**
-	 * \brief vGetShaderProgram
-	 * \return 
+	 * \brief Used to access the shader program of standalone models
+	 * \return Pointer to shader program. Does not pass ownership
 	 */
 	ShaderProgram* vGetShaderProgram() const override;
 
+	/**
+	 * \brief Used to access the shader program of chunk meshes
+	 * \return Pointer to shader program. Does not pass ownership
+	 */
+	ShaderProgram* vGetChunkShaderProgram() const override;
+
+	/**
+	 * \brief Used to set camera view matrix to every shader program
+	 * \param view View matrix of camera
+	 */
+	void vSetViewMatrix(const glm::mat4& view) override;
+
+	/**
+	 * \brief Used to get the matrix from world space to clip space, e.g. for frustum culling
+	 * \return Projection matrix multiplied by the view matrix set last
+	 */
+	glm::mat4 vGetViewProjectionMatrix() const override;
+
 	/**
 	 * \brief Used to access cursor position on screen
 	 * \param x Position on x axis
@@ -120,6 +138,14 @@ public:
 	 */
 	bool vKeyPressed(int key) const override;
 
+	/**
+	 * \brief Used to test if mouse button is pressed. Uses glfw mouse button codes
+	 * \param button glfw code of mouse button
+	 * \pre m_window
+	 * \return True if button state is pressed, otherwise false
+	 */
+	bool vMouseButtonPressed(int button) const override;
+
 	/**
 	 * \brief Used to test if window size has changed
 	 * \return True if window has changed, otherwise false
@@ -132,11 +158,36 @@ private:
 	int m_height;			//!< Window height
 	bool m_sizeChanged;		//!< Used to indicate if screen size has changed
 
-	std::unique_ptr<ShaderProgram> m_shaderProgram;	//!< Shader program used to access shaders
+	std::unique_ptr<ShaderProgram> m_shaderProgram;			//!< Shader program used to draw standalone models
+	std::unique_ptr<ShaderProgram> m_chunkShaderProgram;	//!< Shader program used to draw chunk meshes
 
 	glm::mat4 m_projection;	//!< Matrice From view space to clip space
+	glm::mat4 m_view;		//!< Matrice from world space to view space
+	float m_viewDistance;	//!< Distance of projection far plane
 
 	Logger m_log; //!< Logger
 
 	std::function<void(float)> m_gameLogic; //!< Function object used to update game logic
+
+	/**
+	 * \brief Used to create shader program from vertex and fragment shader files
+	 * \param vertexShader Vertex shader filename without filepath
+	 * \param fragmentShader Fragment shader filename without filepath
+	 * \return Pointer to linked shader program, nullptr if a shader could not be attached
+	 */
+	std::unique_ptr<ShaderProgram> createShaderProgram(const std::string& vertexShader, const std::string& fragmentShader) const;
+
+	/**
+	 * \brief Used to set matrix uniform to every shader program
+	 * \param name Uniform name
+	 * \param mat Matrix to be set
+	 */
+	void setMat4ToAll(const std::string& name, const glm::mat4& mat) const;
+
+	/**
+	 * \brief Used to recalculate projection matrix for window size
+	 * \param width Window width
+	 * \param height Window height
+	 */
+	void updateProjection(int width, int height);
 };
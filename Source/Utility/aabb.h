@@ -0,0 +1,23 @@
+#pragma once
+
+#pragma warning (push, 2)  // Temporarily set warning level 2
+#include <3rdParty/glm/glm.hpp>
+#pragma warning (pop)      // Restore back
+
+// Axis aligned bounding box in world coordinates
+struct AABB {
+	glm::vec3 min;	//!< Corner with the smallest coordinates
+	glm::vec3 max;	//!< Corner with the largest coordinates
+
+	/**
+	 * \brief Used to get the center point of the box
+	 * \return Center point
+	 */
+	glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+
+	/**
+	 * \brief Used to get the half size of the box on each axis
+	 * \return Distance from center to max corner
+	 */
+	glm::vec3 getExtents() const { return (max - min) * 0.5f; }
+};
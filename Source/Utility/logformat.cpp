@@ -0,0 +1,111 @@
+#include "Utility/logformat.h"
+
+#include <sstream>
+
+namespace {
+
+	/**
+	* \brief Used to read raw value from encoded arguments
+	* \param args Encoded arguments
+	* \param length Length of args in bytes
+	* \param position Read position, advanced past the value
+	* \param value Output, set only when enough bytes are left
+	* \return True if value was read, false if args ended
+	*/
+	template<typename T>
+	bool readRaw(const char* args, std::size_t length, std::size_t& position, T& value)
+	{
+		if (length - position < sizeof(T))
+			return false;
+		std::memcpy(&value, args + position, sizeof(T));
+		position += sizeof(T);
+		return true;
+	}
+
+	/**
+	* \brief Used to render next encoded argument
+	* \param args Encoded arguments
+	* \param length Length of args in bytes
+	* \param position Read position, advanced past the argument
+	* \param hex True to render integer in hexadecimal
+	* \param output Output, rendered argument is appended
+	* \return True if an argument was rendered, false if args ended or were invalid
+	*/
+	bool renderArg(const char* args, std::size_t length, std::size_t& position, bool hex, std::string& output)
+	{
+		unsigned char type = 0;
+		if (!readRaw(args, length, position, type))
+			return false;
+
+		switch (type) {
+		case logFormat::ARG_INT: {
+			int64_t value = 0;
+			if (!readRaw(args, length, position, value))
+				return false;
+			if (!hex) {
+				output += std::to_string(value);
+				return true;
+			}
+			std::stringstream ss;
+			ss << "0x" << std::hex << value;
+			output += ss.str();
+			return true;
+		}
+		case logFormat::ARG_UINT: {
+			uint64_t value = 0;
+			if (!readRaw(args, length, position, value))
+				return false;
+			if (!hex) {
+				output += std::to_string(value);
+				return true;
+			}
+			std::stringstream ss;
+			ss << "0x" << std::hex << value;
+			output += ss.str();
+			return true;
+		}
+		case logFormat::ARG_REAL: {
+			double value = 0.0;
+			if (!readRaw(args, length, position, value))
+				return false;
+			output += std::to_string(value);
+			return true;
+		}
+		case logFormat::ARG_STRING: {
+			uint32_t size = 0;
+			if (!readRaw(args, length, position, size) || length - position < size)
+				return false;
+			output.append(args + position, size);
+			position += size;
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+} // Anonymous namespace
+
+namespace logFormat {
+
+	std::string render(const char* format, const char* args, std::size_t length)
+	{
+		std::string output;
+		std::size_t position = 0;
+		bool argsLeft = true;
+		for (const char* c = format; *c != '\0'; ++c) {
+			const bool plain = c[0] == '{' && c[1] == '}';
+			const bool hex = c[0] == '{' && c[1] == 'x' && c[2] == '}';
+			if ((plain || hex) && argsLeft) {
+				argsLeft = renderArg(args, length, position, hex, output);
+				if (argsLeft) {
+					c += plain ? 1 : 2;
+					continue;
+				}
+			}
+			output.push_back(*c);
+		}
+		return output;
+	}
+
+} // namespace logFormat
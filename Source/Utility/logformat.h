@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// Encoding of log arguments as raw bytes, so that the text of a message is built only when it is written
+//
+// Every argument is a type byte followed by its value: integers widened to 64 bits, floating point numbers
+// as double and strings as 32-bit length and bytes. Format strings have a placeholder {} per argument, or {x}
+// for an integer in hexadecimal. Arguments are rendered the same way utility::toStr and utility::toHex do
+//
+// The same bytes are stored in binary log files, see Scripts/PyCppUtility/LogDecoder for the file layout
+namespace logFormat {
+
+	// Type byte of an encoded argument
+	enum ARG_TYPE : unsigned char {
+		ARG_INT = 1,	//!< int64_t
+		ARG_UINT = 2,	//!< uint64_t
+		ARG_REAL = 3,	//!< double
+		ARG_STRING = 4	//!< uint32_t length and bytes
+	};
+
+	/**
+	 * \brief Used to append raw bytes of value to buffer
+	 * \param buffer Output, bytes are appended
+	 * \param value Value to append
+	 */
+	template<typename T>
+	void appendRaw(std::string& buffer, const T& value)
+	{
+		buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	/**
+	 * \brief Used to append encoded string argument to buffer
+	 * \param buffer Output, type byte, length and text are appended
+	 * \param text Argument
+	 * \param length Length of text in bytes
+	 */
+	inline void appendString(std::string& buffer, const char* text, std::size_t length)
+	{
+		buffer.push_back(static_cast<char>(ARG_STRING));
+		appendRaw(buffer, static_cast<uint32_t>(length));
+		buffer.append(text, length);
+	}
+
+	inline void append(std::string& buffer, const std::string& value) { appendString(buffer, value.data(), value.size()); }
+	inline void append(std::string& buffer, const char* value) { appendString(buffer, value, std::strlen(value)); }
+
+	/**
+	 * \brief Used to append encoded number argument to buffer
+	 * \param buffer Output, type byte and value are appended
+	 * \param value Argument, bool, integer, enum or floating point
+	 */
+	template<typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value || std::is_enum<T>::value>>
+	void append(std::string& buffer, T value)
+	{
+#pragma warning(suppress: 4127)
+		if (std::is_floating_point<T>::value) {
+			buffer.push_back(static_cast<char>(ARG_REAL));
+			appendRaw(buffer, static_cast<double>(value));
+		}
+#pragma warning(suppress: 4127)
+		else if (std::is_signed<T>::value) {
+			buffer.push_back(static_cast<char>(ARG_INT));
+			appendRaw(buffer, static_cast<int64_t>(value));
+		}
+		else {
+			buffer.push_back(static_cast<char>(ARG_UINT));
+			appendRaw(buffer, static_cast<uint64_t>(value));
+		}
+	}
+
+	/**
+	 * \brief Used to encode arguments to buffer
+	 * \param buffer Output, cleared and filled with encoded arguments
+	 * \param args Arguments, strings and numbers
+	 */
+	template<typename... Args>
+	void encode(std::string& buffer, const Args&... args)
+	{
+		buffer.clear();
+		using expand = int[];
+		(void)expand{ 0, (append(buffer, args), 0)... };
+	}
+
+	/**
+	 * \brief Used to render format string with encoded arguments. Placeholders without an argument are kept
+	 *	as they are and arguments without a placeholder are ignored
+	 * \param format Format string with {} and {x} placeholders
+	 * \param args Encoded arguments
+	 * \param length Length of args in bytes
+	 * \return Rendered text
+	 */
+	std::string render(const char* format, const char* args, std::size_t length);
+
+} // namespace logFormat
@@ -1,12 +1,8 @@
 #include "Utility/logger.h"
 
-#include <algorithm>
-#include <vector>
-#include <chrono>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <unordered_map>
 
 #include <3rdParty/rapidjson/document.h>
 #include <3rdParty/rapidjson/istreamwrapper.h>
@@ -15,46 +11,116 @@
 #include "Utility/config.h"
 #include "Utility/contract.h"
 #include "Utility/locator.h"
+#include "Utility/logwriter.h"
 
 namespace {
 
+	// Settings of one logger in log config file
+	struct LoggerSettings {
+		std::string file;				//!< Name of log output file
+		unsigned int levels;			//!< Bit per enabled logging level
+		LogWriter::FILE_FORMAT format;	//!< Layout of log output file
+	};
+
+	using LogConfig = std::unordered_map<std::string, LoggerSettings>;	//!< Settings by logger name
+
 	/**
-	* \brief Used to get timestamp in string
-	* \return Timestamp in yyyy-mm-dd 24hh:mm:ss
+	* \brief Used to read settings of every logger from log config file. Invalid loggers are reported and skipped
+	* \param filename Name of log config file in log folder
+	* \return Settings by logger name, empty if file could not be parsed
 	*/
-	std::string datetime()
+	LogConfig parseLogConfig(const std::string& filename)
 	{
-		using namespace std::chrono;
-		const auto now = system_clock::now();
-		const std::time_t now_t = system_clock::to_time_t(now);
-		tm timeinfo;
-		localtime_s(&timeinfo, &now_t);
-		std::stringstream ss;
-		ss << std::put_time(&timeinfo, "%F %X");
-		return ss.str();
+		LogConfig config;
+		std::ifstream stream;
+		// Builder should not emit exceptions so wrap the 3rd party code in try catch
+		try {
+			// Open config file
+			stream.open(Locator::getConfig()->get("DataPath", std::string("../Data/")) + "Log/" + filename);
+			if (!stream.is_open()) {
+				std::cerr << "Could not open file " << filename << std::endl;
+				return config;
+			}
+
+			// Give ifstream to rapidjson stream wrapper
+			rapidjson::IStreamWrapper isw(stream);
+			rapidjson::Document doc;
+			doc.ParseStream(isw);
+			stream.close(); // rapidjson has parsed file so close stream
+							// Check for parse errors
+			if (doc.HasParseError()) {
+				std::cerr << "Parse error in: " << filename << std::endl;
+				return config;
+			}
+			// Validate root object
+			if (!doc.IsObject()) {
+				std::cerr << "Root object not valid in: " << filename << std::endl;
+				return config;
+			}
+
+			for (auto member = doc.MemberBegin(); member != doc.MemberEnd(); ++member) {
+				const std::string name = member->name.GetString();
+				const rapidjson::Value& obj = member->value;
+				// Check that log is object
+				if (!obj.IsObject()) {
+					std::cerr << name << " is not an object in: " << filename << std::endl;
+					continue;
+				}
+				// Check log object's properties
+				if (!obj.HasMember("file") || !obj["file"].IsString()) {
+					std::cerr << name << " does not have valid file property in: " << filename << std::endl;
+					continue;
+				}
+				if (!obj.HasMember("detail") || !obj["detail"].IsArray()) {
+					std::cerr << name << " does not have valid detail property in: " << filename << std::endl;
+					continue;
+				}
+
+				LoggerSettings settings{ obj["file"].GetString(), 0, LogWriter::TEXT };
+				auto a = obj["detail"].GetArray();
+				for (rapidjson::SizeType i = 0; i < a.Size(); ++i) { // Uses SizeType instead of size_t
+					if (!a[i].IsString()) continue;
+
+					const std::string str = a[i].GetString();
+					if (str == "DEBUG") settings.levels |= 1u << DEBUG;
+					else if (str == "INFO") settings.levels |= 1u << INFO;
+					else if (str == "WARN") settings.levels |= 1u << WARN;
+					else if (str == "ERROR") settings.levels |= 1u << ERR;
+					else if (str == "FATAL") settings.levels |= 1u << FATAL;
+				}
+
+				// Optional format property selects binary file, read with Scripts/PyCppUtility/LogDecoder
+				if (obj.HasMember("format") && obj["format"].IsString()
+					&& std::string(obj["format"].GetString()) == "binary")
+					settings.format = LogWriter::BINARY;
+
+				config.emplace(name, std::move(settings));
+			}
+		}
+		catch (...) {
+			std::cerr << "Something went terribly wrong in Logger builder" << std::endl;
+		}
+		return config;
 	}
 
 	/**
-	* \brief Used to transform logging level to string format
-	* \param lvl Logging level to be transformed
-	* \return String format of logging level
+	* \brief Used to get settings of every logger, parsed on first call. Thread safe
+	* \param filename Name of log config file in log folder, only the name given on first call is parsed
+	* \return Settings by logger name
 	*/
-	std::string levelToFixedString(LOGGING_LEVEL lvl)
+	const LogConfig& sharedLogConfig(const std::string& filename)
 	{
-		static const std::vector<std::string> lookup{ "DEBUG", "INFO", "WARN", "ERROR", "FATAL" };
-		auto output = lookup[lvl];
-		while (output.length() < 5) {
-			output += " ";
-		}
-		return output;
+		static const LogConfig config = parseLogConfig(filename);
+		return config;
 	}
 
 } // Anonymous namespace
 
-Logger::Logger() : m_enabledLogLevels(), m_logName(""), m_filename(""), m_configFilename("logconfig.json") {}
+Logger::Logger()
+	: m_enabledLevels(0), m_logName(""), m_filename(""), m_configFilename("logconfig.json"), m_fileIndex(-1), m_loggerId(-1) {}
 
 Logger::Logger(const std::string & name)
-	: m_enabledLogLevels(), m_logName(""),  m_filename(""), m_configFilename("logconfig.json")
+	: m_enabledLevels(0), m_logName(""),  m_filename(""), m_configFilename("logconfig.json"), m_fileIndex(-1), m_loggerId(-1)
 {
 	initialize(name);
 }
@@ -63,10 +129,12 @@ Logger::~Logger() {}
 
 Logger & Logger::operator=(Logger && rhs) noexcept
 {
-	m_enabledLogLevels = std::move(rhs.m_enabledLogLevels);
+	m_enabledLevels = rhs.m_enabledLevels;
 	m_logName = std::move(rhs.m_logName);
-	m_filename = std::move(m_filename);
-	m_configFilename = std::move(m_configFilename);
+	m_filename = std::move(rhs.m_filename);
+	m_configFilename = std::move(rhs.m_configFilename);
+	m_fileIndex = rhs.m_fileIndex;
+	m_loggerId = rhs.m_loggerId;
 	return *this;
 }
 
@@ -78,78 +146,25 @@ void Logger::initialize(const std::string & name)
 
 	m_logName = name;
 
-	std::ifstream stream;
-	// Builder should not emit exceptions so wrap the 3rd party code in try catch
-	try {
-		// Open config file
-		stream.open(Locator::getConfig()->get("DataPath", std::string("../Data/")) + "Log/" + m_configFilename);
-		if (!stream.is_open()) {
-			std::cerr << "Could not open file " << m_configFilename << std::endl;
-			return;
-		}
-
-		// Give ifstream to rapidjson stream wrapper
-		rapidjson::IStreamWrapper isw(stream);
-		rapidjson::Document doc;
-		doc.ParseStream(isw);
-		stream.close(); // rapidjson has parsed file so close stream
-						// Check for parse errors
-		if (doc.HasParseError()) {
-			std::cerr << "Parse error in: " << m_configFilename << std::endl;
-			return;
-		}
-		// Validate root object
-		if (!doc.IsObject()) {
-			std::cerr << "Root object not valid in: " << m_configFilename << std::endl;
-			return;
-		}
-		// Check if current log object exists
-		if (!doc.HasMember(m_logName.c_str())) {
-			std::cerr << "Object " << m_logName << " not found in: " << m_configFilename << std::endl;
-			return;
-		}
-
-		const rapidjson::Value& obj = doc[m_logName.c_str()];
-		// Check that current log is object
-		if (!obj.IsObject()) {
-			std::cerr << m_logName << " is not an object in: " << m_configFilename << std::endl;
-			return;
-		}
-		// Check current log object's properties
-		if (!obj.HasMember("file") && !obj["file"].IsString()) {
-			std::cerr << m_logName << " does not have valid file property in: " << m_configFilename << std::endl;
-			return;
-		}
-		if (!obj.HasMember("detail") && !obj["detail"].IsArray()) {
-			std::cerr << m_logName << " does not have valid detail property in: " << m_configFilename << std::endl;
-			return;
-		}
+	const LogConfig& config = sharedLogConfig(m_configFilename);
+	const auto it = config.find(m_logName);
+	if (it == config.end()) {
+		std::cerr << "Object " << m_logName << " not found in: " << m_configFilename << std::endl;
+		return;
+	}
 
-		// Initialize members
-		m_filename = obj["file"].GetString();
-		auto a = obj["detail"].GetArray();
-		for (rapidjson::SizeType i = 0; i < a.Size(); ++i) { // Uses SizeType instead of size_t
-			if (!a[i].IsString()) continue;
-
-			const std::string str = a[i].GetString();
-			if (str == "DEBUG") m_enabledLogLevels.emplace_back(DEBUG);
-			else if (str == "INFO") m_enabledLogLevels.emplace_back(INFO);
-			else if (str == "WARN") m_enabledLogLevels.emplace_back(WARN);
-			else if (str == "ERROR") m_enabledLogLevels.emplace_back(ERR);
-			else if (str == "FATAL") m_enabledLogLevels.emplace_back(FATAL);
-		}
+	// Initialize members
+	const LoggerSettings& settings = it->second;
+	m_filename = settings.file;
+	m_enabledLevels = settings.levels;
 
-		// Create or truncate log file
-		std::ofstream ofs(
-			Locator::getConfig()->get("DataPath", std::string("../Data/")) + "Log/" + m_filename, 
-			std::ofstream::out | std::ofstream::trunc);
+	// Create or truncate log file, kept open by the writer
+	m_loggerId = LogWriter::registerLogger(m_logName);
+	m_fileIndex = LogWriter::openFile(
+		Locator::getConfig()->get("DataPath", std::string("../Data/")) + "Log/" + m_filename, settings.format);
 
-		if (!ofs.is_open()) 
-			std::cerr << "Error opening file " << m_filename << " when truncating" << std::endl;
-	}
-	catch (...) {
-		std::cerr << "Something went terribly wrong in Logger builder" << std::endl;
-	}
+	if (m_fileIndex < 0)
+		std::cerr << "Error opening file " << m_filename << " when truncating" << std::endl;
 }
 
 void Logger::debug(const std::string & message) const
@@ -212,23 +227,20 @@ void Logger::fatal(const std::string & functionName, const std::string & message
 		write(FATAL, functionName + "(): " + message);
 }
 
-bool Logger::isEnabled(LOGGING_LEVEL lvl) const
+void Logger::write(LOGGING_LEVEL lvl, const std::string& message) const
 {
-	if (m_enabledLogLevels.empty()) 
-		return false;
-	
-	return std::find(m_enabledLogLevels.begin(), m_enabledLogLevels.end(), lvl) != m_enabledLogLevels.end();
+	if (m_fileIndex < 0) return;
+
+	LogWriter::write(m_fileIndex, m_loggerId, lvl, message);
+	if (lvl == FATAL)
+		LogWriter::flush();
 }
 
-void Logger::write(LOGGING_LEVEL lvl, const std::string& message) const
+void Logger::writeEncoded(LOGGING_LEVEL lvl, const char* functionName, const char* format, const std::string& args) const
 {
-	if (m_filename.empty()) return;
-	
-	std::ofstream ostream(Locator::getConfig()->get("DataPath", std::string("../Data/")) + "Log/" + m_filename, 
-		std::ofstream::out | std::ofstream::app);
+	if (m_fileIndex < 0) return;
 
-	if (!ostream.is_open()) {
-		return;
-	}
-	ostream << datetime() << " " << levelToFixedString(lvl) << " - " << message << std::endl;
+	LogWriter::writeEncoded(m_fileIndex, m_loggerId, lvl, functionName, format, args);
+	if (lvl == FATAL)
+		LogWriter::flush();
 }
@@ -1,10 +1,30 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
-#include <vector>
+#include <type_traits>
+#include <utility>
+
+#include "Utility/logformat.h"
 
 enum LOGGING_LEVEL { DEBUG, INFO, WARN, ERR, FATAL };
 
+// Levels below the minimum are compiled out, so that messages of release builds skip them without any check.
+// Define LOG_MIN_LEVEL as a LOGGING_LEVEL in project settings to override
+#ifndef LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define LOG_MIN_LEVEL DEBUG
+#else
+#define LOG_MIN_LEVEL INFO
+#endif
+#endif
+
+constexpr LOGGING_LEVEL MIN_LOGGING_LEVEL = LOG_MIN_LEVEL;	//!< Lowest level that can be enabled in logconfig.json
+
+// Used to tell lazy message formatters from messages, formatter is anything callable returning a string
+template<typename Formatter>
+using EnableIfFormatter = std::enable_if_t<!std::is_convertible<Formatter, std::string>::value>;
+
 class Logger {
 public:
 
@@ -55,6 +75,35 @@ public:
 	 */
 	void debug(const std::string& functionName, const std::string& message) const;
 
+	/**
+	 * \brief Used to write debug level message to log. Formatter is not called if debug level is not active in
+	 *	logconfig.json or is below MIN_LOGGING_LEVEL
+	 * \param functionName Function name written to file
+	 * \param formatter Callable returning entry to be written to log
+	 */
+	template<typename Formatter, typename = EnableIfFormatter<Formatter>>
+	void debug(const char* functionName, Formatter&& formatter) const
+	{
+		if (isEnabled(DEBUG))
+			write(DEBUG, std::string(functionName) + "(): " + std::forward<Formatter>(formatter)());
+	}
+
+	/**
+	 * \brief Used to write debug level message to log. Text is rendered from format and arguments only when it is
+	 *	written to a text log file, and not at all if debug level is not active in logconfig.json
+	 * \param functionName Function name written to file, a string literal as only its address is kept
+	 * \param format Format string with placeholder {} or {x} (hexadecimal) per argument, a string literal as only its
+	 *	address is kept until the record is written
+	 * \param arg First argument
+	 * \param args Other arguments, strings and numbers
+	 */
+	template<std::size_t N, std::size_t M, typename Arg, typename... Args>
+	void debug(const char (&functionName)[N], const char (&format)[M], const Arg& arg, const Args&... args) const
+	{
+		if (isEnabled(DEBUG))
+			writeFormat(DEBUG, functionName, format, arg, args...);
+	}
+
 	/**
 	 * \brief Used to write info level message to log. Does nothing if info level is not active in logconfig.json
 	 * \param message Entry to be written to log
@@ -68,6 +117,35 @@ public:
 	 */
 	void info(const std::string& functionName, const std::string& message) const;
 
+	/**
+	 * \brief Used to write info level message to log. Formatter is not called if info level is not active in
+	 *	logconfig.json or is below MIN_LOGGING_LEVEL
+	 * \param functionName Function name written to file
+	 * \param formatter Callable returning entry to be written to log
+	 */
+	template<typename Formatter, typename = EnableIfFormatter<Formatter>>
+	void info(const char* functionName, Formatter&& formatter) const
+	{
+		if (isEnabled(INFO))
+			write(INFO, std::string(functionName) + "(): " + std::forward<Formatter>(formatter)());
+	}
+
+	/**
+	 * \brief Used to write info level message to log. Text is rendered from format and arguments only when it is
+	 *	written to a text log file, and not at all if info level is not active in logconfig.json
+	 * \param functionName Function name written to file, a string literal as only its address is kept
+	 * \param format Format string with placeholder {} or {x} (hexadecimal) per argument, a string literal as only its
+	 *	address is kept until the record is written
+	 * \param arg First argument
+	 * \param args Other arguments, strings and numbers
+	 */
+	template<std::size_t N, std::size_t M, typename Arg, typename... Args>
+	void info(const char (&functionName)[N], const char (&format)[M], const Arg& arg, const Args&... args) const
+	{
+		if (isEnabled(INFO))
+			writeFormat(INFO, functionName, format, arg, args...);
+	}
+
 	/**
 	 * \brief Used to write warn level message to log. Does nothing if warn level is not active in logconfig.json
 	 * \param message Entry to be written to log
@@ -81,6 +159,35 @@ public:
 	 */
 	void warn(const std::string& functionName, const std::string& message) const;
 
+	/**
+	 * \brief Used to write warn level message to log. Formatter is not called if warn level is not active in
+	 *	logconfig.json or is below MIN_LOGGING_LEVEL
+	 * \param functionName Function name written to file
+	 * \param formatter Callable returning entry to be written to log
+	 */
+	template<typename Formatter, typename = EnableIfFormatter<Formatter>>
+	void warn(const char* functionName, Formatter&& formatter) const
+	{
+		if (isEnabled(WARN))
+			write(WARN, std::string(functionName) + "(): " + std::forward<Formatter>(formatter)());
+	}
+
+	/**
+	 * \brief Used to write warn level message to log. Text is rendered from format and arguments only when it is
+	 *	written to a text log file, and not at all if warn level is not active in logconfig.json
+	 * \param functionName Function name written to file, a string literal as only its address is kept
+	 * \param format Format string with placeholder {} or {x} (hexadecimal) per argument, a string literal as only its
+	 *	address is kept until the record is written
+	 * \param arg First argument
+	 * \param args Other arguments, strings and numbers
+	 */
+	template<std::size_t N, std::size_t M, typename Arg, typename... Args>
+	void warn(const char (&functionName)[N], const char (&format)[M], const Arg& arg, const Args&... args) const
+	{
+		if (isEnabled(WARN))
+			writeFormat(WARN, functionName, format, arg, args...);
+	}
+
 	/**
 	 * \brief Used to write error level message to log. Does nothing if error level is not active in logconfig.json
 	 * \param message Entry to be written to log
@@ -94,6 +201,35 @@ public:
 	 */
 	void error(const std::string& functionName, const std::string& message) const;
 
+	/**
+	 * \brief Used to write error level message to log. Formatter is not called if error level is not active in
+	 *	logconfig.json or is below MIN_LOGGING_LEVEL
+	 * \param functionName Function name written to file
+	 * \param formatter Callable returning entry to be written to log
+	 */
+	template<typename Formatter, typename = EnableIfFormatter<Formatter>>
+	void error(const char* functionName, Formatter&& formatter) const
+	{
+		if (isEnabled(ERR))
+			write(ERR, std::string(functionName) + "(): " + std::forward<Formatter>(formatter)());
+	}
+
+	/**
+	 * \brief Used to write error level message to log. Text is rendered from format and arguments only when it is
+	 *	written to a text log file, and not at all if error level is not active in logconfig.json
+	 * \param functionName Function name written to file, a string literal as only its address is kept
+	 * \param format Format string with placeholder {} or {x} (hexadecimal) per argument, a string literal as only its
+	 *	address is kept until the record is written
+	 * \param arg First argument
+	 * \param args Other arguments, strings and numbers
+	 */
+	template<std::size_t N, std::size_t M, typename Arg, typename... Args>
+	void error(const char (&functionName)[N], const char (&format)[M], const Arg& arg, const Args&... args) const
+	{
+		if (isEnabled(ERR))
+			writeFormat(ERR, functionName, format, arg, args...);
+	}
+
 	/**
 	 * \brief Used to write fatal level message to log. Does nothing if fatal level is not active in logconfig.json
 	 * \param message Entry to be written to log
@@ -107,23 +243,83 @@ public:
 	 */
 	void fatal(const std::string& functionName, const std::string& message) const;
 
+	/**
+	 * \brief Used to write fatal level message to log. Formatter is not called if fatal level is not active in
+	 *	logconfig.json or is below MIN_LOGGING_LEVEL
+	 * \param functionName Function name written to file
+	 * \param formatter Callable returning entry to be written to log
+	 */
+	template<typename Formatter, typename = EnableIfFormatter<Formatter>>
+	void fatal(const char* functionName, Formatter&& formatter) const
+	{
+		if (isEnabled(FATAL))
+			write(FATAL, std::string(functionName) + "(): " + std::forward<Formatter>(formatter)());
+	}
+
+	/**
+	 * \brief Used to write fatal level message to log. Text is rendered from format and arguments only when it is
+	 *	written to a text log file, and not at all if fatal level is not active in logconfig.json
+	 * \param functionName Function name written to file, a string literal as only its address is kept
+	 * \param format Format string with placeholder {} or {x} (hexadecimal) per argument, a string literal as only its
+	 *	address is kept until the record is written
+	 * \param arg First argument
+	 * \param args Other arguments, strings and numbers
+	 */
+	template<std::size_t N, std::size_t M, typename Arg, typename... Args>
+	void fatal(const char (&functionName)[N], const char (&format)[M], const Arg& arg, const Args&... args) const
+	{
+		if (isEnabled(FATAL))
+			writeFormat(FATAL, functionName, format, arg, args...);
+	}
+
+	/**
+	 * \brief Called to see if logging level is enabled for logger, e.g. before building an expensive message
+	 * \param lvl Logging level to be tested
+	 * \return True if level is enabled and not below MIN_LOGGING_LEVEL, otherwise False
+	 */
+	bool isEnabled(LOGGING_LEVEL lvl) const
+	{
+		return lvl >= MIN_LOGGING_LEVEL && (m_enabledLevels & (1u << lvl)) != 0;
+	}
+
 private:
-	std::vector<LOGGING_LEVEL> m_enabledLogLevels;	//!< Logging levels enabled for the logger
+	unsigned int m_enabledLevels;					//!< Bit per logging level enabled for the logger
 	std::string m_logName;							//!< Name of logger, used to fetch data from log config file
 	std::string m_filename;							//!< Name of log output file
 	std::string m_configFilename;					//!< Name of config file for logger
+	int m_fileIndex;								//!< Index of log file in LogWriter, -1 if not opened
+	int m_loggerId;									//!< Id of logger in LogWriter
 
 	/**
-	 * \brief Called to see if logging level is enabled for logger
-	 * \param lvl Logging level to be tested
-	 * \return True if level is enabled, otherwise False
+	 * \brief Used to push entry to LogWriter. Fatal entries are flushed to file before returning
+	 * \param lvl Log level to be written in log entry
+	 * \param message Entry to be written to log
 	 */
-	bool isEnabled(LOGGING_LEVEL lvl) const;
+	void write(LOGGING_LEVEL lvl, const std::string& message) const;
 
 	/**
-	 * \brief Used to write log file
+	 * \brief Used to encode arguments and push entry to LogWriter
 	 * \param lvl Log level to be written in log entry
-	 * \param message Entry to be written to log
+	 * \param functionName Function name written to file
+	 * \param format Format string
+	 * \param args Arguments
 	 */
-	void write(LOGGING_LEVEL lvl, const std::string& message) const;
+	template<typename... Args>
+	void writeFormat(LOGGING_LEVEL lvl, const char* functionName, const char* format, const Args&... args) const
+	{
+		// Capacity is kept between calls, so encoding does not allocate once the buffer has grown
+		thread_local std::string buffer;
+		logFormat::encode(buffer, args...);
+		writeEncoded(lvl, functionName, format, buffer);
+	}
+
+	/**
+	 * \brief Used to push entry with encoded arguments to LogWriter. Fatal entries are flushed to file before
+	 *	returning
+	 * \param lvl Log level to be written in log entry
+	 * \param functionName Function name written to file
+	 * \param format Format string
+	 * \param args Encoded arguments
+	 */
+	void writeEncoded(LOGGING_LEVEL lvl, const char* functionName, const char* format, const std::string& args) const;
 };
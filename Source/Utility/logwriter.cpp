@@ -0,0 +1,411 @@
+#include "Utility/logwriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "Utility/logformat.h"
+
+namespace {
+
+	const char* const levelNames[] = { "DEBUG", "INFO ", "WARN ", "ERROR", "FATAL" };	//!< Fixed width level names
+
+	// Writer is a function local static, so this tells whether it can still be used during static destruction.
+	// Set when destruction starts, records pushed after that go to std::cerr
+	std::atomic<bool> writerStopped(false);
+
+	const char binaryMagic[8] = { 'B', 'L', 'O', 'C', 'K', 'L', 'O', 'G' };	//!< Start of binary log file
+	const uint32_t binaryVersion = 1;											//!< Layout version of binary file
+
+	// Type byte of a record in binary file
+	enum BINARY_RECORD : unsigned char {
+		RECORD_LOGGER = 1,		//!< uint16 id, uint16 length, name
+		RECORD_STRING = 2,		//!< uint32 id, uint32 length, text
+		RECORD_MESSAGE = 3,		//!< int64 ticks, uint16 logger, uint8 level, uint32 length, text
+		RECORD_FORMATTED = 4	//!< int64 ticks, uint16 logger, uint8 level, uint32 function id, uint32 format id,
+								//!< uint32 length, encoded arguments
+	};
+
+	/**
+	* \brief Used to write raw bytes of value to binary file
+	* \param stream Binary file
+	* \param value Value to write
+	*/
+	template<typename T>
+	void writeValue(std::ofstream& stream, const T& value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	/**
+	* \brief Used to copy bytes into ring buffer, wrapping around at the end
+	* \param buffer Ring buffer of LogWriter::RING_SIZE bytes
+	* \param position Byte count from the start of the ring
+	* \param data Bytes to copy
+	* \param size Count of bytes
+	*/
+	void copyIn(char* buffer, std::size_t position, const void* data, std::size_t size)
+	{
+		const std::size_t offset = position % LogWriter::RING_SIZE;
+		const std::size_t first = std::min(size, LogWriter::RING_SIZE - offset);
+		std::memcpy(buffer + offset, data, first);
+		std::memcpy(buffer, static_cast<const char*>(data) + first, size - first);
+	}
+
+	/**
+	* \brief Used to copy bytes out of ring buffer, wrapping around at the end
+	* \param buffer Ring buffer of LogWriter::RING_SIZE bytes
+	* \param position Byte count from the start of the ring
+	* \param data Output, size bytes
+	* \param size Count of bytes
+	*/
+	void copyOut(const char* buffer, std::size_t position, void* data, std::size_t size)
+	{
+		const std::size_t offset = position % LogWriter::RING_SIZE;
+		const std::size_t first = std::min(size, LogWriter::RING_SIZE - offset);
+		std::memcpy(data, buffer + offset, first);
+		std::memcpy(static_cast<char*>(data) + first, buffer, size - first);
+	}
+
+} // Anonymous namespace
+
+const std::size_t LogWriter::RING_SIZE;
+const int LogWriter::FLUSH_INTERVAL_MS;
+
+LogWriter::LogWriter()
+	: m_rings(), m_files(), m_loggerNames(), m_policy(DROP), m_dropped(0), m_wake(false), m_flushRequested(0),
+	m_flushCompleted(0), m_stopping(false), m_pushing(0), m_mutex(), m_fileMtx(), m_condition(), m_flushed(),
+	m_cachedTime(0), m_text(), m_cachedDatetime(), m_thread()
+{
+	m_thread = std::thread(&LogWriter::writerLoop, this);
+}
+
+LogWriter::~LogWriter()
+{
+	// Pushes that started before the flag are in their rings before the writer drains them the last time
+	writerStopped = true;
+	while (m_pushing > 0)
+		std::this_thread::yield();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_condition.notify_all();
+	m_thread.join();
+}
+
+int LogWriter::openFile(const std::string& path, FILE_FORMAT format)
+{
+	if (writerStopped)
+		return -1;
+
+	LogWriter& writer = instance();
+	std::lock_guard<std::mutex> lock(writer.m_fileMtx);
+	const auto it = std::find_if(writer.m_files.begin(), writer.m_files.end(),
+		[&path](const LogFile& file) { return file.path == path; });
+	if (it != writer.m_files.end())
+		return static_cast<int>(it - writer.m_files.begin());
+
+	const auto mode = format == BINARY ? std::ofstream::out | std::ofstream::trunc | std::ofstream::binary
+		: std::ofstream::out | std::ofstream::trunc;
+	LogFile file{ path, format, std::make_unique<std::ofstream>(path, mode), {}, {} };
+	if (!file.stream->is_open())
+		return -1;
+
+	// Decoder needs the tick length to turn timestamps to dates
+	if (format == BINARY) {
+		file.stream->write(binaryMagic, sizeof(binaryMagic));
+		writeValue(*file.stream, binaryVersion);
+		writeValue(*file.stream, static_cast<int64_t>(std::chrono::system_clock::period::num));
+		writeValue(*file.stream, static_cast<int64_t>(std::chrono::system_clock::period::den));
+	}
+	writer.m_files.push_back(std::move(file));
+	return static_cast<int>(writer.m_files.size() - 1);
+}
+
+int LogWriter::registerLogger(const std::string& name)
+{
+	if (writerStopped)
+		return -1;
+
+	LogWriter& writer = instance();
+	std::lock_guard<std::mutex> lock(writer.m_fileMtx);
+	const auto it = std::find(writer.m_loggerNames.begin(), writer.m_loggerNames.end(), name);
+	if (it != writer.m_loggerNames.end())
+		return static_cast<int>(it - writer.m_loggerNames.begin());
+	writer.m_loggerNames.push_back(name);
+	return static_cast<int>(writer.m_loggerNames.size() - 1);
+}
+
+void LogWriter::write(int file, int logger, LOGGING_LEVEL lvl, const std::string& message)
+{
+	if (writerStopped) {
+		std::cerr << levelNames[lvl] << " - " << message << std::endl;
+		return;
+	}
+
+	const RecordHeader header{ nowTicks(), file, logger, lvl, nullptr, nullptr, std::min(message.size(), RING_SIZE / 2) };
+	LogWriter& writer = instance();
+	if (!writer.push(writer.threadRing(), header, message.data()))
+		std::cerr << levelNames[lvl] << " - " << message << std::endl;
+}
+
+void LogWriter::writeEncoded(int file, int logger, LOGGING_LEVEL lvl, const char* functionName, const char* format,
+	const std::string& args)
+{
+	if (writerStopped) {
+		std::cerr << levelNames[lvl] << " - " << functionName << "(): "
+			<< logFormat::render(format, args.data(), args.size()) << std::endl;
+		return;
+	}
+
+	// Arguments cut in the middle would be invalid, so too long ones are dropped and the format kept
+	const RecordHeader header{ nowTicks(), file, logger, lvl, functionName, format,
+		args.size() <= RING_SIZE / 2 ? args.size() : 0 };
+	LogWriter& writer = instance();
+	if (!writer.push(writer.threadRing(), header, args.data())) {
+		std::cerr << levelNames[lvl] << " - " << functionName << "(): "
+			<< logFormat::render(format, args.data(), args.size()) << std::endl;
+	}
+}
+
+void LogWriter::flush()
+{
+	if (writerStopped)
+		return;
+
+	LogWriter& writer = instance();
+	std::unique_lock<std::mutex> lock(writer.m_mutex);
+	const unsigned long long request = ++writer.m_flushRequested;
+	writer.m_condition.notify_all();
+	writer.m_flushed.wait(lock, [&writer, request]() { return writer.m_flushCompleted >= request; });
+}
+
+void LogWriter::setOverflowPolicy(OVERFLOW_POLICY policy)
+{
+	if (!writerStopped)
+		instance().m_policy = policy;
+}
+
+unsigned long long LogWriter::getDroppedCount()
+{
+	return writerStopped ? 0 : instance().m_dropped.load();
+}
+
+long long LogWriter::nowTicks()
+{
+	return static_cast<long long>(std::chrono::system_clock::now().time_since_epoch().count());
+}
+
+LogWriter& LogWriter::instance()
+{
+	static LogWriter writer;
+	return writer;
+}
+
+LogWriter::Ring& LogWriter::threadRing()
+{
+	// Writer keeps the ring until it has written the records left by an exited thread
+	struct Handle {
+		~Handle() { if (ring) ring->closed = true; }
+		std::shared_ptr<Ring> ring;
+	};
+	thread_local Handle handle;
+
+	if (!handle.ring) {
+		handle.ring = std::make_shared<Ring>();
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_rings.push_back(handle.ring);
+	}
+	return *handle.ring;
+}
+
+bool LogWriter::push(Ring& ring, const RecordHeader& header, const char* text)
+{
+	// Destructor waits for pushes in progress, so a record is either in the ring before the last drain or rejected
+	struct Pushing {
+		explicit Pushing(std::atomic<unsigned int>& pushing) : count(pushing) { ++count; }
+		~Pushing() { --count; }
+		std::atomic<unsigned int>& count;
+	} pushing(m_pushing);
+	if (writerStopped)
+		return false;
+
+	const std::size_t size = sizeof(RecordHeader) + header.length;
+	const std::size_t head = ring.head.load(std::memory_order_relaxed);
+
+	// Only this thread advances head, so free space can only grow while waiting
+	while (RING_SIZE - (head - ring.tail.load(std::memory_order_acquire)) < size) {
+		if (header.lvl < ERR && m_policy == DROP) {
+			++ring.dropped;
+			++m_dropped;
+			return true;
+		}
+
+		// Writer makes no more space once it is stopping
+		if (writerStopped)
+			return false;
+		m_wake = true;
+		m_condition.notify_one();
+		std::this_thread::yield();
+	}
+
+	copyIn(ring.buffer.get(), head, &header, sizeof(RecordHeader));
+	copyIn(ring.buffer.get(), head + sizeof(RecordHeader), text, header.length);
+	ring.head.store(head + size, std::memory_order_release);
+
+	// Writer is woken up early only when the ring passes half full, otherwise it wakes up on its interval
+	const std::size_t used = head + size - ring.tail.load(std::memory_order_relaxed);
+	if (used > RING_SIZE / 2 && used - size <= RING_SIZE / 2) {
+		m_wake = true;
+		m_condition.notify_one();
+	}
+	return true;
+}
+
+void LogWriter::writerLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;) {
+		m_condition.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS),
+			[this]() { return m_stopping || m_wake || m_flushRequested != m_flushCompleted; });
+		m_wake = false;
+		const bool stopping = m_stopping;
+		const unsigned long long flushRequest = m_flushRequested;
+		const auto rings = m_rings;
+		lock.unlock();
+
+		// Logging threads keep pushing while records are written
+		{
+			std::lock_guard<std::mutex> fileLock(m_fileMtx);
+			for (const auto& ring : rings)
+				drain(*ring);
+			for (auto& file : m_files)
+				file.stream->flush();
+		}
+
+		lock.lock();
+		m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(), [](const std::shared_ptr<Ring>& ring) {
+			return ring->closed && ring->head.load() == ring->tail.load();
+		}), m_rings.end());
+		m_flushCompleted = flushRequest;
+		m_flushed.notify_all();
+		if (stopping)
+			return;
+	}
+}
+
+void LogWriter::drain(Ring& ring)
+{
+	std::size_t tail = ring.tail.load(std::memory_order_relaxed);
+	const std::size_t head = ring.head.load(std::memory_order_acquire);
+	std::string text;
+	while (tail != head) {
+		RecordHeader header;
+		copyOut(ring.buffer.get(), tail, &header, sizeof(RecordHeader));
+		text.resize(header.length);
+		copyOut(ring.buffer.get(), tail + sizeof(RecordHeader), &text[0], header.length);
+		tail += sizeof(RecordHeader) + header.length;
+		ring.tail.store(tail, std::memory_order_release);
+
+		// Drops are reported before the next record of the thread
+		const unsigned long long dropped = ring.dropped.exchange(0);
+		if (dropped > 0) {
+			const std::string report = "LogWriter(): " + std::to_string(dropped) + " records dropped, log buffer was full";
+			const RecordHeader reportHeader{ header.ticks, header.file, header.logger, WARN, nullptr, nullptr,
+				report.size() };
+			writeRecord(reportHeader, report.data());
+		}
+		writeRecord(header, text.data());
+	}
+}
+
+void LogWriter::writeRecord(const RecordHeader& header, const char* data)
+{
+	if (header.file < 0 || static_cast<std::size_t>(header.file) >= m_files.size())
+		return;
+
+	LogFile& file = m_files[header.file];
+	if (file.format == BINARY)
+		writeBinary(file, header, data);
+	else
+		writeLine(file, header, data);
+}
+
+void LogWriter::writeLine(LogFile& file, const RecordHeader& header, const char* data)
+{
+	// Records of the same second share the formatted time
+	const std::time_t time = std::chrono::system_clock::to_time_t(
+		std::chrono::system_clock::time_point(std::chrono::system_clock::duration(header.ticks)));
+	if (time != m_cachedTime || m_cachedDatetime.empty()) {
+		tm timeinfo;
+		localtime_s(&timeinfo, &time);
+		std::stringstream ss;
+		ss << std::put_time(&timeinfo, "%F %X");
+		m_cachedTime = time;
+		m_cachedDatetime = ss.str();
+	}
+
+	std::ofstream& stream = *file.stream;
+	stream << m_cachedDatetime << " " << levelNames[header.lvl] << " - ";
+	if (header.format == nullptr) {
+		stream.write(data, static_cast<std::streamsize>(header.length));
+	}
+	else {
+		m_text = logFormat::render(header.format, data, header.length);
+		stream << header.functionName << "(): " << m_text;
+	}
+	stream << '\n';
+}
+
+void LogWriter::writeBinary(LogFile& file, const RecordHeader& header, const char* data)
+{
+	std::ofstream& stream = *file.stream;
+	const auto logger = static_cast<std::size_t>(header.logger);
+	if (logger >= file.loggersDefined.size())
+		file.loggersDefined.resize(logger + 1, false);
+	if (!file.loggersDefined[logger] && logger < m_loggerNames.size()) {
+		const std::string& name = m_loggerNames[logger];
+		writeValue(stream, static_cast<unsigned char>(RECORD_LOGGER));
+		writeValue(stream, static_cast<uint16_t>(logger));
+		writeValue(stream, static_cast<uint16_t>(name.size()));
+		stream.write(name.data(), static_cast<std::streamsize>(name.size()));
+		file.loggersDefined[logger] = true;
+	}
+
+	// Strings are defined before the record using them, so the decoder reads the file in one pass
+	const bool formatted = header.format != nullptr;
+	const uint32_t functionId = formatted ? stringId(file, header.functionName) : 0;
+	const uint32_t formatId = formatted ? stringId(file, header.format) : 0;
+
+	writeValue(stream, static_cast<unsigned char>(formatted ? RECORD_FORMATTED : RECORD_MESSAGE));
+	writeValue(stream, static_cast<int64_t>(header.ticks));
+	writeValue(stream, static_cast<uint16_t>(logger));
+	writeValue(stream, static_cast<unsigned char>(header.lvl));
+	if (formatted) {
+		writeValue(stream, functionId);
+		writeValue(stream, formatId);
+	}
+	writeValue(stream, static_cast<uint32_t>(header.length));
+	stream.write(data, static_cast<std::streamsize>(header.length));
+}
+
+uint32_t LogWriter::stringId(LogFile& file, const char* text)
+{
+	const auto it = file.stringIds.find(text);
+	if (it != file.stringIds.end())
+		return it->second;
+
+	const auto id = static_cast<uint32_t>(file.stringIds.size());
+	const auto length = static_cast<uint32_t>(std::strlen(text));
+	file.stringIds.emplace(text, id);
+	writeValue(*file.stream, static_cast<unsigned char>(RECORD_STRING));
+	writeValue(*file.stream, id);
+	writeValue(*file.stream, length);
+	file.stream->write(text, static_cast<std::streamsize>(length));
+	return id;
+}
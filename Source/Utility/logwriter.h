@@ -0,0 +1,238 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Utility/logger.h"
+
+// Writes log records to files on a background thread, so that logging costs the caller only a copy to memory
+//
+// Every thread that logs gets a ring buffer of RING_SIZE bytes that only it writes and only the writer thread
+// reads, so pushing a record takes no lock. Writer thread wakes up every FLUSH_INTERVAL_MS, when a ring is
+// half full or when a flush is requested, appends the records of every ring to log files that stay open and
+// flushes the files. Memory used is bounded by RING_SIZE per logging thread
+//
+// When a ring is full, records below ERR are dropped or the caller waits for space, depending on the overflow
+// policy. ERR and FATAL records always wait. Dropped records are counted and reported in the log file of the
+// next record written by the same thread. Records are written and files closed on shutdown, i.e. when static
+// objects are destroyed, and records pushed after that go to std::cerr
+//
+// Records pushed with writeEncoded carry a static format string and encoded arguments instead of text. Text files
+// get the rendered line, binary files get the record as it is with a tick timestamp and ids of the logger and
+// strings, which Scripts/PyCppUtility/LogDecoder turns back into text lines
+class LogWriter {
+public:
+	// Layout of log file
+	enum FILE_FORMAT {
+		TEXT,	//!< Human readable lines
+		BINARY	//!< Compact records, read with the decoder
+	};
+
+	// What to do with a record below ERR when the ring of the thread is full
+	enum OVERFLOW_POLICY {
+		DROP,	//!< Record is dropped and counted
+		BLOCK	//!< Caller waits until the writer thread has made space
+	};
+
+	static const std::size_t RING_SIZE = 64 * 1024;	//!< Bytes of ring buffer per logging thread
+	static const int FLUSH_INTERVAL_MS = 200;			//!< Longest time a record waits before it is in the file
+
+	~LogWriter();
+
+	LogWriter(const LogWriter&) = delete;
+	LogWriter& operator=(const LogWriter&) = delete;
+
+	/**
+	 * \brief Used to open log file for writing. File is truncated when it is opened the first time, later calls
+	 *	with the same path return the same file in the format it was first opened with. Thread safe
+	 * \param path Path of log file
+	 * \param format Layout of the file
+	 * \return Index of file used with write, -1 if file could not be opened
+	 */
+	static int openFile(const std::string& path, FILE_FORMAT format);
+
+	/**
+	 * \brief Used to get the id of a logger, written to binary files. Thread safe
+	 * \param name Name of logger
+	 * \return Id of logger, same for every call with the same name
+	 */
+	static int registerLogger(const std::string& name);
+
+	/**
+	 * \brief Used to push record to be written to log file. Thread safe, does not lock unless the ring of the
+	 *	thread is full and the record waits
+	 * \param file Index returned by openFile
+	 * \param logger Id returned by registerLogger
+	 * \param lvl Logging level of record
+	 * \param message Text of record, cut to half of RING_SIZE
+	 */
+	static void write(int file, int logger, LOGGING_LEVEL lvl, const std::string& message);
+
+	/**
+	 * \brief Used to push record whose text is rendered only when it is written to a text file. Thread safe,
+	 *	does not lock unless the ring of the thread is full and the record waits
+	 * \param file Index returned by openFile
+	 * \param logger Id returned by registerLogger
+	 * \param lvl Logging level of record
+	 * \param functionName Function name written before the message, must be a string literal
+	 * \param format Format string with a placeholder per argument, must be a string literal
+	 * \param args Arguments encoded with logFormat::encode, dropped if longer than half of RING_SIZE
+	 */
+	static void writeEncoded(int file, int logger, LOGGING_LEVEL lvl, const char* functionName, const char* format,
+		const std::string& args);
+
+	/**
+	 * \brief Used to wait until every record pushed before the call is written and the files are flushed.
+	 *	Thread safe
+	 */
+	static void flush();
+
+	/**
+	 * \brief Used to set what happens to records below ERR when the ring of the thread is full. Thread safe
+	 * \param policy Overflow policy, DROP by default
+	 */
+	static void setOverflowPolicy(OVERFLOW_POLICY policy);
+
+	/**
+	 * \brief Used to get the count of records dropped because a ring was full. Thread safe
+	 * \return Count of dropped records since start
+	 */
+	static unsigned long long getDroppedCount();
+
+private:
+	// Ring buffer of one logging thread. Head and tail count bytes from the start and only grow
+	struct Ring {
+		Ring() : buffer(new char[RING_SIZE]), head(0), tail(0), dropped(0), closed(false) {}
+
+		std::unique_ptr<char[]> buffer;				//!< Records, wrapping around at the end
+		std::atomic<std::size_t> head;				//!< End of written records, advanced by the logging thread
+		std::atomic<std::size_t> tail;				//!< End of read records, advanced by the writer thread
+		std::atomic<unsigned long long> dropped;	//!< Records dropped and not reported yet
+		std::atomic<bool> closed;					//!< Set when the logging thread exits
+	};
+
+	// Fixed part of a record, followed by the text or encoded arguments
+	struct RecordHeader {
+		long long ticks;			//!< Time when the record was pushed, in std::chrono::system_clock ticks
+		int file;					//!< Index of log file
+		int logger;					//!< Id of logger
+		LOGGING_LEVEL lvl;			//!< Logging level
+		const char* functionName;	//!< Function name of a formatted record, otherwise nullptr
+		const char* format;			//!< Format string of a formatted record, nullptr if record is text
+		std::size_t length;			//!< Length of text or encoded arguments in bytes
+	};
+
+	// Opened log file
+	struct LogFile {
+		std::string path;										//!< Path of file
+		FILE_FORMAT format;										//!< Layout of file
+		std::unique_ptr<std::ofstream> stream;					//!< Open stream
+		std::unordered_map<const char*, uint32_t> stringIds;	//!< Ids of strings defined in a binary file
+		std::vector<bool> loggersDefined;						//!< Loggers whose names are in a binary file
+	};
+
+	std::vector<std::shared_ptr<Ring>> m_rings;				//!< Rings of logging threads, guarded by m_mutex
+	std::vector<LogFile> m_files;							//!< Opened files, guarded by m_fileMtx
+	std::vector<std::string> m_loggerNames;					//!< Names of loggers by id, guarded by m_fileMtx
+	std::atomic<OVERFLOW_POLICY> m_policy;					//!< Overflow policy of records below ERR
+	std::atomic<unsigned long long> m_dropped;				//!< Count of dropped records
+	std::atomic<bool> m_wake;								//!< Set by logging threads to wake up writer early
+	unsigned long long m_flushRequested;					//!< Flushes requested, guarded by m_mutex
+	unsigned long long m_flushCompleted;					//!< Flushes completed, guarded by m_mutex
+	bool m_stopping;										//!< Set by destructor, guarded by m_mutex
+	std::atomic<unsigned int> m_pushing;					//!< Count of threads inside push
+	std::mutex m_mutex;										//!< Mutex used when accessing rings and flush state
+	std::mutex m_fileMtx;									//!< Mutex used when accessing files
+	std::condition_variable m_condition;					//!< Wakes up writer thread
+	std::condition_variable m_flushed;						//!< Signals threads waiting for flush
+	std::time_t m_cachedTime;								//!< Time of m_cachedDatetime, used only by writer
+	std::string m_text;										//!< Rendered text, used only by writer
+	std::string m_cachedDatetime;							//!< Formatted m_cachedTime, used only by writer
+	std::thread m_thread;									//!< Writer thread, started last
+
+	/**
+	 * \brief Constructor. Starts the writer thread
+	 */
+	LogWriter();
+
+	/**
+	 * \brief Used to get the writer, created on first use
+	 * \return Writer
+	 */
+	static LogWriter& instance();
+
+	/**
+	 * \brief Used to get the current time of records
+	 * \return std::chrono::system_clock ticks since epoch
+	 */
+	static long long nowTicks();
+
+	/**
+	 * \brief Used to get the ring of the calling thread, created and registered on first use
+	 * \return Ring of calling thread
+	 */
+	Ring& threadRing();
+
+	/**
+	 * \brief Used to copy record to ring
+	 * \param ring Ring of the calling thread
+	 * \param header Fixed part of record
+	 * \param text Text of record, header.length bytes
+	 * \return True if record was pushed or dropped and counted, false if writer is stopping and record has to be
+	 *	written elsewhere
+	 */
+	bool push(Ring& ring, const RecordHeader& header, const char* text);
+
+	/**
+	 * \brief Writer thread main loop. Writes records until writer is stopping and every ring is empty
+	 */
+	void writerLoop();
+
+	/**
+	 * \brief Used to write the records of ring to files. Called only by writer thread with m_fileMtx held
+	 * \param ring Ring to drain
+	 */
+	void drain(Ring& ring);
+
+	/**
+	 * \brief Used to write one record to log file. Called only by writer thread with m_fileMtx held
+	 * \param header Fixed part of record
+	 * \param data Text or encoded arguments of record, header.length bytes
+	 */
+	void writeRecord(const RecordHeader& header, const char* data);
+
+	/**
+	 * \brief Used to write one line to text file. Called only by writer thread with m_fileMtx held
+	 * \param file Text file
+	 * \param header Fixed part of record
+	 * \param data Text or encoded arguments of record, header.length bytes
+	 */
+	void writeLine(LogFile& file, const RecordHeader& header, const char* data);
+
+	/**
+	 * \brief Used to write one record to binary file, preceded by the names it uses the first time they appear.
+	 *	Called only by writer thread with m_fileMtx held
+	 * \param file Binary file
+	 * \param header Fixed part of record
+	 * \param data Text or encoded arguments of record, header.length bytes
+	 */
+	void writeBinary(LogFile& file, const RecordHeader& header, const char* data);
+
+	/**
+	 * \brief Used to get the id of a string in binary file, writing the string the first time it appears
+	 * \param file Binary file
+	 * \param text Static string, identified by its address
+	 * \return Id of string in file
+	 */
+	uint32_t stringId(LogFile& file, const char* text);
+};
@@ -0,0 +1,112 @@
+#include "Utility/mappedfile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr), m_data(nullptr), m_size(0) {}
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+	// Share write access, so that the file can be appended to while it is mapped
+	m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+		close();
+		return false;
+	}
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping == nullptr) {
+		close();
+		return false;
+	}
+
+	m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (m_data == nullptr) {
+		close();
+		return false;
+	}
+	m_size = static_cast<std::size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr)
+		CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = nullptr;
+	m_data = nullptr;
+	m_size = 0;
+}
+
+#else
+
+MappedFile::MappedFile() : m_file(-1), m_data(nullptr), m_size(0) {}
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+	m_file = ::open(path.c_str(), O_RDONLY);
+	if (m_file < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(m_file, &info) != 0 || info.st_size == 0) {
+		close();
+		return false;
+	}
+
+	void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, m_file, 0);
+	if (data == MAP_FAILED) {
+		close();
+		return false;
+	}
+	m_data = static_cast<const uint8_t*>(data);
+	m_size = static_cast<std::size_t>(info.st_size);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data != nullptr)
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+	if (m_file >= 0)
+		::close(m_file);
+
+	m_file = -1;
+	m_data = nullptr;
+	m_size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::isOpen() const { return m_data != nullptr; }
+
+const uint8_t* MappedFile::getData() const { return m_data; }
+
+std::size_t MappedFile::getSize() const { return m_size; }
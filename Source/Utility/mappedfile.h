@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read only view of a whole file mapped into memory. Pages are read from disk when they are first touched,
+// so opening a large file is cheap and only the parts that are accessed are ever read
+//
+// File may be appended to while it is mapped, but the view keeps the size it had when it was opened.
+// Mapped data can be read from any thread
+class MappedFile {
+public:
+
+	/**
+	 * \brief Constructor. Creates closed file
+	 */
+	MappedFile();
+
+	/**
+	 * \brief Destructor. Unmaps the file
+	 */
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * \brief Used to map file for reading. Closes previously opened file
+	 * \param path Path to the file
+	 * \return True if file was mapped, false if it does not exist, is empty or could not be mapped
+	 */
+	bool open(const std::string& path);
+
+	/**
+	 * \brief Used to unmap the file. Does nothing if file is not open
+	 */
+	void close();
+
+	/**
+	 * \brief Used to test if file is mapped
+	 * \return True if file is open, otherwise false
+	 */
+	bool isOpen() const;
+
+	/**
+	 * \brief Used to access file contents
+	 * \return Pointer to getSize() bytes, nullptr if file is not open. Valid until file is closed
+	 */
+	const uint8_t* getData() const;
+
+	/**
+	 * \brief Used to get the size of mapped view
+	 * \return Size in bytes, 0 if file is not open
+	 */
+	std::size_t getSize() const;
+
+private:
+#ifdef _WIN32
+	void* m_file;		//!< Handle of the opened file
+	void* m_mapping;	//!< Handle of the file mapping object
+#else
+	int m_file;			//!< Descriptor of the opened file
+#endif
+	const uint8_t* m_data;	//!< Start of the mapped view
+	std::size_t m_size;		//!< Size of the mapped view in bytes
+};
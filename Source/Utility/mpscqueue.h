@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+
+// Unbounded multi-producer single-consumer FIFO queue of caller owned nodes, never takes a lock or allocates
+//
+// Producers link a node with one atomic exchange, so push never waits for other producers or the consumer.
+// Consumer pops from the other end without touching the producer side. Node pushed by a producer that has
+// exchanged but not yet linked it is not visible, and neither are nodes behind it, so tryPop may report
+// empty while such a push is in progress
+//
+// Nodes are linked in place, so Node must have a member std::atomic<Node*> next. Queue keeps a stub node of
+// its own that is put back to the end whenever the last node is popped, so every popped node is unlinked and
+// may be reused or freed at once
+//
+// Any thread may push. Only one thread at a time may pop, callers must serialize tryPop themselves
+template<typename Node>
+class IntrusiveMpscQueue {
+public:
+
+	/**
+	 * \brief Constructor. Creates empty queue
+	 */
+	IntrusiveMpscQueue() : m_stub(), m_head(&m_stub), m_tail(&m_stub) { m_stub.next.store(nullptr, std::memory_order_relaxed); }
+
+	/**
+	 * \brief Destructor. Nodes still in queue are not touched, owner must pop them first
+	 */
+	~IntrusiveMpscQueue() {}
+
+	IntrusiveMpscQueue(const IntrusiveMpscQueue&) = delete;
+	IntrusiveMpscQueue& operator=(const IntrusiveMpscQueue&) = delete;
+
+	/**
+	 * \brief Used to add node to the back of the queue. Thread safe, never blocks on other threads
+	 * \param node Node to be added, must not be in the queue
+	 */
+	void push(Node* node)
+	{
+		node->next.store(nullptr, std::memory_order_relaxed);
+		Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+		previous->next.store(node, std::memory_order_release);
+	}
+
+	/**
+	 * \brief Used to take the node from the front of the queue. Single consumer only
+	 * \return Unlinked node, nullptr if the queue is empty or the front node is still being pushed
+	 */
+	Node* tryPop()
+	{
+		Node* tail = m_tail;
+		Node* next = tail->next.load(std::memory_order_acquire);
+
+		// Stub is never returned, step over it
+		if (tail == &m_stub) {
+			if (next == nullptr)
+				return nullptr;
+			m_tail = next;
+			tail = next;
+			next = next->next.load(std::memory_order_acquire);
+		}
+
+		if (next != nullptr) {
+			m_tail = next;
+			return tail;
+		}
+
+		// Tail is the last node. Unless a producer is linking a node behind it, put the stub behind it so
+		// that it can be unlinked
+		if (tail != m_head.load(std::memory_order_acquire))
+			return nullptr;
+		push(&m_stub);
+		next = tail->next.load(std::memory_order_acquire);
+		if (next != nullptr) {
+			m_tail = next;
+			return tail;
+		}
+		return nullptr;
+	}
+
+private:
+	Node m_stub;				//!< Placeholder node, never returned
+	std::atomic<Node*> m_head;	//!< Last pushed node, shared by producers
+	Node* m_tail;				//!< Front node, owned by the consumer
+};
@@ -1,72 +1,79 @@
 #include "staticsafelogger.h"
 
-StaticSafeLogger::StaticSafeLogger(const std::string& name) : m_log(), m_name(name) {}
+StaticSafeLogger::StaticSafeLogger(const std::string& name)
+	: m_log(), m_name(name), m_initialized(false), m_initMtx() {}
 
 StaticSafeLogger::~StaticSafeLogger() {}
 
 StaticSafeLogger & StaticSafeLogger::operator=(StaticSafeLogger && rhs) noexcept
 {
+	if (this == &rhs)
+		return *this;
+
+	std::lock(m_initMtx, rhs.m_initMtx);
+	std::lock_guard<std::mutex> lock(m_initMtx, std::adopt_lock);
+	std::lock_guard<std::mutex> rhsLock(rhs.m_initMtx, std::adopt_lock);
 	m_log = std::move(rhs.m_log);
 	m_name = std::move(rhs.m_name);
+	m_initialized = rhs.m_initialized.load();
 	return *this;
 }
 
 void StaticSafeLogger::debug(const std::string & message)
 {
-	m_log.initialize(m_name);
-	m_log.debug(message);
+	logger().debug(message);
 }
 
 void StaticSafeLogger::debug(const std::string & functionName, const std::string & message)
 {
-	m_log.initialize(m_name);
-	m_log.debug(functionName, message);
+	logger().debug(functionName, message);
 }
 
 void StaticSafeLogger::info(const std::string & message)
 {
-	m_log.initialize(m_name);
-	m_log.info(message);
+	logger().info(message);
 }
 
 void StaticSafeLogger::info(const std::string & functionName, const std::string & message)
 {
-	m_log.initialize(m_name);
-	m_log.info(functionName, message);
+	logger().info(functionName, message);
 }
 
 void StaticSafeLogger::warn(const std::string & message)
 {
-	m_log.initialize(m_name);
-	m_log.warn(message);
+	logger().warn(message);
 }
 
 void StaticSafeLogger::warn(const std::string & functionName, const std::string & message)
 {
-	m_log.initialize(m_name);
-	m_log.warn(functionName, message);
+	logger().warn(functionName, message);
 }
 
 void StaticSafeLogger::error(const std::string & message)
 {
-	m_log.initialize(m_name);
-	m_log.error(message);
+	logger().error(message);
 }
 
 void StaticSafeLogger::error(const std::string & functionName, const std::string & message)
 {
-	m_log.initialize(m_name);
-	m_log.error(functionName, message);
+	logger().error(functionName, message);
 }
 
 void StaticSafeLogger::fatal(const std::string & message)
 {
-	m_log.initialize(m_name);
-	m_log.fatal(message);
+	logger().fatal(message);
 }
 
 void StaticSafeLogger::fatal(const std::string & functionName, const std::string & message)
 {
+	logger().fatal(functionName, message);
+}
+
+void StaticSafeLogger::initialize()
+{
+	std::lock_guard<std::mutex> lock(m_initMtx);
+	if (m_initialized.load(std::memory_order_relaxed))
+		return;
 	m_log.initialize(m_name);
-	m_log.fatal(functionName, message);
+	m_initialized.store(true, std::memory_order_release);
 }
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <utility>
 
 #include "Utility/logger.h"
 
+// Logger usable from static objects and functions, i.e. before main or from any thread
+//
+// Logger is initialized on first use instead of construction, so that log config is read only after static
+// initialization. Initialization happens once under a mutex, later calls only load an atomic flag
 class StaticSafeLogger {
 public:
 
@@ -42,6 +49,35 @@ public:
 	 */
 	void debug(const std::string& functionName, const std::string& message);
 
+	/**
+	 * \brief Used to write debug level message to log. Formatter is not called if debug level is not active in
+	 *	logconfig.json or is below MIN_LOGGING_LEVEL
+	 * \param functionName Function name written to file
+	 * \param formatter Callable returning entry to be written to log
+	 */
+	template<typename Formatter, typename = EnableIfFormatter<Formatter>>
+	void debug(const char* functionName, Formatter&& formatter)
+	{
+		if (DEBUG >= MIN_LOGGING_LEVEL)
+			logger().debug(functionName, std::forward<Formatter>(formatter));
+	}
+
+	/**
+	 * \brief Used to write debug level message to log. Text is rendered from format and arguments only when it is
+	 *	written to a text log file, and not at all if debug level is not active in logconfig.json
+	 * \param functionName Function name written to file, a string literal as only its address is kept
+	 * \param format Format string with placeholder {} or {x} (hexadecimal) per argument, a string literal as only its
+	 *	address is kept until the record is written
+	 * \param arg First argument
+	 * \param args Other arguments, strings and numbers
+	 */
+	template<std::size_t N, std::size_t M, typename Arg, typename... Args>
+	void debug(const char (&functionName)[N], const char (&format)[M], const Arg& arg, const Args&... args)
+	{
+		if (DEBUG >= MIN_LOGGING_LEVEL)
+			logger().debug(functionName, format, arg, args...);
+	}
+
 	/**
 	 * \brief Used to write info level message to log. Does nothing if info level is not active in logconfig.json
 	 * \param message Entry to be written to log
@@ -55,6 +91,35 @@ public:
 	 */
 	void info(const std::string& functionName, const std::string& message);
 
+	/**
+	 * \brief Used to write info level message to log. Formatter is not called if info level is not active in
+	 *	logconfig.json or is below MIN_LOGGING_LEVEL
+	 * \param functionName Function name written to file
+	 * \param formatter Callable returning entry to be written to log
+	 */
+	template<typename Formatter, typename = EnableIfFormatter<Formatter>>
+	void info(const char* functionName, Formatter&& formatter)
+	{
+		if (INFO >= MIN_LOGGING_LEVEL)
+			logger().info(functionName, std::forward<Formatter>(formatter));
+	}
+
+	/**
+	 * \brief Used to write info level message to log. Text is rendered from format and arguments only when it is
+	 *	written to a text log file, and not at all if info level is not active in logconfig.json
+	 * \param functionName Function name written to file, a string literal as only its address is kept
+	 * \param format Format string with placeholder {} or {x} (hexadecimal) per argument, a string literal as only its
+	 *	address is kept until the record is written
+	 * \param arg First argument
+	 * \param args Other arguments, strings and numbers
+	 */
+	template<std::size_t N, std::size_t M, typename Arg, typename... Args>
+	void info(const char (&functionName)[N], const char (&format)[M], const Arg& arg, const Args&... args)
+	{
+		if (INFO >= MIN_LOGGING_LEVEL)
+			logger().info(functionName, format, arg, args...);
+	}
+
 	/**
 	 * \brief Used to write warn level message to log. Does nothing if warn level is not active in logconfig.json
 	 * \param message Entry to be written to log
@@ -68,6 +133,35 @@ public:
 	 */
 	void warn(const std::string& functionName, const std::string& message);
 
+	/**
+	 * \brief Used to write warn level message to log. Formatter is not called if warn level is not active in
+	 *	logconfig.json or is below MIN_LOGGING_LEVEL
+	 * \param functionName Function name written to file
+	 * \param formatter Callable returning entry to be written to log
+	 */
+	template<typename Formatter, typename = EnableIfFormatter<Formatter>>
+	void warn(const char* functionName, Formatter&& formatter)
+	{
+		if (WARN >= MIN_LOGGING_LEVEL)
+			logger().warn(functionName, std::forward<Formatter>(formatter));
+	}
+
+	/**
+	 * \brief Used to write warn level message to log. Text is rendered from format and arguments only when it is
+	 *	written to a text log file, and not at all if warn level is not active in logconfig.json
+	 * \param functionName Function name written to file, a string literal as only its address is kept
+	 * \param format Format string with placeholder {} or {x} (hexadecimal) per argument, a string literal as only its
+	 *	address is kept until the record is written
+	 * \param arg First argument
+	 * \param args Other arguments, strings and numbers
+	 */
+	template<std::size_t N, std::size_t M, typename Arg, typename... Args>
+	void warn(const char (&functionName)[N], const char (&format)[M], const Arg& arg, const Args&... args)
+	{
+		if (WARN >= MIN_LOGGING_LEVEL)
+			logger().warn(functionName, format, arg, args...);
+	}
+
 	/**
 	 * \brief Used to write error level message to log. Does nothing if error level is not active in logconfig.json
 	 * \param message Entry to be written to log
@@ -81,6 +175,35 @@ public:
 	 */
 	void error(const std::string& functionName, const std::string& message);
 
+	/**
+	 * \brief Used to write error level message to log. Formatter is not called if error level is not active in
+	 *	logconfig.json or is below MIN_LOGGING_LEVEL
+	 * \param functionName Function name written to file
+	 * \param formatter Callable returning entry to be written to log
+	 */
+	template<typename Formatter, typename = EnableIfFormatter<Formatter>>
+	void error(const char* functionName, Formatter&& formatter)
+	{
+		if (ERR >= MIN_LOGGING_LEVEL)
+			logger().error(functionName, std::forward<Formatter>(formatter));
+	}
+
+	/**
+	 * \brief Used to write error level message to log. Text is rendered from format and arguments only when it is
+	 *	written to a text log file, and not at all if error level is not active in logconfig.json
+	 * \param functionName Function name written to file, a string literal as only its address is kept
+	 * \param format Format string with placeholder {} or {x} (hexadecimal) per argument, a string literal as only its
+	 *	address is kept until the record is written
+	 * \param arg First argument
+	 * \param args Other arguments, strings and numbers
+	 */
+	template<std::size_t N, std::size_t M, typename Arg, typename... Args>
+	void error(const char (&functionName)[N], const char (&format)[M], const Arg& arg, const Args&... args)
+	{
+		if (ERR >= MIN_LOGGING_LEVEL)
+			logger().error(functionName, format, arg, args...);
+	}
+
 	/**
 	 * \brief Used to write fatal level message to log. Does nothing if fatal level is not active in logconfig.json
 	 * \param message Entry to be written to log
@@ -94,7 +217,54 @@ public:
 	 */
 	void fatal(const std::string& functionName, const std::string& message);
 
+	/**
+	 * \brief Used to write fatal level message to log. Formatter is not called if fatal level is not active in
+	 *	logconfig.json or is below MIN_LOGGING_LEVEL
+	 * \param functionName Function name written to file
+	 * \param formatter Callable returning entry to be written to log
+	 */
+	template<typename Formatter, typename = EnableIfFormatter<Formatter>>
+	void fatal(const char* functionName, Formatter&& formatter)
+	{
+		if (FATAL >= MIN_LOGGING_LEVEL)
+			logger().fatal(functionName, std::forward<Formatter>(formatter));
+	}
+
+	/**
+	 * \brief Used to write fatal level message to log. Text is rendered from format and arguments only when it is
+	 *	written to a text log file, and not at all if fatal level is not active in logconfig.json
+	 * \param functionName Function name written to file, a string literal as only its address is kept
+	 * \param format Format string with placeholder {} or {x} (hexadecimal) per argument, a string literal as only its
+	 *	address is kept until the record is written
+	 * \param arg First argument
+	 * \param args Other arguments, strings and numbers
+	 */
+	template<std::size_t N, std::size_t M, typename Arg, typename... Args>
+	void fatal(const char (&functionName)[N], const char (&format)[M], const Arg& arg, const Args&... args)
+	{
+		if (FATAL >= MIN_LOGGING_LEVEL)
+			logger().fatal(functionName, format, arg, args...);
+	}
+
 private:
-	Logger m_log;		//!< Actual logger that is guarded against static usage
-	std::string m_name;	//!< Name of logger, used to fetch data from log config file
+	Logger m_log;						//!< Actual logger that is guarded against static usage
+	std::string m_name;					//!< Name of logger, used to fetch data from log config file
+	std::atomic<bool> m_initialized;	//!< Set when m_log has been initialized
+	std::mutex m_initMtx;				//!< Mutex used when initializing m_log
+
+	/**
+	 * \brief Used to get logger, initialized on first call. Thread safe
+	 * \return Initialized logger
+	 */
+	const Logger& logger()
+	{
+		if (!m_initialized.load(std::memory_order_acquire))
+			initialize();
+		return m_log;
+	}
+
+	/**
+	 * \brief Used to initialize logger unless another thread already did. Thread safe
+	 */
+	void initialize();
 };
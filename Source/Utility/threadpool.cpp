@@ -0,0 +1,63 @@
+#include "Utility/threadpool.h"
+
+#include <algorithm>
+
+#include "Utility/contract.h"
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+	: m_threads(), m_tasks(), m_mutex(), m_condition(), m_stopping(false)
+{
+	if (threadCount == 0)
+		threadCount = getDefaultThreadCount();
+
+	m_threads.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; ++i) {
+		m_threads.emplace_back(&ThreadPool::workerLoop, this);
+	}
+
+	ENSURE(getThreadCount() > 0);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_condition.notify_all();
+	for (auto& thread : m_threads) { thread.join(); }
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+	return static_cast<unsigned int>(m_threads.size());
+}
+
+std::size_t ThreadPool::getQueuedCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_tasks.size();
+}
+
+unsigned int ThreadPool::getDefaultThreadCount()
+{
+	// hardware_concurrency may return 0 when it cannot be determined
+	const unsigned int hardware = std::thread::hardware_concurrency();
+	return std::max(1u, hardware > 1 ? hardware - 1 : 1u);
+}
+
+void ThreadPool::workerLoop()
+{
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+			if (m_tasks.empty())
+				return;
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+		task();
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed size pool of worker threads that run submitted tasks in submission order
+// Tasks must not touch OpenGL, as the context only exists on the render thread
+// Destructor waits for queued tasks to finish before joining the workers
+class ThreadPool {
+public:
+
+	/**
+	 * \brief Constructor. Starts the worker threads
+	 * \param threadCount Count of worker threads, 0 selects getDefaultThreadCount()
+	 */
+	explicit ThreadPool(unsigned int threadCount);
+
+	/**
+	 * \brief Destructor. Runs queued tasks and joins worker threads
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * \brief Used to queue task to be run on a worker thread. Thread safe
+	 * \param func Callable without parameters
+	 * \return Future holding the return value, or exception thrown by func
+	 */
+	template<typename Func>
+	std::future<typename std::result_of<Func()>::type> submit(Func&& func)
+	{
+		using Result = typename std::result_of<Func()>::type;
+
+		// std::function needs copyable target, so share the move only packaged task
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+		auto future = task->get_future();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_tasks.emplace_back([task]() { (*task)(); });
+		}
+		m_condition.notify_one();
+		return future;
+	}
+
+	/**
+	 * \brief Used to get the count of worker threads
+	 * \return Count of worker threads
+	 */
+	unsigned int getThreadCount() const;
+
+	/**
+	 * \brief Used to get the count of queued tasks that have not started yet. Thread safe
+	 * \return Count of waiting tasks
+	 */
+	std::size_t getQueuedCount() const;
+
+	/**
+	 * \brief Used to get the worker count that leaves one hardware thread for the render thread
+	 * \return Count of worker threads, at least 1
+	 */
+	static unsigned int getDefaultThreadCount();
+
+private:
+	std::vector<std::thread> m_threads;			//!< Worker threads
+	std::deque<std::function<void()>> m_tasks;	//!< Tasks waiting for a worker
+	mutable std::mutex m_mutex;					//!< Guards m_tasks and m_stopping
+	std::condition_variable m_condition;		//!< Signals workers when tasks are queued or pool stops
+	bool m_stopping;							//!< Set by destructor to let workers exit once queue is empty
+
+	/**
+	 * \brief Worker thread main loop. Runs tasks until pool is stopping and queue is empty
+	 */
+	void workerLoop();
+};
@@ -2,7 +2,18 @@
 
 #include <chrono>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <direct.h>
+#include <windows.h>
+#else
+#include <cstdio>
+#include <sys/stat.h>
+#endif
+
 static const auto gameStartTime = std::chrono::system_clock::now();
+static const auto steadyStartTime = std::chrono::steady_clock::now();
 
 long utility::timeSinceEpoch()
 {
@@ -28,3 +39,32 @@ int utility::deltaTimeMs(int timestamp)
 {
 	return static_cast<int>(timestampMs() - timestamp);
 }
+
+long long utility::steadyTimeUs()
+{
+	using namespace std::chrono;
+	return duration_cast<microseconds>(steady_clock::now() - steadyStartTime).count();
+}
+
+void utility::createDirectories(const std::string& path)
+{
+	for (std::size_t end = path.find('/', 1); end != std::string::npos; end = path.find('/', end + 1)) {
+		const auto directory = path.substr(0, end);
+		// Existing directory fails too, failure to create shows up when a file is written to it
+#ifdef _WIN32
+		_mkdir(directory.c_str());
+#else
+		mkdir(directory.c_str(), 0755);
+#endif
+	}
+}
+
+bool utility::replaceFile(const std::string& from, const std::string& to)
+{
+	// Plain rename fails on Windows when the target exists, and removing it first would leave a gap
+#ifdef _WIN32
+	return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
@@ -31,6 +31,28 @@ namespace utility {
 	 */
 	int deltaTimeMs(int timestamp);
 
+	/**
+	 * \brief Used to get timestamp of a steady clock in microseconds, thread safe. Never goes backwards, so
+	 *	it is meant for measuring durations
+	 * \return Microseconds since game start
+	 */
+	long long steadyTimeUs();
+
+	/**
+	 * \brief Used to create directory and its missing parents
+	 * \param path Directory path, separated with '/'. Only directories ending with '/' are created, so a path
+	 *	to a file creates the directories of the file
+	 */
+	void createDirectories(const std::string& path);
+
+	/**
+	 * \brief Used to move file over another one in one step, so that readers see either the old or the new file
+	 * \param from Path of file to move
+	 * \param to Path of file to replace, created if it does not exist
+	 * \return True if file was moved, otherwise false
+	 */
+	bool replaceFile(const std::string& from, const std::string& to);
+
 	// Utility function to return hex format of a number
 	template<typename T>
 	std::string toHex(T&& num)
@@ -0,0 +1,57 @@
+#include "World/chunk.h"
+
+#include "Utility/contract.h"
+
+Chunk::Chunk() : m_blocks(), m_solidCount(0)
+{
+	m_blocks.fill(AIR);
+}
+
+BlockId Chunk::getBlock(int x, int y, int z) const
+{
+	REQUIRE(isInside(x, y, z));
+	return m_blocks[index(x, y, z)];
+}
+
+void Chunk::setBlock(int x, int y, int z, BlockId id)
+{
+	REQUIRE(isInside(x, y, z));
+	REQUIRE(id < TERRAIN_TYPE_COUNT);
+
+	auto& block = m_blocks[index(x, y, z)];
+	if (block == AIR && id != AIR)
+		++m_solidCount;
+	else if (block != AIR && id == AIR)
+		--m_solidCount;
+	block = id;
+
+	ENSURE(getBlock(x, y, z) == id);
+}
+
+void Chunk::fill(BlockId id)
+{
+	REQUIRE(id < TERRAIN_TYPE_COUNT);
+	m_blocks.fill(id);
+	m_solidCount = id == AIR ? 0 : VOLUME;
+}
+
+void Chunk::assign(const BlockId* blocks)
+{
+	REQUIRE(blocks != nullptr);
+	if (blocks == nullptr)
+		return;
+
+	unsigned int solidCount = 0;
+	for (int i = 0; i < VOLUME; ++i) {
+		REQUIRE(blocks[i] < TERRAIN_TYPE_COUNT);
+		m_blocks[i] = blocks[i];
+		solidCount += blocks[i] != AIR ? 1 : 0;
+	}
+	m_solidCount = solidCount;
+}
+
+bool Chunk::isEmpty() const { return m_solidCount == 0; }
+
+unsigned int Chunk::getSolidCount() const { return m_solidCount; }
+
+const BlockId* Chunk::getData() const { return m_blocks.data(); }
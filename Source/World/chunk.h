@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+using BlockId = uint8_t;
+
+// Block types stored in the world. AIR marks an empty cell and TERRAIN_TYPE_COUNT is not a valid type
+enum TERRAIN_TYPE : BlockId { AIR, GRASS, DIRT, STONE, SAND, SNOW, TERRAIN_TYPE_COUNT };
+
+// Fixed size cube of blocks stored as one contiguous array of block ids
+// Blocks are indexed with x running fastest, then z and then y, so each horizontal layer is contiguous
+// Chunk local coordinates are between 0..SIZE-1 on every axis
+class Chunk {
+public:
+	static const int SIZE = 16;						//!< Blocks per chunk edge
+	static const int VOLUME = SIZE * SIZE * SIZE;	//!< Blocks per chunk
+
+	/**
+	 * \brief Constructor. Creates chunk filled with AIR
+	 */
+	Chunk();
+
+	~Chunk() = default;
+
+	/**
+	 * \brief Used to get block id in chunk local coordinates
+	 * \param x Local position on x axis
+	 * \param y Local position on y axis
+	 * \param z Local position on z axis
+	 * \pre isInside(x, y, z)
+	 * \return Block id in the position
+	 */
+	BlockId getBlock(int x, int y, int z) const;
+
+	/**
+	 * \brief Used to set block id in chunk local coordinates
+	 * \param x Local position on x axis
+	 * \param y Local position on y axis
+	 * \param z Local position on z axis
+	 * \param id Block id to be set
+	 * \pre isInside(x, y, z)
+	 * \pre id < TERRAIN_TYPE_COUNT
+	 * \post getBlock(x, y, z) == id
+	 */
+	void setBlock(int x, int y, int z, BlockId id);
+
+	/**
+	 * \brief Used to set every block in chunk to the same id
+	 * \param id Block id to be set
+	 * \pre id < TERRAIN_TYPE_COUNT
+	 */
+	void fill(BlockId id);
+
+	/**
+	 * \brief Used to replace every block in chunk, e.g. when chunk is loaded from disk
+	 * \param blocks VOLUME block ids indexed with index()
+	 * \pre blocks != nullptr
+	 * \pre Every id < TERRAIN_TYPE_COUNT
+	 */
+	void assign(const BlockId* blocks);
+
+	/**
+	 * \brief Used to test if chunk holds only AIR
+	 * \return True if there are no solid blocks in chunk, otherwise false
+	 */
+	bool isEmpty() const;
+
+	/**
+	 * \brief Used to get the count of solid (non-AIR) blocks in chunk
+	 * \return Count of solid blocks
+	 */
+	unsigned int getSolidCount() const;
+
+	/**
+	 * \brief Used to access the raw block array, indexed with index()
+	 * \return Pointer to VOLUME block ids. Does not pass ownership
+	 */
+	const BlockId* getData() const;
+
+	/**
+	 * \brief Used to calculate array index of local coordinates
+	 * \param x Local position on x axis
+	 * \param y Local position on y axis
+	 * \param z Local position on z axis
+	 * \return Index to block array
+	 */
+	static int index(int x, int y, int z) { return x + SIZE * (z + SIZE * y); }
+
+	/**
+	 * \brief Used to test if local coordinates are inside chunk
+	 * \param x Local position on x axis
+	 * \param y Local position on y axis
+	 * \param z Local position on z axis
+	 * \return True if coordinates are between 0..SIZE-1, otherwise false
+	 */
+	static bool isInside(int x, int y, int z)
+	{
+		return x >= 0 && x < SIZE && y >= 0 && y < SIZE && z >= 0 && z < SIZE;
+	}
+
+private:
+	std::array<BlockId, VOLUME> m_blocks;	//!< Block ids of chunk
+	unsigned int m_solidCount;				//!< Count of non-AIR blocks, kept up to date by setters
+};
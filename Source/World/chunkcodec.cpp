@@ -0,0 +1,163 @@
+#include "World/chunkcodec.h"
+
+#include <algorithm>
+#include <array>
+
+namespace chunkCodec {
+
+	// Anonymous namespace to hide encoding details from namespace interface
+	namespace {
+
+		// Layout of the index array following the palette
+		enum ENCODING : uint8_t { UNIFORM, RUN_LENGTH, BIT_PACKED };
+
+		const std::size_t RUN_SIZE = 3;	//!< Bytes per run: palette index and 16 bit length
+
+		using Indices = std::array<uint8_t, Chunk::VOLUME>;
+
+		/**
+		 * \brief Used to select bits per packed index. Only widths that divide a byte are used,
+		 *	so indices never straddle bytes
+		 * \param paletteSize Count of palette entries, at least 2
+		 * \return 1, 2, 4 or 8
+		 */
+		unsigned int bitsPerIndex(std::size_t paletteSize)
+		{
+			if (paletteSize <= 2)
+				return 1;
+			if (paletteSize <= 4)
+				return 2;
+			if (paletteSize <= 16)
+				return 4;
+			return 8;
+		}
+
+		/**
+		 * \brief Used to count runs of equal indices
+		 * \param indices Palette index of every block
+		 * \return Count of runs
+		 */
+		std::size_t countRuns(const Indices& indices)
+		{
+			std::size_t runs = 1;
+			for (std::size_t i = 1; i < indices.size(); ++i) { runs += indices[i] != indices[i - 1] ? 1 : 0; }
+			return runs;
+		}
+
+	} // anonymous namespace
+
+
+	void encode(const Chunk& chunk, std::vector<uint8_t>& out)
+	{
+		// Palette in order of first appearance
+		std::array<int, TERRAIN_TYPE_COUNT> paletteIndex;
+		paletteIndex.fill(-1);
+		std::vector<BlockId> palette;
+		Indices indices;
+		const BlockId* blocks = chunk.getData();
+		for (int i = 0; i < Chunk::VOLUME; ++i) {
+			auto& index = paletteIndex[blocks[i]];
+			if (index < 0) {
+				index = static_cast<int>(palette.size());
+				palette.push_back(blocks[i]);
+			}
+			indices[i] = static_cast<uint8_t>(index);
+		}
+
+		const std::size_t runs = countRuns(indices);
+		const unsigned int bits = bitsPerIndex(palette.size());
+		const std::size_t packedSize = Chunk::VOLUME * bits / 8;
+		ENCODING encoding = BIT_PACKED;
+		if (palette.size() == 1)
+			encoding = UNIFORM;
+		else if (runs * RUN_SIZE <= packedSize)
+			encoding = RUN_LENGTH;
+
+		out.push_back(encoding);
+		out.push_back(static_cast<uint8_t>(palette.size()));
+		out.insert(out.end(), palette.begin(), palette.end());
+
+		if (encoding == RUN_LENGTH) {
+			for (std::size_t start = 0; start < indices.size();) {
+				std::size_t end = start + 1;
+				while (end < indices.size() && indices[end] == indices[start]) { ++end; }
+				const auto length = static_cast<uint16_t>(end - start);
+				out.push_back(indices[start]);
+				out.push_back(static_cast<uint8_t>(length & 0xFF));
+				out.push_back(static_cast<uint8_t>(length >> 8));
+				start = end;
+			}
+		}
+		else if (encoding == BIT_PACKED) {
+			const unsigned int perByte = 8 / bits;
+			const std::size_t first = out.size();
+			out.resize(first + packedSize, 0);
+			for (std::size_t i = 0; i < indices.size(); ++i) {
+				out[first + i / perByte] |= static_cast<uint8_t>(indices[i] << (i % perByte * bits));
+			}
+		}
+	}
+
+	bool decode(const uint8_t* data, std::size_t size, Chunk& chunk)
+	{
+		if (data == nullptr || size < 2)
+			return false;
+
+		const uint8_t encoding = data[0];
+		const std::size_t paletteSize = data[1];
+		if (paletteSize == 0 || size < 2 + paletteSize)
+			return false;
+
+		const uint8_t* palette = data + 2;
+		for (std::size_t i = 0; i < paletteSize; ++i) {
+			if (palette[i] >= TERRAIN_TYPE_COUNT)
+				return false;
+		}
+		const uint8_t* payload = palette + paletteSize;
+		const std::size_t payloadSize = size - 2 - paletteSize;
+
+		std::array<BlockId, Chunk::VOLUME> blocks;
+		if (encoding == UNIFORM) {
+			if (paletteSize != 1 || payloadSize != 0)
+				return false;
+			blocks.fill(palette[0]);
+		}
+		else if (encoding == RUN_LENGTH) {
+			if (payloadSize % RUN_SIZE != 0)
+				return false;
+
+			std::size_t count = 0;
+			for (std::size_t i = 0; i < payloadSize; i += RUN_SIZE) {
+				const std::size_t index = payload[i];
+				const std::size_t length = payload[i + 1] | static_cast<std::size_t>(payload[i + 2]) << 8;
+				if (index >= paletteSize || length == 0 || count + length > blocks.size())
+					return false;
+				std::fill_n(blocks.begin() + count, length, palette[index]);
+				count += length;
+			}
+			if (count != blocks.size())
+				return false;
+		}
+		else if (encoding == BIT_PACKED) {
+			const unsigned int bits = bitsPerIndex(paletteSize);
+			const unsigned int perByte = 8 / bits;
+			const unsigned int mask = (1u << bits) - 1;
+			if (payloadSize != Chunk::VOLUME * bits / 8)
+				return false;
+
+			for (std::size_t i = 0; i < blocks.size(); ++i) {
+				const std::size_t index = payload[i / perByte] >> (i % perByte * bits) & mask;
+				if (index >= paletteSize)
+					return false;
+				blocks[i] = palette[index];
+			}
+		}
+		else {
+			return false;
+		}
+
+		chunk.assign(blocks.data());
+		return true;
+	}
+
+} // namespace chunkCodec
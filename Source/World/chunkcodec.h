@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "World/chunk.h"
+
+// Namespace to group the compact binary encoding of chunk blocks used by world saves
+//
+// Blocks are stored as indices to a palette of the block ids found in the chunk. Index array is stored
+// either run-length encoded or bit-packed, whichever is smaller, and chunk of one block id needs only the
+// palette. Encoding is byte oriented and little endian, so it can be decoded straight from a mapped file
+namespace chunkCodec {
+
+	/**
+	 * \brief Used to encode blocks of chunk
+	 * \param chunk Chunk to be encoded
+	 * \param out Output, encoded bytes are appended
+	 */
+	void encode(const Chunk& chunk, std::vector<uint8_t>& out);
+
+	/**
+	 * \brief Used to decode blocks written with encode
+	 * \param data Encoded bytes
+	 * \param size Count of encoded bytes
+	 * \param chunk Output, every block is replaced when decoding succeeds
+	 * \return True if data was a valid encoded chunk, otherwise false and chunk is not changed
+	 */
+	bool decode(const uint8_t* data, std::size_t size, Chunk& chunk);
+
+} // namespace chunkCodec
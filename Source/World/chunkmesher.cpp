@@ -0,0 +1,337 @@
+#include "World/chunkmesher.h"
+
+#include <algorithm>
+#include <array>
+
+#include "Utility/contract.h"
+
+namespace chunkMesher {
+
+	// Anonymous namespace to hide meshing helpers from namespace interface
+	namespace {
+
+		using FaceMask = std::array<BlockId, Chunk::SIZE * Chunk::SIZE>;
+
+		/**
+		* \brief Used to get index to padded cell array
+		* \param pos Cell position, may be one cell outside the grid
+		* \param size Cells per grid edge without the border
+		* \return Index to padded cell array
+		*/
+		int paddedIndex(const glm::ivec3& pos, int size)
+		{
+			const int padded = size + 2;
+			return (pos.x + 1) + padded * ((pos.z + 1) + padded * (pos.y + 1));
+		}
+
+		/**
+		* \brief Used to get index to padded block array
+		* \param pos Chunk local position, may be one block outside the chunk
+		* \return Index to padded block array
+		*/
+		int paddedIndex(const glm::ivec3& pos)
+		{
+			return paddedIndex(pos, Chunk::SIZE);
+		}
+
+		/**
+		* \brief Used to get texture coordinates of quad corner in block units
+		* \param corner Quad corner position relative to chunk origin
+		* \param d Axis of the face normal
+		* \return Texture coordinates. Side faces have v pointing up
+		*/
+		glm::vec2 cornerUV(const glm::vec3& corner, int d)
+		{
+			const glm::vec3 p = corner + glm::vec3(0.5f);
+			if (d == 0)
+				return glm::vec2(p.z, p.y);
+			if (d == 1)
+				return glm::vec2(p.x, p.z);
+			return glm::vec2(p.x, p.y);
+		}
+
+		/**
+		* \brief Appends quad to mesh data of its block type
+		* \param meshes Mesh data per block type
+		* \param meshIndex Index to meshes per block type, -1 when type has no mesh data yet
+		* \param type Block type of the quad
+		* \param d Axis of the face normal
+		* \param side Direction of the face normal along axis d, -1 or 1
+		* \param slice Cell coordinate along axis d
+		* \param i Start of quad in cells along axis (d + 1) % 3
+		* \param j Start of quad in cells along axis (d + 2) % 3
+		* \param w Quad width in cells along axis (d + 1) % 3
+		* \param h Quad height in cells along axis (d + 2) % 3
+		* \param scale Edge of cell in blocks
+		*/
+		void addQuad(std::vector<ChunkMeshData>& meshes, std::array<int, TERRAIN_TYPE_COUNT>& meshIndex,
+			BlockId type, int d, int side, int slice, int i, int j, int w, int h, int scale)
+		{
+			if (meshIndex[type] < 0) {
+				meshIndex[type] = static_cast<int>(meshes.size());
+				meshes.push_back(ChunkMeshData{ type, {}, {} });
+			}
+			auto& mesh = meshes[meshIndex[type]];
+
+			const int u = (d + 1) % 3;
+			const int v = (d + 2) % 3;
+
+			// Cell covers blocks slice * scale .. slice * scale + scale - 1, and blocks extend half a block
+			// from their centre, so the face lies on the cell boundary towards the normal
+			glm::vec3 base;
+			base[d] = (slice + (side > 0 ? 1 : 0)) * scale - 0.5f;
+			base[u] = i * scale - 0.5f;
+			base[v] = j * scale - 0.5f;
+			glm::vec3 du(0.0f);
+			glm::vec3 dv(0.0f);
+			du[u] = static_cast<float>(w * scale);
+			dv[v] = static_cast<float>(h * scale);
+			glm::vec3 normal(0.0f);
+			normal[d] = static_cast<float>(side);
+
+			const glm::vec3 corners[4] = { base, base + du, base + du + dv, base + dv };
+			const auto first = static_cast<unsigned short>(mesh.vertices.size());
+			for (const auto& corner : corners) {
+				mesh.vertices.push_back(Vertex{ corner, normal, cornerUV(corner, d) });
+			}
+
+			// u x v points along +d, so the corner order is counter-clockwise for faces looking towards +d
+			if (side > 0) {
+				mesh.indices.insert(mesh.indices.end(), {
+					first, static_cast<unsigned short>(first + 1), static_cast<unsigned short>(first + 2),
+					first, static_cast<unsigned short>(first + 2), static_cast<unsigned short>(first + 3) });
+			}
+			else {
+				mesh.indices.insert(mesh.indices.end(), {
+					first, static_cast<unsigned short>(first + 2), static_cast<unsigned short>(first + 1),
+					first, static_cast<unsigned short>(first + 3), static_cast<unsigned short>(first + 2) });
+			}
+		}
+
+		/**
+		* \brief Used to downsample chunk blocks for coarser level of detail. Cell is solid when at least half
+		*	of its blocks are, and takes the type of its highest solid block, as that is what is seen from above
+		* \param blocks Output of copyBlocks, only the chunk itself is read
+		* \param scale Edge of cell in blocks, divides Chunk::SIZE
+		* \param cells Output, padded cell array with AIR border
+		*/
+		void downsample(const PaddedBlocks& blocks, int scale, std::vector<BlockId>& cells)
+		{
+			const int size = Chunk::SIZE / scale;
+			cells.assign((size + 2) * (size + 2) * (size + 2), AIR);
+
+			glm::ivec3 cell;
+			for (cell.y = 0; cell.y < size; ++cell.y) {
+				for (cell.z = 0; cell.z < size; ++cell.z) {
+					for (cell.x = 0; cell.x < size; ++cell.x) {
+						int solid = 0;
+						BlockId top = AIR;
+						glm::ivec3 pos;
+						for (pos.y = cell.y * scale; pos.y < (cell.y + 1) * scale; ++pos.y) {
+							for (pos.z = cell.z * scale; pos.z < (cell.z + 1) * scale; ++pos.z) {
+								for (pos.x = cell.x * scale; pos.x < (cell.x + 1) * scale; ++pos.x) {
+									const BlockId block = blocks[paddedIndex(pos)];
+									if (block != AIR) {
+										++solid;
+										top = block;
+									}
+								}
+							}
+						}
+						if (solid * 2 >= scale * scale * scale)
+							cells[paddedIndex(cell, size)] = top;
+					}
+				}
+			}
+		}
+
+		/**
+		* \brief Used to build mesh of padded cell grid
+		* \param cells Padded cell array, border cells hide faces on grid edges
+		* \param size Cells per grid edge without the border
+		* \param scale Edge of cell in blocks
+		* \return Mesh data per block type found in grid, empty if grid has no visible faces
+		*/
+		std::vector<ChunkMeshData> meshGrid(const BlockId* cells, int size, int scale)
+		{
+			std::vector<ChunkMeshData> meshes;
+			std::array<int, TERRAIN_TYPE_COUNT> meshIndex;
+			meshIndex.fill(-1);
+			FaceMask mask;
+
+			// Sweep each axis in both directions one slice at a time
+			for (int d = 0; d < 3; ++d) {
+				const int u = (d + 1) % 3;
+				const int v = (d + 2) % 3;
+				for (int side = -1; side <= 1; side += 2) {
+					glm::ivec3 pos;
+					for (int slice = 0; slice < size; ++slice) {
+						pos[d] = slice;
+
+						// Mark faces of the slice that are visible from this direction
+						int n = 0;
+						for (pos[v] = 0; pos[v] < size; ++pos[v]) {
+							for (pos[u] = 0; pos[u] < size; ++pos[u], ++n) {
+								const BlockId cell = cells[paddedIndex(pos, size)];
+								glm::ivec3 next = pos;
+								next[d] += side;
+								mask[n] = cell != AIR && cells[paddedIndex(next, size)] == AIR ? cell : static_cast<BlockId>(AIR);
+							}
+						}
+
+						// Merge marked faces greedily, first along u and then along v
+						n = 0;
+						for (int j = 0; j < size; ++j) {
+							for (int i = 0; i < size;) {
+								const BlockId type = mask[n];
+								if (type == AIR) {
+									++i;
+									++n;
+									continue;
+								}
+
+								int w = 1;
+								while (i + w < size && mask[n + w] == type) { ++w; }
+
+								int h = 1;
+								bool rowMatches = true;
+								while (rowMatches && j + h < size) {
+									for (int k = 0; k < w; ++k) {
+										if (mask[n + k + h * size] != type) {
+											rowMatches = false;
+											break;
+										}
+									}
+									if (rowMatches)
+										++h;
+								}
+
+								addQuad(meshes, meshIndex, type, d, side, slice, i, j, w, h, scale);
+
+								// Clear merged faces so they are not emitted again
+								for (int l = 0; l < h; ++l) {
+									for (int k = 0; k < w; ++k) { mask[n + k + l * size] = AIR; }
+								}
+								i += w;
+								n += w;
+							}
+						}
+					}
+				}
+			}
+
+			ENSURE(std::all_of(meshes.begin(), meshes.end(), [](const auto& mesh) { return mesh.vertices.size() <= 65536; }));
+			return meshes;
+		}
+
+	} // anonymous namespace
+
+
+	std::vector<ChunkMeshData> buildMesh(const World& world, const ChunkCoord& coord)
+	{
+		const Chunk* chunk = world.getChunk(coord);
+		if (chunk == nullptr || chunk->isEmpty())
+			return std::vector<ChunkMeshData>();
+
+		PaddedBlocks blocks;
+		copyBlocks(world, coord, blocks);
+		return buildMesh(blocks);
+	}
+
+	void copyBlocks(const World& world, const ChunkCoord& coord, PaddedBlocks& blocks)
+	{
+		blocks.fill(AIR);
+
+		const Chunk* chunk = world.getChunk(coord);
+		if (chunk == nullptr)
+			return;
+
+		const BlockId* data = chunk->getData();
+		glm::ivec3 pos;
+		for (pos.y = 0; pos.y < Chunk::SIZE; ++pos.y) {
+			for (pos.z = 0; pos.z < Chunk::SIZE; ++pos.z) {
+				for (pos.x = 0; pos.x < Chunk::SIZE; ++pos.x) {
+					blocks[paddedIndex(pos)] = data[Chunk::index(pos.x, pos.y, pos.z)];
+				}
+			}
+		}
+
+		// Copy the layer of each neighbour that touches this chunk
+		for (int d = 0; d < 3; ++d) {
+			const int u = (d + 1) % 3;
+			const int v = (d + 2) % 3;
+			for (int side = -1; side <= 1; side += 2) {
+				ChunkCoord neighbourCoord = coord;
+				neighbourCoord[d] += side;
+				const Chunk* neighbour = world.getChunk(neighbourCoord);
+				if (neighbour == nullptr)
+					continue;
+
+				glm::ivec3 dst;
+				glm::ivec3 src;
+				dst[d] = side < 0 ? -1 : Chunk::SIZE;
+				src[d] = side < 0 ? Chunk::SIZE - 1 : 0;
+				for (int a = 0; a < Chunk::SIZE; ++a) {
+					for (int b = 0; b < Chunk::SIZE; ++b) {
+						dst[u] = src[u] = a;
+						dst[v] = src[v] = b;
+						blocks[paddedIndex(dst)] = neighbour->getBlock(src.x, src.y, src.z);
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<ChunkMeshData> buildMesh(const PaddedBlocks& blocks)
+	{
+		return meshGrid(blocks.data(), Chunk::SIZE, 1);
+	}
+
+	std::vector<ChunkMeshData> buildMesh(const PaddedBlocks& blocks, int lod)
+	{
+		REQUIRE(lod >= 0 && lod < LOD_COUNT);
+		if (lod <= 0)
+			return buildMesh(blocks);
+
+		// Coarse cells do not match the blocks of neighbouring chunks, so border faces are always kept.
+		// They form skirts that close the gaps between levels of detail
+		const int scale = getLodScale(lod);
+		std::vector<BlockId> cells;
+		downsample(blocks, scale, cells);
+		return meshGrid(cells.data(), Chunk::SIZE / scale, scale);
+	}
+
+	LodMeshes buildLodMeshes(const PaddedBlocks& blocks)
+	{
+		LodMeshes meshes;
+		meshes[0] = buildMesh(blocks);
+
+		// Chunk hidden by its neighbours is hidden at every level of detail, skirts would only add overdraw
+		if (meshes[0].empty())
+			return meshes;
+
+		for (int lod = 1; lod < LOD_COUNT; ++lod) { meshes[lod] = buildMesh(blocks, lod); }
+		return meshes;
+	}
+
+	int getLodScale(int lod)
+	{
+		REQUIRE(lod >= 0 && lod < LOD_COUNT);
+		return 1 << lod;
+	}
+
+	unsigned int countVertices(const std::vector<ChunkMeshData>& meshes)
+	{
+		unsigned int vertices = 0;
+		for (const auto& mesh : meshes) { vertices += static_cast<unsigned int>(mesh.vertices.size()); }
+		return vertices;
+	}
+
+	unsigned int countQuads(const std::vector<ChunkMeshData>& meshes)
+	{
+		unsigned int quads = 0;
+		for (const auto& mesh : meshes) { quads += static_cast<unsigned int>(mesh.indices.size() / 6); }
+		return quads;
+	}
+
+} // namespace chunkMesher
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "Renderer/mesh.h"
+#include "World/world.h"
+
+// Namespace to group CPU side chunk meshing. Does not touch OpenGL so meshes can be built on any thread
+//
+// Only faces between a solid block and AIR are emitted, and coplanar faces of the same block type are
+// greedily merged into larger quads. Vertex positions are local to the chunk origin (World::toWorldPos)
+// and UV coordinates are in block units, so the shader repeats the texture once per block over merged quads
+//
+// Distant chunks use coarser levels of detail, where the chunk is downsampled to cells of 2, 4 or 8 blocks
+// per edge before meshing. Coarse meshes keep the faces on chunk borders, so whatever level the neighbour
+// is drawn with, the border is closed by the walls of the coarser side and no cracks show between levels
+namespace chunkMesher {
+
+	const int PADDED = Chunk::SIZE + 2;	//!< Edge of chunk with one block border of neighbouring chunks
+	const int LOD_COUNT = 4;			//!< Levels of detail, level n has cells of 2^n blocks per edge
+
+	// Copy of chunk blocks and the touching layers of its six neighbours, used to mesh without world access
+	using PaddedBlocks = std::array<BlockId, PADDED * PADDED * PADDED>;
+
+	// Mesh data of one block type inside one chunk
+	struct ChunkMeshData {
+		BlockId type;						//!< Block type, selects the texture
+		std::vector<Vertex> vertices;		//!< Quad corners, four per quad
+		std::vector<unsigned short> indices;//!< Two triangles per quad
+	};
+
+	// Mesh data of one chunk for every level of detail, indexed with level
+	using LodMeshes = std::array<std::vector<ChunkMeshData>, LOD_COUNT>;
+
+	/**
+	 * \brief Used to build the mesh of one chunk. Neighbouring chunks are read to hide faces on chunk borders
+	 * \param world World holding the chunk
+	 * \param coord Chunk coordinates
+	 * \return Mesh data per block type found in chunk, empty if chunk has no visible faces
+	 */
+	std::vector<ChunkMeshData> buildMesh(const World& world, const ChunkCoord& coord);
+
+	/**
+	 * \brief Used to copy blocks needed to mesh one chunk. Only this step reads the world, so the copy can be
+	 *	meshed on another thread while the world keeps changing
+	 * \param world World holding the chunk
+	 * \param coord Chunk coordinates
+	 * \param blocks Output, cells without chunk are AIR
+	 */
+	void copyBlocks(const World& world, const ChunkCoord& coord, PaddedBlocks& blocks);
+
+	/**
+	 * \brief Used to build the mesh of one chunk from copied blocks
+	 * \param blocks Output of copyBlocks
+	 * \return Mesh data per block type found in chunk, empty if chunk has no visible faces
+	 */
+	std::vector<ChunkMeshData> buildMesh(const PaddedBlocks& blocks);
+
+	/**
+	 * \brief Used to build the mesh of one chunk at level of detail. Levels above 0 only read the chunk
+	 *	itself and keep faces on chunk borders
+	 * \param blocks Output of copyBlocks
+	 * \param lod Level of detail
+	 * \pre lod >= 0 && lod < LOD_COUNT
+	 * \return Mesh data per block type found in chunk, empty if chunk has no visible faces
+	 */
+	std::vector<ChunkMeshData> buildMesh(const PaddedBlocks& blocks, int lod);
+
+	/**
+	 * \brief Used to build the mesh of one chunk at every level of detail
+	 * \param blocks Output of copyBlocks
+	 * \return Mesh data per level, every level is empty if level 0 has no visible faces
+	 */
+	LodMeshes buildLodMeshes(const PaddedBlocks& blocks);
+
+	/**
+	 * \brief Used to get the edge of downsampled cell
+	 * \param lod Level of detail
+	 * \pre lod >= 0 && lod < LOD_COUNT
+	 * \return Blocks per cell edge, 1 for level 0
+	 */
+	int getLodScale(int lod);
+
+	/**
+	 * \brief Used to count vertices in built meshes
+	 * \param meshes Output of buildMesh
+	 * \return Count of vertices
+	 */
+	unsigned int countVertices(const std::vector<ChunkMeshData>& meshes);
+
+	/**
+	 * \brief Used to count quads in built meshes
+	 * \param meshes Output of buildMesh
+	 * \return Count of quads, triangle count is twice this
+	 */
+	unsigned int countQuads(const std::vector<ChunkMeshData>& meshes);
+
+} // namespace chunkMesher
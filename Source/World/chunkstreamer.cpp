@@ -0,0 +1,396 @@
+#include "World/chunkstreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "Utility/contract.h"
+#include "Utility/utility.h"
+
+namespace {
+
+	/**
+	 * \brief Used to test if future has its value without waiting for it
+	 * \param future Valid future
+	 * \return True if value is ready, otherwise false
+	 */
+	template<typename T>
+	bool isReady(const std::future<T>& future)
+	{
+		return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}
+
+	/**
+	 * \brief Used to load every generator layer of column from storage
+	 * \param storage Storage of saved chunks
+	 * \param generator Generator, selects the layers
+	 * \param column Column coordinates
+	 * \param chunks Output, non-empty chunks are appended
+	 * \return True if every layer was stored and could be read, otherwise false and column must be generated
+	 */
+	template<typename Chunks>
+	bool loadColumn(WorldStorage& storage, const TerrainGenerator& generator, const ChunkCoord& column, Chunks& chunks)
+	{
+		for (int y = generator.getMinChunkY(); y <= generator.getMaxChunkY(); ++y) {
+			const ChunkCoord coord(column.x, y, column.z);
+			std::unique_ptr<Chunk> chunk;
+			if (storage.loadChunk(coord, chunk) != WorldStorage::STORED)
+				return false;
+			if (chunk != nullptr)
+				chunks.emplace_back(coord, std::move(chunk));
+		}
+		return true;
+	}
+
+} // anonymous namespace
+
+ChunkStreamer::ChunkStreamer(World& world, const TerrainGenerator& generator, ThreadPool& pool, WorldStorage* storage,
+	const Settings& settings)
+	: m_world(world), m_generator(generator), m_pool(pool), m_storage(storage), m_settings(settings), m_loadOffsets(),
+	m_center(), m_hasCenter(false), m_loadedColumns(), m_pendingColumns(), m_columnTasks(), m_requestCursor(0),
+	m_storedColumns(), m_modifiedColumns(), m_savingColumns(), m_saveTasks(), m_failedSaves(0),
+	m_revisions(), m_lastRevision(0), m_requestTimes(), m_dirtyChunks(), m_meshTasks(), m_readyMeshes()
+{
+	REQUIRE(settings.loadRadius >= 0);
+	REQUIRE(settings.unloadRadius >= settings.loadRadius);
+
+	// Request order is fixed once, nearest columns first so the ground under the player appears first
+	const int radius = m_settings.loadRadius;
+	for (int x = -radius; x <= radius; ++x) {
+		for (int z = -radius; z <= radius; ++z) { m_loadOffsets.emplace_back(x, z); }
+	}
+	std::stable_sort(m_loadOffsets.begin(), m_loadOffsets.end(), [](const glm::ivec2& lhs, const glm::ivec2& rhs) {
+		return lhs.x * lhs.x + lhs.y * lhs.y < rhs.x * rhs.x + rhs.y * rhs.y;
+	});
+}
+
+void ChunkStreamer::update(const glm::vec3& center, Changes& changes)
+{
+	changes.loaded.clear();
+	changes.unloaded.clear();
+
+	const glm::ivec3 block(
+		static_cast<int>(std::floor(center.x + 0.5f)),
+		static_cast<int>(std::floor(center.y + 0.5f)),
+		static_cast<int>(std::floor(center.z + 0.5f)));
+	const auto column = toColumn(World::toChunkCoord(block));
+	const bool moved = !m_hasCenter || column != m_center;
+	m_center = column;
+	m_hasCenter = true;
+
+	collectColumns(changes);
+	if (moved) {
+		evictColumns(changes);
+		m_requestCursor = 0;
+	}
+	collectSaves();
+	requestColumns();
+	updateMeshes();
+}
+
+void ChunkStreamer::markDirty(const ChunkCoord& coord)
+{
+	// Coordinates that never had a chunk, e.g. neighbours of edits at the border of loaded columns, have no mesh
+	// to update. Chunk that was just removed is still tracked, so its old mesh gets dropped
+	if (m_world.getChunk(coord) == nullptr && m_revisions.count(coord) == 0)
+		return;
+
+	m_dirtyChunks.insert(coord);
+	m_revisions[coord] = ++m_lastRevision;
+}
+
+void ChunkStreamer::markModified(const ChunkCoord& coord)
+{
+	// Edits outside loaded columns are dropped on eviction, so there is nothing to save
+	const auto column = toColumn(coord);
+	if (m_loadedColumns.count(column) > 0)
+		m_modifiedColumns.insert(column);
+}
+
+bool ChunkStreamer::saveAll()
+{
+	if (m_storage == nullptr)
+		return true;
+
+	bool success = true;
+	for (auto& task : m_saveTasks) {
+		if (!task.result.get()) {
+			m_failedSaves += static_cast<unsigned int>(task.columns.size());
+			success = false;
+		}
+	}
+	m_saveTasks.clear();
+	m_savingColumns.clear();
+	m_requestCursor = 0;
+
+	std::vector<ColumnCoord> columns;
+	std::vector<std::pair<ChunkCoord, const Chunk*>> chunks;
+	for (const auto& column : m_loadedColumns) {
+		if (!needsSave(column))
+			continue;
+		columns.push_back(column);
+		for (int y = m_generator.getMinChunkY(); y <= m_generator.getMaxChunkY(); ++y) {
+			const ChunkCoord coord(column.x, y, column.z);
+			chunks.emplace_back(coord, m_world.getChunk(coord));
+		}
+	}
+	if (columns.empty())
+		return success;
+
+	if (!m_storage->saveChunks(chunks)) {
+		m_failedSaves += static_cast<unsigned int>(columns.size());
+		return false;
+	}
+	for (const auto& column : columns) {
+		m_storedColumns.insert(column);
+		m_modifiedColumns.erase(column);
+	}
+	return success;
+}
+
+bool ChunkStreamer::popMesh(MeshResult& result)
+{
+	if (m_readyMeshes.empty())
+		return false;
+
+	result = std::move(m_readyMeshes.front());
+	m_readyMeshes.pop_front();
+	return true;
+}
+
+ChunkStreamer::Stats ChunkStreamer::getStats() const
+{
+	return Stats{
+		static_cast<unsigned int>(m_loadedColumns.size()),
+		static_cast<unsigned int>(m_columnTasks.size()),
+		static_cast<unsigned int>(m_dirtyChunks.size()),
+		static_cast<unsigned int>(m_meshTasks.size()),
+		static_cast<unsigned int>(m_readyMeshes.size()),
+		static_cast<unsigned int>(m_storedColumns.size()),
+		static_cast<unsigned int>(m_savingColumns.size()),
+		m_failedSaves
+	};
+}
+
+ChunkStreamer::ColumnCoord ChunkStreamer::toColumn(const ChunkCoord& coord)
+{
+	return ColumnCoord(coord.x, 0, coord.z);
+}
+
+void ChunkStreamer::collectColumns(Changes& changes)
+{
+	for (std::size_t i = 0; i < m_columnTasks.size();) {
+		auto& task = m_columnTasks[i];
+		if (!isReady(task.result)) {
+			++i;
+			continue;
+		}
+
+		auto loaded = task.result.get();
+		const auto column = task.column;
+		const auto requestTime = task.requestTime;
+		m_pendingColumns.erase(column);
+		task = std::move(m_columnTasks.back());
+		m_columnTasks.pop_back();
+
+		// Player may have moved away while the column was generated
+		if (!isWithin(column, m_settings.unloadRadius))
+			continue;
+
+		m_loadedColumns.insert(column);
+		if (loaded.stored)
+			m_storedColumns.insert(column);
+		for (auto& pair : loaded.chunks) {
+			const auto coord = pair.first;
+			m_world.setChunk(coord, std::move(pair.second));
+			changes.loaded.push_back(coord);
+			m_requestTimes[coord] = requestTime;
+			markDirty(coord);
+
+			// Border faces of loaded neighbours are now hidden
+			for (const auto& offset : { ChunkCoord(1, 0, 0), ChunkCoord(-1, 0, 0), ChunkCoord(0, 0, 1), ChunkCoord(0, 0, -1) }) {
+				const auto neighbour = coord + offset;
+				if (m_world.getChunk(neighbour) != nullptr)
+					markDirty(neighbour);
+			}
+		}
+	}
+}
+
+void ChunkStreamer::evictColumns(Changes& changes)
+{
+	std::unordered_set<ColumnCoord, ChunkCoordHash> saving;
+	for (auto it = m_loadedColumns.begin(); it != m_loadedColumns.end();) {
+		if (isWithin(*it, m_settings.unloadRadius)) {
+			++it;
+			continue;
+		}
+		if (needsSave(*it))
+			saving.insert(*it);
+		m_storedColumns.erase(*it);
+		m_modifiedColumns.erase(*it);
+		it = m_loadedColumns.erase(it);
+	}
+
+	// Layers without chunk are saved as empty, so that the column is known to be complete in storage
+	const int minY = m_generator.getMinChunkY();
+	const int maxY = m_generator.getMaxChunkY();
+	auto saved = std::make_shared<ColumnChunks>();
+	for (const auto& column : saving) {
+		for (int y = minY; y <= maxY; ++y) {
+			const ChunkCoord coord(column.x, y, column.z);
+			if (m_world.getChunk(coord) == nullptr)
+				saved->emplace_back(coord, nullptr);
+		}
+	}
+
+	// Scan the world instead of the columns, so chunks created by editing outside generated layers go too
+	std::vector<ChunkCoord> evicted;
+	for (const auto& pair : m_world.getChunks()) {
+		if (!isWithin(toColumn(pair.first), m_settings.unloadRadius))
+			evicted.push_back(pair.first);
+	}
+
+	for (const auto& coord : evicted) {
+		auto chunk = m_world.takeChunk(coord);
+		if (coord.y >= minY && coord.y <= maxY && saving.count(toColumn(coord)) > 0)
+			saved->emplace_back(coord, std::move(chunk));
+		m_revisions.erase(coord);
+		m_requestTimes.erase(coord);
+		m_dirtyChunks.erase(coord);
+		changes.unloaded.push_back(coord);
+	}
+
+	// Meshes in flight are dropped when they finish, as their revision no longer exists
+	m_readyMeshes.erase(std::remove_if(m_readyMeshes.begin(), m_readyMeshes.end(),
+		[this](const MeshResult& result) { return !isWithin(toColumn(result.coord), m_settings.unloadRadius); }),
+		m_readyMeshes.end());
+
+	if (saving.empty())
+		return;
+
+	// Evicted chunks are moved to the task, so saving never reads the world
+	auto* storage = m_storage;
+	auto result = m_pool.submit([storage, saved]() {
+		std::vector<std::pair<ChunkCoord, const Chunk*>> chunks;
+		chunks.reserve(saved->size());
+		for (const auto& pair : *saved) { chunks.emplace_back(pair.first, pair.second.get()); }
+		return storage->saveChunks(chunks);
+	});
+	m_savingColumns.insert(saving.begin(), saving.end());
+	m_saveTasks.push_back(SaveTask{ std::vector<ColumnCoord>(saving.begin(), saving.end()), std::move(result) });
+}
+
+void ChunkStreamer::collectSaves()
+{
+	for (std::size_t i = 0; i < m_saveTasks.size();) {
+		auto& task = m_saveTasks[i];
+		if (!isReady(task.result)) {
+			++i;
+			continue;
+		}
+
+		if (!task.result.get())
+			m_failedSaves += static_cast<unsigned int>(task.columns.size());
+		for (const auto& column : task.columns) { m_savingColumns.erase(column); }
+		task = std::move(m_saveTasks.back());
+		m_saveTasks.pop_back();
+
+		// Saved columns were skipped by earlier request scans
+		m_requestCursor = 0;
+	}
+}
+
+bool ChunkStreamer::needsSave(const ColumnCoord& column) const
+{
+	return m_storage != nullptr && (m_storedColumns.count(column) == 0 || m_modifiedColumns.count(column) > 0);
+}
+
+void ChunkStreamer::requestColumns()
+{
+	// Columns only become loaded or pending while center stays, so scanning can continue where it stopped
+	for (; m_requestCursor < m_loadOffsets.size(); ++m_requestCursor) {
+		if (m_columnTasks.size() >= m_settings.maxPendingColumns)
+			return;
+
+		const auto& offset = m_loadOffsets[m_requestCursor];
+		const auto column = m_center + ColumnCoord(offset.x, 0, offset.y);
+		if (m_loadedColumns.count(column) > 0 || m_pendingColumns.count(column) > 0 || m_savingColumns.count(column) > 0)
+			continue;
+
+		const auto& generator = m_generator;
+		auto* storage = m_storage;
+		auto result = m_pool.submit([&generator, storage, column]() {
+			LoadedColumn loaded{ {}, false };
+			if (storage != nullptr)
+				loaded.stored = loadColumn(*storage, generator, column, loaded.chunks);
+			if (loaded.stored)
+				return loaded;
+
+			// Partly stored column is generated as a whole
+			loaded.chunks.clear();
+			for (int y = generator.getMinChunkY(); y <= generator.getMaxChunkY(); ++y) {
+				const ChunkCoord coord(column.x, y, column.z);
+				auto chunk = generator.generateChunk(coord);
+				if (chunk != nullptr)
+					loaded.chunks.emplace_back(coord, std::move(chunk));
+			}
+			return loaded;
+		});
+		m_pendingColumns.insert(column);
+		m_columnTasks.push_back(ColumnTask{ column, utility::timestampMs(), std::move(result) });
+	}
+}
+
+void ChunkStreamer::updateMeshes()
+{
+	for (std::size_t i = 0; i < m_meshTasks.size();) {
+		auto& task = m_meshTasks[i];
+		if (!isReady(task.result)) {
+			++i;
+			continue;
+		}
+
+		auto meshes = task.result.get();
+		const auto coord = task.coord;
+		const auto revision = task.revision;
+		task = std::move(m_meshTasks.back());
+		m_meshTasks.pop_back();
+
+		// Chunk changed or was evicted while it was meshed, newer revision is already queued if needed
+		const auto it = m_revisions.find(coord);
+		if (it == m_revisions.end() || it->second != revision)
+			continue;
+
+		int requestTime = -1;
+		const auto requested = m_requestTimes.find(coord);
+		if (requested != m_requestTimes.end()) {
+			requestTime = requested->second;
+			m_requestTimes.erase(requested);
+		}
+		m_readyMeshes.push_back(MeshResult{ coord, std::move(meshes), requestTime });
+	}
+
+	for (auto it = m_dirtyChunks.begin(); it != m_dirtyChunks.end() && m_meshTasks.size() < m_settings.maxPendingMeshes;) {
+		const auto coord = *it;
+		it = m_dirtyChunks.erase(it);
+
+		// Removed chunk only needs its old mesh dropped
+		if (m_world.getChunk(coord) == nullptr) {
+			m_revisions.erase(coord);
+			m_requestTimes.erase(coord);
+			m_readyMeshes.push_back(MeshResult{ coord, {}, -1 });
+			continue;
+		}
+
+		auto blocks = std::make_shared<chunkMesher::PaddedBlocks>();
+		chunkMesher::copyBlocks(m_world, coord, *blocks);
+		auto result = m_pool.submit([blocks]() { return chunkMesher::buildLodMeshes(*blocks); });
+		m_meshTasks.push_back(MeshTask{ coord, m_revisions[coord], std::move(result) });
+	}
+}
+
+bool ChunkStreamer::isWithin(const ColumnCoord& column, int radius) const
+{
+	return std::abs(column.x - m_center.x) <= radius && std::abs(column.z - m_center.z) <= radius;
+}
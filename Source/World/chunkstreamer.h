@@ -0,0 +1,246 @@
+#pragma once
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#pragma warning (push, 2)  // Temporarily set warning level 2
+#include <3rdParty/glm/glm.hpp>
+#pragma warning (pop)      // Restore back
+
+#include "Utility/threadpool.h"
+#include "World/chunkmesher.h"
+#include "World/terraingenerator.h"
+#include "World/world.h"
+#include "World/worldstorage.h"
+
+// Keeps the chunks around a moving center loaded by generating and meshing them on worker threads
+//
+// World is streamed in columns, i.e. all chunk layers the generator can fill at one x, z position.
+// Columns within load radius of the center column are requested nearest first, and columns further than
+// unload radius are evicted, so moving back and forth over the load border does not reload columns.
+// Dirty chunks are copied with their neighbour layers on the calling thread and meshed on workers at every
+// level of detail, so the world can switch levels without remeshing
+//
+// With storage, columns are loaded from disk when every generator layer of them has been saved, otherwise
+// generated. Evicted columns that were edited or have not been saved yet are saved on workers, and a column
+// is not requested again before its save has finished. Only the layers the generator fills are persisted
+//
+// All functions must be called from the thread that owns the world. Worker threads never see the world,
+// only the generator and block copies, and results are polled without waiting so update never blocks
+class ChunkStreamer {
+public:
+	using ColumnCoord = ChunkCoord; //!< Chunk column position, y is always 0
+
+	// Parameters of streaming
+	struct Settings {
+		int loadRadius;					//!< Columns up to this distance from the center are loaded
+		int unloadRadius;				//!< Columns further than this are evicted, at least loadRadius
+		unsigned int maxPendingColumns;	//!< Limit of column generation tasks in flight
+		unsigned int maxPendingMeshes;	//!< Limit of meshing tasks in flight
+	};
+
+	// Chunks stored in or removed from the world by the last update
+	struct Changes {
+		std::vector<ChunkCoord> loaded;		//!< Chunks added by generation
+		std::vector<ChunkCoord> unloaded;	//!< Chunks removed by eviction
+	};
+
+	// Finished mesh of one chunk, ready to be uploaded
+	struct MeshResult {
+		ChunkCoord coord;								//!< Chunk coordinates
+		chunkMesher::LodMeshes meshes;					//!< Mesh data per level of detail, all levels are empty if
+														//!< chunk has nothing to draw
+		int requestTime;								//!< Timestamp in ms when the chunk was requested, -1 if
+														//!< chunk has been meshed before
+	};
+
+	// Counters of the pipeline
+	struct Stats {
+		unsigned int loadedColumns;		//!< Columns stored in the world
+		unsigned int pendingColumns;	//!< Columns being generated
+		unsigned int dirtyChunks;		//!< Chunks waiting to be meshed
+		unsigned int pendingMeshes;		//!< Chunks being meshed
+		unsigned int readyMeshes;		//!< Meshes waiting to be taken with popMesh
+		unsigned int storedColumns;		//!< Loaded columns that were read from or written to storage
+		unsigned int pendingSaves;		//!< Columns being saved
+		unsigned int failedSaves;		//!< Columns that could not be saved since construction
+	};
+
+	/**
+	 * \brief Constructor
+	 * \param world World where chunks are stored
+	 * \param generator Generator of chunks
+	 * \param pool Worker threads. Must outlive tasks, i.e. be destroyed after generator and storage and
+	 *	before world
+	 * \param storage Storage of saved chunks, nullptr to only generate
+	 * \param settings Parameters of streaming
+	 * \pre settings.loadRadius >= 0
+	 * \pre settings.unloadRadius >= settings.loadRadius
+	 */
+	ChunkStreamer(World& world, const TerrainGenerator& generator, ThreadPool& pool, WorldStorage* storage,
+		const Settings& settings);
+
+	~ChunkStreamer() = default;
+
+	ChunkStreamer(const ChunkStreamer&) = delete;
+	ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+	/**
+	 * \brief Used to advance the pipeline. Stores finished columns, evicts far columns, requests missing columns
+	 *	and starts meshing of dirty chunks. Does not wait for workers
+	 * \param center Position the world is loaded around, e.g. player position
+	 * \param changes Output, cleared and filled with chunks added and removed by this update
+	 */
+	void update(const glm::vec3& center, Changes& changes);
+
+	/**
+	 * \brief Used to queue chunk for meshing, e.g. after its blocks have changed. Coordinates without chunk are
+	 *	ignored, unless the chunk was removed after it was queued before, so its mesh is dropped
+	 * \param coord Chunk coordinates
+	 */
+	void markDirty(const ChunkCoord& coord);
+
+	/**
+	 * \brief Used to tell that blocks of chunk were edited, so its column is saved when it is evicted
+	 * \param coord Chunk coordinates
+	 */
+	void markModified(const ChunkCoord& coord);
+
+	/**
+	 * \brief Used to save every loaded column that was edited or has not been saved yet, e.g. on exit.
+	 *	Waits for saves in flight and writes on the calling thread. Does nothing without storage
+	 * \return True if every column was saved, otherwise false
+	 */
+	bool saveAll();
+
+	/**
+	 * \brief Used to take the oldest finished mesh
+	 * \param result Output, set only when a mesh was ready
+	 * \return True if a mesh was taken, otherwise false
+	 */
+	bool popMesh(MeshResult& result);
+
+	/**
+	 * \brief Used to get pipeline counters
+	 * \return Counters at the time of call
+	 */
+	Stats getStats() const;
+
+	/**
+	 * \brief Used to get column holding chunk
+	 * \param coord Chunk coordinates
+	 * \return Column coordinates
+	 */
+	static ColumnCoord toColumn(const ChunkCoord& coord);
+
+private:
+	using ColumnChunks = std::vector<std::pair<ChunkCoord, std::unique_ptr<Chunk>>>;
+
+	// Non-empty chunks of one column
+	struct LoadedColumn {
+		ColumnChunks chunks;	//!< Loaded or generated chunks
+		bool stored;			//!< True if chunks were loaded from storage
+	};
+
+	// Column generation in flight
+	struct ColumnTask {
+		ColumnCoord column;					//!< Column being generated
+		int requestTime;					//!< Timestamp in ms of the request
+		std::future<LoadedColumn> result;	//!< Loaded or generated chunks
+	};
+
+	// Saving of evicted columns in flight
+	struct SaveTask {
+		std::vector<ColumnCoord> columns;	//!< Columns being saved
+		std::future<bool> result;			//!< True if every column was saved
+	};
+
+	// Meshing in flight
+	struct MeshTask {
+		ChunkCoord coord;												//!< Chunk being meshed
+		unsigned int revision;											//!< Revision of chunk when blocks were copied
+		std::future<chunkMesher::LodMeshes> result;						//!< Mesh data per level of detail
+	};
+
+	World& m_world;								//!< World where chunks are stored
+	const TerrainGenerator& m_generator;		//!< Generator of chunks
+	ThreadPool& m_pool;							//!< Worker threads
+	WorldStorage* m_storage;					//!< Storage of saved chunks, may be nullptr
+	Settings m_settings;						//!< Parameters of streaming
+	std::vector<glm::ivec2> m_loadOffsets;		//!< Column offsets within load radius, nearest first
+
+	ColumnCoord m_center;												//!< Column at the center on last update
+	bool m_hasCenter;													//!< False until first update
+	std::unordered_set<ColumnCoord, ChunkCoordHash> m_loadedColumns;	//!< Columns stored in the world
+	std::unordered_set<ColumnCoord, ChunkCoordHash> m_pendingColumns;	//!< Columns being generated
+	std::vector<ColumnTask> m_columnTasks;								//!< Column generation in flight
+	std::size_t m_requestCursor;										//!< Index to m_loadOffsets where request scan
+																		//!< continues, reset when center moves
+																		//!< or a save finishes
+
+	std::unordered_set<ColumnCoord, ChunkCoordHash> m_storedColumns;	//!< Loaded columns whose blocks match storage
+	std::unordered_set<ColumnCoord, ChunkCoordHash> m_modifiedColumns;	//!< Loaded columns edited since stored
+	std::unordered_set<ColumnCoord, ChunkCoordHash> m_savingColumns;	//!< Columns being saved
+	std::vector<SaveTask> m_saveTasks;									//!< Saving in flight
+	unsigned int m_failedSaves;											//!< Columns that could not be saved
+
+	std::unordered_map<ChunkCoord, unsigned int, ChunkCoordHash> m_revisions;	//!< Revision of last change per
+																				//!< tracked chunk, used to drop
+																				//!< outdated meshes
+	unsigned int m_lastRevision;												//!< Revision of last change of any
+																				//!< chunk, so a chunk that is
+																				//!< removed and loaded again never
+																				//!< reuses a revision in flight
+	std::unordered_map<ChunkCoord, int, ChunkCoordHash> m_requestTimes;			//!< Request time of chunks not
+																				//!< meshed yet
+	std::unordered_set<ChunkCoord, ChunkCoordHash> m_dirtyChunks;				//!< Chunks waiting for meshing
+	std::vector<MeshTask> m_meshTasks;											//!< Meshing in flight
+	std::deque<MeshResult> m_readyMeshes;										//!< Finished meshes
+
+	/**
+	 * \brief Used to store finished columns in the world
+	 * \param changes Output, loaded chunks are appended
+	 */
+	void collectColumns(Changes& changes);
+
+	/**
+	 * \brief Used to remove columns further than unload radius from the center
+	 * \param changes Output, unloaded chunks are appended
+	 */
+	void evictColumns(Changes& changes);
+
+	/**
+	 * \brief Used to finish saves and allow saved columns to be requested again
+	 */
+	void collectSaves();
+
+	/**
+	 * \brief Used to test if loaded column has to be written to storage before it is dropped
+	 * \param column Column coordinates
+	 * \return True if storage exists and column was edited or has not been saved, otherwise false
+	 */
+	bool needsSave(const ColumnCoord& column) const;
+
+	/**
+	 * \brief Used to start generation of missing columns within load radius, nearest first
+	 */
+	void requestColumns();
+
+	/**
+	 * \brief Used to move finished meshes to ready queue and start meshing of dirty chunks
+	 */
+	void updateMeshes();
+
+	/**
+	 * \brief Used to test if column is within distance from the center
+	 * \param column Column coordinates
+	 * \param radius Distance in columns
+	 * \return True if column is within radius, otherwise false
+	 */
+	bool isWithin(const ColumnCoord& column, int radius) const;
+};
@@ -0,0 +1,43 @@
+#include "World/lodrings.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "Utility/contract.h"
+
+LodRings::LodRings(const Distances& distances) : m_distances(distances), m_center(), m_stats()
+{
+	REQUIRE(std::is_sorted(distances.begin(), distances.end()));
+}
+
+void LodRings::setCenter(const glm::vec3& position)
+{
+	// Position is rounded to the block holding it, blocks are centered on integer positions
+	m_center = World::toChunkCoord(glm::ivec3(
+		static_cast<int>(std::floor(position.x + 0.5f)),
+		static_cast<int>(std::floor(position.y + 0.5f)),
+		static_cast<int>(std::floor(position.z + 0.5f))));
+	m_stats.chunks.fill(0);
+	m_stats.vertices.fill(0);
+}
+
+int LodRings::select(const ChunkCoord& coord) const
+{
+	const int distance = std::max(std::abs(coord.x - m_center.x),
+		std::max(std::abs(coord.y - m_center.y), std::abs(coord.z - m_center.z)));
+	int lod = 0;
+	while (lod < static_cast<int>(m_distances.size()) && distance >= m_distances[lod]) { ++lod; }
+	return lod;
+}
+
+void LodRings::countDrawn(int lod, unsigned int vertices)
+{
+	REQUIRE(lod >= 0 && lod < chunkMesher::LOD_COUNT);
+	++m_stats.chunks[lod];
+	m_stats.vertices[lod] += vertices;
+}
+
+const ChunkCoord& LodRings::getCenter() const { return m_center; }
+
+const LodRings::Stats& LodRings::getStats() const { return m_stats; }
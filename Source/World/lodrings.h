@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+
+#pragma warning (push, 2)  // Temporarily set warning level 2
+#include <3rdParty/glm/glm.hpp>
+#pragma warning (pop)      // Restore back
+
+#include "World/chunkmesher.h"
+#include "World/world.h"
+
+// Selects level of detail of chunks in rings around the chunk holding a center position, e.g. the viewer
+//
+// Distance of a chunk is the largest coordinate difference to the center chunk, so that of two neighbouring
+// chunks the finer one is always on the side of the viewer. Chunks closer than the first limit use level 0,
+// chunks from limit n - 1 up to limit n level n, and chunks at or beyond the last limit the coarsest level.
+// Chunks and vertices drawn with each level are counted since the center was last set
+class LodRings {
+public:
+	using Distances = std::array<int, chunkMesher::LOD_COUNT - 1>;	//!< Chunk distance where levels 1, 2... start
+
+	// Counters of chunks drawn since the center was set, indexed with level of detail
+	struct Stats {
+		std::array<unsigned int, chunkMesher::LOD_COUNT> chunks;	//!< Chunks drawn with the level
+		std::array<unsigned int, chunkMesher::LOD_COUNT> vertices;	//!< Vertices drawn with the level
+	};
+
+	/**
+	 * \brief Constructor. Center is the chunk at the origin
+	 * \param distances Chunk distance where each coarser level starts
+	 * \pre distances are not decreasing
+	 */
+	explicit LodRings(const Distances& distances);
+
+	/**
+	 * \brief Used to move the rings and clear the counters, e.g. at the start of a frame
+	 * \param position Center position in world coordinates
+	 */
+	void setCenter(const glm::vec3& position);
+
+	/**
+	 * \brief Used to select level of detail of chunk
+	 * \param coord Chunk coordinates
+	 * \return Level of detail, 0..LOD_COUNT-1
+	 */
+	int select(const ChunkCoord& coord) const;
+
+	/**
+	 * \brief Used to count chunk drawn with level of detail
+	 * \param lod Level of detail returned by select
+	 * \param vertices Vertices drawn for the chunk
+	 * \pre lod >= 0 && lod < chunkMesher::LOD_COUNT
+	 */
+	void countDrawn(int lod, unsigned int vertices);
+
+	/**
+	 * \brief Used to get coordinates of the chunk holding the center
+	 * \return Center chunk coordinates
+	 */
+	const ChunkCoord& getCenter() const;
+
+	/**
+	 * \brief Used to get chunk and vertex counts drawn per level since the center was set
+	 * \return Counters
+	 */
+	const Stats& getStats() const;
+
+private:
+	Distances m_distances;	//!< Chunk distance where each coarser level starts
+	ChunkCoord m_center;	//!< Chunk holding the center
+	Stats m_stats;			//!< Draw counters per level of detail
+};
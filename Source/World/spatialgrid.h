@@ -0,0 +1,408 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#pragma warning (push, 2)  // Temporarily set warning level 2
+#include <3rdParty/glm/glm.hpp>
+#pragma warning (pop)      // Restore back
+
+#include "Utility/aabb.h"
+#include "Utility/contract.h"
+
+// Uniform grid spatial index of axis aligned boxes identified by key
+// Each entry is linked to every cell its box overlaps, so queries only look at entries in the cells
+// the query shape touches instead of scanning all entries
+// Entries can be added, moved and removed one at a time without rebuilding the grid
+// Not thread safe
+//
+// Key must be copyable and hashable with Hash
+template<typename Key, typename Hash = std::hash<Key>>
+class SpatialGrid {
+public:
+
+	/**
+	 * \brief Constructor. Creates empty grid
+	 * \param cellSize Width of one cubic cell in world units
+	 * \pre cellSize > 0.0f
+	 */
+	explicit SpatialGrid(float cellSize)
+		: m_cellSize(cellSize), m_entries(), m_cells(), m_minCell(), m_maxCell(), m_queryStamp(0)
+	{
+		REQUIRE(cellSize > 0.0f);
+	}
+
+	~SpatialGrid() = default;
+
+	SpatialGrid(const SpatialGrid&) = delete;
+	SpatialGrid& operator=(const SpatialGrid&) = delete;
+
+	/**
+	 * \brief Used to add entry or move existing entry to new box
+	 * \param key Key of the entry
+	 * \param box Box of the entry in world coordinates
+	 * \post contains(key)
+	 */
+	void set(const Key& key, const AABB& box)
+	{
+		auto it = m_entries.find(key);
+		if (it == m_entries.end()) {
+			it = m_entries.emplace(key, Entry{ key, box, glm::ivec3(), glm::ivec3(), 0 }).first;
+		}
+		else {
+			const auto minCell = toCell(box.min);
+			const auto maxCell = toCell(box.max);
+			Entry& entry = it->second;
+			entry.box = box;
+			// Moving inside the same cells only changes the box
+			if (minCell == entry.minCell && maxCell == entry.maxCell)
+				return;
+			unlink(entry);
+		}
+		link(it->second);
+
+		ENSURE(contains(key));
+	}
+
+	/**
+	 * \brief Used to remove entry
+	 * \param key Key of the entry
+	 * \return True if entry existed, otherwise false
+	 * \post !contains(key)
+	 */
+	bool remove(const Key& key)
+	{
+		const auto it = m_entries.find(key);
+		if (it == m_entries.end())
+			return false;
+
+		unlink(it->second);
+		m_entries.erase(it);
+
+		ENSURE(!contains(key));
+		return true;
+	}
+
+	/**
+	 * \brief Used to remove all entries
+	 */
+	void clear()
+	{
+		m_cells.clear();
+		m_entries.clear();
+	}
+
+	/**
+	 * \brief Used to test if entry exists
+	 * \param key Key of the entry
+	 * \return True if entry exists, otherwise false
+	 */
+	bool contains(const Key& key) const { return m_entries.find(key) != m_entries.end(); }
+
+	/**
+	 * \brief Used to get the count of entries
+	 * \return Count of entries
+	 */
+	std::size_t size() const { return m_entries.size(); }
+
+	/**
+	 * \brief Used to find entries whose box overlaps the box
+	 * \param box Query box in world coordinates
+	 * \param result Output, keys of overlapping entries are appended in no particular order
+	 */
+	void queryBox(const AABB& box, std::vector<Key>& result) const
+	{
+		forEachCandidate(box, [&box, &result](const Entry& entry) {
+			if (overlaps(entry.box, box))
+				result.push_back(entry.key);
+		});
+	}
+
+	/**
+	 * \brief Used to find entries whose box overlaps the sphere
+	 * \param center Sphere center in world coordinates
+	 * \param radius Sphere radius
+	 * \param result Output, keys of overlapping entries are appended in no particular order
+	 * \pre radius >= 0.0f
+	 */
+	void querySphere(const glm::vec3& center, float radius, std::vector<Key>& result) const
+	{
+		REQUIRE(radius >= 0.0f);
+
+		const AABB bounds{ center - glm::vec3(radius), center + glm::vec3(radius) };
+		forEachCandidate(bounds, [&center, radius, &result](const Entry& entry) {
+			// Distance from sphere center to the closest point of the box
+			const glm::vec3 closest = glm::clamp(center, entry.box.min, entry.box.max);
+			const glm::vec3 offset = closest - center;
+			if (glm::dot(offset, offset) <= radius * radius)
+				result.push_back(entry.key);
+		});
+	}
+
+	/**
+	 * \brief Used to find entries whose box is hit by the ray. Cells are walked in ray order until the ray
+	 *	leaves the cells that have entries, so maxDistance may be infinite
+	 * \param origin Ray start in world coordinates
+	 * \param direction Ray direction, does not need to be normalized
+	 * \param maxDistance Length of the ray in units of direction
+	 * \param result Output, keys of hit entries are appended sorted by distance to the hit
+	 * \pre maxDistance >= 0.0f
+	 * \pre direction != glm::vec3(0.0f)
+	 */
+	void queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<Key>& result) const
+	{
+		REQUIRE(maxDistance >= 0.0f);
+		REQUIRE(direction != glm::vec3(0.0f));
+		if (direction == glm::vec3(0.0f) || m_cells.empty())
+			return;
+
+		std::vector<std::pair<float, const Entry*>> hits;
+		const auto stamp = ++m_queryStamp;
+
+		// Walk the cells the ray passes through with 3D DDA
+		glm::ivec3 cell = toCell(origin);
+		glm::ivec3 step;
+		glm::vec3 tMax;
+		glm::vec3 tDelta;
+		for (int d = 0; d < 3; ++d) {
+			const float cellStart = cell[d] * m_cellSize;
+			if (direction[d] > 0.0f) {
+				step[d] = 1;
+				tDelta[d] = m_cellSize / direction[d];
+				tMax[d] = (cellStart + m_cellSize - origin[d]) / direction[d];
+			}
+			else if (direction[d] < 0.0f) {
+				step[d] = -1;
+				tDelta[d] = -m_cellSize / direction[d];
+				tMax[d] = (cellStart - origin[d]) / direction[d];
+			}
+			else {
+				step[d] = 0;
+				tDelta[d] = std::numeric_limits<float>::infinity();
+				tMax[d] = std::numeric_limits<float>::infinity();
+			}
+		}
+
+		float t = 0.0f;
+		while (t <= maxDistance && !leavesExtent(cell, step)) {
+			const auto it = m_cells.find(cell);
+			if (it != m_cells.end()) {
+				for (const Entry* entry : it->second) {
+					if (entry->queryStamp == stamp)
+						continue;
+					entry->queryStamp = stamp;
+
+					float hitDistance;
+					if (intersectRay(entry->box, origin, direction, maxDistance, hitDistance))
+						hits.emplace_back(hitDistance, entry);
+				}
+			}
+
+			// Step to the neighbouring cell whose border is closest along the ray
+			int axis = 0;
+			if (tMax.y < tMax[axis])
+				axis = 1;
+			if (tMax.z < tMax[axis])
+				axis = 2;
+			t = tMax[axis];
+			tMax[axis] += tDelta[axis];
+			cell[axis] += step[axis];
+		}
+
+		std::sort(hits.begin(), hits.end(),
+			[](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+		for (const auto& hit : hits) { result.push_back(hit.second->key); }
+	}
+
+private:
+	// Hash used to find cells
+	struct CellHash {
+		std::size_t operator()(const glm::ivec3& cell) const
+		{
+			return static_cast<std::size_t>(cell.x) * 73856093u
+				^ static_cast<std::size_t>(cell.y) * 19349663u
+				^ static_cast<std::size_t>(cell.z) * 83492791u;
+		}
+	};
+
+	// Indexed box and the range of cells it is linked to
+	struct Entry {
+		Key key;						//!< Key of the entry
+		AABB box;						//!< Box in world coordinates
+		glm::ivec3 minCell;				//!< First cell the entry is linked to
+		glm::ivec3 maxCell;				//!< Last cell the entry is linked to
+		mutable unsigned int queryStamp;//!< Stamp of the last query that visited entry, used to skip duplicates
+	};
+
+	float m_cellSize;														//!< Width of one cell
+	std::unordered_map<Key, Entry, Hash> m_entries;							//!< Entries by key, nodes do not move
+	std::unordered_map<glm::ivec3, std::vector<Entry*>, CellHash> m_cells;	//!< Entries overlapping each non-empty cell
+	glm::ivec3 m_minCell;													//!< Lowest cell linked since the grid was last empty
+	glm::ivec3 m_maxCell;													//!< Highest cell linked since the grid was last empty
+	mutable unsigned int m_queryStamp;										//!< Stamp of the last query
+
+	/**
+	 * \brief Used to get the cell holding a point
+	 * \param point Point in world coordinates
+	 * \return Cell coordinates
+	 */
+	glm::ivec3 toCell(const glm::vec3& point) const
+	{
+		return glm::ivec3(
+			static_cast<int>(std::floor(point.x / m_cellSize)),
+			static_cast<int>(std::floor(point.y / m_cellSize)),
+			static_cast<int>(std::floor(point.z / m_cellSize)));
+	}
+
+	/**
+	 * \brief Used to add entry to the cells its box overlaps
+	 * \param entry Entry with up to date box
+	 */
+	void link(Entry& entry)
+	{
+		entry.minCell = toCell(entry.box.min);
+		entry.maxCell = toCell(entry.box.max);
+		m_minCell = m_cells.empty() ? entry.minCell : glm::min(m_minCell, entry.minCell);
+		m_maxCell = m_cells.empty() ? entry.maxCell : glm::max(m_maxCell, entry.maxCell);
+		glm::ivec3 cell;
+		for (cell.y = entry.minCell.y; cell.y <= entry.maxCell.y; ++cell.y) {
+			for (cell.z = entry.minCell.z; cell.z <= entry.maxCell.z; ++cell.z) {
+				for (cell.x = entry.minCell.x; cell.x <= entry.maxCell.x; ++cell.x) {
+					m_cells[cell].push_back(&entry);
+				}
+			}
+		}
+	}
+
+	/**
+	 * \brief Used to remove entry from the cells it was linked to. Cells left empty are freed
+	 * \param entry Linked entry
+	 */
+	void unlink(const Entry& entry)
+	{
+		glm::ivec3 cell;
+		for (cell.y = entry.minCell.y; cell.y <= entry.maxCell.y; ++cell.y) {
+			for (cell.z = entry.minCell.z; cell.z <= entry.maxCell.z; ++cell.z) {
+				for (cell.x = entry.minCell.x; cell.x <= entry.maxCell.x; ++cell.x) {
+					const auto it = m_cells.find(cell);
+					if (it == m_cells.end())
+						continue;
+					auto& entries = it->second;
+					// Order inside a cell does not matter, swap with last to erase in constant time
+					const auto pos = std::find(entries.begin(), entries.end(), &entry);
+					if (pos != entries.end()) {
+						*pos = entries.back();
+						entries.pop_back();
+					}
+					if (entries.empty())
+						m_cells.erase(it);
+				}
+			}
+		}
+	}
+
+	/**
+	 * \brief Used to test if a ray walk is past the linked cells, i.e. no later cell can have entries
+	 * \param cell Current cell of the walk
+	 * \param step Direction of the walk on each axis, -1, 0 or 1
+	 * \return True if cell is outside of the extent on an axis the walk does not move towards it
+	 */
+	bool leavesExtent(const glm::ivec3& cell, const glm::ivec3& step) const
+	{
+		for (int d = 0; d < 3; ++d) {
+			if ((cell[d] > m_maxCell[d] && step[d] >= 0) || (cell[d] < m_minCell[d] && step[d] <= 0))
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * \brief Calls function once for every entry linked to the cells overlapping the box
+	 * \param box Box in world coordinates
+	 * \param func Callable with signature void(const Entry&)
+	 */
+	template<typename Func>
+	void forEachCandidate(const AABB& box, Func&& func) const
+	{
+		const auto stamp = ++m_queryStamp;
+		const auto visit = [stamp, &func](const Entry& entry) {
+			if (entry.queryStamp == stamp)
+				return;
+			entry.queryStamp = stamp;
+			func(entry);
+		};
+
+		const auto minCell = toCell(box.min);
+		const auto maxCell = toCell(box.max);
+		const glm::dvec3 span = glm::dvec3(maxCell - minCell) + glm::dvec3(1.0);
+
+		// Huge query box would visit mostly empty cells, scanning the entries is cheaper then
+		if (span.x * span.y * span.z > static_cast<double>(m_cells.size())) {
+			for (const auto& pair : m_entries) { visit(pair.second); }
+			return;
+		}
+
+		glm::ivec3 cell;
+		for (cell.y = minCell.y; cell.y <= maxCell.y; ++cell.y) {
+			for (cell.z = minCell.z; cell.z <= maxCell.z; ++cell.z) {
+				for (cell.x = minCell.x; cell.x <= maxCell.x; ++cell.x) {
+					const auto it = m_cells.find(cell);
+					if (it == m_cells.end())
+						continue;
+					for (const Entry* entry : it->second) { visit(*entry); }
+				}
+			}
+		}
+	}
+
+	/**
+	 * \brief Used to test if two boxes overlap. Touching boxes overlap
+	 * \param lhs First box
+	 * \param rhs Second box
+	 * \return True if boxes overlap, otherwise false
+	 */
+	static bool overlaps(const AABB& lhs, const AABB& rhs)
+	{
+		return lhs.min.x <= rhs.max.x && lhs.max.x >= rhs.min.x
+			&& lhs.min.y <= rhs.max.y && lhs.max.y >= rhs.min.y
+			&& lhs.min.z <= rhs.max.z && lhs.max.z >= rhs.min.z;
+	}
+
+	/**
+	 * \brief Used to intersect ray with box using the slab method
+	 * \param box Box in world coordinates
+	 * \param origin Ray start
+	 * \param direction Ray direction
+	 * \param maxDistance Length of the ray in units of direction
+	 * \param distance Output, distance to the point where ray enters the box, 0 if origin is inside
+	 * \return True if ray hits the box, otherwise false
+	 */
+	static bool intersectRay(const AABB& box, const glm::vec3& origin, const glm::vec3& direction,
+		float maxDistance, float& distance)
+	{
+		float tNear = 0.0f;
+		float tFar = maxDistance;
+		for (int d = 0; d < 3; ++d) {
+			if (direction[d] == 0.0f) {
+				if (origin[d] < box.min[d] || origin[d] > box.max[d])
+					return false;
+				continue;
+			}
+			float t0 = (box.min[d] - origin[d]) / direction[d];
+			float t1 = (box.max[d] - origin[d]) / direction[d];
+			if (t0 > t1)
+				std::swap(t0, t1);
+			tNear = std::max(tNear, t0);
+			tFar = std::min(tFar, t1);
+			if (tNear > tFar)
+				return false;
+		}
+		distance = tNear;
+		return true;
+	}
+};
@@ -0,0 +1,168 @@
+#include "World/terraingenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "Utility/contract.h"
+
+namespace {
+
+	/**
+	 * \brief Integer division that rounds towards negative infinity
+	 * \param value Dividend
+	 * \param divisor Positive divisor
+	 * \return value / divisor rounded down
+	 */
+	int floorDiv(int value, int divisor)
+	{
+		return (value >= 0 ? value : value - (divisor - 1)) / divisor;
+	}
+
+	/**
+	 * \brief Used to mix bits of integer so that neighbouring inputs give unrelated outputs
+	 * \param value Value to mix
+	 * \return Mixed value
+	 */
+	uint32_t mix(uint32_t value)
+	{
+		// Finalizer of MurmurHash3
+		value ^= value >> 16;
+		value *= 0x85ebca6bu;
+		value ^= value >> 13;
+		value *= 0xc2b2ae35u;
+		value ^= value >> 16;
+		return value;
+	}
+
+	/**
+	 * \brief Smooth interpolation weight with zero derivative at both ends
+	 * \param t Weight between 0..1
+	 * \return Smoothed weight
+	 */
+	float smooth(float t)
+	{
+		return t * t * (3.0f - 2.0f * t);
+	}
+
+} // anonymous namespace
+
+TerrainGenerator::TerrainGenerator(const Settings& settings) : m_settings(settings), m_noiseScale(0.0f)
+{
+	REQUIRE(settings.octaves > 0);
+	REQUIRE(settings.scale > 0.0f);
+
+	// Sum of octave amplitudes, used to keep the layered noise within -1..1
+	float sum = 0.0f;
+	float amplitude = 1.0f;
+	for (int i = 0; i < m_settings.octaves; ++i) {
+		sum += amplitude;
+		amplitude *= m_settings.persistence;
+	}
+	m_noiseScale = sum > 0.0f ? 1.0f / sum : 1.0f;
+}
+
+const TerrainGenerator::Settings& TerrainGenerator::getSettings() const { return m_settings; }
+
+int TerrainGenerator::getHeight(int x, int z) const
+{
+	float noise = 0.0f;
+	float amplitude = 1.0f;
+	float frequency = 1.0f / m_settings.scale;
+	for (int i = 0; i < m_settings.octaves; ++i) {
+		noise += amplitude * valueNoise(x * frequency, z * frequency, i);
+		amplitude *= m_settings.persistence;
+		frequency *= 2.0f;
+	}
+	return m_settings.baseHeight + static_cast<int>(std::floor(noise * m_noiseScale * m_settings.amplitude));
+}
+
+std::unique_ptr<Chunk> TerrainGenerator::generateChunk(const ChunkCoord& coord) const
+{
+	const glm::ivec3 origin = World::toWorldPos(coord);
+	if (origin.y > m_settings.baseHeight + m_settings.amplitude || origin.y + Chunk::SIZE - 1 < m_settings.bottom)
+		return nullptr;
+
+	// Surface heights of the columns, computed once per column instead of once per block
+	std::array<int, Chunk::SIZE * Chunk::SIZE> heights;
+	int maxHeight = m_settings.bottom - 1;
+	for (int z = 0; z < Chunk::SIZE; ++z) {
+		for (int x = 0; x < Chunk::SIZE; ++x) {
+			const int height = getHeight(origin.x + x, origin.z + z);
+			heights[x + z * Chunk::SIZE] = height;
+			maxHeight = std::max(maxHeight, height);
+		}
+	}
+	if (maxHeight < origin.y)
+		return nullptr;
+
+	auto chunk = std::make_unique<Chunk>();
+	const int top = std::min(Chunk::SIZE - 1, maxHeight - origin.y);
+	for (int y = 0; y <= top; ++y) {
+		for (int z = 0; z < Chunk::SIZE; ++z) {
+			for (int x = 0; x < Chunk::SIZE; ++x) {
+				const BlockId block = getBlock(origin.y + y, heights[x + z * Chunk::SIZE]);
+				if (block != AIR)
+					chunk->setBlock(x, y, z, block);
+			}
+		}
+	}
+
+	if (chunk->isEmpty())
+		return nullptr;
+	return chunk;
+}
+
+int TerrainGenerator::getMinChunkY() const
+{
+	return floorDiv(m_settings.bottom, Chunk::SIZE);
+}
+
+int TerrainGenerator::getMaxChunkY() const
+{
+	return floorDiv(m_settings.baseHeight + m_settings.amplitude, Chunk::SIZE);
+}
+
+float TerrainGenerator::valueNoise(float x, float z, int octave) const
+{
+	const float cellX = std::floor(x);
+	const float cellZ = std::floor(z);
+	const int x0 = static_cast<int>(cellX);
+	const int z0 = static_cast<int>(cellZ);
+	const float tx = smooth(x - cellX);
+	const float tz = smooth(z - cellZ);
+
+	// Bilinear interpolation between the four lattice values around the point
+	const float v00 = latticeValue(x0, z0, octave);
+	const float v10 = latticeValue(x0 + 1, z0, octave);
+	const float v01 = latticeValue(x0, z0 + 1, octave);
+	const float v11 = latticeValue(x0 + 1, z0 + 1, octave);
+	const float row0 = v00 + (v10 - v00) * tx;
+	const float row1 = v01 + (v11 - v01) * tx;
+	return row0 + (row1 - row0) * tz;
+}
+
+float TerrainGenerator::latticeValue(int x, int z, int octave) const
+{
+	uint32_t hash = mix(m_settings.seed + static_cast<uint32_t>(octave) * 0x9e3779b9u);
+	hash = mix(hash ^ static_cast<uint32_t>(x) * 0x27d4eb2du);
+	hash = mix(hash ^ static_cast<uint32_t>(z) * 0x165667b1u);
+
+	// Top 24 bits fit exactly in float mantissa
+	return static_cast<float>(hash >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+BlockId TerrainGenerator::getBlock(int y, int height) const
+{
+	if (y > height || y < m_settings.bottom)
+		return AIR;
+
+	if (height <= m_settings.sandLevel)
+		return y > height - m_settings.dirtDepth ? SAND : STONE;
+
+	if (y == height)
+		return height >= m_settings.snowLevel ? SNOW : GRASS;
+	if (y > height - m_settings.dirtDepth)
+		return DIRT;
+	return STONE;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "World/world.h"
+
+// Deterministic seed based terrain generator
+//
+// Surface height of each block column comes from layered value noise, i.e. octaves of smoothly
+// interpolated random values on a lattice hashed from the seed. Column material depends on the height:
+// low columns are sand, high columns are capped with snow and the rest are grass over dirt over stone
+//
+// Every chunk is a pure function of the settings and chunk coordinates, so chunks can be generated
+// independently on any thread and in any order with identical results. Generator has no mutable state
+// and is thread safe
+class TerrainGenerator {
+public:
+
+	// Parameters of generated terrain
+	struct Settings {
+		uint32_t seed = 1337;		//!< Seed of the noise, same seed gives same terrain
+		int baseHeight = 8;			//!< Average surface height
+		int amplitude = 24;			//!< Maximum distance of surface from baseHeight
+		float scale = 96.0f;		//!< Width of first octave noise cell in blocks
+		int octaves = 4;			//!< Count of noise layers, each with half the width of the previous
+		float persistence = 0.5f;	//!< Amplitude multiplier between octaves
+		int sandLevel = 1;			//!< Columns with surface at or below are sand
+		int snowLevel = 18;			//!< Columns with surface at or above are capped with snow
+		int dirtDepth = 3;			//!< Count of dirt blocks below grass
+		int bottom = -16;			//!< Lowest solid block layer
+	};
+
+	/**
+	 * \brief Constructor
+	 * \param settings Parameters of generated terrain
+	 * \pre settings.octaves > 0
+	 * \pre settings.scale > 0.0f
+	 */
+	explicit TerrainGenerator(const Settings& settings);
+
+	/**
+	 * \brief Used to access generator parameters
+	 * \return Reference to settings
+	 */
+	const Settings& getSettings() const;
+
+	/**
+	 * \brief Used to get surface height of block column
+	 * \param x Column position on x axis
+	 * \param z Column position on z axis
+	 * \return Y position of the highest solid block in column
+	 */
+	int getHeight(int x, int z) const;
+
+	/**
+	 * \brief Used to generate blocks of one chunk
+	 * \param coord Chunk coordinates
+	 * \return Pointer to generated chunk, nullptr if chunk would be empty
+	 */
+	std::unique_ptr<Chunk> generateChunk(const ChunkCoord& coord) const;
+
+	/**
+	 * \brief Used to get the lowest chunk layer that can hold generated blocks
+	 * \return Chunk coordinate on y axis
+	 */
+	int getMinChunkY() const;
+
+	/**
+	 * \brief Used to get the highest chunk layer that can hold generated blocks
+	 * \return Chunk coordinate on y axis
+	 */
+	int getMaxChunkY() const;
+
+private:
+	Settings m_settings;	//!< Parameters of generated terrain
+	float m_noiseScale;		//!< Multiplier that maps sum of octaves to -1..1
+
+	/**
+	 * \brief Used to get value noise of one octave
+	 * \param x Position on x axis in noise cell units
+	 * \param z Position on z axis in noise cell units
+	 * \param octave Octave index, selects the lattice
+	 * \return Noise value between -1..1
+	 */
+	float valueNoise(float x, float z, int octave) const;
+
+	/**
+	 * \brief Used to get random lattice value
+	 * \param x Lattice position on x axis
+	 * \param z Lattice position on z axis
+	 * \param octave Octave index
+	 * \return Value between -1..1
+	 */
+	float latticeValue(int x, int z, int octave) const;
+
+	/**
+	 * \brief Used to get block type in column
+	 * \param y Block position on y axis
+	 * \param height Surface height of the column
+	 * \return Block type
+	 */
+	BlockId getBlock(int y, int height) const;
+};
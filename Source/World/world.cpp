@@ -0,0 +1,130 @@
+#include "World/world.h"
+
+#include "Utility/contract.h"
+
+namespace {
+
+	/**
+	 * \brief Integer division that rounds towards negative infinity
+	 * \param value Dividend
+	 * \return value / Chunk::SIZE rounded down
+	 */
+	int floorDiv(int value)
+	{
+		return (value >= 0 ? value : value - (Chunk::SIZE - 1)) / Chunk::SIZE;
+	}
+
+} // anonymous namespace
+
+World::World() : m_chunks() {}
+
+World::~World() {}
+
+BlockId World::getBlock(const glm::ivec3& pos) const
+{
+	const auto it = m_chunks.find(toChunkCoord(pos));
+	if (it == m_chunks.end())
+		return AIR;
+
+	const auto local = toLocalPos(pos);
+	return it->second->getBlock(local.x, local.y, local.z);
+}
+
+void World::setBlock(const glm::ivec3& pos, BlockId id)
+{
+	REQUIRE(id < TERRAIN_TYPE_COUNT);
+
+	const auto coord = toChunkCoord(pos);
+	const auto local = toLocalPos(pos);
+	auto it = m_chunks.find(coord);
+	if (it == m_chunks.end()) {
+		// Do not allocate chunk just to store air
+		if (id == AIR)
+			return;
+		it = m_chunks.emplace(coord, std::make_unique<Chunk>()).first;
+	}
+
+	it->second->setBlock(local.x, local.y, local.z, id);
+	if (it->second->isEmpty())
+		m_chunks.erase(it);
+
+	ENSURE(getBlock(pos) == id);
+}
+
+const Chunk* World::getChunk(const ChunkCoord& coord) const
+{
+	const auto it = m_chunks.find(coord);
+	return it == m_chunks.end() ? nullptr : it->second.get();
+}
+
+Chunk& World::getOrCreateChunk(const ChunkCoord& coord)
+{
+	auto& chunk = m_chunks[coord];
+	if (!chunk)
+		chunk = std::make_unique<Chunk>();
+	return *chunk;
+}
+
+void World::setChunk(const ChunkCoord& coord, std::unique_ptr<Chunk> chunk)
+{
+	REQUIRE(chunk != nullptr);
+	if (chunk == nullptr || chunk->isEmpty()) {
+		m_chunks.erase(coord);
+		return;
+	}
+	m_chunks[coord] = std::move(chunk);
+}
+
+bool World::removeChunk(const ChunkCoord& coord) { return m_chunks.erase(coord) > 0; }
+
+std::unique_ptr<Chunk> World::takeChunk(const ChunkCoord& coord)
+{
+	const auto it = m_chunks.find(coord);
+	if (it == m_chunks.end())
+		return nullptr;
+
+	auto chunk = std::move(it->second);
+	m_chunks.erase(it);
+	return chunk;
+}
+
+void World::clear() { m_chunks.clear(); }
+
+const World::ChunkMap& World::getChunks() const { return m_chunks; }
+
+unsigned int World::getChunkCount() const { return static_cast<unsigned int>(m_chunks.size()); }
+
+unsigned int World::getBlockCount() const
+{
+	unsigned int count = 0;
+	for (const auto& pair : m_chunks) { count += pair.second->getSolidCount(); }
+	return count;
+}
+
+std::size_t World::getMemoryUsage() const
+{
+	// Each chunk costs the chunk itself and a hash map node holding key, pointer and bucket link
+	const std::size_t perChunk = sizeof(Chunk) + sizeof(ChunkMap::value_type) + sizeof(void*);
+	return sizeof(World) + m_chunks.size() * perChunk + m_chunks.bucket_count() * sizeof(void*);
+}
+
+ChunkCoord World::toChunkCoord(const glm::ivec3& pos)
+{
+	return ChunkCoord(floorDiv(pos.x), floorDiv(pos.y), floorDiv(pos.z));
+}
+
+glm::ivec3 World::toLocalPos(const glm::ivec3& pos)
+{
+	return pos - toWorldPos(toChunkCoord(pos));
+}
+
+glm::ivec3 World::toWorldPos(const ChunkCoord& coord)
+{
+	return coord * Chunk::SIZE;
+}
+
+AABB World::getChunkBounds(const ChunkCoord& coord)
+{
+	const glm::vec3 min = glm::vec3(toWorldPos(coord)) - glm::vec3(0.5f);
+	return AABB{ min, min + glm::vec3(static_cast<float>(Chunk::SIZE)) };
+}
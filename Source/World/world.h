@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+#pragma warning (push, 2)  // Temporarily set warning level 2
+#include <3rdParty/glm/glm.hpp>
+#pragma warning (pop)      // Restore back
+
+#include "Utility/aabb.h"
+#include "World/chunk.h"
+
+using ChunkCoord = glm::ivec3; // Chunk position in chunk units, block position divided by Chunk::SIZE
+
+// Hash used to store chunks in unordered containers
+struct ChunkCoordHash {
+	std::size_t operator()(const ChunkCoord& coord) const
+	{
+		// Large primes spread neighbouring coordinates to different buckets
+		return static_cast<std::size_t>(coord.x) * 73856093u
+			^ static_cast<std::size_t>(coord.y) * 19349663u
+			^ static_cast<std::size_t>(coord.z) * 83492791u;
+	}
+};
+
+// Sparse voxel storage of the world. Blocks are kept in chunks that are only allocated when they hold something
+// Block at integer position p occupies the unit cube centered at p, i.e. p - 0.5 .. p + 0.5
+// Not thread safe
+class World {
+public:
+	using ChunkMap = std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>, ChunkCoordHash>;
+
+	/**
+	 * \brief Constructor. Creates empty world
+	 */
+	World();
+
+	/**
+	 * \brief Destructor
+	 */
+	~World();
+
+	World(const World&) = delete;
+	World& operator=(const World&) = delete;
+
+	/**
+	 * \brief Used to get block in world position
+	 * \param pos Block position in world
+	 * \return Block id, AIR if position is in chunk that does not exist
+	 */
+	BlockId getBlock(const glm::ivec3& pos) const;
+
+	/**
+	 * \brief Used to set block in world position. Creates the chunk if needed and removes it if it becomes empty
+	 * \param pos Block position in world
+	 * \param id Block id to be set
+	 * \pre id < TERRAIN_TYPE_COUNT
+	 * \post getBlock(pos) == id
+	 */
+	void setBlock(const glm::ivec3& pos, BlockId id);
+
+	/**
+	 * \brief Used to access chunk
+	 * \param coord Chunk coordinates
+	 * \return Pointer to chunk, nullptr if chunk does not exist. Does not pass ownership
+	 */
+	const Chunk* getChunk(const ChunkCoord& coord) const;
+
+	/**
+	 * \brief Used to access chunk for writing. Creates empty chunk if it does not exist
+	 * \param coord Chunk coordinates
+	 * \return Reference to chunk
+	 */
+	Chunk& getOrCreateChunk(const ChunkCoord& coord);
+
+	/**
+	 * \brief Used to replace chunk with chunk built elsewhere, e.g. by terrain generator on another thread
+	 * \param coord Chunk coordinates
+	 * \param chunk Chunk to be stored. Empty chunk removes the existing chunk instead
+	 * \pre chunk != nullptr
+	 */
+	void setChunk(const ChunkCoord& coord, std::unique_ptr<Chunk> chunk);
+
+	/**
+	 * \brief Used to remove chunk and all blocks in it
+	 * \param coord Chunk coordinates
+	 * \return True if chunk existed, otherwise false
+	 */
+	bool removeChunk(const ChunkCoord& coord);
+
+	/**
+	 * \brief Used to remove chunk and take its ownership, e.g. to save it on another thread
+	 * \param coord Chunk coordinates
+	 * \return Removed chunk, nullptr if chunk did not exist
+	 */
+	std::unique_ptr<Chunk> takeChunk(const ChunkCoord& coord);
+
+	/**
+	 * \brief Used to remove all chunks
+	 */
+	void clear();
+
+	/**
+	 * \brief Used to access all chunks, e.g. for iteration
+	 * \return Map of chunk coordinates and chunks
+	 */
+	const ChunkMap& getChunks() const;
+
+	/**
+	 * \brief Calls function for every solid block in the world
+	 * \param func Callable with signature void(const glm::ivec3& position, BlockId id)
+	 */
+	template<typename Func>
+	void forEachBlock(Func&& func) const
+	{
+		for (const auto& pair : m_chunks) {
+			const Chunk& chunk = *pair.second;
+			if (chunk.isEmpty())
+				continue;
+
+			const glm::ivec3 origin = toWorldPos(pair.first);
+			const BlockId* data = chunk.getData();
+			for (int y = 0, i = 0; y < Chunk::SIZE; ++y) {
+				for (int z = 0; z < Chunk::SIZE; ++z) {
+					for (int x = 0; x < Chunk::SIZE; ++x, ++i) {
+						if (data[i] != AIR)
+							func(glm::ivec3(origin.x + x, origin.y + y, origin.z + z), data[i]);
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * \brief Used to get the count of allocated chunks
+	 * \return Count of chunks
+	 */
+	unsigned int getChunkCount() const;
+
+	/**
+	 * \brief Used to get the count of solid blocks in the world
+	 * \return Count of solid blocks
+	 */
+	unsigned int getBlockCount() const;
+
+	/**
+	 * \brief Used to estimate heap and object memory used by the world storage
+	 * \return Estimated size in bytes
+	 */
+	std::size_t getMemoryUsage() const;
+
+	/**
+	 * \brief Used to get chunk coordinates of the chunk holding world position
+	 * \param pos Block position in world
+	 * \return Chunk coordinates
+	 */
+	static ChunkCoord toChunkCoord(const glm::ivec3& pos);
+
+	/**
+	 * \brief Used to get chunk local position of world position
+	 * \param pos Block position in world
+	 * \return Local coordinates between 0..Chunk::SIZE-1
+	 */
+	static glm::ivec3 toLocalPos(const glm::ivec3& pos);
+
+	/**
+	 * \brief Used to get world position of chunk's first block
+	 * \param coord Chunk coordinates
+	 * \return Block position in world
+	 */
+	static glm::ivec3 toWorldPos(const ChunkCoord& coord);
+
+	/**
+	 * \brief Used to get the space covered by chunk, including the half block around its border blocks
+	 * \param coord Chunk coordinates
+	 * \return Bounding box of chunk in world coordinates
+	 */
+	static AABB getChunkBounds(const ChunkCoord& coord);
+
+private:
+	ChunkMap m_chunks;	//!< Allocated chunks
+};
@@ -0,0 +1,219 @@
+#include "World/worldquery.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Utility/contract.h"
+
+namespace worldQuery {
+
+	// Anonymous namespace to hide query helpers from namespace interface
+	namespace {
+
+		const float SKIN = 0.001f;	// Gap left between swept box and the block that stopped it
+
+		// Reads blocks from world while remembering the last chunk, so that walking through
+		// neighbouring blocks only does a chunk lookup when the walk crosses a chunk border
+		class BlockReader {
+		public:
+			explicit BlockReader(const World& world)
+				: m_world(world), m_coord(), m_chunk(nullptr), m_valid(false) {}
+
+			BlockId get(const glm::ivec3& pos)
+			{
+				const auto coord = World::toChunkCoord(pos);
+				if (!m_valid || coord != m_coord) {
+					m_coord = coord;
+					m_chunk = m_world.getChunk(coord);
+					m_valid = true;
+				}
+				if (m_chunk == nullptr)
+					return AIR;
+
+				const auto local = pos - World::toWorldPos(coord);
+				return m_chunk->getBlock(local.x, local.y, local.z);
+			}
+
+		private:
+			const World& m_world;
+			ChunkCoord m_coord;		// Coordinates of the remembered chunk
+			const Chunk* m_chunk;	// Remembered chunk, nullptr if it does not exist
+			bool m_valid;			// False until first lookup
+		};
+
+		/**
+		 * \brief Used to get the block whose unit cube holds the point
+		 * \param point Point in world coordinates
+		 * \return Block position
+		 */
+		glm::ivec3 toBlock(const glm::vec3& point)
+		{
+			return glm::ivec3(
+				static_cast<int>(std::floor(point.x + 0.5f)),
+				static_cast<int>(std::floor(point.y + 0.5f)),
+				static_cast<int>(std::floor(point.z + 0.5f)));
+		}
+
+		/**
+		 * \brief Used to get the range of blocks the box overlaps on one axis. Touching does not count
+		 * \param min Box minimum on the axis
+		 * \param max Box maximum on the axis
+		 * \param first Output, first overlapped block
+		 * \param last Output, last overlapped block, less than first if none
+		 */
+		void overlapRange(float min, float max, int& first, int& last)
+		{
+			// Block b spans b - 0.5 .. b + 0.5
+			first = static_cast<int>(std::floor(min - 0.5f)) + 1;
+			last = static_cast<int>(std::ceil(max + 0.5f)) - 1;
+		}
+
+		/**
+		 * \brief Used to test if any block in the layer of the box cross-section is solid
+		 * \param reader Block reader
+		 * \param axis Axis the layer is perpendicular to
+		 * \param layer Block coordinate of the layer on axis
+		 * \param first First block of the cross-section
+		 * \param last Last block of the cross-section
+		 * \return True if a solid block was found, otherwise false
+		 */
+		bool layerHasSolid(BlockReader& reader, int axis, int layer, const glm::ivec3& first, const glm::ivec3& last)
+		{
+			const int u = (axis + 1) % 3;
+			const int v = (axis + 2) % 3;
+			glm::ivec3 pos;
+			pos[axis] = layer;
+			for (pos[u] = first[u]; pos[u] <= last[u]; ++pos[u]) {
+				for (pos[v] = first[v]; pos[v] <= last[v]; ++pos[v]) {
+					if (reader.get(pos) != AIR)
+						return true;
+				}
+			}
+			return false;
+		}
+
+	} // anonymous namespace
+
+
+	bool raycast(const World& world, const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+		RaycastHit& hit)
+	{
+		REQUIRE(direction != glm::vec3(0.0f));
+		REQUIRE(maxDistance >= 0.0f);
+		if (direction == glm::vec3(0.0f))
+			return false;
+
+		const glm::vec3 dir = glm::normalize(direction);
+		BlockReader reader(world);
+
+		glm::ivec3 block = toBlock(origin);
+		glm::ivec3 step;
+		glm::vec3 tMax;
+		glm::vec3 tDelta;
+		for (int d = 0; d < 3; ++d) {
+			if (dir[d] > 0.0f) {
+				step[d] = 1;
+				tDelta[d] = 1.0f / dir[d];
+				tMax[d] = (block[d] + 0.5f - origin[d]) / dir[d];
+			}
+			else if (dir[d] < 0.0f) {
+				step[d] = -1;
+				tDelta[d] = -1.0f / dir[d];
+				tMax[d] = (block[d] - 0.5f - origin[d]) / dir[d];
+			}
+			else {
+				step[d] = 0;
+				tDelta[d] = std::numeric_limits<float>::infinity();
+				tMax[d] = std::numeric_limits<float>::infinity();
+			}
+		}
+
+		glm::ivec3 normal(0);
+		float distance = 0.0f;
+		for (;;) {
+			const BlockId type = reader.get(block);
+			if (type != AIR) {
+				hit = RaycastHit{ block, normal, distance, type };
+				return true;
+			}
+
+			// Cross the block face that is closest along the ray
+			int axis = 0;
+			if (tMax.y < tMax[axis])
+				axis = 1;
+			if (tMax.z < tMax[axis])
+				axis = 2;
+			distance = tMax[axis];
+			if (distance > maxDistance)
+				return false;
+
+			block[axis] += step[axis];
+			tMax[axis] += tDelta[axis];
+			normal = glm::ivec3(0);
+			normal[axis] = -step[axis];
+		}
+	}
+
+	SweepResult sweep(const World& world, const AABB& box, const glm::vec3& motion)
+	{
+		SweepResult result{ motion, { { false, false, false } } };
+		BlockReader reader(world);
+		AABB moved = box;
+
+		for (const int axis : { 1, 0, 2 }) {
+			float& delta = result.motion[axis];
+			if (delta == 0.0f)
+				continue;
+
+			// Blocks the box overlaps on the other two axes form the cross-section swept along axis
+			glm::ivec3 first;
+			glm::ivec3 last;
+			for (int d = 0; d < 3; ++d) { overlapRange(moved.min[d], moved.max[d], first[d], last[d]); }
+
+			if (delta > 0.0f) {
+				// Layers whose near face lies between the leading face and its destination
+				const int begin = static_cast<int>(std::ceil(moved.max[axis] + 0.5f - SKIN));
+				const int end = static_cast<int>(std::ceil(moved.max[axis] + delta + 0.5f)) - 1;
+				for (int layer = begin; layer <= end; ++layer) {
+					if (layerHasSolid(reader, axis, layer, first, last)) {
+						delta = std::max(0.0f, layer - 0.5f - moved.max[axis] - SKIN);
+						result.blocked[axis] = true;
+						break;
+					}
+				}
+			}
+			else {
+				const int begin = static_cast<int>(std::floor(moved.min[axis] - 0.5f + SKIN));
+				const int end = static_cast<int>(std::floor(moved.min[axis] + delta - 0.5f)) + 1;
+				for (int layer = begin; layer >= end; --layer) {
+					if (layerHasSolid(reader, axis, layer, first, last)) {
+						delta = std::min(0.0f, layer + 0.5f - moved.min[axis] + SKIN);
+						result.blocked[axis] = true;
+						break;
+					}
+				}
+			}
+
+			moved.min[axis] += delta;
+			moved.max[axis] += delta;
+		}
+
+		return result;
+	}
+
+	bool overlapsSolid(const World& world, const AABB& box)
+	{
+		glm::ivec3 first;
+		glm::ivec3 last;
+		for (int d = 0; d < 3; ++d) { overlapRange(box.min[d], box.max[d], first[d], last[d]); }
+
+		BlockReader reader(world);
+		for (int layer = first.y; layer <= last.y; ++layer) {
+			if (layerHasSolid(reader, 1, layer, first, last))
+				return true;
+		}
+		return false;
+	}
+
+} // namespace worldQuery
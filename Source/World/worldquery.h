@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+
+#pragma warning (push, 2)  // Temporarily set warning level 2
+#include <3rdParty/glm/glm.hpp>
+#pragma warning (pop)      // Restore back
+
+#include "Utility/aabb.h"
+#include "World/world.h"
+
+// Namespace to group geometric queries against world block storage
+// Queries walk the blocks directly, so their cost depends on the distance travelled and not on
+// the count of blocks in the world
+namespace worldQuery {
+
+	// First solid block hit by a ray
+	struct RaycastHit {
+		glm::ivec3 block;	//!< Position of the hit block
+		glm::ivec3 normal;	//!< Normal of the face that was hit, zero if ray started inside the block
+		float distance;		//!< Distance from ray origin to the hit point
+		BlockId type;		//!< Type of the hit block
+	};
+
+	// Outcome of moving a box through the world
+	struct SweepResult {
+		glm::vec3 motion;				//!< Motion that can be done without entering solid blocks
+		std::array<bool, 3> blocked;	//!< True for each axis on which motion was shortened
+	};
+
+	/**
+	 * \brief Used to find the first solid block along a ray. Walks blocks in ray order (Amanatides-Woo)
+	 * \param world World holding the blocks
+	 * \param origin Ray start in world coordinates
+	 * \param direction Ray direction, does not need to be normalized
+	 * \param maxDistance Length of the ray in world units
+	 * \param hit Output, set only when a block was hit
+	 * \pre direction != glm::vec3(0.0f)
+	 * \pre maxDistance >= 0.0f
+	 * \return True if a solid block was hit within maxDistance, otherwise false
+	 */
+	bool raycast(const World& world, const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+		RaycastHit& hit);
+
+	/**
+	 * \brief Used to move a box through the world without letting it enter solid blocks. Motion is resolved
+	 *	one axis at a time, vertical first, so that the box slides along walls and floors
+	 * \param world World holding the blocks
+	 * \param box Box at the start of the motion in world coordinates, should not overlap solid blocks
+	 * \param motion Wanted motion of the box
+	 * \return Allowed motion and the axes on which it was blocked
+	 */
+	SweepResult sweep(const World& world, const AABB& box, const glm::vec3& motion);
+
+	/**
+	 * \brief Used to test if box overlaps any solid block. Touching a block does not count as overlap
+	 * \param world World holding the blocks
+	 * \param box Box in world coordinates
+	 * \return True if box overlaps a solid block, otherwise false
+	 */
+	bool overlapsSolid(const World& world, const AABB& box);
+
+} // namespace worldQuery
@@ -0,0 +1,329 @@
+#include "World/worldstorage.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <tuple>
+
+#include "Utility/contract.h"
+#include "Utility/utility.h"
+#include "World/chunkcodec.h"
+
+namespace {
+
+	const uint32_t MAGIC = 0x4E475242;	//!< "BRGN" in little endian
+	const uint32_t VERSION = 1;			//!< Incremented when layout changes
+
+	const int SLOT_COUNT = WorldStorage::REGION_SIZE * WorldStorage::REGION_SIZE * WorldStorage::REGION_SIZE;
+	const std::size_t HEADER_SIZE = 8;	//!< Magic and version
+	const std::size_t ENTRY_SIZE = 8;	//!< Offset and size of payload, offset 0 means chunk is not stored
+	const std::size_t DATA_START = HEADER_SIZE + SLOT_COUNT * ENTRY_SIZE;
+
+	// Regions are small, mapping many of them at once only costs handles and address space
+	const std::size_t MAX_CACHED_REGIONS = 64;
+
+	// Region is compacted when replaced payloads take at least this many bytes and more than the live ones
+	const std::size_t COMPACT_DEAD_BYTES = 64 * 1024;
+
+	// Location of chunk's payload in region file, offset 0 means chunk is not stored
+	struct Entry {
+		std::size_t offset;
+		std::size_t size;
+	};
+
+	/**
+	 * \brief Integer division that rounds towards negative infinity
+	 * \param value Dividend
+	 * \return value / REGION_SIZE rounded down
+	 */
+	int floorDiv(int value)
+	{
+		return (value >= 0 ? value : value - (WorldStorage::REGION_SIZE - 1)) / WorldStorage::REGION_SIZE;
+	}
+
+	/**
+	 * \brief Used to get index of chunk's table entry in its region
+	 * \param coord Chunk coordinates
+	 * \return Index between 0..SLOT_COUNT-1
+	 */
+	int slotIndex(const ChunkCoord& coord)
+	{
+		const auto local = coord - WorldStorage::toRegion(coord) * WorldStorage::REGION_SIZE;
+		return local.x + WorldStorage::REGION_SIZE * (local.z + WorldStorage::REGION_SIZE * local.y);
+	}
+
+	/**
+	 * \brief Used to read little endian 32 bit value
+	 * \param data At least 4 bytes
+	 * \return Value
+	 */
+	uint32_t readU32(const uint8_t* data)
+	{
+		return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8
+			| static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+	}
+
+	/**
+	 * \brief Used to append little endian 32 bit value
+	 * \param value Value to be written
+	 * \param out Output, 4 bytes are appended
+	 */
+	void writeU32(uint32_t value, std::vector<uint8_t>& out)
+	{
+		for (int i = 0; i < 4; ++i) { out.push_back(static_cast<uint8_t>(value >> (i * 8))); }
+	}
+
+	/**
+	 * \brief Used to write little endian 32 bit value in place
+	 * \param value Value to be written
+	 * \param out At least 4 bytes
+	 */
+	void storeU32(uint32_t value, uint8_t* out)
+	{
+		for (int i = 0; i < 4; ++i) { out[i] = static_cast<uint8_t>(value >> (i * 8)); }
+	}
+
+	/**
+	 * \brief Used to read table entry of chunk
+	 * \param head Header and table of region file
+	 * \param slot Index of chunk's table entry
+	 * \return Entry
+	 */
+	Entry readEntry(const uint8_t* head, int slot)
+	{
+		const uint8_t* entry = head + HEADER_SIZE + slot * ENTRY_SIZE;
+		return Entry{ readU32(entry), readU32(entry + 4) };
+	}
+
+	/**
+	 * \brief Used to write table entry of chunk
+	 * \param slot Index of chunk's table entry
+	 * \param entry Entry to be written
+	 * \param head Output, header and table of region file
+	 */
+	void storeEntry(int slot, const Entry& entry, uint8_t* head)
+	{
+		storeU32(static_cast<uint32_t>(entry.offset), head + HEADER_SIZE + slot * ENTRY_SIZE);
+		storeU32(static_cast<uint32_t>(entry.size), head + HEADER_SIZE + slot * ENTRY_SIZE + 4);
+	}
+
+	/**
+	 * \brief Used to build region file holding only the payloads still in use, followed by new payloads
+	 * \param file Region file
+	 * \param head Header and table of region file
+	 * \param replaced Chunks whose old payload is dropped, indexed with slot
+	 * \param payloads New payloads
+	 * \param entries Slots of new payloads and their location in payloads
+	 * \param out Output, contents of compacted region file
+	 * \return True if the file could be read and the result fits 32 bit offsets, otherwise false
+	 */
+	bool buildCompacted(std::fstream& file, const std::vector<uint8_t>& head, const std::vector<bool>& replaced,
+		const std::vector<uint8_t>& payloads, const std::vector<std::pair<int, Entry>>& entries, std::vector<uint8_t>& out)
+	{
+		out = head;
+		for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+			const Entry entry = readEntry(head.data(), slot);
+			if (replaced[slot] || entry.offset == 0)
+				continue;
+
+			const std::size_t offset = out.size();
+			out.resize(offset + entry.size);
+			if (entry.size > 0 && !file.seekg(entry.offset).read(reinterpret_cast<char*>(&out[offset]), entry.size))
+				return false;
+			storeEntry(slot, Entry{ offset, entry.size }, out.data());
+		}
+
+		const std::size_t start = out.size();
+		out.insert(out.end(), payloads.begin(), payloads.end());
+		if (out.size() > UINT32_MAX)
+			return false;
+		for (const auto& entry : entries) {
+			storeEntry(entry.first, Entry{ start + entry.second.offset, entry.second.size }, out.data());
+		}
+		return true;
+	}
+
+	/**
+	 * \brief Used to test that mapped region starts with a valid header and full table
+	 * \param file Mapped region file
+	 * \return True if file can be read, otherwise false
+	 */
+	bool isValidRegion(const MappedFile& file)
+	{
+		return file.getSize() >= DATA_START && readU32(file.getData()) == MAGIC && readU32(file.getData() + 4) == VERSION;
+	}
+
+} // anonymous namespace
+
+WorldStorage::WorldStorage(const std::string& directory) : m_directory(directory), m_mutex(), m_regions()
+{
+	REQUIRE(!directory.empty());
+	if (!m_directory.empty() && m_directory.back() != '/' && m_directory.back() != '\\')
+		m_directory += '/';
+	utility::createDirectories(m_directory);
+}
+
+bool WorldStorage::saveChunks(const std::vector<std::pair<ChunkCoord, const Chunk*>>& chunks)
+{
+	// Ordered so that regions are written in a stable order
+	std::map<std::tuple<int, int, int>, std::vector<std::pair<ChunkCoord, const Chunk*>>> regions;
+	for (const auto& pair : chunks) {
+		const auto region = toRegion(pair.first);
+		regions[std::make_tuple(region.x, region.y, region.z)].push_back(pair);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	bool success = true;
+	for (const auto& pair : regions) {
+		const RegionCoord region(std::get<0>(pair.first), std::get<1>(pair.first), std::get<2>(pair.first));
+
+		// Readers still holding the old mapping see the old table, new readers map the written file. Cached
+		// mapping is dropped first, so that the file can be replaced when it is compacted
+		m_regions.erase(region);
+		success = writeRegion(region, pair.second) && success;
+	}
+	return success;
+}
+
+WorldStorage::LOAD_STATUS WorldStorage::loadChunk(const ChunkCoord& coord, std::unique_ptr<Chunk>& chunk)
+{
+	chunk = nullptr;
+	const auto file = getRegion(toRegion(coord));
+	if (file == nullptr)
+		return NOT_STORED;
+	if (!isValidRegion(*file))
+		return CORRUPT;
+
+	const uint8_t* entry = file->getData() + HEADER_SIZE + slotIndex(coord) * ENTRY_SIZE;
+	const std::size_t offset = readU32(entry);
+	const std::size_t size = readU32(entry + 4);
+	if (offset == 0)
+		return NOT_STORED;
+	if (size == 0)
+		return STORED;
+	if (offset < DATA_START || offset + size > file->getSize())
+		return CORRUPT;
+
+	auto loaded = std::make_unique<Chunk>();
+	if (!chunkCodec::decode(file->getData() + offset, size, *loaded))
+		return CORRUPT;
+	if (!loaded->isEmpty())
+		chunk = std::move(loaded);
+	return STORED;
+}
+
+const std::string& WorldStorage::getDirectory() const { return m_directory; }
+
+WorldStorage::RegionCoord WorldStorage::toRegion(const ChunkCoord& coord)
+{
+	return RegionCoord(floorDiv(coord.x), floorDiv(coord.y), floorDiv(coord.z));
+}
+
+std::shared_ptr<const MappedFile> WorldStorage::getRegion(const RegionCoord& region)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const auto it = m_regions.find(region);
+	if (it != m_regions.end())
+		return it->second;
+
+	if (m_regions.size() >= MAX_CACHED_REGIONS)
+		m_regions.clear();
+
+	auto file = std::make_shared<MappedFile>();
+	if (!file->open(getRegionPath(region)))
+		file = nullptr;
+	m_regions.emplace(region, file);
+	return file;
+}
+
+bool WorldStorage::writeRegion(const RegionCoord& region, const std::vector<std::pair<ChunkCoord, const Chunk*>>& chunks)
+{
+	const auto path = getRegionPath(region);
+	std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+	if (!file.is_open()) {
+		// New region starts with an empty table
+		std::vector<uint8_t> header;
+		writeU32(MAGIC, header);
+		writeU32(VERSION, header);
+		header.resize(DATA_START, 0);
+		std::ofstream create(path, std::ios::binary);
+		create.write(reinterpret_cast<const char*>(header.data()), header.size());
+		create.close();
+		if (!create)
+			return false;
+		file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+		if (!file.is_open())
+			return false;
+	}
+
+	std::vector<uint8_t> head(DATA_START);
+	if (!file.read(reinterpret_cast<char*>(head.data()), head.size()) || readU32(head.data()) != MAGIC
+		|| readU32(head.data() + 4) != VERSION)
+		return false;
+
+	file.seekp(0, std::ios::end);
+	const auto end = static_cast<std::size_t>(file.tellp());
+
+	// Encode all payloads first, so the file is written with one append
+	std::vector<uint8_t> payloads;
+	std::vector<std::pair<int, Entry>> entries;
+	std::vector<bool> replaced(SLOT_COUNT, false);
+	for (const auto& pair : chunks) {
+		const std::size_t start = payloads.size();
+		if (pair.second != nullptr && !pair.second->isEmpty())
+			chunkCodec::encode(*pair.second, payloads);
+		entries.emplace_back(slotIndex(pair.first), Entry{ start, payloads.size() - start });
+		replaced[entries.back().first] = true;
+	}
+
+	// Space of payloads no table entry points to is reclaimed by writing the region again, but only if every
+	// entry left is readable
+	std::size_t live = 0;
+	bool intact = true;
+	for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+		const Entry entry = readEntry(head.data(), slot);
+		if (replaced[slot] || entry.offset == 0 || entry.size == 0)
+			continue;
+		intact = intact && entry.offset >= DATA_START && entry.offset + entry.size <= end;
+		live += entry.size;
+	}
+	const std::size_t used = end - DATA_START;
+	if (intact && live <= used && used - live >= COMPACT_DEAD_BYTES && used - live > live) {
+		// Replacing fails while the file is mapped on Windows, then chunks are appended as usual
+		std::vector<uint8_t> compacted;
+		if (buildCompacted(file, head, replaced, payloads, entries, compacted)) {
+			file.close();
+			const auto temporary = path + ".tmp";
+			std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+			out.write(reinterpret_cast<const char*>(compacted.data()), compacted.size());
+			out.close();
+			if (out && utility::replaceFile(temporary, path))
+				return true;
+			std::remove(temporary.c_str());
+			file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+			if (!file.is_open())
+				return false;
+		}
+		file.clear();
+	}
+
+	// New payloads go after the old ones, table entries are updated only after they have been written
+	if (end + payloads.size() > UINT32_MAX)
+		return false;
+	file.seekp(end);
+	file.write(reinterpret_cast<const char*>(payloads.data()), payloads.size());
+	file.flush();
+	for (const auto& entry : entries) {
+		storeEntry(entry.first, Entry{ end + entry.second.offset, entry.second.size }, head.data());
+		file.seekp(HEADER_SIZE + entry.first * ENTRY_SIZE);
+		file.write(reinterpret_cast<const char*>(head.data() + HEADER_SIZE + entry.first * ENTRY_SIZE), ENTRY_SIZE);
+	}
+	file.flush();
+	return static_cast<bool>(file);
+}
+
+std::string WorldStorage::getRegionPath(const RegionCoord& region) const
+{
+	return m_directory + "r." + utility::toStr(region.x) + "." + utility::toStr(region.y) + "." + utility::toStr(region.z) + ".region";
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#pragma warning (push, 2)  // Temporarily set warning level 2
+#include <3rdParty/glm/glm.hpp>
+#pragma warning (pop)      // Restore back
+
+#include "Utility/mappedfile.h"
+#include "World/world.h"
+
+// Saves chunks to region files and loads them back through memory mapped reads
+//
+// Region file holds REGION_SIZE^3 chunks. It starts with a header and a table with offset and size of each
+// chunk's payload, followed by payloads encoded with chunkCodec. Saving appends new payloads to the end of
+// the file and only then updates their table entries, so a file cut short by a crash still points to
+// complete older payloads. Once replaced payloads take more space than live ones, the region is written
+// again without them to a temporary file that replaces the old one in one step.
+// Loading maps the region file and decodes the one chunk straight from the mapping, nothing else is read
+//
+// Chunk can be stored as empty, which tells it is known to hold only AIR, unlike a chunk that was never saved.
+// All functions are thread safe. Saving blocks other saves and cache lookups, decoding runs in parallel
+class WorldStorage {
+public:
+	using RegionCoord = glm::ivec3; //!< Region position in region units, chunk position divided by REGION_SIZE
+
+	static const int REGION_SIZE = 8;	//!< Chunks per region edge
+
+	// Result of loading one chunk
+	enum LOAD_STATUS {
+		NOT_STORED,	//!< Chunk has never been saved
+		STORED,		//!< Chunk was loaded, or stored as empty
+		CORRUPT		//!< Chunk is in storage but could not be read
+	};
+
+	/**
+	 * \brief Constructor. Creates the save directory if it does not exist
+	 * \param directory Directory of region files, ending with path separator
+	 * \pre !directory.empty()
+	 */
+	explicit WorldStorage(const std::string& directory);
+
+	~WorldStorage() = default;
+
+	WorldStorage(const WorldStorage&) = delete;
+	WorldStorage& operator=(const WorldStorage&) = delete;
+
+	/**
+	 * \brief Used to save chunks. Chunks of the same region are written with one append
+	 * \param chunks Chunk coordinates and chunks. nullptr or empty chunk is stored as empty
+	 * \return True if every chunk was saved, otherwise false
+	 */
+	bool saveChunks(const std::vector<std::pair<ChunkCoord, const Chunk*>>& chunks);
+
+	/**
+	 * \brief Used to load one chunk
+	 * \param coord Chunk coordinates
+	 * \param chunk Output, loaded chunk when status is STORED, nullptr if chunk is stored as empty
+	 * \return Status of the chunk in storage
+	 */
+	LOAD_STATUS loadChunk(const ChunkCoord& coord, std::unique_ptr<Chunk>& chunk);
+
+	/**
+	 * \brief Used to get the directory of region files
+	 * \return Directory given to constructor
+	 */
+	const std::string& getDirectory() const;
+
+	/**
+	 * \brief Used to get region holding chunk
+	 * \param coord Chunk coordinates
+	 * \return Region coordinates
+	 */
+	static RegionCoord toRegion(const ChunkCoord& coord);
+
+private:
+	using RegionCache = std::unordered_map<RegionCoord, std::shared_ptr<const MappedFile>, ChunkCoordHash>;
+
+	std::string m_directory;	//!< Directory of region files
+	std::mutex m_mutex;			//!< Guards region files and the cache
+	RegionCache m_regions;		//!< Mapped regions, nullptr for regions without file. Dropped when region is saved
+
+	/**
+	 * \brief Used to get mapped region file, maps the file on first use
+	 * \param region Region coordinates
+	 * \return Mapped file, nullptr if region has no file. Stays valid while held, even if region is saved
+	 */
+	std::shared_ptr<const MappedFile> getRegion(const RegionCoord& region);
+
+	/**
+	 * \brief Used to append chunks of one region to its file, creates the file if needed. Compacts the file
+	 *	instead when enough of it is taken by replaced payloads and it is not mapped. Caller holds m_mutex
+	 * \param region Region coordinates
+	 * \param chunks Chunks inside the region
+	 * \return True if chunks were written, otherwise false
+	 */
+	bool writeRegion(const RegionCoord& region, const std::vector<std::pair<ChunkCoord, const Chunk*>>& chunks);
+
+	/**
+	 * \brief Used to get path of region file
+	 * \param region Region coordinates
+	 * \return Path to file
+	 */
+	std::string getRegionPath(const RegionCoord& region) const;
+};
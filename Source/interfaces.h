@@ -19,9 +19,13 @@ public:
 	virtual bool vInitialize(std::string&& windowName, std::function<void(float)>&& gameLogic) = 0;
 	virtual void vStartMainLoop() = 0;
 	virtual ShaderProgram* vGetShaderProgram() const = 0;
+	virtual ShaderProgram* vGetChunkShaderProgram() const = 0;
+	virtual void vSetViewMatrix(const glm::mat4& view) = 0;
+	virtual glm::mat4 vGetViewProjectionMatrix() const = 0;
 	virtual void vGetCursorPosition(double& x, double& y) const = 0;
 	virtual void vCenterCursor() const = 0;
 	virtual bool vKeyPressed(int key) const = 0;
+	virtual bool vMouseButtonPressed(int button) const = 0;
 	virtual bool vWindowSizeChanged() const = 0;
 };
 
@@ -31,6 +35,7 @@ public:
 
 	virtual bool vLoadFile(std::ifstream& stream) = 0;
 	virtual std::unique_ptr<uint8_t[]> vDecode() = 0;
+	virtual bool vDecodeTo(uint8_t* destination, int stride, int channels) = 0;
 	virtual int vGetHeight() const = 0;
 	virtual int vGetWidth() const = 0;
 };
@@ -43,19 +48,19 @@ public:
 
 	virtual EventType vGetEventType() const = 0;
 	virtual long vGetCreateTime() const = 0;
-	virtual std::string vGetEventName() const = 0;
+	virtual const std::string& vGetEventName() const = 0;
 };
 
 using ListenerId = int;
 using EventDataPtr = std::shared_ptr<IEvent>;
 using EventDelegate = std::function<void(EventDataPtr)>;
-using EventListenerVector = std::vector<std::tuple<ListenerId, std::function<void(EventDataPtr)>>>;
 
 class IEventManager {
 public:
 	virtual ~IEventManager() {}
 
 	virtual ListenerId registerListener() = 0;
+	virtual ListenerId registerThreadSafeListener() = 0;
 	virtual bool addListener(const EventType evtType, const ListenerId listener, const EventDelegate evtDelegate) = 0;
 	virtual bool removeListener(const EventType evtType, const ListenerId listener) = 0;
 	virtual void triggerEvent(EventDataPtr pEvent) = 0;
@@ -1,5 +1,13 @@
 #include "3rdParty/gtest/gtest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "Event/eventmanager_test.h"
 #include "Utility/locator.h"
 #include "Utility/utility.h"
@@ -120,6 +128,32 @@ namespace {
 		EXPECT_EQ(m_evtMgr->getEventListenerCount(TestEvent::eventType), g_callbackCounter);
 	}
 
+	TEST_F(EventManagerTest, listenerSwappedDuringDispatchWaitsForNextEvent) {
+		m_evtMgr->clearListeners();
+		TestClass1 original;
+		TestClass2 replacement;
+		bool swapped = false;
+
+		// Delegate replaces a listener that has not been called yet, dispatch in progress calls neither
+		EventListener swapping;
+		EXPECT_TRUE(swapping.registerForEvent(TestEvent::eventType, [&](std::shared_ptr<IEvent>) {
+			if (!swapped) {
+				EXPECT_TRUE(original.unregisterListener());
+				EXPECT_TRUE(replacement.registerListener());
+				swapped = true;
+			}
+		}));
+		EXPECT_TRUE(original.registerListener());
+
+		m_evtMgr->triggerEvent(std::make_shared<TestEvent>());
+		EXPECT_TRUE(swapped);
+		EXPECT_EQ(g_callbackCounter, 0);
+
+		// Replacement gets the next event
+		m_evtMgr->triggerEvent(std::make_shared<TestEvent>());
+		EXPECT_EQ(g_callbackCounter, 1);
+	}
+
 	// Test queueEvent
 #ifdef NDEBUG
 	TEST_F(EventManagerTest, queueInvalidEvent) { // This test breaks precondition and therefore cannot be run in debug mode
@@ -137,6 +171,103 @@ namespace {
 		EXPECT_TRUE(m_evtMgr->queueEvent(std::make_shared<TestEvent2>()));
 		EXPECT_EQ(m_evtMgr->getQueueLength(), 2);
 	}
+	TEST_F(EventManagerTest, queueFromManyThreadsWhileUpdating) {
+		const int producers = 4;
+		const int perProducer = 10000;
+		std::atomic<int> producing(producers);
+		std::vector<std::thread> threads;
+		for (int i = 0; i < producers; ++i) {
+			threads.emplace_back([this, &producing, perProducer]() {
+				for (int j = 0; j < perProducer; ++j) {
+					EXPECT_TRUE(m_evtMgr->queueEvent(std::make_shared<TestEvent>()));
+				}
+				--producing;
+			});
+		}
+
+		// Single consumer drains the queue while producers are still pushing
+		while (producing > 0 || m_evtMgr->getQueueLength() > 0) {
+			m_evtMgr->onUpdate(10);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		EXPECT_EQ(g_callbackCounter, producers * perProducer);
+	}
+
+	// Test typed events
+	TEST_F(EventManagerTest, emplacedEventReachesTypedDelegate) {
+		const ListenerId listener = m_evtMgr->registerListener();
+		std::vector<int> values;
+		std::string text;
+		EXPECT_TRUE(m_evtMgr->addTypedListener<TestTypedEvent>(listener, [&values, &text](const TestTypedEvent& evt) {
+			values.push_back(evt.value);
+			text = evt.text;
+		}));
+
+		EXPECT_TRUE(m_evtMgr->emplaceEvent<TestTypedEvent>(1, "first"));
+		EXPECT_TRUE(m_evtMgr->emplaceEvent<TestTypedEvent>(2, "second"));
+		EXPECT_EQ(m_evtMgr->getQueueLength(), 2);
+		EXPECT_EQ(TestTypedEvent::liveCount, 2);
+
+		m_evtMgr->onUpdate(1000);
+		EXPECT_EQ(values, std::vector<int>({ 1, 2 }));
+		EXPECT_EQ(text, "second");
+		EXPECT_EQ(TestTypedEvent::liveCount, 0);
+		EXPECT_TRUE(m_evtMgr->removeListener(TestTypedEvent::eventType, listener));
+	}
+	TEST_F(EventManagerTest, triggerTypedEventDoesNotCopy) {
+		const ListenerId listener = m_evtMgr->registerListener();
+		const TestTypedEvent evt(3, "immediate");
+		const TestTypedEvent* received = nullptr;
+		EXPECT_TRUE(m_evtMgr->addTypedListener<TestTypedEvent>(listener, [&received](const TestTypedEvent& evt) { received = &evt; }));
+
+		m_evtMgr->triggerTypedEvent(evt);
+		EXPECT_EQ(received, &evt);
+		EXPECT_TRUE(m_evtMgr->removeListener(TestTypedEvent::eventType, listener));
+	}
+	TEST_F(EventManagerTest, typedAndSharedDelegatesGetOnlyTheirType) {
+		// Typed delegate for the event type of TestEvent is not called for shared TestEvents, nor the other way round
+		const ListenerId listener = m_evtMgr->registerListener();
+		int typedCalls = 0;
+		EXPECT_TRUE(m_evtMgr->addTypedListener<TestTypedEvent2>(listener, [&typedCalls](const TestTypedEvent2&) { ++typedCalls; }));
+
+		EXPECT_TRUE(m_evtMgr->queueEvent(std::make_shared<TestEvent>()));
+		EXPECT_TRUE(m_evtMgr->emplaceEvent<TestTypedEvent2>());
+		m_evtMgr->onUpdate(1000);
+		EXPECT_EQ(g_callbackCounter, 1);
+		EXPECT_EQ(typedCalls, 1);
+
+		// Listener has one delegate per event type, typed or not
+		EXPECT_FALSE(m_evtMgr->addListener(TestEvent::eventType, listener, &TestClass2::callback));
+		EXPECT_TRUE(m_evtMgr->removeListener(TestEvent::eventType, listener));
+	}
+	TEST_F(EventManagerTest, typedAndSharedEventsKeepQueueOrder) {
+		const ListenerId listener = m_evtMgr->registerListener();
+		std::vector<int> order;
+		EXPECT_TRUE(m_evtMgr->addTypedListener<TestTypedEvent>(listener, [&order](const TestTypedEvent& evt) { order.push_back(evt.value); }));
+		EventListener shared;
+		EXPECT_TRUE(shared.registerForEvent(TestEvent2::eventType, [&order](std::shared_ptr<IEvent>) { order.push_back(0); }));
+
+		EXPECT_TRUE(m_evtMgr->emplaceEvent<TestTypedEvent>(1, ""));
+		EXPECT_TRUE(m_evtMgr->queueEvent(std::make_shared<TestEvent2>()));
+		EXPECT_TRUE(m_evtMgr->emplaceEvent<TestTypedEvent>(2, ""));
+		m_evtMgr->onUpdate(1000);
+		EXPECT_EQ(order, std::vector<int>({ 1, 0, 2 }));
+		EXPECT_TRUE(m_evtMgr->removeListener(TestTypedEvent::eventType, listener));
+	}
+	TEST_F(EventManagerTest, flushedTypedEventsAreDestroyed) {
+		for (int i = 0; i < 3000; ++i) {
+			EXPECT_TRUE(m_evtMgr->emplaceEvent<TestTypedEvent>(i, "pooled"));
+		}
+		EXPECT_EQ(TestTypedEvent::liveCount, 3000);
+		m_evtMgr->flushQueue();
+		EXPECT_EQ(TestTypedEvent::liveCount, 0);
+
+		// Slots are reused for the next events
+		EXPECT_TRUE(m_evtMgr->emplaceEvent<TestTypedEvent>(0, "reused"));
+		EXPECT_EQ(TestTypedEvent::liveCount, 1);
+	}
 
 	// Test onUpdate
 #ifdef NDEBUG
@@ -157,6 +288,13 @@ namespace {
 #endif // Debug
 
 	TEST_F(EventManagerTest, onUpdateProcessTime) {
+		// Delegate taking a few microseconds keeps the queue from running empty within process time
+		EventListener slow;
+		EXPECT_TRUE(slow.registerForEvent(TestEvent2::eventType, [](std::shared_ptr<IEvent>) {
+			const long long start = utility::steadyTimeUs();
+			while (utility::steadyTimeUs() - start < 2) {}
+		}));
+
 		// Populate queue
 		for (unsigned int i = 0; i < 100000; ++i) {
 			EXPECT_TRUE(m_evtMgr->queueEvent(std::make_shared<TestEvent>()));
@@ -170,6 +308,66 @@ namespace {
 		EXPECT_NEAR(processTime, delta, 3); // Actual processing time varies from given time the amount it takes to process one event
 	}
 
+	// Test delegates that use the event manager
+	TEST_F(EventManagerTest, queueEventFromDelegate) {
+		EventListener queueing;
+		EXPECT_TRUE(queueing.registerForEvent(TestEvent::eventType, [this](std::shared_ptr<IEvent>) {
+			EXPECT_TRUE(m_evtMgr->queueEvent(std::make_shared<TestEvent2>()));
+		}));
+		TestClass2 counting;
+		EXPECT_TRUE(counting.registerListener(TestEvent2::eventType));
+
+		// Event queued by delegate waits for the next update
+		EXPECT_TRUE(m_evtMgr->queueEvent(std::make_shared<TestEvent>()));
+		m_evtMgr->onUpdate(1000);
+		EXPECT_EQ(g_callbackCounter, 1);
+		EXPECT_EQ(m_evtMgr->getQueueLength(), 1);
+		m_evtMgr->onUpdate(1000);
+		EXPECT_EQ(g_callbackCounter, 2);
+		EXPECT_EQ(m_evtMgr->getQueueLength(), 0);
+	}
+	TEST_F(EventManagerTest, triggerEventFromDelegate) {
+		EventListener triggering;
+		EXPECT_TRUE(triggering.registerForEvent(TestEvent2::eventType, [this](std::shared_ptr<IEvent>) {
+			m_evtMgr->triggerEvent(std::make_shared<TestEvent>());
+		}));
+		m_evtMgr->triggerEvent(std::make_shared<TestEvent2>());
+		EXPECT_EQ(g_callbackCounter, 1);
+	}
+	TEST_F(EventManagerTest, unregisterSelfFromDelegate) {
+		int calls = 0;
+		EventListener listener;
+		EXPECT_TRUE(listener.registerForEvent(TestEvent::eventType, [&listener, &calls](std::shared_ptr<IEvent>) {
+			++calls;
+			EXPECT_TRUE(listener.unregisterForEvent(TestEvent::eventType));
+		}));
+		EXPECT_EQ(m_evtMgr->getEventListenerCount(TestEvent::eventType), 2);
+
+		m_evtMgr->triggerEvent(std::make_shared<TestEvent>());
+		EXPECT_EQ(calls, 1);
+		EXPECT_EQ(m_evtMgr->getEventListenerCount(TestEvent::eventType), 1);
+
+		// Queued events are not delivered after unregistering either
+		EXPECT_TRUE(m_evtMgr->queueEvent(std::make_shared<TestEvent>()));
+		EXPECT_TRUE(m_evtMgr->queueEvent(std::make_shared<TestEvent>()));
+		m_evtMgr->onUpdate(1000);
+		EXPECT_EQ(calls, 1);
+		EXPECT_EQ(g_callbackCounter, 3);
+	}
+	TEST_F(EventManagerTest, unregisterOtherFromDelegate) {
+		// Listener removed during dispatch is skipped if it has not been called yet
+		TestClass2 removed;
+		EventListener removing;
+		EXPECT_TRUE(removing.registerForEvent(TestEvent::eventType, [&removed](std::shared_ptr<IEvent>) {
+			EXPECT_TRUE(removed.unregisterListener());
+		}));
+		EXPECT_TRUE(removed.registerListener());
+
+		m_evtMgr->triggerEvent(std::make_shared<TestEvent>());
+		EXPECT_EQ(g_callbackCounter, 1);
+		EXPECT_EQ(m_evtMgr->getEventListenerCount(TestEvent::eventType), 2);
+	}
+
 	TEST_F(EventManagerTest, onUpdateUntilQueueEmpty) {
 		// Populate queue
 		for (unsigned int i = 0; i < 100; ++i) {
@@ -180,4 +378,414 @@ namespace {
 		m_evtMgr->onUpdate(processTime);
 		EXPECT_EQ(m_evtMgr->getQueueLength(), static_cast<unsigned int>(0));
 	}
-}
\ No newline at end of file
+
+	// Test removing thread safe delegates while they run on dispatch workers. Locator keeps the first event manager
+	// it is given, so these use a manager of their own
+	class EventManagerParallelTest : public ::testing::Test {
+	protected:
+		EventManagerParallelTest() : m_evtMgr(2), m_listener(m_evtMgr.registerThreadSafeListener()) {}
+
+		DerivedEventManager m_evtMgr;
+		const ListenerId m_listener;
+	};
+
+	TEST_F(EventManagerParallelTest, removeListenerWaitsForRunningDelegate) {
+		std::atomic<bool> started(false);
+		std::atomic<bool> finished(false);
+		EXPECT_TRUE(m_evtMgr.addListener(TestEvent::eventType, m_listener, [&started, &finished](std::shared_ptr<IEvent>) {
+			started = true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			finished = true;
+		}));
+
+		std::thread trigger([this]() { m_evtMgr.triggerEvent(std::make_shared<TestEvent>()); });
+		while (!started) {
+			std::this_thread::yield();
+		}
+
+		// Delegate must have returned when removeListener does, so its owner could be destroyed
+		EXPECT_TRUE(m_evtMgr.removeListener(TestEvent::eventType, m_listener));
+		EXPECT_TRUE(finished);
+		EXPECT_EQ(m_evtMgr.getEventListenerCount(TestEvent::eventType), 0);
+		trigger.join();
+	}
+
+	TEST_F(EventManagerParallelTest, threadSafeDelegateCanRemoveItself) {
+		int calls = 0;
+		EXPECT_TRUE(m_evtMgr.addListener(TestEvent::eventType, m_listener, [this, &calls](std::shared_ptr<IEvent>) {
+			++calls;
+			EXPECT_TRUE(m_evtMgr.removeListener(TestEvent::eventType, m_listener));
+		}));
+
+		m_evtMgr.triggerEvent(std::make_shared<TestEvent>());
+		m_evtMgr.triggerEvent(std::make_shared<TestEvent>());
+		EXPECT_EQ(calls, 1);
+		EXPECT_EQ(m_evtMgr.getEventListenerCount(TestEvent::eventType), 0);
+	}
+
+	// Each thread safe listener gets events in queue order and never two at a time, while delegates of other
+	// listeners run on the dispatching thread
+	TEST_F(EventManagerParallelTest, threadSafeListenersKeepTheirOrder) {
+		const int count = 2000;
+		struct Received {
+			std::atomic<int> running;
+			std::atomic<bool> overlapped;
+			std::vector<int> values;
+		};
+		std::vector<ListenerId> listeners = { m_listener, m_evtMgr.registerThreadSafeListener() };
+		std::vector<std::unique_ptr<Received>> received;
+		for (const ListenerId listener : listeners) {
+			received.push_back(std::make_unique<Received>());
+			Received* out = received.back().get();
+			out->running = 0;
+			out->overlapped = false;
+			EXPECT_TRUE(m_evtMgr.addTypedListener<TestTypedEvent>(listener, [out](const TestTypedEvent& evt) {
+				if (out->running.fetch_add(1) != 0)
+					out->overlapped = true;
+				out->values.push_back(evt.value);
+				--out->running;
+			}));
+		}
+		const std::thread::id dispatcher = std::this_thread::get_id();
+		int serialCalls = 0;
+		const ListenerId serial = m_evtMgr.registerListener();
+		EXPECT_TRUE(m_evtMgr.addTypedListener<TestTypedEvent>(serial, [dispatcher, &serialCalls](const TestTypedEvent&) {
+			EXPECT_EQ(std::this_thread::get_id(), dispatcher);
+			++serialCalls;
+		}));
+
+		std::vector<int> expected;
+		for (int i = 0; i < count; ++i) {
+			EXPECT_TRUE(m_evtMgr.emplaceEvent<TestTypedEvent>(i, std::string()));
+			expected.push_back(i);
+		}
+		while (m_evtMgr.getQueueLength() > 0) {
+			m_evtMgr.onUpdate(100);
+		}
+
+		// onUpdate returns only after every delegate has been called
+		EXPECT_EQ(serialCalls, count);
+		for (const auto& out : received) {
+			EXPECT_FALSE(out->overlapped);
+			EXPECT_EQ(out->values, expected);
+		}
+		for (const ListenerId listener : listeners) {
+			EXPECT_TRUE(m_evtMgr.removeListener(TestTypedEvent::eventType, listener));
+		}
+		EXPECT_TRUE(m_evtMgr.removeListener(TestTypedEvent::eventType, serial));
+	}
+
+	// Test priority lanes and their counters. Locator keeps the first event manager it is given, so these use a
+	// manager of their own with fresh counters
+	class EventManagerLaneTest : public ::testing::Test {
+	protected:
+		EventManagerLaneTest() : m_evtMgr(0), m_listener(m_evtMgr.registerListener()) {}
+
+		DerivedEventManager m_evtMgr;
+		const ListenerId m_listener;
+		std::vector<int> m_order;
+
+		// Adds delegate recording the value of each TestTypedEvent, spinning for delayUs in each call
+		void listen(long long delayUs = 0)
+		{
+			EXPECT_TRUE(m_evtMgr.addTypedListener<TestTypedEvent>(m_listener, [this, delayUs](const TestTypedEvent& evt) {
+				m_order.push_back(evt.value);
+				const long long start = utility::steadyTimeUs();
+				while (utility::steadyTimeUs() - start < delayUs) {}
+			}));
+		}
+	};
+
+	TEST_F(EventManagerLaneTest, higherLanesAreTriggeredFirst) {
+		listen();
+		EXPECT_TRUE(m_evtMgr.emplacePriorityEvent<TestTypedEvent>(EventManager::LOW, 3, ""));
+		EXPECT_TRUE(m_evtMgr.emplaceEvent<TestTypedEvent>(2, ""));
+		EXPECT_TRUE(m_evtMgr.emplacePriorityEvent<TestTypedEvent>(EventManager::HIGH, 1, ""));
+		EXPECT_TRUE(m_evtMgr.queuePriorityEvent(std::make_shared<TestEvent>(), EventManager::HIGH));
+		EXPECT_TRUE(m_evtMgr.emplacePriorityEvent<TestTypedEvent>(EventManager::LOW, 4, ""));
+
+		m_evtMgr.onUpdate(1000);
+		EXPECT_EQ(m_order, std::vector<int>({ 1, 2, 3, 4 }));
+
+		const auto stats = m_evtMgr.getStats();
+		EXPECT_EQ(stats[EventManager::HIGH].triggered, 2u);
+		EXPECT_EQ(stats[EventManager::NORMAL].triggered, 1u);
+		EXPECT_EQ(stats[EventManager::LOW].triggered, 2u);
+		for (const auto& lane : stats) {
+			EXPECT_EQ(lane.queued, 0u);
+			EXPECT_EQ(lane.oldestAgeUs, 0);
+			EXPECT_EQ(lane.deferred, 0u);
+			EXPECT_EQ(lane.dropped, 0u);
+		}
+	}
+
+	TEST_F(EventManagerLaneTest, laneLimitDropsEvents) {
+		m_evtMgr.setLaneLimit(EventManager::LOW, 2);
+		EXPECT_TRUE(m_evtMgr.emplacePriorityEvent<TestTypedEvent>(EventManager::LOW, 1, ""));
+		EXPECT_TRUE(m_evtMgr.queuePriorityEvent(std::make_shared<TestEvent>(), EventManager::LOW));
+		EXPECT_FALSE(m_evtMgr.emplacePriorityEvent<TestTypedEvent>(EventManager::LOW, 2, ""));
+		EXPECT_FALSE(m_evtMgr.queuePriorityEvent(std::make_shared<TestEvent>(), EventManager::LOW));
+
+		// Other lanes are not limited
+		EXPECT_TRUE(m_evtMgr.emplaceEvent<TestTypedEvent>(3, ""));
+		EXPECT_EQ(TestTypedEvent::liveCount, 2);
+
+		auto stats = m_evtMgr.getStats();
+		EXPECT_EQ(stats[EventManager::LOW].queued, 2u);
+		EXPECT_EQ(stats[EventManager::LOW].dropped, 2u);
+		EXPECT_EQ(stats[EventManager::NORMAL].queued, 1u);
+		EXPECT_EQ(stats[EventManager::NORMAL].dropped, 0u);
+
+		// Limit of 0 removes the limit
+		m_evtMgr.setLaneLimit(EventManager::LOW, 0);
+		EXPECT_TRUE(m_evtMgr.emplacePriorityEvent<TestTypedEvent>(EventManager::LOW, 4, ""));
+		m_evtMgr.flushQueue();
+		EXPECT_EQ(TestTypedEvent::liveCount, 0);
+	}
+
+	TEST_F(EventManagerLaneTest, eventsOverBudgetAreDeferred) {
+		listen(1000);
+		for (int i = 0; i < 20; ++i) {
+			EXPECT_TRUE(m_evtMgr.emplacePriorityEvent<TestTypedEvent>(EventManager::LOW, i, ""));
+		}
+
+		// Budget of 5 ms gives time for a few of the 1 ms events
+		m_evtMgr.onUpdate(5);
+		const std::size_t firstCount = m_order.size();
+		EXPECT_GE(firstCount, 1u);
+		EXPECT_LT(firstCount, 20u);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		auto stats = m_evtMgr.getStats();
+		EXPECT_EQ(stats[EventManager::LOW].queued, 20 - firstCount);
+		EXPECT_EQ(stats[EventManager::LOW].triggered, firstCount);
+		EXPECT_EQ(stats[EventManager::LOW].deferred, 20 - firstCount);
+		EXPECT_GE(stats[EventManager::LOW].oldestAgeUs, 2000);
+
+		// High priority event queued later goes first, then the deferred events continue in order
+		EXPECT_TRUE(m_evtMgr.emplacePriorityEvent<TestTypedEvent>(EventManager::HIGH, 100, ""));
+		m_evtMgr.onUpdate(1000);
+		ASSERT_EQ(m_order.size(), 21u);
+		EXPECT_EQ(m_order[firstCount], 100);
+		for (std::size_t i = firstCount + 1; i < m_order.size(); ++i) {
+			EXPECT_EQ(m_order[i], static_cast<int>(i - 1));
+		}
+
+		stats = m_evtMgr.getStats();
+		EXPECT_EQ(stats[EventManager::LOW].queued, 0u);
+		EXPECT_EQ(stats[EventManager::LOW].oldestAgeUs, 0);
+		EXPECT_EQ(stats[EventManager::LOW].triggered, 20u);
+		EXPECT_EQ(stats[EventManager::HIGH].triggered, 1u);
+	}
+
+	TEST_F(EventManagerLaneTest, budgetHasMicrosecondResolution) {
+		listen(100);
+		for (int i = 0; i < 1000; ++i) {
+			EXPECT_TRUE(m_evtMgr.emplaceEvent<TestTypedEvent>(i, ""));
+		}
+
+		// Processing stops one 0.1 ms event after the budget, with the same slack as onUpdateProcessTime
+		const long long start = utility::steadyTimeUs();
+		m_evtMgr.onUpdate(10);
+		const long long elapsedUs = utility::steadyTimeUs() - start;
+		EXPECT_GE(elapsedUs, 10000);
+		EXPECT_LT(elapsedUs, 10000 + 3000);
+		EXPECT_GT(m_evtMgr.getQueueLength(), 0u);
+		m_evtMgr.flushQueue();
+	}
+
+	// Throughput of triggerEvent called from 1, 8 and 32 threads at once, each event going to four delegates
+	class EventManagerBenchmark : public ::testing::TestWithParam<int> {
+	protected:
+		EventManagerBenchmark()
+		{
+			Locator::provideEventManager(std::make_unique<DerivedEventManager>());
+		}
+	};
+
+	TEST_P(EventManagerBenchmark, concurrentTriggerEvent) {
+		const int callers = GetParam();
+		const int perCaller = 400000 / callers;
+		std::atomic<int> calls(0);
+		std::vector<std::unique_ptr<EventListener>> listeners;
+		for (int i = 0; i < 4; ++i) {
+			listeners.push_back(std::make_unique<EventListener>());
+			EXPECT_TRUE(listeners.back()->registerForEvent(TestEvent::eventType, [&calls](std::shared_ptr<IEvent>) {
+				calls.fetch_add(1, std::memory_order_relaxed);
+			}));
+		}
+
+		IEventManager* evtMgr = Locator::getEventManager();
+		const auto evt = std::make_shared<TestEvent>();
+		const auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		for (int i = 0; i < callers; ++i) {
+			threads.emplace_back([evtMgr, &evt, perCaller]() {
+				for (int j = 0; j < perCaller; ++j) {
+					evtMgr->triggerEvent(evt);
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		EXPECT_EQ(calls, perCaller * callers * 4);
+		std::cout << "  " << callers << " callers: " << perCaller * callers / seconds / 1e6 << " M events/s" << std::endl;
+	}
+	INSTANTIATE_TEST_CASE_P(EventManagerBenchmark, EventManagerBenchmark, ::testing::Values(1, 8, 32));
+
+	// Events per second through queue and onUpdate, shared IEvent objects against typed events built in a pool
+	TEST(EventPathBenchmark, sharedAgainstTyped) {
+		Locator::provideEventManager(std::make_unique<DerivedEventManager>());
+		DerivedEventManager* evtMgr = static_cast<DerivedEventManager*>(Locator::getEventManager());
+		const int count = 200000;
+		const int rounds = 5;
+		long long sum = 0;
+		EventListener shared;
+		EXPECT_TRUE(shared.registerForEvent(TestEvent::eventType, [&sum](std::shared_ptr<IEvent> evt) { sum += evt->vGetEventType() != 0; }));
+		const ListenerId listener = evtMgr->registerListener();
+		EXPECT_TRUE(evtMgr->addTypedListener<TestTypedEvent>(listener, [&sum](const TestTypedEvent& evt) { sum += evt.value; }));
+
+		const auto measure = [evtMgr, count, rounds](auto queue) {
+			const auto start = std::chrono::steady_clock::now();
+			for (int round = 0; round < rounds; ++round) {
+				for (int i = 0; i < count; ++i) {
+					queue();
+				}
+				evtMgr->onUpdate(100000);
+			}
+			return count * rounds / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		};
+		const double sharedRate = measure([evtMgr]() { evtMgr->queueEvent(std::make_shared<TestEvent>()); });
+		const double typedRate = measure([evtMgr]() { evtMgr->emplaceEvent<TestTypedEvent>(1, std::string()); });
+
+		EXPECT_EQ(sum, 2LL * count * rounds);
+		EXPECT_EQ(evtMgr->getQueueLength(), 0);
+		EXPECT_TRUE(evtMgr->removeListener(TestTypedEvent::eventType, listener));
+		std::cout << "  shared " << sharedRate / 1e6 << " M events/s, typed " << typedRate / 1e6 << " M events/s" << std::endl;
+	}
+
+	// Shared event stamped with the time it was queued
+	class TimedEvent : public Event {
+	public:
+		static const EventType eventType;
+
+		explicit TimedEvent(std::chrono::steady_clock::time_point time) : queueTime(time) {}
+		EventType vGetEventType() const override { return eventType; }
+		const std::string& vGetEventName() const override { return m_eventName; }
+
+		const std::chrono::steady_clock::time_point queueTime;
+
+	private:
+		static const std::string m_eventName;
+	};
+	const EventType TimedEvent::eventType(0x3c1f9a55);
+	const std::string TimedEvent::m_eventName("TimedEvent");
+
+	// Typed event stamped with the time it was queued
+	struct TimedTypedEvent {
+		static const EventType eventType;
+
+		explicit TimedTypedEvent(std::chrono::steady_clock::time_point time) : queueTime(time) {}
+
+		std::chrono::steady_clock::time_point queueTime;
+	};
+	const EventType TimedTypedEvent::eventType(0x6e02b4d7);
+
+	// Queueing rate and queue to delegate latency with 1..8 producers queueing while the main thread runs
+	// onUpdate, shared events with queueEvent against typed events with emplaceEvent
+	class EventQueueBenchmark : public ::testing::TestWithParam<int> {
+	protected:
+		EventQueueBenchmark() : m_evtMgr(nullptr), m_latencyUs()
+		{
+			Locator::provideEventManager(std::make_unique<DerivedEventManager>());
+			m_evtMgr = static_cast<DerivedEventManager*>(Locator::getEventManager());
+		}
+
+		/**
+		 * \brief Used to queue events from producer threads until every one has been delivered, and print rates
+		 *	and latencies
+		 * \param name Name of the event path
+		 * \param queue Function queueing one event stamped with the given time, returns false if not queued
+		 */
+		template<typename Queue>
+		void run(const char* name, Queue queue)
+		{
+			const int producers = GetParam();
+			const int perProducer = 200000 / producers;
+			const std::size_t total = static_cast<std::size_t>(producers) * perProducer;
+			m_latencyUs.clear();
+			m_latencyUs.reserve(total);
+
+			std::atomic<int> failed(0);
+			std::vector<double> queueSeconds(producers);
+			std::vector<std::thread> threads;
+			const auto start = std::chrono::steady_clock::now();
+			for (int p = 0; p < producers; ++p) {
+				threads.emplace_back([&, p]() {
+					const auto begin = std::chrono::steady_clock::now();
+					for (int i = 0; i < perProducer; ++i) {
+						if (!queue(std::chrono::steady_clock::now()))
+							++failed;
+					}
+					queueSeconds[p] = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+				});
+			}
+
+			// Delegates run on this thread, so latencies are stored without locking
+			const auto end = start + std::chrono::seconds(30);
+			while (m_latencyUs.size() + failed < total && std::chrono::steady_clock::now() < end) {
+				m_evtMgr->onUpdate(10);
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			EXPECT_EQ(failed, 0);
+			ASSERT_EQ(m_latencyUs.size(), total);
+			EXPECT_EQ(m_evtMgr->getQueueLength(), 0);
+
+			std::sort(m_latencyUs.begin(), m_latencyUs.end());
+			double queueTotal = 0.0;
+			for (const double producerSeconds : queueSeconds) {
+				queueTotal += producerSeconds;
+			}
+			std::cout << "  " << name << ", " << producers << " producers: " << total / queueTotal / 1e6
+				<< " M queued/s per producer second, " << total / seconds / 1e6 << " M delivered/s, latency median "
+				<< m_latencyUs[total / 2] << " us, p99 " << m_latencyUs[total * 99 / 100] << " us" << std::endl;
+		}
+
+		// Stores latency of event queued at time
+		void delivered(std::chrono::steady_clock::time_point queueTime)
+		{
+			m_latencyUs.push_back(
+				std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - queueTime).count());
+		}
+
+		DerivedEventManager* m_evtMgr;
+		std::vector<double> m_latencyUs;
+	};
+
+	TEST_P(EventQueueBenchmark, queueToDelegate) {
+		EventListener shared;
+		EXPECT_TRUE(shared.registerForEvent(TimedEvent::eventType, [this](std::shared_ptr<IEvent> evt) {
+			delivered(static_cast<const TimedEvent&>(*evt).queueTime);
+		}));
+		const ListenerId listener = m_evtMgr->registerListener();
+		EXPECT_TRUE(m_evtMgr->addTypedListener<TimedTypedEvent>(listener, [this](const TimedTypedEvent& evt) {
+			delivered(evt.queueTime);
+		}));
+
+		run("queueEvent", [this](std::chrono::steady_clock::time_point time) {
+			return m_evtMgr->queueEvent(std::make_shared<TimedEvent>(time));
+		});
+		run("emplaceEvent", [this](std::chrono::steady_clock::time_point time) {
+			return m_evtMgr->emplaceEvent<TimedTypedEvent>(time);
+		});
+		EXPECT_TRUE(m_evtMgr->removeListener(TimedTypedEvent::eventType, listener));
+	}
+	INSTANTIATE_TEST_CASE_P(EventQueueBenchmark, EventQueueBenchmark, ::testing::Values(1, 2, 4, 8));
+}
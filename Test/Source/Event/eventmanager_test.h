@@ -8,27 +8,39 @@
 // Extend EventManager class for testing purposes
 class DerivedEventManager : public EventManager {
 public:
+	using EventManager::EventManager;
+
 	// Return listener count for given event type
 	unsigned int getEventListenerCount(const EventType evtType) {
-		std::lock_guard<std::mutex> lock(m_mapMtx);
-
-		const auto it = m_eventListenerMap.find(evtType);
-		if (it != m_eventListenerMap.end()) {
-			return it->second.size();
+		const auto table = getListenerTable();
+		const auto listeners = table->find(evtType);
+		if (listeners != nullptr) {
+			return listeners->size();
 		}
 		return 0;
 	}
 
 	// Clear all listeners
 	void clearListeners() {
-		std::lock_guard<std::mutex> lock(m_mapMtx);
-		m_eventListenerMap.clear();
+		std::lock_guard<std::mutex> lock(m_tableMtx);
+		getListenerTable()->forEach([](EventType, const ListenerList& listeners) {
+			for (const auto& entry : listeners) {
+				entry->active = false;
+			}
+		});
+		std::atomic_store(&m_listenerTable, std::shared_ptr<const ListenerTable>(std::make_shared<ListenerTable>()));
 	}
 
+	// Destroy every queued event without triggering it
 	void flushQueue() {
-		std::lock_guard<std::mutex> lock(m_queueMtx);
-		while (!m_eventQueue.empty()) {
-			m_eventQueue.pop();
+		std::lock_guard<std::mutex> lock(m_updateMtx);
+		for (auto& lane : m_lanes) {
+			fillBatch(lane);
+			for (const auto node : lane.batch) {
+				destroy(node);
+			}
+			lane.length -= static_cast<unsigned int>(lane.batch.size());
+			lane.batch.clear();
 		}
 	}
 };
@@ -42,7 +54,7 @@ public:
 	TestEvent() {};
 	~TestEvent() {};
 	EventType vGetEventType() const override { return eventType; };
-	std::string vGetEventName() const override { return m_eventName; };
+	const std::string& vGetEventName() const override { return m_eventName; };
 
 private:
 	static const std::string m_eventName;
@@ -58,7 +70,7 @@ public:
 	TestEvent2() {};
 	~TestEvent2() {};
 	EventType vGetEventType() const override { return eventType; };
-	std::string vGetEventName() const override { return m_eventName; };
+	const std::string& vGetEventName() const override { return m_eventName; };
 
 private:
 	static const std::string m_eventName;
@@ -66,6 +78,27 @@ private:
 const EventType TestEvent2::eventType(0x8545422b);
 const std::string TestEvent2::m_eventName("TestEvent2");
 
+// Typed event for testing purposes, counts its live instances
+struct TestTypedEvent {
+	static const EventType eventType;
+	static int liveCount;
+
+	TestTypedEvent(int eventValue, const std::string& eventText) : value(eventValue), text(eventText) { ++liveCount; }
+	TestTypedEvent(const TestTypedEvent& rhs) : value(rhs.value), text(rhs.text) { ++liveCount; }
+	~TestTypedEvent() { --liveCount; }
+
+	int value;
+	std::string text;
+};
+const EventType TestTypedEvent::eventType(0x5a0c7e11);
+int TestTypedEvent::liveCount = 0;
+
+// Typed event sharing the event type of TestEvent
+struct TestTypedEvent2 {
+	static const EventType eventType;
+};
+const EventType TestTypedEvent2::eventType(TestEvent::eventType);
+
 
 // Used to count the callback count on event trigger
 int g_callbackCounter = 0;
@@ -0,0 +1,45 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include "Object/player.h"
+#include "World/world.h"
+
+//Hide functions from other files
+namespace {
+
+	// Player at the origin looks towards negative z, block reach is 8 by default
+	class PlayerTest : public ::testing::Test {
+	protected:
+		PlayerTest() : player(Transform(glm::vec3(0.0f), glm::vec3(0.0f))) {}
+
+		World world;
+		worldQuery::RaycastHit hit;
+		Player player;
+	};
+
+	TEST_F(PlayerTest, noTargetWithoutWorld)
+	{
+		world.setBlock(glm::ivec3(0, 0, -3), STONE);
+		EXPECT_FALSE(player.getTargetBlock(hit));
+	}
+
+	TEST_F(PlayerTest, targetsFirstBlockUnderCrosshair)
+	{
+		world.setBlock(glm::ivec3(0, 0, -3), STONE);
+		world.setBlock(glm::ivec3(0, 0, -5), DIRT);
+		world.setBlock(glm::ivec3(0, 0, 3), SAND);
+		player.setWorld(&world);
+
+		const Player& constPlayer = player;
+		ASSERT_TRUE(constPlayer.getTargetBlock(hit));
+		EXPECT_EQ(hit.block, glm::ivec3(0, 0, -3));
+		EXPECT_EQ(hit.normal, glm::ivec3(0, 0, 1));
+		EXPECT_EQ(hit.type, STONE);
+	}
+
+	TEST_F(PlayerTest, blocksOutOfReachAreNotTargeted)
+	{
+		world.setBlock(glm::ivec3(0, 0, -20), STONE);
+		player.setWorld(&world);
+		EXPECT_FALSE(player.getTargetBlock(hit));
+	}
+}
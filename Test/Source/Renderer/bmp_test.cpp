@@ -0,0 +1,235 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Renderer/bmp.h"
+#include "Utility/utility.h"
+
+//Hide functions from other files
+namespace {
+
+	const std::string IMAGE_DIRECTORY = "../Data/Images/Test/";
+	const uint8_t GUARD = 0x55;
+
+	// Returns channel c of pixel at x, y as RGB
+	uint8_t pixel(int x, int y, int c)
+	{
+		return static_cast<uint8_t>(x * 7 + y * 13 + c * 101 + x * y);
+	}
+
+	// Returns size of BMP row in bytes, padded to multiple of 4 bytes
+	int rowBytes(int width)
+	{
+		return (width * 3 + 3) & ~3;
+	}
+
+	/**
+	 * \brief Used to create 24bit BMP file of pixel() values, row padding is filled with nonzero bytes
+	 * \param width Image width in pixels
+	 * \param height Image height in pixels
+	 * \return Contents of BMP file
+	 */
+	std::string createBmp(int width, int height)
+	{
+		const int row = rowBytes(width);
+		const BITMAPFILEHEADER fileHeader{ BF_TYPE_MB, static_cast<unsigned int>(54 + row * height), 0, 0, 54 };
+		const BITMAPINFOHEADER infoHeader{ 40, width, height, 1, BIT_COUNT_24, 0,
+			static_cast<unsigned int>(row * height), 0, 0, 0, 0 };
+
+		std::string pixels(static_cast<std::size_t>(row) * height, '\xee');
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				for (int c = 0; c < 3; ++c) { pixels[y * row + x * 3 + c] = static_cast<char>(pixel(x, y, 2 - c)); }
+			}
+		}
+		return std::string(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader))
+			+ std::string(reinterpret_cast<const char*>(&infoHeader), sizeof(infoHeader)) + pixels;
+	}
+
+	class BmpTest : public ::testing::Test {
+	protected:
+		BmpTest() : m_log("BmpTest") {}
+
+		// Function called before every TEST_F call
+		void SetUp() override
+		{
+			utility::createDirectories(IMAGE_DIRECTORY);
+		}
+
+		// Function called after every TEST_F call
+		void TearDown() override
+		{
+			BMP::setSsse3(true);
+		}
+
+		/**
+		 * \brief Used to write image file named after the running test
+		 * \param contents Contents of image file
+		 * \return Path to image file
+		 */
+		std::string writeImage(const std::string& contents)
+		{
+			const std::string path = IMAGE_DIRECTORY
+				+ ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bmp";
+			std::ofstream stream(path, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+			EXPECT_TRUE(stream.is_open());
+			stream << contents;
+			return path;
+		}
+
+		// Loads BMP file with contents
+		bool load(BMP& bmp, const std::string& contents)
+		{
+			std::ifstream stream(writeImage(contents), std::ifstream::binary);
+			return bmp.vLoadFile(stream);
+		}
+
+		/**
+		 * \brief Used to test decoding of image with and without SSSE3. RGB is decoded with vDecode, RGBA with
+		 *	vDecodeTo to rows that have bytes after the pixels, which must not be written
+		 * \param width Image width in pixels
+		 * \param height Image height in pixels
+		 */
+		void expectDecoded(int width, int height)
+		{
+			BMP bmp(m_log);
+			ASSERT_TRUE(load(bmp, createBmp(width, height)));
+			ASSERT_EQ(bmp.vGetWidth(), width);
+			ASSERT_EQ(bmp.vGetHeight(), height);
+
+			for (const bool ssse3 : { false, true }) {
+				if (BMP::setSsse3(ssse3) != ssse3)
+					continue;
+
+				const auto rgb = bmp.vDecode();
+				ASSERT_NE(rgb, nullptr);
+				const int stride = width * 4 + 12;
+				std::vector<uint8_t> rgba(static_cast<std::size_t>(stride) * height, GUARD);
+				ASSERT_TRUE(bmp.vDecodeTo(rgba.data(), stride, 4));
+
+				for (int y = 0; y < height; ++y) {
+					for (int x = 0; x < width; ++x) {
+						for (int c = 0; c < 3; ++c) {
+							ASSERT_EQ(rgb[(y * width + x) * 3 + c], pixel(x, y, c)) << width << "x" << height << " "
+								<< ssse3 << " " << x << "," << y;
+							ASSERT_EQ(rgba[y * stride + x * 4 + c], pixel(x, y, c)) << width << "x" << height << " "
+								<< ssse3 << " " << x << "," << y;
+						}
+						ASSERT_EQ(rgba[y * stride + x * 4 + 3], 255);
+					}
+					for (int i = width * 4; i < stride; ++i) {
+						ASSERT_EQ(rgba[y * stride + i], GUARD) << width << "x" << height << " " << ssse3 << " " << y;
+					}
+				}
+			}
+		}
+
+		StaticSafeLogger m_log;
+	};
+
+	// Widths that are not multiple of 4 have row padding, and leave pixels for the scalar tail of SSSE3 decoding
+	TEST_F(BmpTest, oddWidthsDecode)
+	{
+		for (const int width : { 1, 2, 3, 4, 5, 6, 7, 8, 9, 13, 17, 31, 33, 63, 64, 65, 127 }) {
+			for (const int height : { 1, 2, 3, 7 }) {
+				expectDecoded(width, height);
+			}
+		}
+	}
+
+	TEST_F(BmpTest, ssse3MatchesScalar)
+	{
+		if (!BMP::setSsse3(true)) {
+			std::cout << "  SSSE3 not supported, only scalar decoding is tested" << std::endl;
+			return;
+		}
+
+		BMP bmp(m_log);
+		ASSERT_TRUE(load(bmp, createBmp(301, 17)));
+		const auto ssse3 = bmp.vDecode();
+		BMP::setSsse3(false);
+		const auto scalar = bmp.vDecode();
+		ASSERT_NE(ssse3, nullptr);
+		ASSERT_NE(scalar, nullptr);
+		EXPECT_TRUE(std::equal(scalar.get(), scalar.get() + 301 * 17 * 3, ssse3.get()));
+	}
+
+	TEST_F(BmpTest, truncatedFileIsRejected)
+	{
+		const std::string contents = createBmp(5, 4);
+		BMP bmp(m_log);
+		EXPECT_FALSE(load(bmp, contents.substr(0, contents.size() - 1)));
+		EXPECT_FALSE(load(bmp, contents.substr(0, 53)));
+		EXPECT_TRUE(load(bmp, contents));
+	}
+
+	// Headers of images larger than the file, including sizes whose byte counts overflow int
+	TEST_F(BmpTest, oversizedHeaderIsRejected)
+	{
+		const std::string contents = createBmp(5, 4);
+		const auto withHeader = [&contents](int width, int height, unsigned int offset) {
+			std::string changed = contents;
+			BITMAPFILEHEADER* fileHeader = reinterpret_cast<BITMAPFILEHEADER*>(&changed[0]);
+			BITMAPINFOHEADER* infoHeader = reinterpret_cast<BITMAPINFOHEADER*>(&changed[sizeof(BITMAPFILEHEADER)]);
+			fileHeader->bfOffBits = offset;
+			infoHeader->biWidth = width;
+			infoHeader->biHeight = height;
+			infoHeader->biSizeImage = 0xffffffffu;
+			return changed;
+		};
+
+		BMP bmp(m_log);
+		EXPECT_FALSE(load(bmp, withHeader(5, 5, 54)));
+		EXPECT_FALSE(load(bmp, withHeader(6, 4, 54)));
+		EXPECT_FALSE(load(bmp, withHeader(5, 4, 55)));
+		EXPECT_FALSE(load(bmp, withHeader(5, 4, 0xffffffffu)));
+		EXPECT_FALSE(load(bmp, withHeader(0x7fffffff, 1, 54)));
+		EXPECT_FALSE(load(bmp, withHeader(0x1fffffff, 1, 54)));
+		EXPECT_FALSE(load(bmp, withHeader(1, 0x7fffffff, 54)));
+		EXPECT_FALSE(load(bmp, withHeader(0x10000, 0x10000, 54)));
+		EXPECT_FALSE(load(bmp, withHeader(0, 4, 54)));
+		EXPECT_FALSE(load(bmp, withHeader(5, -4, 54)));
+	}
+
+	// Decoding speed in MB of BMP pixel data per second, without and with SSSE3
+	class BmpBenchmark : public BmpTest {};
+
+	TEST_F(BmpBenchmark, decode)
+	{
+		for (const int width : { 1023, 2048 }) {
+			const int height = 2048;
+			BMP bmp(m_log);
+			ASSERT_TRUE(load(bmp, createBmp(width, height)));
+			const double megabytes = static_cast<double>(rowBytes(width)) * height / 1e6;
+			std::vector<uint8_t> rgba(static_cast<std::size_t>(width) * height * 4);
+
+			for (const bool ssse3 : { false, true }) {
+				if (BMP::setSsse3(ssse3) != ssse3)
+					continue;
+
+				double rgbSeconds = 1e9;
+				double rgbaSeconds = 1e9;
+				for (int round = 0; round < 10; ++round) {
+					auto start = std::chrono::steady_clock::now();
+					const auto rgb = bmp.vDecode();
+					rgbSeconds = std::min(rgbSeconds,
+						std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+					ASSERT_NE(rgb, nullptr);
+
+					start = std::chrono::steady_clock::now();
+					ASSERT_TRUE(bmp.vDecodeTo(rgba.data(), width * 4, 4));
+					rgbaSeconds = std::min(rgbaSeconds,
+						std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+				}
+				std::cout << "  " << width << "x" << height << (ssse3 ? " SSSE3" : " scalar") << ": RGB "
+					<< megabytes / rgbSeconds << " MB/s, RGBA " << megabytes / rgbaSeconds << " MB/s" << std::endl;
+			}
+		}
+	}
+}
@@ -0,0 +1,381 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Renderer/bmp.h"
+#include "Renderer/fileloader.h"
+#include "Renderer/image.h"
+#include "Utility/config.h"
+#include "Utility/locator.h"
+#include "Utility/utility.h"
+
+//Hide functions from other files
+namespace {
+
+	const std::string MODEL_DIRECTORY = "../Data/Models/Test/";
+	const std::string CACHE_DIRECTORY = "../Data/Cache/Models/Test/";
+	const std::string IMAGE_DIRECTORY = "../Data/Images/Test/";
+
+	// Config that allows models larger than the default MaxByteFileSizeToLoad
+	class LargeModelConfig : public NullConfig {
+	public:
+		using NullConfig::get;
+		int get(std::string&& valueName, int defaultValue) override
+		{
+			return valueName == "MaxByteFileSizeToLoad" ? 512 * 1024 * 1024 : defaultValue;
+		}
+	};
+
+	/**
+	 * \brief Used to write image file for loadTexture
+	 * \param name Filename in IMAGE_DIRECTORY
+	 * \param contents Contents of image file
+	 * \return Filename of image given to fileloader
+	 */
+	std::string writeImage(const std::string& name, const std::string& contents)
+	{
+		utility::createDirectories(IMAGE_DIRECTORY);
+		std::ofstream stream(IMAGE_DIRECTORY + name, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+		EXPECT_TRUE(stream.is_open());
+		stream << contents;
+		return "Test/" + name;
+	}
+
+	// Returns 24bit BMP file of 2x1 pixels, red and blue, with row padded to 8 bytes
+	std::string createBmp()
+	{
+		const std::string pixels("\x00\x00\xff\xff\x00\x00\x00\x00", 8);
+		BITMAPFILEHEADER fileHeader{ BF_TYPE_MB, 54 + 8, 0, 0, 54 };
+		BITMAPINFOHEADER infoHeader{ 40, 2, 1, 1, BIT_COUNT_24, 0, 8, 0, 0, 0, 0 };
+		return std::string(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader))
+			+ std::string(reinterpret_cast<const char*>(&infoHeader), sizeof(infoHeader)) + pixels;
+	}
+
+	// Returns indices of mesh whichever width they have
+	std::vector<unsigned int> indicesOf(const MeshData& mesh)
+	{
+		if (!mesh.wideIndices.empty())
+			return mesh.wideIndices;
+		return std::vector<unsigned int>(mesh.indices.begin(), mesh.indices.end());
+	}
+
+	/**
+	 * \brief Used to write synthetic model of a square grid lying on the xy-plane, two triangles per cell
+	 * \param stream Output
+	 * \param cells Cells per side
+	 */
+	void writeGrid(std::ostream& stream, int cells)
+	{
+		const int side = cells + 1;
+		for (int y = 0; y < side; ++y) {
+			for (int x = 0; x < side; ++x) { stream << "v " << x * 0.25f << " " << y * 0.25f << " 0.000000\n"; }
+		}
+		for (int y = 0; y < side; ++y) {
+			for (int x = 0; x < side; ++x) { stream << "vt " << x / float(cells) << " " << y / float(cells) << "\n"; }
+		}
+		stream << "vn 0.0000 0.0000 1.0000\n";
+		for (int y = 0; y < cells; ++y) {
+			for (int x = 0; x < cells; ++x) {
+				const int a = y * side + x + 1;
+				const int b = a + 1;
+				const int c = a + side;
+				const int d = c + 1;
+				stream << "f " << a << "/" << a << "/1 " << b << "/" << b << "/1 " << d << "/" << d << "/1\n";
+				stream << "f " << a << "/" << a << "/1 " << d << "/" << d << "/1 " << c << "/" << c << "/1\n";
+			}
+		}
+	}
+
+	class FileLoaderTest : public ::testing::Test {
+	protected:
+
+		// Function called before every TEST_F call
+		void SetUp() override
+		{
+			utility::createDirectories(MODEL_DIRECTORY);
+			Locator::provideConfig(std::make_unique<LargeModelConfig>());
+		}
+
+		// Function called after every TEST_F call
+		void TearDown() override
+		{
+			Locator::provideConfig(std::make_unique<NullConfig>());
+		}
+
+		/**
+		 * \brief Used to write model file named after the running test, and to remove its cache so that it is parsed
+		 * \param contents Contents of model file
+		 * \param suffix Added to the name, for tests that write several models
+		 * \return Filename of model given to fileloader
+		 */
+		std::string writeModel(const std::string& contents, const std::string& suffix = "")
+		{
+			const std::string name = std::string(::testing::UnitTest::GetInstance()->current_test_info()->name())
+				+ suffix + ".obj";
+			std::ofstream stream(MODEL_DIRECTORY + name, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+			EXPECT_TRUE(stream.is_open());
+			stream << contents;
+			stream.close();
+			std::remove((CACHE_DIRECTORY + name + ".mesh").c_str());
+			return "Test/" + name;
+		}
+
+		// Loads model that is expected to have one mesh
+		MeshData loadSingle(const std::string& file)
+		{
+			std::vector<MeshData> meshes;
+			EXPECT_TRUE(fileloader::loadModelData(file, meshes));
+			EXPECT_EQ(meshes.size(), 1u);
+			return meshes.empty() ? MeshData() : std::move(meshes[0]);
+		}
+	};
+
+	TEST_F(FileLoaderTest, cubeModel)
+	{
+		std::vector<MeshData> meshes;
+		ASSERT_TRUE(fileloader::loadModelData("cube.obj", meshes));
+		ASSERT_EQ(meshes.size(), 1u);
+		EXPECT_EQ(meshes[0].vertices.size(), 36u - 12u);
+		EXPECT_EQ(meshes[0].indices.size(), 36u);
+		EXPECT_TRUE(meshes[0].wideIndices.empty());
+		for (const auto& vertex : meshes[0].vertices) {
+			EXPECT_FLOAT_EQ(glm::length(vertex.normal), 1.0f);
+			EXPECT_FLOAT_EQ(std::abs(vertex.position.x), 0.5f);
+		}
+	}
+
+	TEST_F(FileLoaderTest, sharedCornersBecomeOneVertex)
+	{
+		const MeshData mesh = loadSingle(writeModel(
+			"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+			"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+			"vn 0 0 1\n"
+			"f 1/1/1 2/2/1 3/3/1\n"
+			"f 1/1/1 3/3/1 4/4/1\n"
+			"f 1/2/1 3/3/1 4/4/1\n"));
+		ASSERT_EQ(mesh.vertices.size(), 5u);
+		EXPECT_EQ(indicesOf(mesh), (std::vector<unsigned int>{ 0, 1, 2, 0, 2, 3, 4, 2, 3 }));
+		EXPECT_EQ(mesh.vertices[3].position, glm::vec3(0.0f, 1.0f, 0.0f));
+		EXPECT_EQ(mesh.vertices[3].uvCoord, glm::vec2(0.0f, 1.0f));
+		EXPECT_EQ(mesh.vertices[4].position, glm::vec3(0.0f));
+		EXPECT_EQ(mesh.vertices[4].uvCoord, glm::vec2(1.0f, 0.0f));
+	}
+
+	TEST_F(FileLoaderTest, numberFormats)
+	{
+		const MeshData mesh = loadSingle(writeModel(
+			"# comment\r\n"
+			"  v\t-1.5 +2.25e1 3E-2\r\n"
+			"v 0.000000 .5 -0.\r\n"
+			"v 1.234567890123456789 1e30 -7\r\n"
+			"\r\n"
+			"f 1 2 3\r\n"));
+		ASSERT_EQ(mesh.vertices.size(), 3u);
+		EXPECT_EQ(mesh.vertices[0].position, glm::vec3(-1.5f, 22.5f, 0.03f));
+		EXPECT_EQ(mesh.vertices[1].position, glm::vec3(0.0f, 0.5f, 0.0f));
+		EXPECT_EQ(mesh.vertices[2].position, glm::vec3(1.2345679f, 1e30f, -7.0f));
+	}
+
+	// Long mantissas, large exponents and special values are parsed without the C library
+	TEST_F(FileLoaderTest, numberFallbacks)
+	{
+		const MeshData mesh = loadSingle(writeModel(
+			"v 12345678901234567890e-19 1e-50 -1e50\n"
+			"v 0.000000000000000000000000000000000000015 -INF Infinity\n"
+			"v 340282346638528859811704183484516925440 1e-400 -0e999\n"
+			"vn 0 0 1\n"
+			"f 1//1 2//1 3//1\n", "Fallbacks"));
+		ASSERT_EQ(mesh.vertices.size(), 3u);
+		EXPECT_EQ(mesh.vertices[0].position, glm::vec3(1.2345679f, 0.0f, -std::numeric_limits<float>::infinity()));
+		EXPECT_EQ(mesh.vertices[1].position, glm::vec3(1.5e-38f, -std::numeric_limits<float>::infinity(),
+			std::numeric_limits<float>::infinity()));
+		EXPECT_EQ(mesh.vertices[2].position, glm::vec3(std::numeric_limits<float>::max(), 0.0f, 0.0f));
+	}
+
+	// Texture coordinate rows may give only u, v is then zero
+	TEST_F(FileLoaderTest, uvWithOnlyU)
+	{
+		const MeshData mesh = loadSingle(writeModel(
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0.25\nvt 0.5 # comment\nvt 0.75 1 0\r\nvn 0 0 1\n"
+			"f 1/1/1 2/2/1 3/3/1\n", "OnlyU"));
+		ASSERT_EQ(mesh.vertices.size(), 3u);
+		EXPECT_EQ(mesh.vertices[0].uvCoord, glm::vec2(0.25f, 0.0f));
+		EXPECT_EQ(mesh.vertices[1].uvCoord, glm::vec2(0.5f, 0.0f));
+		EXPECT_EQ(mesh.vertices[2].uvCoord, glm::vec2(0.75f, 1.0f));
+
+		std::vector<MeshData> meshes;
+		EXPECT_FALSE(fileloader::loadModelData(writeModel(
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0.25 x\nf 1/1 2/1 3/1\n", "BadV"), meshes));
+		EXPECT_FALSE(fileloader::loadModelData(writeModel(
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nvt\nf 1/1 2/1 3/1\n", "NoU"), meshes));
+	}
+
+	TEST_F(FileLoaderTest, wideIndicesWhenVerticesDoNotFitShort)
+	{
+		std::stringstream small;
+		writeGrid(small, 200);
+		const MeshData narrow = loadSingle(writeModel(small.str(), "Narrow"));
+		EXPECT_EQ(narrow.vertices.size(), 201u * 201u);
+		EXPECT_EQ(narrow.indices.size(), 200u * 200u * 6u);
+		EXPECT_TRUE(narrow.wideIndices.empty());
+
+		std::stringstream large;
+		writeGrid(large, 300);
+		const MeshData wide = loadSingle(writeModel(large.str(), "Wide"));
+		EXPECT_EQ(wide.vertices.size(), 301u * 301u);
+		EXPECT_TRUE(wide.indices.empty());
+		ASSERT_EQ(wide.wideIndices.size(), 300u * 300u * 6u);
+		EXPECT_EQ(wide.vertices[wide.wideIndices.back()].position, glm::vec3(74.75f, 75.0f, 0.0f));
+	}
+
+	TEST_F(FileLoaderTest, badRowsFail)
+	{
+		std::vector<MeshData> meshes;
+		EXPECT_FALSE(fileloader::loadModelData(writeModel("v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 4\n", "OutOfRange"), meshes));
+		EXPECT_FALSE(fileloader::loadModelData(writeModel("v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1/1 2/1 3/1\n", "MissingUv"), meshes));
+		EXPECT_FALSE(fileloader::loadModelData(writeModel("v 0 0 x\nv 1 0 0\nv 1 1 0\nf 1 2 3\n", "BadNumber"), meshes));
+		EXPECT_FALSE(fileloader::loadModelData(writeModel("v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 a\n", "BadIndex"), meshes));
+		EXPECT_FALSE(fileloader::loadModelData("Test/fileThatDoesNotExist.obj", meshes));
+		EXPECT_TRUE(meshes.empty());
+	}
+
+	TEST_F(FileLoaderTest, polygonsAreFanTriangulated)
+	{
+		const MeshData mesh = loadSingle(writeModel(
+			"v 0 0 0\nv 2 0 0\nv 3 1 0\nv 1 2 0\nv -1 1 0\nvt 0 0\nvn 0 0 1\n"
+			"f 1/1/1 2/1/1 3/1/1 4/1/1 5/1/1\n"
+			"f 1/1/1 2/1/1 3/1/1 4/1/1\n"));
+		EXPECT_EQ(mesh.vertices.size(), 5u);
+		EXPECT_EQ(indicesOf(mesh), (std::vector<unsigned int>{ 0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 1, 2, 0, 2, 3 }));
+	}
+
+	TEST_F(FileLoaderTest, negativeIndicesCountBack)
+	{
+		const std::string positions = "v 0 0 0\nv 1 0 0\nv 1 1 0\nvt 0.5 0.5\nvt 1 1\nvn 0 0 1\nvn 0 1 0\n";
+		const MeshData positive = loadSingle(writeModel(positions + "f 1/1/2 2/2/1 3/1/2\n", "Positive"));
+		const MeshData negative = loadSingle(writeModel(positions + "f -3/-2/-1 -2/-1/-2 -1/-2/-1\n", "Negative"));
+		EXPECT_EQ(indicesOf(negative), indicesOf(positive));
+		ASSERT_EQ(negative.vertices.size(), positive.vertices.size());
+		for (std::size_t i = 0; i < negative.vertices.size(); ++i) {
+			EXPECT_TRUE(negative.vertices[i].isEqual(positive.vertices[i])) << i;
+		}
+
+		// Negative index refers to the last element read before the face, not the last in file
+		const MeshData interleaved = loadSingle(writeModel(
+			"v 0 0 0\nv 1 0 0\nv 1 1 0\nf -3 -2 -1\nv 5 5 5\nf -4 -3 -1\n", "Interleaved"));
+		ASSERT_EQ(interleaved.vertices.size(), 4u);
+		EXPECT_EQ(interleaved.vertices[3].position, glm::vec3(5.0f));
+		EXPECT_EQ(indicesOf(interleaved), (std::vector<unsigned int>{ 0, 1, 2, 0, 1, 3 }));
+	}
+
+	TEST_F(FileLoaderTest, cornersWithoutUvOrNormal)
+	{
+		// v//vn gets zero uv and the given normal
+		const MeshData noUv = loadSingle(writeModel("v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 -1\nf 1//1 2//1 3//1\n", "NoUv"));
+		ASSERT_EQ(noUv.vertices.size(), 3u);
+		for (const auto& vertex : noUv.vertices) {
+			EXPECT_EQ(vertex.uvCoord, glm::vec2(0.0f));
+			EXPECT_EQ(vertex.normal, glm::vec3(0.0f, 0.0f, -1.0f));
+		}
+
+		// v and v/vt get a normal averaged from the faces using the position
+		const MeshData noNormal = loadSingle(writeModel(
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0 0 1\nvt 0.25 0.75\nf 1/1 2/1 3/1\nf 1 3 4\n", "NoNormal"));
+		ASSERT_EQ(noNormal.vertices.size(), 6u);
+		EXPECT_EQ(noNormal.vertices[0].uvCoord, glm::vec2(0.25f, 0.75f));
+		EXPECT_EQ(noNormal.vertices[1].normal, glm::vec3(0.0f, 0.0f, 1.0f));
+		EXPECT_EQ(noNormal.vertices[5].normal, glm::vec3(1.0f, 0.0f, 0.0f));
+		const float diagonal = 1.0f / std::sqrt(2.0f);
+		EXPECT_FLOAT_EQ(noNormal.vertices[0].normal.x, diagonal);
+		EXPECT_FLOAT_EQ(noNormal.vertices[0].normal.z, diagonal);
+		EXPECT_EQ(noNormal.vertices[3].uvCoord, glm::vec2(0.0f));
+	}
+
+	TEST_F(FileLoaderTest, sectionsBecomeMeshes)
+	{
+		std::vector<MeshData> meshes;
+		ASSERT_TRUE(fileloader::loadModelData(writeModel(
+			"mtllib test.mtl\n"
+			"o First\nv 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\n"
+			"usemtl Stone\nf 1 2 3\n"
+			"usemtl Dirt\nf 2 4 3\nf 1 2 4\n"
+			"g Empty\n"
+			"o Second\ng Group\n\tf 3 2 1 4\n"), meshes));
+		ASSERT_EQ(meshes.size(), 3u);
+		EXPECT_EQ(indicesOf(meshes[0]), (std::vector<unsigned int>{ 0, 1, 2 }));
+		EXPECT_EQ(indicesOf(meshes[1]), (std::vector<unsigned int>{ 0, 1, 2, 3, 0, 1 }));
+		EXPECT_EQ(meshes[1].vertices[0].position, glm::vec3(1.0f, 0.0f, 0.0f));
+		EXPECT_EQ(indicesOf(meshes[2]), (std::vector<unsigned int>{ 0, 1, 2, 0, 2, 3 }));
+	}
+
+	TEST_F(FileLoaderTest, badFacesFail)
+	{
+		std::vector<MeshData> meshes;
+		const std::string positions = "v 0 0 0\nv 1 0 0\nv 1 1 0\n";
+		EXPECT_FALSE(fileloader::loadModelData(writeModel(positions + "f 1 2\n", "TwoCorners"), meshes));
+		EXPECT_FALSE(fileloader::loadModelData(writeModel(positions + "f 0 1 2\n", "ZeroIndex"), meshes));
+		EXPECT_FALSE(fileloader::loadModelData(writeModel(positions + "f -4 1 2\n", "NegativeOutOfRange"), meshes));
+		EXPECT_FALSE(fileloader::loadModelData(writeModel(positions + "f 1// 2// 3//\n", "EmptyNormal"), meshes));
+		EXPECT_FALSE(fileloader::loadModelData(writeModel(positions + "o Nothing\n", "NoFaces"), meshes));
+		EXPECT_TRUE(meshes.empty());
+	}
+
+	TEST_F(FileLoaderTest, bmpTextureIsRgba)
+	{
+		const auto image = fileloader::loadTexture(writeImage("FileLoaderTest.bmp", createBmp()));
+		ASSERT_NE(image, nullptr);
+		EXPECT_EQ(image->getWidth(), 2);
+		EXPECT_EQ(image->getHeight(), 1);
+		ASSERT_EQ(image->getChannels(), 4);
+		const uint8_t expected[] = { 255, 0, 0, 255, 0, 0, 255, 255 };
+		EXPECT_TRUE(std::equal(std::begin(expected), std::end(expected), image->getData()));
+	}
+
+	// Failed textures are nullptr, so that model manager fails the asset instead of uploading it
+	TEST_F(FileLoaderTest, badTexturesFail)
+	{
+		const std::string bmp = createBmp();
+		EXPECT_EQ(fileloader::loadTexture("Test/FileLoaderTestMissing.bmp"), nullptr);
+		EXPECT_EQ(fileloader::loadTexture(writeImage("FileLoaderTest.png", bmp)), nullptr);
+		EXPECT_EQ(fileloader::loadTexture(writeImage("FileLoaderTestNoExtension", bmp)), nullptr);
+		EXPECT_EQ(fileloader::loadTexture(writeImage("FileLoaderTestTruncated.bmp", bmp.substr(0, bmp.size() - 1))),
+			nullptr);
+		EXPECT_EQ(fileloader::loadTexture(writeImage("FileLoaderTestNotBmp.bmp", "XX" + bmp.substr(2))), nullptr);
+	}
+
+	// Load time of synthetic models, parsed with the cache removed
+	class FileLoaderBenchmark : public FileLoaderTest {};
+
+	TEST_F(FileLoaderBenchmark, gridModels)
+	{
+		for (const int cells : { 100, 180, 708 }) {
+			std::stringstream contents;
+			writeGrid(contents, cells);
+			const std::string file = writeModel(contents.str(), std::to_string(cells));
+
+			std::vector<MeshData> meshes;
+			const auto start = std::chrono::steady_clock::now();
+			ASSERT_TRUE(fileloader::loadModelData(file, meshes));
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			ASSERT_EQ(meshes.size(), 1u);
+			EXPECT_EQ(meshes[0].vertices.size(), static_cast<std::size_t>((cells + 1) * (cells + 1)));
+
+			std::cout << "  " << cells * cells * 2 << " triangles, " << contents.str().size() / (1024 * 1024) << " MB: "
+				<< ms << " ms, " << meshes[0].vertices.size() << " vertices, "
+				<< (meshes[0].wideIndices.empty() ? 16 : 32) << "-bit indices" << std::endl;
+			std::remove((MODEL_DIRECTORY + file.substr(5)).c_str());
+			std::remove((CACHE_DIRECTORY + file.substr(5) + ".mesh").c_str());
+		}
+	}
+}
@@ -0,0 +1,134 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#pragma warning (push, 2)  // Temporarily set warning level 2
+#include <3rdParty/glm/gtc/matrix_transform.hpp>
+#pragma warning (pop)      // Restore back
+
+#include "Renderer/frustum.h"
+
+//Hide functions from other files
+namespace {
+
+	class FrustumTest : public ::testing::Test {
+	protected:
+		// Camera at origin looking towards negative z, sees from 0.1 to 100 units away with 90 degree field of view
+		FrustumTest() : frustum(glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f)
+			* glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f))) {}
+
+		Frustum frustum;
+
+		// Unit box centered at position
+		static AABB box(const glm::vec3& center, float halfSize = 0.5f)
+		{
+			return AABB{ center - glm::vec3(halfSize), center + glm::vec3(halfSize) };
+		}
+	};
+
+	TEST_F(FrustumTest, defaultFrustumContainsEverything)
+	{
+		const Frustum everything;
+		EXPECT_TRUE(everything.isVisible(box(glm::vec3(0.0f))));
+		EXPECT_TRUE(everything.isVisible(box(glm::vec3(1e6f, -1e6f, 1e6f))));
+	}
+
+	TEST_F(FrustumTest, boxInFrontIsVisible)
+	{
+		EXPECT_TRUE(frustum.isVisible(box(glm::vec3(0.0f, 0.0f, -10.0f))));
+		EXPECT_TRUE(frustum.isVisible(box(glm::vec3(5.0f, -5.0f, -10.0f))));
+	}
+
+	TEST_F(FrustumTest, boxBehindIsCulled)
+	{
+		EXPECT_FALSE(frustum.isVisible(box(glm::vec3(0.0f, 0.0f, 10.0f))));
+	}
+
+	TEST_F(FrustumTest, boxBeyondFarPlaneIsCulled)
+	{
+		EXPECT_FALSE(frustum.isVisible(box(glm::vec3(0.0f, 0.0f, -200.0f))));
+		EXPECT_TRUE(frustum.isVisible(box(glm::vec3(0.0f, 0.0f, -99.8f))));
+	}
+
+	TEST_F(FrustumTest, boxOutsideSidePlanesIsCulled)
+	{
+		// At distance 10 the 90 degree view reaches 10 units to each side
+		EXPECT_FALSE(frustum.isVisible(box(glm::vec3(12.0f, 0.0f, -10.0f))));
+		EXPECT_FALSE(frustum.isVisible(box(glm::vec3(-12.0f, 0.0f, -10.0f))));
+		EXPECT_FALSE(frustum.isVisible(box(glm::vec3(0.0f, 12.0f, -10.0f))));
+		EXPECT_FALSE(frustum.isVisible(box(glm::vec3(0.0f, -12.0f, -10.0f))));
+	}
+
+	TEST_F(FrustumTest, boxIntersectingPlaneIsVisible)
+	{
+		// Center is outside the right plane but the box reaches inside
+		EXPECT_TRUE(frustum.isVisible(box(glm::vec3(11.0f, 0.0f, -10.0f), 2.0f)));
+		// Box around the camera crosses the near plane
+		EXPECT_TRUE(frustum.isVisible(box(glm::vec3(0.0f), 1.0f)));
+	}
+
+	TEST_F(FrustumTest, cullMatchesIsVisible)
+	{
+		Frustum::BoxList boxes;
+		std::vector<AABB> source;
+		for (int z = -20; z <= 20; z += 2) {
+			for (int x = -30; x <= 30; x += 3) { source.push_back(box(glm::vec3(static_cast<float>(x), 0.0f, static_cast<float>(z)))); }
+		}
+		for (const auto& aabb : source) { boxes.add(aabb); }
+		ASSERT_EQ(boxes.size(), source.size());
+
+		std::vector<unsigned char> visibility;
+		const unsigned int visible = frustum.cull(boxes, visibility);
+		ASSERT_EQ(visibility.size(), source.size());
+		unsigned int expected = 0;
+		for (std::size_t i = 0; i < source.size(); ++i) {
+			EXPECT_EQ(visibility[i] != 0, frustum.isVisible(source[i])) << "box " << i;
+			expected += frustum.isVisible(source[i]) ? 1 : 0;
+		}
+		EXPECT_EQ(visible, expected);
+		EXPECT_GT(visible, 0u);
+		EXPECT_LT(visible, source.size());
+	}
+
+	TEST_F(FrustumTest, boxListClear)
+	{
+		Frustum::BoxList boxes;
+		boxes.add(box(glm::vec3(0.0f)));
+		boxes.clear();
+		EXPECT_EQ(boxes.size(), 0u);
+		std::vector<unsigned char> visibility(3, 1);
+		EXPECT_EQ(frustum.cull(boxes, visibility), 0u);
+		EXPECT_TRUE(visibility.empty());
+	}
+
+	// Culls one million boxes spread around the camera, as would be done once per frame
+	TEST(FrustumBenchmark, cullMillionBoxes)
+	{
+		const Frustum frustum(glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 500.0f)
+			* glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+		Frustum::BoxList boxes;
+		const int edge = 100;
+		boxes.reserve(edge * edge * edge);
+		for (int y = 0; y < edge; ++y) {
+			for (int z = 0; z < edge; ++z) {
+				for (int x = 0; x < edge; ++x) {
+					const glm::vec3 center(static_cast<float>(x * 10 - 500), static_cast<float>(y * 2 - 100), static_cast<float>(z * 10 - 500));
+					boxes.add(AABB{ center - glm::vec3(1.0f), center + glm::vec3(1.0f) });
+				}
+			}
+		}
+
+		std::vector<unsigned char> visibility;
+		const int frames = 10;
+		unsigned int visible = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < frames; ++i) { visible = frustum.cull(boxes, visibility); }
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+		EXPECT_GT(visible, 0u);
+		EXPECT_LT(visible, boxes.size());
+
+		std::cout << "  " << boxes.size() << " boxes culled in " << ms << " ms per frame, " << visible << " visible" << std::endl;
+	}
+}
@@ -0,0 +1,285 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Renderer/fileloader.h"
+#include "Renderer/meshcache.h"
+#include "Utility/config.h"
+#include "Utility/locator.h"
+#include "Utility/utility.h"
+
+//Hide functions from other files
+namespace {
+
+	const std::string CACHE_DIRECTORY = "../Data/Test/MeshCache/";
+	const std::string MODEL_DIRECTORY = "../Data/Models/Test/";
+	const std::string MODEL_CACHE_DIRECTORY = "../Data/Cache/Models/Test/";
+	const uint64_t SOURCE_SIZE = 1234;
+	const uint64_t SOURCE_CHECKSUM = 0x0123456789ABCDEFull;
+
+	// Config that allows models larger than the default MaxByteFileSizeToLoad
+	class LargeModelConfig : public NullConfig {
+	public:
+		using NullConfig::get;
+		int get(std::string&& valueName, int defaultValue) override
+		{
+			return valueName == "MaxByteFileSizeToLoad" ? 512 * 1024 * 1024 : defaultValue;
+		}
+	};
+
+	// Returns mesh data with count vertices and indices going through them backwards
+	MeshData createMesh(unsigned int count, bool wide)
+	{
+		MeshData mesh;
+		for (unsigned int i = 0; i < count; ++i) {
+			const float f = static_cast<float>(i);
+			mesh.vertices.push_back(Vertex{ glm::vec3(f, -f, 0.5f * f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(f, 1.0f) });
+			if (wide)
+				mesh.wideIndices.push_back(count - 1 - i);
+			else
+				mesh.indices.push_back(static_cast<unsigned short>(count - 1 - i));
+		}
+		return mesh;
+	}
+
+	// Tests that meshes have the same vertices and indices
+	void expectEqual(const std::vector<MeshData>& actual, const std::vector<MeshData>& expected)
+	{
+		ASSERT_EQ(actual.size(), expected.size());
+		for (std::size_t i = 0; i < actual.size(); ++i) {
+			ASSERT_EQ(actual[i].vertices.size(), expected[i].vertices.size());
+			for (std::size_t j = 0; j < actual[i].vertices.size(); ++j) {
+				EXPECT_TRUE(actual[i].vertices[j].isEqual(expected[i].vertices[j])) << i << " " << j;
+			}
+			EXPECT_EQ(actual[i].indices, expected[i].indices);
+			EXPECT_EQ(actual[i].wideIndices, expected[i].wideIndices);
+		}
+	}
+
+	// Reads whole file
+	std::string readFile(const std::string& path)
+	{
+		std::ifstream stream(path, std::ifstream::binary);
+		return std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	}
+
+	// Writes whole file
+	void writeFile(const std::string& path, const std::string& contents)
+	{
+		std::ofstream stream(path, std::ofstream::binary | std::ofstream::trunc);
+		ASSERT_TRUE(stream.is_open());
+		stream << contents;
+	}
+
+	class MeshCacheTest : public ::testing::Test {
+	protected:
+		MeshCacheTest() : m_meshes{ createMesh(5, false), createMesh(70000, true), createMesh(3, false) } {}
+
+		// Function called before every TEST_F call
+		void SetUp() override
+		{
+			utility::createDirectories(CACHE_DIRECTORY);
+			utility::createDirectories(MODEL_DIRECTORY);
+			m_path = CACHE_DIRECTORY + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".mesh";
+			ASSERT_TRUE(meshCache::save(m_path, SOURCE_SIZE, SOURCE_CHECKSUM, m_meshes));
+			Locator::provideConfig(std::make_unique<LargeModelConfig>());
+		}
+
+		// Function called after every TEST_F call
+		void TearDown() override
+		{
+			Locator::provideConfig(std::make_unique<NullConfig>());
+		}
+
+		// Tests that cache at m_path is not loaded and meshes are not changed
+		void expectRejected(uint64_t size = SOURCE_SIZE, uint64_t checksum = SOURCE_CHECKSUM)
+		{
+			std::vector<MeshData> loaded{ createMesh(1, false) };
+			EXPECT_FALSE(meshCache::load(m_path, size, checksum, loaded));
+			ASSERT_EQ(loaded.size(), 1u);
+			EXPECT_EQ(loaded[0].vertices.size(), 1u);
+		}
+
+		const std::vector<MeshData> m_meshes;
+		std::string m_path;
+	};
+
+	TEST_F(MeshCacheTest, savedMeshesLoad)
+	{
+		std::vector<MeshData> loaded;
+		ASSERT_TRUE(meshCache::load(m_path, SOURCE_SIZE, SOURCE_CHECKSUM, loaded));
+		expectEqual(loaded, m_meshes);
+		EXPECT_FALSE(std::ifstream(m_path + ".tmp").is_open());
+	}
+
+	// Writers of the same cache use their own temporary files, so the cache left behind is whole
+	TEST_F(MeshCacheTest, concurrentSavesLeaveWholeCache)
+	{
+		const std::vector<MeshData> other{ createMesh(7, false), createMesh(2, true) };
+		std::atomic<int> saved(0);
+		std::vector<std::thread> writers;
+		for (int i = 0; i < 4; ++i) {
+			writers.emplace_back([this, &other, &saved, i]() {
+				for (int round = 0; round < 10; ++round) {
+					if (meshCache::save(m_path, SOURCE_SIZE, SOURCE_CHECKSUM, i % 2 == 0 ? m_meshes : other))
+						++saved;
+				}
+			});
+		}
+		for (auto& writer : writers) { writer.join(); }
+		EXPECT_GT(saved, 0);
+
+		std::vector<MeshData> loaded;
+		ASSERT_TRUE(meshCache::load(m_path, SOURCE_SIZE, SOURCE_CHECKSUM, loaded));
+		if (loaded.size() == other.size())
+			expectEqual(loaded, other);
+		else
+			expectEqual(loaded, m_meshes);
+	}
+
+	// Temporary file left by another writer, here one that cannot be opened, does not block saving
+	TEST_F(MeshCacheTest, saveIgnoresOtherTemporaryFiles)
+	{
+		utility::createDirectories(m_path + ".tmp/");
+		const std::vector<MeshData> other{ createMesh(7, false) };
+		ASSERT_TRUE(meshCache::save(m_path, SOURCE_SIZE, SOURCE_CHECKSUM, other));
+		std::vector<MeshData> loaded;
+		ASSERT_TRUE(meshCache::load(m_path, SOURCE_SIZE, SOURCE_CHECKSUM, loaded));
+		expectEqual(loaded, other);
+	}
+
+	TEST_F(MeshCacheTest, changedSourceIsRejected)
+	{
+		expectRejected(SOURCE_SIZE + 1, SOURCE_CHECKSUM);
+		expectRejected(SOURCE_SIZE, SOURCE_CHECKSUM ^ 1);
+	}
+
+	TEST_F(MeshCacheTest, damagedFileIsRejected)
+	{
+		const std::string contents = readFile(m_path);
+
+		writeFile(m_path, contents.substr(0, contents.size() - 4));
+		expectRejected();
+		writeFile(m_path, contents + "xxxx");
+		expectRejected();
+		writeFile(m_path, "HSMB" + contents.substr(4));
+		expectRejected();
+		writeFile(m_path, std::string());
+		expectRejected();
+		std::remove(m_path.c_str());
+		expectRejected();
+	}
+
+	TEST_F(MeshCacheTest, indexPastVerticesIsRejected)
+	{
+		const std::string contents = readFile(m_path);
+		// Last mesh has 3 vertices and 3 short indices, followed by 2 bytes of padding
+		std::string damaged = contents;
+		damaged[damaged.size() - 4] = 3;
+		writeFile(m_path, damaged);
+		expectRejected();
+
+		// Largest valid index still loads
+		damaged[damaged.size() - 4] = 2;
+		writeFile(m_path, damaged);
+		std::vector<MeshData> loaded;
+		ASSERT_TRUE(meshCache::load(m_path, SOURCE_SIZE, SOURCE_CHECKSUM, loaded));
+		EXPECT_EQ(loaded[2].indices.back(), 2u);
+
+		// Wide indices of the second mesh
+		const std::size_t wideIndex = 32 + 3 * 16 + 5 * sizeof(Vertex) + 12 + 70000 * sizeof(Vertex);
+		damaged = contents;
+		damaged[wideIndex + 3] = 1;
+		writeFile(m_path, damaged);
+		expectRejected();
+	}
+
+	TEST_F(MeshCacheTest, checksumDependsOnEveryByte)
+	{
+		std::string data(1000, 'a');
+		const auto checksumOf = [](const std::string& bytes, std::size_t size) {
+			return meshCache::checksum(reinterpret_cast<const uint8_t*>(bytes.data()), size);
+		};
+		const uint64_t original = checksumOf(data, data.size());
+		for (std::size_t i = 0; i < data.size(); i += 37) {
+			data[i] = 'b';
+			EXPECT_NE(checksumOf(data, data.size()), original) << i;
+			data[i] = 'a';
+		}
+		EXPECT_NE(checksumOf(data, data.size() - 1), original);
+		EXPECT_EQ(checksumOf(data, data.size()), original);
+	}
+
+	// Editing a model, even without changing its size, gives the new model instead of the cached one
+	TEST_F(MeshCacheTest, editedModelInvalidatesCache)
+	{
+		const std::string name = "MeshCacheTestEdited.obj";
+		const std::string model = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+		writeFile(MODEL_DIRECTORY + name, model);
+
+		std::vector<MeshData> first;
+		ASSERT_TRUE(fileloader::loadModelData("Test/" + name, first));
+		EXPECT_TRUE(std::ifstream(MODEL_CACHE_DIRECTORY + name + ".mesh").is_open());
+		std::vector<MeshData> cached;
+		ASSERT_TRUE(fileloader::loadModelData("Test/" + name, cached));
+		expectEqual(cached, first);
+
+		std::string edited = model;
+		edited[edited.find("v 0 1 0") + 6] = '7';
+		writeFile(MODEL_DIRECTORY + name, edited);
+		std::vector<MeshData> reloaded;
+		ASSERT_TRUE(fileloader::loadModelData("Test/" + name, reloaded));
+		ASSERT_EQ(reloaded.size(), 1u);
+		EXPECT_EQ(reloaded[0].vertices[2].position, glm::vec3(0.0f, 1.0f, 7.0f));
+	}
+
+	// Model load time, cold load parses and writes the cache, warm load reads the cache
+	class MeshCacheBenchmark : public MeshCacheTest {};
+
+	TEST_F(MeshCacheBenchmark, coldAgainstWarm)
+	{
+		for (const int cells : { 100, 180, 708 }) {
+			// Grid on the xy-plane, two triangles per cell
+			const int side = cells + 1;
+			std::stringstream contents;
+			for (int i = 0; i < side * side; ++i) { contents << "v " << (i % side) * 0.25f << " " << (i / side) * 0.25f << " 0\n"; }
+			contents << "vn 0 0 1\n";
+			for (int y = 0; y < cells; ++y) {
+				for (int x = 0; x < cells; ++x) {
+					const int a = y * side + x + 1;
+					contents << "f " << a << "//1 " << a + 1 << "//1 " << a + side + 1 << "//1\n";
+					contents << "f " << a << "//1 " << a + side + 1 << "//1 " << a + side << "//1\n";
+				}
+			}
+			const std::string name = "MeshCacheTestGrid" + std::to_string(cells) + ".obj";
+			writeFile(MODEL_DIRECTORY + name, contents.str());
+			std::remove((MODEL_CACHE_DIRECTORY + name + ".mesh").c_str());
+
+			std::vector<MeshData> cold;
+			auto start = std::chrono::steady_clock::now();
+			ASSERT_TRUE(fileloader::loadModelData("Test/" + name, cold));
+			const double coldMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			std::vector<MeshData> warm;
+			start = std::chrono::steady_clock::now();
+			ASSERT_TRUE(fileloader::loadModelData("Test/" + name, warm));
+			const double warmMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			expectEqual(warm, cold);
+
+			std::cout << "  " << cells * cells * 2 << " triangles: cold " << coldMs << " ms, warm " << warmMs << " ms"
+				<< std::endl;
+			std::remove((MODEL_DIRECTORY + name).c_str());
+			std::remove((MODEL_CACHE_DIRECTORY + name + ".mesh").c_str());
+		}
+	}
+}
@@ -0,0 +1,66 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+
+#include "Utility/logformat.h"
+#include "Utility/utility.h"
+
+//Hide functions from other files
+namespace {
+
+	// Encodes arguments and renders them with format
+	template<typename... Args>
+	std::string format(const char* text, const Args&... args)
+	{
+		std::string buffer;
+		logFormat::encode(buffer, args...);
+		return logFormat::render(text, buffer.data(), buffer.size());
+	}
+
+	TEST(LogFormatTest, rendersNumbersLikeToStr)
+	{
+		const int negative = -42;
+		const unsigned long long large = 18446744073709551615ull;
+		const float real = 2.5f;
+		const double precise = -0.125;
+		EXPECT_EQ(format("{}", negative), utility::toStr(negative));
+		EXPECT_EQ(format("{}", large), utility::toStr(large));
+		EXPECT_EQ(format("{}", real), utility::toStr(real));
+		EXPECT_EQ(format("{}", precise), utility::toStr(precise));
+		EXPECT_EQ(format("{} {}", true, 'a'), "1 97");
+	}
+
+	TEST(LogFormatTest, rendersHexadecimal)
+	{
+		EXPECT_EQ(format("{x}", 0x7de5db2bu), "0x7de5db2b");
+		EXPECT_EQ(format("{x}", static_cast<int8_t>(-1)), "0xffffffffffffffff");
+		EXPECT_EQ(format("{x}", 0), "0x0");
+	}
+
+	TEST(LogFormatTest, rendersStrings)
+	{
+		const std::string text = "chunk {} ";
+		EXPECT_EQ(format("[{}][{}]", text, "literal"), "[chunk {} ][literal]");
+		EXPECT_EQ(format("[{}]", std::string()), "[]");
+	}
+
+	TEST(LogFormatTest, keepsPlaceholdersWithoutArguments)
+	{
+		EXPECT_EQ(format("{} and {x} and {}", 1, 2), "1 and 0x2 and {}");
+		EXPECT_EQ(format("no placeholders", 1, "ignored"), "no placeholders");
+		EXPECT_EQ(format("{ } {y} {"), "{ } {y} {");
+	}
+
+	TEST(LogFormatTest, stopsAtInvalidArguments)
+	{
+		std::string buffer;
+		logFormat::encode(buffer, 12345, std::string("text"));
+		// Cut in the middle of the string argument
+		EXPECT_EQ(logFormat::render("{} {}", buffer.data(), buffer.size() - 2), "12345 {}");
+		// Unknown type byte
+		buffer[0] = 0x7f;
+		EXPECT_EQ(logFormat::render("{} {}", buffer.data(), buffer.size()), "{} {}");
+		EXPECT_EQ(logFormat::render("{}", nullptr, 0), "{}");
+	}
+}
@@ -0,0 +1,110 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "Utility/logger.h"
+#include "Utility/utility.h"
+
+//Hide functions from other files
+namespace {
+
+	const LOGGING_LEVEL LEVELS[] = { DEBUG, INFO, WARN, ERR, FATAL };
+
+	// Returns a formatter that counts its calls
+	auto countingFormatter(int& calls)
+	{
+		return [&calls]() {
+			++calls;
+			return std::string("formatted");
+		};
+	}
+
+	TEST(LoggerTest, emptyLoggerHasNoLevels)
+	{
+		const Logger log;
+		for (const auto lvl : LEVELS) {
+			EXPECT_FALSE(log.isEnabled(lvl)) << lvl;
+		}
+	}
+
+	TEST(LoggerTest, disabledLevelSkipsFormatter)
+	{
+		const Logger log;
+		int calls = 0;
+		log.debug("disabledLevelSkipsFormatter", countingFormatter(calls));
+		log.info("disabledLevelSkipsFormatter", countingFormatter(calls));
+		log.warn("disabledLevelSkipsFormatter", countingFormatter(calls));
+		log.error("disabledLevelSkipsFormatter", countingFormatter(calls));
+		log.fatal("disabledLevelSkipsFormatter", countingFormatter(calls));
+		EXPECT_EQ(calls, 0);
+	}
+
+	// EventManager logger has INFO, WARN and ERROR enabled in logconfig.json
+	TEST(LoggerTest, levelsFollowLogConfig)
+	{
+		const Logger log("EventManager");
+		EXPECT_FALSE(log.isEnabled(DEBUG));
+		EXPECT_TRUE(log.isEnabled(INFO));
+		EXPECT_TRUE(log.isEnabled(WARN));
+		EXPECT_TRUE(log.isEnabled(ERR));
+		EXPECT_FALSE(log.isEnabled(FATAL));
+
+		int calls = 0;
+		log.debug("levelsFollowLogConfig", countingFormatter(calls));
+		EXPECT_EQ(calls, 0);
+		log.info("levelsFollowLogConfig", countingFormatter(calls));
+		EXPECT_EQ(calls, 1);
+		log.fatal("levelsFollowLogConfig", countingFormatter(calls));
+		EXPECT_EQ(calls, 1);
+	}
+
+	TEST(LoggerTest, levelsBelowMinimumAreOff)
+	{
+		const Logger log("EventManager");
+		for (const auto lvl : LEVELS) {
+			if (lvl < MIN_LOGGING_LEVEL) {
+				EXPECT_FALSE(log.isEnabled(lvl)) << lvl;
+			}
+		}
+	}
+
+	TEST(LoggerTest, unknownLoggerHasNoLevels)
+	{
+		const Logger log("LoggerTestNotInConfig");
+		for (const auto lvl : LEVELS) {
+			EXPECT_FALSE(log.isEnabled(lvl)) << lvl;
+		}
+	}
+
+	// Cost of a disabled debug message built eagerly with toStr, with a formatter and with a format string
+	TEST(LoggerBenchmark, disabledMessage)
+	{
+		const Logger log("EventManager");
+		ASSERT_FALSE(log.isEnabled(DEBUG));
+		const int count = 1000000;
+		const float x = 12.5f, y = -3.25f, z = 7.0f;
+
+		const auto measure = [count](const char* name, auto write) {
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < count; ++i) { write(i); }
+			const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+			std::cout << "  " << name << ": " << ns / count << " ns per message" << std::endl;
+		};
+
+		measure("eager string", [&](int i) {
+			log.debug("disabledMessage", "Created cube " + utility::toStr(i) + " at " + utility::toStr(x) + ", "
+				+ utility::toStr(y) + ", " + utility::toStr(z));
+		});
+		measure("formatter", [&](int i) {
+			log.debug("disabledMessage", [&]() {
+				return "Created cube " + utility::toStr(i) + " at " + utility::toStr(x) + ", " + utility::toStr(y)
+					+ ", " + utility::toStr(z);
+			});
+		});
+		measure("format string", [&](int i) {
+			log.debug("disabledMessage", "Created cube {} at {}, {}, {}", i, x, y, z);
+		});
+	}
+}
@@ -0,0 +1,367 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Utility/logformat.h"
+#include "Utility/logwriter.h"
+#include "Utility/utility.h"
+
+//Hide functions from other files
+namespace {
+
+	const std::string DIRECTORY = "../Data/Test/Log/";
+
+	// Reads lines of a text log file
+	std::vector<std::string> readLines(const std::string& path)
+	{
+		std::ifstream file(path);
+		std::vector<std::string> lines;
+		std::string line;
+		while (std::getline(file, line)) { lines.push_back(line); }
+		return lines;
+	}
+
+	// Counts lines that contain text
+	std::size_t countLines(const std::vector<std::string>& lines, const std::string& text)
+	{
+		return std::count_if(lines.begin(), lines.end(), [&text](const std::string& line) { return line.find(text) != std::string::npos; });
+	}
+
+	// Reads value from bytes of binary log file
+	template<typename T>
+	T readValue(const std::string& data, std::size_t& position)
+	{
+		T value{};
+		if (data.size() - position >= sizeof(T))
+			std::memcpy(&value, data.data() + position, sizeof(T));
+		position += sizeof(T);
+		return value;
+	}
+
+	// Decodes binary log file to lines without time, like Scripts/PyCppUtility/LogDecoder does
+	std::vector<std::string> decodeBinary(const std::string& path, std::size_t& stringRecords)
+	{
+		const char* const levels[] = { "DEBUG", "INFO ", "WARN ", "ERROR", "FATAL" };
+		std::ifstream file(path, std::ifstream::binary);
+		const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		std::vector<std::string> lines;
+		stringRecords = 0;
+		if (data.compare(0, 8, "BLOCKLOG") != 0)
+			return lines;
+
+		std::size_t position = 8;
+		EXPECT_EQ(readValue<uint32_t>(data, position), 1u);
+		EXPECT_GT(readValue<int64_t>(data, position), 0);
+		EXPECT_GT(readValue<int64_t>(data, position), 0);
+		std::unordered_map<uint32_t, std::string> strings;
+		while (position < data.size()) {
+			const auto type = readValue<unsigned char>(data, position);
+			if (type == 1) {
+				readValue<uint16_t>(data, position);
+				position += readValue<uint16_t>(data, position);
+				continue;
+			}
+			if (type == 2) {
+				const auto id = readValue<uint32_t>(data, position);
+				const auto length = readValue<uint32_t>(data, position);
+				strings[id] = data.substr(position, length);
+				position += length;
+				++stringRecords;
+				continue;
+			}
+			EXPECT_TRUE(type == 3 || type == 4) << static_cast<int>(type);
+			if (type != 3 && type != 4)
+				break;
+
+			readValue<int64_t>(data, position);
+			readValue<uint16_t>(data, position);
+			const auto lvl = readValue<unsigned char>(data, position);
+			const auto function = type == 4 ? readValue<uint32_t>(data, position) : 0;
+			const auto format = type == 4 ? readValue<uint32_t>(data, position) : 0;
+			const auto length = readValue<uint32_t>(data, position);
+			const std::string payload = data.substr(position, length);
+			position += length;
+			lines.push_back(std::string(levels[lvl]) + " - " + (type == 3 ? payload
+				: strings[function] + "(): " + logFormat::render(strings[format].c_str(), payload.data(), payload.size())));
+		}
+		return lines;
+	}
+
+	// Sums the counts of drop reports written by LogWriter
+	unsigned long long countReportedDrops(const std::vector<std::string>& lines)
+	{
+		unsigned long long dropped = 0;
+		for (const auto& line : lines) {
+			const auto pos = line.find("LogWriter(): ");
+			if (pos != std::string::npos && line.find(" records dropped") != std::string::npos)
+				dropped += std::stoull(line.substr(pos + 13));
+		}
+		return dropped;
+	}
+
+	class LogWriterTest : public ::testing::Test {
+	protected:
+		LogWriterTest() : m_logger(LogWriter::registerLogger("LogWriterTest")) {}
+
+		// Function called before every TEST_F call
+		void SetUp() override
+		{
+			utility::createDirectories(DIRECTORY);
+			LogWriter::setOverflowPolicy(LogWriter::DROP);
+		}
+
+		// Function called after every TEST_F call
+		void TearDown() override
+		{
+			LogWriter::setOverflowPolicy(LogWriter::DROP);
+		}
+
+		// Opens a file for the running test, named after it
+		int openFile(std::string& path, LogWriter::FILE_FORMAT format = LogWriter::TEXT)
+		{
+			path = DIRECTORY + ::testing::UnitTest::GetInstance()->current_test_info()->name()
+				+ (format == LogWriter::BINARY ? ".bin" : ".log");
+			const int file = LogWriter::openFile(path, format);
+			EXPECT_GE(file, 0);
+			return file;
+		}
+
+		const int m_logger;
+	};
+
+	TEST_F(LogWriterTest, writesTextLines)
+	{
+		std::string path;
+		const int file = openFile(path);
+		LogWriter::write(file, m_logger, INFO, "first line");
+		LogWriter::write(file, m_logger, ERR, "second line");
+		LogWriter::flush();
+
+		const auto lines = readLines(path);
+		ASSERT_EQ(lines.size(), 2u);
+		EXPECT_NE(lines[0].find(" INFO  - first line"), std::string::npos) << lines[0];
+		EXPECT_NE(lines[1].find(" ERROR - second line"), std::string::npos) << lines[1];
+	}
+
+	TEST_F(LogWriterTest, sameFileIsReturnedForSamePath)
+	{
+		std::string path;
+		const int file = openFile(path);
+		EXPECT_EQ(LogWriter::openFile(path, LogWriter::TEXT), file);
+		EXPECT_EQ(LogWriter::registerLogger("LogWriterTest"), m_logger);
+	}
+
+	TEST_F(LogWriterTest, threadsKeepTheirRecordsInOrder)
+	{
+		std::string path;
+		const int file = openFile(path);
+		const int threadCount = 4;
+		const int perThread = 2000;
+		LogWriter::setOverflowPolicy(LogWriter::BLOCK);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < threadCount; ++t) {
+			threads.emplace_back([file, this, t, perThread]() {
+				for (int i = 0; i < perThread; ++i) {
+					LogWriter::write(file, m_logger, INFO, "thread " + std::to_string(t) + " record " + std::to_string(i) + ";");
+				}
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+		LogWriter::flush();
+
+		const auto lines = readLines(path);
+		ASSERT_EQ(lines.size(), static_cast<std::size_t>(threadCount * perThread));
+		std::vector<int> next(threadCount, 0);
+		for (const auto& line : lines) {
+			const auto pos = line.find("thread ");
+			ASSERT_NE(pos, std::string::npos) << line;
+			const int t = std::stoi(line.substr(pos + 7));
+			ASSERT_NE(line.find(" record " + std::to_string(next[t]) + ";"), std::string::npos) << line;
+			++next[t];
+		}
+	}
+
+	TEST_F(LogWriterTest, dropPolicyCountsAndReportsDrops)
+	{
+		std::string path;
+		const int file = openFile(path);
+		const unsigned long long droppedBefore = LogWriter::getDroppedCount();
+
+		// Burst of records far larger than the ring, pushed faster than they can be written
+		const int count = 20000;
+		const std::string message = "burst " + std::string(2000, 'x');
+		for (int i = 0; i < count; ++i) { LogWriter::write(file, m_logger, INFO, message); }
+
+		// Record that never drops carries the report of the last drops
+		LogWriter::write(file, m_logger, ERR, "after burst");
+		LogWriter::flush();
+		const unsigned long long dropped = LogWriter::getDroppedCount() - droppedBefore;
+
+		const auto lines = readLines(path);
+		EXPECT_GT(dropped, 0u);
+		EXPECT_EQ(countLines(lines, "burst xxx"), count - dropped);
+		EXPECT_EQ(countReportedDrops(lines), dropped);
+		EXPECT_NE(lines.back().find("after burst"), std::string::npos);
+	}
+
+	TEST_F(LogWriterTest, blockPolicyAndErrorsNeverDrop)
+	{
+		std::string path;
+		const int file = openFile(path);
+		const unsigned long long droppedBefore = LogWriter::getDroppedCount();
+		const std::string message = "kept " + std::string(2000, 'x');
+
+		// ERR and FATAL records wait even with the drop policy
+		for (int i = 0; i < 5000; ++i) { LogWriter::write(file, m_logger, ERR, message); }
+		LogWriter::setOverflowPolicy(LogWriter::BLOCK);
+		for (int i = 0; i < 5000; ++i) { LogWriter::write(file, m_logger, DEBUG, message); }
+		LogWriter::flush();
+
+		EXPECT_EQ(LogWriter::getDroppedCount(), droppedBefore);
+		EXPECT_EQ(countLines(readLines(path), "kept xxx"), 10000u);
+	}
+
+	// Pushes the same records, formatted and text, to file
+	void writeMixedRecords(int file, int logger)
+	{
+		// Strings are identified by address, one array keeps identical literals from counting twice
+		static const char function[] = "writeMixedRecords";
+		std::string args;
+		for (int i = 0; i < 3; ++i) {
+			logFormat::encode(args, i, -1.5f * i, std::string("chunk"), 0xbeefu + i);
+			LogWriter::writeEncoded(file, logger, INFO, function, "record {} at {} in {} id {x}", args);
+		}
+		LogWriter::write(file, logger, WARN, "plain text record");
+		logFormat::encode(args, -7ll);
+		LogWriter::writeEncoded(file, logger, ERR, function, "only {} of {}", args);
+		LogWriter::writeEncoded(file, logger, DEBUG, "emptyArguments", "no arguments", std::string());
+	}
+
+	TEST_F(LogWriterTest, binaryRecordsDecodeToTextLines)
+	{
+		std::string textPath;
+		std::string binaryPath;
+		const int textFile = openFile(textPath);
+		const int binaryFile = openFile(binaryPath, LogWriter::BINARY);
+		writeMixedRecords(textFile, m_logger);
+		writeMixedRecords(binaryFile, m_logger);
+		LogWriter::flush();
+
+		// Text lines without time, "yyyy-mm-dd hh:mm:ss "
+		std::vector<std::string> expected;
+		for (const auto& line : readLines(textPath)) { expected.push_back(line.substr(20)); }
+		ASSERT_EQ(expected.size(), 6u);
+		EXPECT_EQ(expected[1], "INFO  - writeMixedRecords(): record 1 at -1.500000 in chunk id 0xbef0");
+		EXPECT_EQ(expected[4], "ERROR - writeMixedRecords(): only -7 of {}");
+
+		std::size_t stringRecords = 0;
+		EXPECT_EQ(decodeBinary(binaryPath, stringRecords), expected);
+		// Function names and formats are written once and referred to by id
+		EXPECT_EQ(stringRecords, 5u);
+	}
+
+	TEST_F(LogWriterTest, binaryFileKeepsFirstFormat)
+	{
+		std::string path;
+		const int file = openFile(path, LogWriter::BINARY);
+		EXPECT_EQ(LogWriter::openFile(path, LogWriter::TEXT), file);
+		LogWriter::write(file, m_logger, INFO, "binary");
+		LogWriter::flush();
+
+		std::size_t stringRecords = 0;
+		const auto lines = decodeBinary(path, stringRecords);
+		ASSERT_EQ(lines.size(), 1u);
+		EXPECT_EQ(lines[0], "INFO  - binary");
+	}
+
+	/**
+	 * \brief Used to write a line the way Logger did before LogWriter: open, format time, write, flush and close
+	 *	on the calling thread
+	 */
+	void writeDirect(const std::string& path, const std::string& message)
+	{
+		std::ofstream ostream(path, std::ofstream::out | std::ofstream::app);
+		if (!ostream.is_open())
+			return;
+		const std::time_t time = std::time(nullptr);
+		tm timeinfo;
+		localtime_s(&timeinfo, &time);
+		std::stringstream ss;
+		ss << std::put_time(&timeinfo, "%F %X");
+		ostream << ss.str() << " INFO  - " << message << std::endl;
+	}
+
+	// Messages per second and caller side latency of the old direct write and of LogWriter with both policies
+	class LogWriterBenchmark : public LogWriterTest {};
+
+	TEST_F(LogWriterBenchmark, directAgainstLogWriter)
+	{
+		const int count = 20000;
+		const std::string message = "Added new listener 12 for event type 0x7de5db2b and a delegate for it";
+		std::string path;
+		const int file = openFile(path);
+
+		const auto measure = [count](const char* name, auto write) {
+			std::vector<double> latencyUs(count);
+			const unsigned long long droppedBefore = LogWriter::getDroppedCount();
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < count; ++i) {
+				const auto callStart = std::chrono::steady_clock::now();
+				write();
+				latencyUs[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - callStart).count();
+			}
+			LogWriter::flush();
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::sort(latencyUs.begin(), latencyUs.end());
+			std::cout << "  " << name << ": " << count / seconds << " messages/s, caller latency median "
+				<< latencyUs[count / 2] << " us, p99 " << latencyUs[count * 99 / 100] << " us, "
+				<< LogWriter::getDroppedCount() - droppedBefore << " dropped" << std::endl;
+		};
+
+		const std::string directPath = DIRECTORY + "LogWriterBenchmarkDirect.log";
+		std::ofstream(directPath, std::ofstream::trunc).close();
+		measure("direct", [&directPath, &message]() { writeDirect(directPath, message); });
+		measure("LogWriter drop", [file, this, &message]() { LogWriter::write(file, m_logger, INFO, message); });
+		LogWriter::setOverflowPolicy(LogWriter::BLOCK);
+		measure("LogWriter block", [file, this, &message]() { LogWriter::write(file, m_logger, INFO, message); });
+	}
+
+	TEST_F(LogWriterBenchmark, textAgainstBinary)
+	{
+		const int count = 100000;
+		LogWriter::setOverflowPolicy(LogWriter::BLOCK);
+
+		const auto measure = [count, this](const char* name, LogWriter::FILE_FORMAT format) {
+			const std::string path = DIRECTORY + "LogWriterBenchmark" + name + (format == LogWriter::BINARY ? ".bin" : ".log");
+			const int file = LogWriter::openFile(path, format);
+			ASSERT_GE(file, 0);
+			std::string args;
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < count; ++i) {
+				logFormat::encode(args, i, 0x7de5db2bu, 0.25f * i);
+				LogWriter::writeEncoded(file, m_logger, INFO, "textAgainstBinary", "Event {} of type {x} took {} ms", args);
+			}
+			LogWriter::flush();
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::ifstream stream(path, std::ifstream::binary | std::ifstream::ate);
+			std::cout << "  " << name << ": " << count / seconds << " messages/s, "
+				<< static_cast<double>(stream.tellg()) / count << " bytes per message" << std::endl;
+		};
+
+		measure("Text", LogWriter::TEXT);
+		measure("Binary", LogWriter::BINARY);
+	}
+}
@@ -0,0 +1,78 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Utility/mpscqueue.h"
+
+//Hide functions from other files
+namespace {
+
+	// Node of intrusive queue
+	struct Node {
+		std::atomic<Node*> next;
+		int value;
+	};
+
+	TEST(IntrusiveMpscQueueTest, emptyQueuePopsNothing)
+	{
+		IntrusiveMpscQueue<Node> queue;
+		EXPECT_EQ(queue.tryPop(), nullptr);
+	}
+
+	TEST(IntrusiveMpscQueueTest, nodesAreReusableAfterDraining)
+	{
+		IntrusiveMpscQueue<Node> queue;
+		std::vector<Node> nodes(3);
+		for (int round = 0; round < 3; ++round) {
+			EXPECT_EQ(queue.tryPop(), nullptr);
+			for (int i = 0; i < 3; ++i) {
+				nodes[i].value = round * 10 + i;
+				queue.push(&nodes[i]);
+			}
+
+			// Last node is returned too, the queue puts its own stub behind it
+			for (int i = 0; i < 3; ++i) {
+				Node* node = queue.tryPop();
+				ASSERT_EQ(node, &nodes[i]);
+				EXPECT_EQ(node->value, round * 10 + i);
+			}
+		}
+		EXPECT_EQ(queue.tryPop(), nullptr);
+	}
+
+	TEST(IntrusiveMpscQueueTest, concurrentProducersKeepTheirOrder)
+	{
+		IntrusiveMpscQueue<Node> queue;
+		const int producers = 4;
+		const int perProducer = 50000;
+		std::vector<Node> nodes(producers * perProducer);
+		std::vector<std::thread> threads;
+		for (int p = 0; p < producers; ++p) {
+			threads.emplace_back([&queue, &nodes, p, perProducer]() {
+				for (int i = 0; i < perProducer; ++i) {
+					Node& node = nodes[p * perProducer + i];
+					node.value = i;
+					queue.push(&node);
+				}
+			});
+		}
+
+		std::vector<int> next(producers, 0);
+		for (int popped = 0; popped < producers * perProducer;) {
+			Node* node = queue.tryPop();
+			if (node == nullptr) {
+				std::this_thread::yield();
+				continue;
+			}
+			const int producer = static_cast<int>(node - nodes.data()) / perProducer;
+			ASSERT_EQ(node->value, next[producer]) << "producer " << producer;
+			++next[producer];
+			++popped;
+		}
+		for (auto& thread : threads) { thread.join(); }
+		EXPECT_EQ(next, std::vector<int>(producers, perProducer));
+		EXPECT_EQ(queue.tryPop(), nullptr);
+	}
+}
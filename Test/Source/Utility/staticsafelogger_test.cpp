@@ -0,0 +1,130 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Utility/logwriter.h"
+#include "Utility/staticsafelogger.h"
+
+//Hide functions from other files
+namespace {
+
+	// EventManager logger writes INFO, WARN and ERROR to this file according to logconfig.json
+	const std::string LOG_NAME = "EventManager";
+	const std::string LOG_PATH = "../Data/Log/eventmanager.log";
+
+	// Counts lines of log file that contain text
+	int countLines(const std::string& text)
+	{
+		LogWriter::flush();
+		std::ifstream file(LOG_PATH);
+		int count = 0;
+		std::string line;
+		while (std::getline(file, line)) {
+			if (line.find(text) != std::string::npos)
+				++count;
+		}
+		return count;
+	}
+
+	// Marker unique to the running test, so that lines of earlier runs and tests are not counted
+	std::string marker()
+	{
+		return std::string("StaticSafeLoggerTest.") + ::testing::UnitTest::GetInstance()->current_test_info()->name()
+			+ "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+	}
+
+	TEST(StaticSafeLoggerTest, initializedOnFirstUse)
+	{
+		StaticSafeLogger log(LOG_NAME);
+		const std::string text = marker();
+		log.info("initializedOnFirstUse", text);
+		log.debug("initializedOnFirstUse", text);
+		EXPECT_EQ(countLines(text), 1);
+	}
+
+	TEST(StaticSafeLoggerTest, disabledLevelSkipsFormatter)
+	{
+		StaticSafeLogger log(LOG_NAME);
+		int calls = 0;
+		log.debug("disabledLevelSkipsFormatter", [&calls]() { ++calls; return std::string(); });
+		log.fatal("disabledLevelSkipsFormatter", [&calls]() { ++calls; return std::string(); });
+		EXPECT_EQ(calls, 0);
+		log.info("disabledLevelSkipsFormatter", [&calls]() { ++calls; return std::string(); });
+		EXPECT_EQ(calls, 1);
+	}
+
+	TEST(StaticSafeLoggerTest, unknownLoggerWritesNothing)
+	{
+		StaticSafeLogger log("StaticSafeLoggerTestNotInConfig");
+		int calls = 0;
+		log.error("unknownLoggerWritesNothing", [&calls]() { ++calls; return std::string(); });
+		EXPECT_EQ(calls, 0);
+	}
+
+	TEST(StaticSafeLoggerTest, moveAssignedLoggerKeepsName)
+	{
+		StaticSafeLogger log("StaticSafeLoggerTestNotInConfig");
+		log = StaticSafeLogger(LOG_NAME);
+		const std::string text = marker();
+		log.warn("moveAssignedLoggerKeepsName", text);
+		EXPECT_EQ(countLines(text), 1);
+	}
+
+	// Threads race to use a logger nobody has used yet, every message is written once
+	TEST(StaticSafeLoggerTest, firstUseFromManyThreads)
+	{
+		const int threadCount = 8;
+		const int perThread = 200;
+		LogWriter::setOverflowPolicy(LogWriter::BLOCK);
+
+		for (int round = 0; round < 5; ++round) {
+			StaticSafeLogger log(LOG_NAME);
+			const std::string text = marker() + "." + std::to_string(round);
+			std::atomic<bool> start(false);
+			std::vector<std::thread> threads;
+			for (int t = 0; t < threadCount; ++t) {
+				threads.emplace_back([&log, &text, &start, perThread]() {
+					while (!start) { std::this_thread::yield(); }
+					for (int i = 0; i < perThread; ++i) {
+						log.info("firstUseFromManyThreads", text);
+					}
+				});
+			}
+			start = true;
+			for (auto& thread : threads) { thread.join(); }
+			EXPECT_EQ(countLines(text), threadCount * perThread);
+		}
+		LogWriter::setOverflowPolicy(LogWriter::DROP);
+	}
+
+	// Cost of a call to a disabled level once the logger is initialized, from one and from several threads
+	TEST(StaticSafeLoggerBenchmark, disabledLevelCall)
+	{
+		StaticSafeLogger log(LOG_NAME);
+		const int count = 2000000;
+		int calls = 0;
+		log.fatal("disabledLevelCall", [&calls]() { ++calls; return std::string(); });
+
+		for (const int threadCount : { 1, 4 }) {
+			std::vector<std::thread> threads;
+			const auto start = std::chrono::steady_clock::now();
+			for (int t = 0; t < threadCount; ++t) {
+				threads.emplace_back([&log, &calls, count]() {
+					for (int i = 0; i < count; ++i) {
+						log.fatal("disabledLevelCall", [&calls]() { ++calls; return std::string(); });
+					}
+				});
+			}
+			for (auto& thread : threads) { thread.join(); }
+			const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+			std::cout << "  " << threadCount << " threads: " << ns / count << " ns per call per thread" << std::endl;
+		}
+		EXPECT_EQ(calls, 0);
+	}
+}
@@ -0,0 +1,137 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "World/chunkmesher.h"
+#include "World/world.h"
+
+//Hide functions from other files
+namespace {
+
+	class ChunkMesherTest : public ::testing::Test {
+	protected:
+		World world;
+		const ChunkCoord origin = ChunkCoord(0, 0, 0);
+
+		// Fills the chunk with one block type
+		void fillChunk(const ChunkCoord& coord, BlockId id)
+		{
+			world.getOrCreateChunk(coord).fill(id);
+		}
+
+		// Meshes chunk at level of detail and returns the count of quads
+		unsigned int quadCount(const ChunkCoord& coord, int lod = 0)
+		{
+			chunkMesher::PaddedBlocks blocks;
+			chunkMesher::copyBlocks(world, coord, blocks);
+			return chunkMesher::countQuads(chunkMesher::buildMesh(blocks, lod));
+		}
+	};
+	class ChunkMesherLodParamTest : public ChunkMesherTest, public ::testing::WithParamInterface<int> {};
+
+	TEST_F(ChunkMesherTest, emptyChunkHasNoMesh)
+	{
+		EXPECT_TRUE(chunkMesher::buildMesh(world, origin).empty());
+	}
+
+	TEST_F(ChunkMesherTest, singleBlockHasSixFaces)
+	{
+		world.setBlock(glm::ivec3(4, 5, 6), GRASS);
+		const auto meshes = chunkMesher::buildMesh(world, origin);
+		ASSERT_EQ(meshes.size(), 1u);
+		EXPECT_EQ(meshes[0].type, GRASS);
+		EXPECT_EQ(chunkMesher::countQuads(meshes), 6u);
+		EXPECT_EQ(chunkMesher::countVertices(meshes), 24u);
+		EXPECT_EQ(meshes[0].indices.size(), 36u);
+	}
+
+	TEST_F(ChunkMesherTest, twoBlocksOfSameTypeMergeToSixFaces)
+	{
+		world.setBlock(glm::ivec3(4, 5, 6), DIRT);
+		world.setBlock(glm::ivec3(5, 5, 6), DIRT);
+		EXPECT_EQ(quadCount(origin), 6u);
+	}
+
+	TEST_F(ChunkMesherTest, twoBlocksOfDifferentTypesDoNotMerge)
+	{
+		world.setBlock(glm::ivec3(4, 5, 6), DIRT);
+		world.setBlock(glm::ivec3(5, 5, 6), STONE);
+		const auto meshes = chunkMesher::buildMesh(world, origin);
+		ASSERT_EQ(meshes.size(), 2u);
+		// Face between the blocks is hidden, both blocks show their other five faces
+		EXPECT_EQ(chunkMesher::countQuads(meshes), 10u);
+		for (const auto& mesh : meshes) { EXPECT_EQ(mesh.vertices.size(), 20u); }
+	}
+
+	TEST_F(ChunkMesherTest, fullChunkMergesToSixFaces)
+	{
+		fillChunk(origin, STONE);
+		EXPECT_EQ(quadCount(origin), 6u);
+	}
+
+	TEST_F(ChunkMesherTest, enclosedHoleAddsSixInnerFaces)
+	{
+		fillChunk(origin, STONE);
+		world.setBlock(glm::ivec3(8, 8, 8), AIR);
+		EXPECT_EQ(quadCount(origin), 12u);
+	}
+
+	TEST_F(ChunkMesherTest, neighbourChunkHidesBorderFaces)
+	{
+		fillChunk(origin, SAND);
+		fillChunk(ChunkCoord(1, 0, 0), SAND);
+		fillChunk(ChunkCoord(0, -1, 0), SAND);
+		EXPECT_EQ(quadCount(origin), 4u);
+	}
+
+	TEST_F(ChunkMesherTest, verticesAreLocalToChunkOrigin)
+	{
+		world.setBlock(glm::ivec3(-Chunk::SIZE, 0, 0), GRASS);
+		const auto meshes = chunkMesher::buildMesh(world, ChunkCoord(-1, 0, 0));
+		ASSERT_EQ(meshes.size(), 1u);
+		for (const auto& vertex : meshes[0].vertices) {
+			EXPECT_GE(vertex.position.x, -0.5f);
+			EXPECT_LE(vertex.position.x, 0.5f);
+		}
+	}
+
+	// Coarse levels keep the faces on chunk borders
+	TEST_P(ChunkMesherLodParamTest, fullChunkHasSixFacesOnEveryLevel)
+	{
+		fillChunk(origin, SNOW);
+		fillChunk(ChunkCoord(1, 0, 0), SNOW);
+		EXPECT_EQ(quadCount(origin, GetParam()), GetParam() == 0 ? 5u : 6u);
+	}
+	INSTANTIATE_TEST_CASE_P(ChunkMesherLodParamTest, ChunkMesherLodParamTest, ::testing::Range(0, chunkMesher::LOD_COUNT));
+
+	TEST_F(ChunkMesherTest, lodScale)
+	{
+		EXPECT_EQ(chunkMesher::getLodScale(0), 1);
+		EXPECT_EQ(chunkMesher::getLodScale(1), 2);
+		EXPECT_EQ(chunkMesher::getLodScale(3), 8);
+	}
+
+	// Meshing throughput of terrain like chunks with uneven surface and two block types
+	TEST(ChunkMesherBenchmark, chunksPerSecond)
+	{
+		World world;
+		for (int z = 0; z < Chunk::SIZE; ++z) {
+			for (int x = 0; x < Chunk::SIZE; ++x) {
+				const int height = 6 + (x * 7 + z * 13) % 5;
+				for (int y = 0; y < height; ++y) { world.setBlock(glm::ivec3(x, y, z), y + 1 < height ? DIRT : GRASS); }
+			}
+		}
+
+		chunkMesher::PaddedBlocks blocks;
+		chunkMesher::copyBlocks(world, ChunkCoord(0, 0, 0), blocks);
+		const int count = 200;
+		unsigned int quads = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < count; ++i) { quads += chunkMesher::countQuads(chunkMesher::buildMesh(blocks)); }
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		EXPECT_GT(quads, 0u);
+
+		std::cout << "  " << count / seconds << " chunks/s, " << quads / count << " quads per chunk" << std::endl;
+	}
+}
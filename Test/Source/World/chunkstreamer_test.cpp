@@ -0,0 +1,253 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Utility/threadpool.h"
+#include "World/chunkstreamer.h"
+
+//Hide functions from other files
+namespace {
+
+	const std::string DIRECTORY = "../Data/Test/ChunkStreamer/";
+	const int SIZE = Chunk::SIZE;
+
+	// Center position inside column at x, z
+	glm::vec3 columnCenter(int x, int z)
+	{
+		return glm::vec3(static_cast<float>(x * SIZE), 0.0f, static_cast<float>(z * SIZE));
+	}
+
+	// Count of vertices per level of detail
+	std::vector<std::size_t> vertexCounts(const chunkMesher::LodMeshes& meshes)
+	{
+		std::vector<std::size_t> counts;
+		for (const auto& lod : meshes) {
+			std::size_t count = 0;
+			for (const auto& mesh : lod) { count += mesh.vertices.size(); }
+			counts.push_back(count);
+		}
+		return counts;
+	}
+
+	class ChunkStreamerTest : public ::testing::Test {
+	protected:
+		ChunkStreamerTest() : m_world(), m_generator(TerrainGenerator::Settings()), m_results() {}
+
+		// Function called before every TEST_F call, removes regions left by earlier runs
+		void SetUp() override
+		{
+			for (int x = -2; x <= 2; ++x) {
+				for (int y = -2; y <= 2; ++y) {
+					for (int z = -2; z <= 2; ++z) {
+						std::remove((DIRECTORY + "r." + std::to_string(x) + "." + std::to_string(y) + "."
+							+ std::to_string(z) + ".region").c_str());
+					}
+				}
+			}
+		}
+
+		/**
+		 * \brief Used to update streamer until every column, mesh and save in flight has finished. Finished
+		 *	meshes are moved to m_results
+		 * \param streamer Streamer to update
+		 * \param center Center position
+		 * \param changes Output, chunks added and removed by all updates
+		 */
+		void settle(ChunkStreamer& streamer, const glm::vec3& center, ChunkStreamer::Changes& changes)
+		{
+			changes.loaded.clear();
+			changes.unloaded.clear();
+			const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+			while (std::chrono::steady_clock::now() < end) {
+				ChunkStreamer::Changes update;
+				streamer.update(center, update);
+				changes.loaded.insert(changes.loaded.end(), update.loaded.begin(), update.loaded.end());
+				changes.unloaded.insert(changes.unloaded.end(), update.unloaded.begin(), update.unloaded.end());
+
+				ChunkStreamer::MeshResult result;
+				while (streamer.popMesh(result)) { m_results.push_back(std::move(result)); }
+
+				const auto stats = streamer.getStats();
+				if (stats.pendingColumns == 0 && stats.dirtyChunks == 0 && stats.pendingMeshes == 0
+					&& stats.pendingSaves == 0)
+					return;
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			FAIL() << "Streamer did not settle";
+		}
+
+		// Columns that have chunks in the world
+		std::set<std::pair<int, int>> worldColumns() const
+		{
+			std::set<std::pair<int, int>> columns;
+			for (const auto& pair : m_world.getChunks()) { columns.emplace(pair.first.x, pair.first.z); }
+			return columns;
+		}
+
+		// Count of finished meshes of chunk
+		int resultCount(const ChunkCoord& coord) const
+		{
+			int count = 0;
+			for (const auto& result : m_results) { count += result.coord == coord ? 1 : 0; }
+			return count;
+		}
+
+		World m_world;
+		TerrainGenerator m_generator;
+		std::vector<ChunkStreamer::MeshResult> m_results;
+	};
+
+	TEST_F(ChunkStreamerTest, loadsColumnsWithinRadius)
+	{
+		ThreadPool pool(2);
+		ChunkStreamer streamer(m_world, m_generator, pool, nullptr, ChunkStreamer::Settings{ 1, 2, 4, 8 });
+		ChunkStreamer::Changes changes;
+		settle(streamer, columnCenter(0, 0), changes);
+
+		std::set<std::pair<int, int>> expected;
+		for (int x = -1; x <= 1; ++x) {
+			for (int z = -1; z <= 1; ++z) { expected.emplace(x, z); }
+		}
+		EXPECT_EQ(worldColumns(), expected);
+		EXPECT_EQ(streamer.getStats().loadedColumns, 9u);
+		EXPECT_EQ(changes.loaded.size(), m_world.getChunks().size());
+		EXPECT_TRUE(changes.unloaded.empty());
+
+		// Every loaded chunk is meshed, first time with its request time
+		for (const auto& coord : changes.loaded) {
+			ASSERT_GE(resultCount(coord), 1);
+			EXPECT_GE(std::find_if(m_results.begin(), m_results.end(), [&coord](const ChunkStreamer::MeshResult& result) {
+				return result.coord == coord; })->requestTime, 0);
+		}
+	}
+
+	// Columns between load and unload radius stay loaded, so moving over the load border does not reload them
+	TEST_F(ChunkStreamerTest, evictsOnlyBeyondUnloadRadius)
+	{
+		ThreadPool pool(2);
+		ChunkStreamer streamer(m_world, m_generator, pool, nullptr, ChunkStreamer::Settings{ 1, 2, 4, 8 });
+		ChunkStreamer::Changes changes;
+		settle(streamer, columnCenter(0, 0), changes);
+
+		settle(streamer, columnCenter(1, 0), changes);
+		EXPECT_TRUE(changes.unloaded.empty());
+		EXPECT_EQ(streamer.getStats().loadedColumns, 12u);
+		for (const auto& coord : changes.loaded) { EXPECT_EQ(coord.x, 2); }
+
+		settle(streamer, columnCenter(0, 0), changes);
+		EXPECT_TRUE(changes.loaded.empty());
+		EXPECT_TRUE(changes.unloaded.empty());
+
+		settle(streamer, columnCenter(2, 0), changes);
+		EXPECT_FALSE(changes.unloaded.empty());
+		for (const auto& coord : changes.unloaded) { EXPECT_EQ(coord.x, -1); }
+		for (const auto& coord : changes.loaded) { EXPECT_EQ(coord.x, 3); }
+		EXPECT_EQ(streamer.getStats().loadedColumns, 12u);
+		for (const auto& column : worldColumns()) {
+			EXPECT_GE(column.first, 0);
+			EXPECT_LE(column.first, 3);
+		}
+	}
+
+	// Mesh whose blocks were copied before a newer change is dropped, only the newest revision is delivered
+	TEST_F(ChunkStreamerTest, dropsOutdatedMeshes)
+	{
+		ThreadPool pool(1);
+		ChunkStreamer streamer(m_world, m_generator, pool, nullptr, ChunkStreamer::Settings{ 0, 0, 1, 8 });
+		ChunkStreamer::Changes changes;
+		settle(streamer, columnCenter(0, 0), changes);
+		ASSERT_FALSE(changes.loaded.empty());
+		const auto coord = changes.loaded.front();
+		m_results.clear();
+
+		// Worker is held, so both meshing tasks are in flight at the same time
+		std::promise<void> gate;
+		auto released = gate.get_future().share();
+		pool.submit([released]() { released.wait(); });
+
+		streamer.markDirty(coord);
+		streamer.update(columnCenter(0, 0), changes);
+		const glm::ivec3 pos = World::toWorldPos(coord) + glm::ivec3(SIZE / 2);
+		m_world.setBlock(pos, m_world.getBlock(pos) == AIR ? STONE : AIR);
+		streamer.markDirty(coord);
+		streamer.update(columnCenter(0, 0), changes);
+		EXPECT_EQ(streamer.getStats().pendingMeshes, 2u);
+
+		gate.set_value();
+		settle(streamer, columnCenter(0, 0), changes);
+		ASSERT_EQ(resultCount(coord), 1);
+
+		chunkMesher::PaddedBlocks blocks;
+		chunkMesher::copyBlocks(m_world, coord, blocks);
+		EXPECT_EQ(vertexCounts(m_results.front().meshes), vertexCounts(chunkMesher::buildLodMeshes(blocks)));
+		EXPECT_EQ(m_results.front().requestTime, -1);
+	}
+
+	TEST_F(ChunkStreamerTest, marksOnlyChunksThatExisted)
+	{
+		ThreadPool pool(2);
+		ChunkStreamer streamer(m_world, m_generator, pool, nullptr, ChunkStreamer::Settings{ 0, 0, 1, 8 });
+		ChunkStreamer::Changes changes;
+		settle(streamer, columnCenter(0, 0), changes);
+		ASSERT_FALSE(changes.loaded.empty());
+		m_results.clear();
+
+		// Never loaded coordinates, e.g. neighbours of edits at the border, are not queued
+		streamer.markDirty(ChunkCoord(1, 0, 0));
+		streamer.markDirty(ChunkCoord(0, 100, 0));
+		EXPECT_EQ(streamer.getStats().dirtyChunks, 0u);
+
+		// Removed chunk delivers an empty mesh once, so the old one is dropped
+		const auto coord = changes.loaded.front();
+		m_world.takeChunk(coord);
+		streamer.markDirty(coord);
+		EXPECT_EQ(streamer.getStats().dirtyChunks, 1u);
+		settle(streamer, columnCenter(0, 0), changes);
+		ASSERT_EQ(resultCount(coord), 1);
+		EXPECT_EQ(vertexCounts(m_results.front().meshes), std::vector<std::size_t>(chunkMesher::LOD_COUNT, 0));
+
+		streamer.markDirty(coord);
+		EXPECT_EQ(streamer.getStats().dirtyChunks, 0u);
+	}
+
+	TEST_F(ChunkStreamerTest, savesEditedColumnOnEvict)
+	{
+		WorldStorage storage(DIRECTORY);
+		ThreadPool pool(2);
+		ChunkStreamer streamer(m_world, m_generator, pool, &storage, ChunkStreamer::Settings{ 0, 0, 1, 8 });
+		ChunkStreamer::Changes changes;
+		settle(streamer, columnCenter(0, 0), changes);
+		EXPECT_EQ(streamer.getStats().storedColumns, 0u);
+
+		const glm::ivec3 pos(3, m_generator.getHeight(3, 5) + 1, 5);
+		ASSERT_EQ(m_world.getBlock(pos), AIR);
+		m_world.setBlock(pos, STONE);
+		streamer.markModified(World::toChunkCoord(pos));
+		streamer.markDirty(World::toChunkCoord(pos));
+
+		settle(streamer, columnCenter(1, 0), changes);
+		EXPECT_FALSE(changes.unloaded.empty());
+		EXPECT_EQ(m_world.getBlock(pos), AIR);
+		EXPECT_EQ(streamer.getStats().failedSaves, 0u);
+
+		std::unique_ptr<Chunk> chunk;
+		ASSERT_EQ(storage.loadChunk(World::toChunkCoord(pos), chunk), WorldStorage::STORED);
+		ASSERT_NE(chunk, nullptr);
+		const auto local = World::toLocalPos(pos);
+		EXPECT_EQ(chunk->getBlock(local.x, local.y, local.z), STONE);
+
+		// Column comes back from storage with the edit
+		settle(streamer, columnCenter(0, 0), changes);
+		EXPECT_EQ(m_world.getBlock(pos), STONE);
+		EXPECT_EQ(streamer.getStats().storedColumns, 1u);
+		EXPECT_EQ(streamer.getStats().failedSaves, 0u);
+	}
+}
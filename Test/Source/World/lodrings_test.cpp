@@ -0,0 +1,82 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include "World/lodrings.h"
+
+//Hide functions from other files
+namespace {
+
+	const int SIZE = Chunk::SIZE;
+	const LodRings::Distances DISTANCES = { 2, 4, 7 };
+
+	TEST(LodRingsTest, ringsFollowChebyshevDistance)
+	{
+		LodRings rings(DISTANCES);
+		rings.setCenter(glm::vec3(0.0f));
+		EXPECT_EQ(rings.getCenter(), ChunkCoord(0, 0, 0));
+
+		EXPECT_EQ(rings.select(ChunkCoord(0, 0, 0)), 0);
+		EXPECT_EQ(rings.select(ChunkCoord(1, -1, 1)), 0);
+		EXPECT_EQ(rings.select(ChunkCoord(2, 0, 0)), 1);
+		EXPECT_EQ(rings.select(ChunkCoord(0, -2, 0)), 1);
+		EXPECT_EQ(rings.select(ChunkCoord(3, 3, -3)), 1);
+		EXPECT_EQ(rings.select(ChunkCoord(1, 0, 4)), 2);
+		EXPECT_EQ(rings.select(ChunkCoord(-6, 6, 6)), 2);
+		EXPECT_EQ(rings.select(ChunkCoord(7, 0, 0)), 3);
+		EXPECT_EQ(rings.select(ChunkCoord(0, 0, -100)), 3);
+	}
+
+	TEST(LodRingsTest, ringsMoveWhenCenterCrossesChunkBorder)
+	{
+		LodRings rings(DISTANCES);
+		const ChunkCoord coord(2, 0, 0);
+
+		// Block at SIZE - 1 is the last one of chunk 0, it ends half a block further
+		rings.setCenter(glm::vec3(SIZE - 0.51f, 5.0f, 3.0f));
+		EXPECT_EQ(rings.getCenter(), ChunkCoord(0, 0, 0));
+		EXPECT_EQ(rings.select(coord), 1);
+		EXPECT_EQ(rings.select(ChunkCoord(-1, 0, 0)), 0);
+
+		rings.setCenter(glm::vec3(SIZE - 0.49f, 5.0f, 3.0f));
+		EXPECT_EQ(rings.getCenter(), ChunkCoord(1, 0, 0));
+		EXPECT_EQ(rings.select(coord), 0);
+		EXPECT_EQ(rings.select(ChunkCoord(-1, 0, 0)), 1);
+
+		// Negative positions round down to the chunk below
+		rings.setCenter(glm::vec3(-0.51f, -0.51f, 3.0f));
+		EXPECT_EQ(rings.getCenter(), ChunkCoord(-1, -1, 0));
+		EXPECT_EQ(rings.select(ChunkCoord(1, 0, 0)), 1);
+	}
+
+	TEST(LodRingsTest, statsCountChunksPerRing)
+	{
+		LodRings rings(DISTANCES);
+		rings.setCenter(glm::vec3(0.0f));
+		for (int x = -8; x <= 8; ++x) {
+			const ChunkCoord coord(x, 0, 0);
+			rings.countDrawn(rings.select(coord), 10);
+		}
+
+		// Rings are 3, 4, 6 and 4 chunks wide on the line x = -8..8
+		const LodRings::Stats& stats = rings.getStats();
+		EXPECT_EQ(stats.chunks[0], 3u);
+		EXPECT_EQ(stats.chunks[1], 4u);
+		EXPECT_EQ(stats.chunks[2], 6u);
+		EXPECT_EQ(stats.chunks[3], 4u);
+		EXPECT_EQ(stats.vertices[0], 30u);
+		EXPECT_EQ(stats.vertices[3], 40u);
+
+		// Moving the center starts a new count
+		rings.setCenter(glm::vec3(100.0f));
+		for (const auto count : rings.getStats().chunks) { EXPECT_EQ(count, 0u); }
+	}
+
+	// Equal limits leave the level between them unused
+	TEST(LodRingsTest, equalDistancesSkipLevel)
+	{
+		LodRings rings(LodRings::Distances{ 1, 1, 3 });
+		rings.setCenter(glm::vec3(0.0f));
+		EXPECT_EQ(rings.select(ChunkCoord(0, 0, 0)), 0);
+		EXPECT_EQ(rings.select(ChunkCoord(1, 0, 0)), 2);
+		EXPECT_EQ(rings.select(ChunkCoord(3, 0, 0)), 3);
+	}
+}
@@ -0,0 +1,274 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "World/spatialgrid.h"
+
+//Hide functions from other files
+namespace {
+
+	using Grid = SpatialGrid<int>;
+
+	// Box of half size around center
+	AABB box(const glm::vec3& center, float halfSize)
+	{
+		return AABB{ center - glm::vec3(halfSize), center + glm::vec3(halfSize) };
+	}
+
+	bool overlaps(const AABB& lhs, const AABB& rhs)
+	{
+		return lhs.min.x <= rhs.max.x && lhs.max.x >= rhs.min.x && lhs.min.y <= rhs.max.y && lhs.max.y >= rhs.min.y
+			&& lhs.min.z <= rhs.max.z && lhs.max.z >= rhs.min.z;
+	}
+
+	// Slab test, returns distance to the first hit in units of direction or a negative value if box is missed
+	float rayDistance(const AABB& box, const glm::vec3& origin, const glm::vec3& direction, float maxDistance)
+	{
+		float tNear = 0.0f;
+		float tFar = maxDistance;
+		for (int d = 0; d < 3; ++d) {
+			if (direction[d] == 0.0f) {
+				if (origin[d] < box.min[d] || origin[d] > box.max[d])
+					return -1.0f;
+				continue;
+			}
+			float t0 = (box.min[d] - origin[d]) / direction[d];
+			float t1 = (box.max[d] - origin[d]) / direction[d];
+			if (t0 > t1)
+				std::swap(t0, t1);
+			tNear = std::max(tNear, t0);
+			tFar = std::min(tFar, t1);
+			if (tNear > tFar)
+				return -1.0f;
+		}
+		return tNear;
+	}
+
+	class SpatialGridTest : public ::testing::Test {
+	protected:
+		SpatialGridTest() : grid(8.0f) {}
+
+		Grid grid;
+		std::vector<AABB> boxes;	// Box of each key, key is the index
+		std::vector<int> result;
+
+		// Adds boxes of random size to random positions, some of them larger than a cell
+		void addRandomBoxes(int count)
+		{
+			std::mt19937 random(1234);
+			std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+			std::uniform_real_distribution<float> size(0.1f, 12.0f);
+			for (int i = 0; i < count; ++i) {
+				boxes.push_back(box(glm::vec3(position(random), position(random), position(random)), size(random)));
+				grid.set(i, boxes.back());
+			}
+		}
+
+		// Sorts result so that it can be compared to brute force result
+		std::vector<int> sorted(std::vector<int> keys)
+		{
+			std::sort(keys.begin(), keys.end());
+			return keys;
+		}
+	};
+
+	TEST_F(SpatialGridTest, emptyGridFindsNothing)
+	{
+		grid.queryBox(box(glm::vec3(0.0f), 100.0f), result);
+		grid.querySphere(glm::vec3(0.0f), 100.0f, result);
+		grid.queryRay(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 100.0f, result);
+		EXPECT_TRUE(result.empty());
+		EXPECT_EQ(grid.size(), 0u);
+	}
+
+	TEST_F(SpatialGridTest, setMoveAndRemove)
+	{
+		grid.set(1, box(glm::vec3(0.0f), 1.0f));
+		EXPECT_TRUE(grid.contains(1));
+		EXPECT_EQ(grid.size(), 1u);
+
+		// Moved entry is only found in its new place
+		grid.set(1, box(glm::vec3(50.0f, 0.0f, 0.0f), 1.0f));
+		EXPECT_EQ(grid.size(), 1u);
+		grid.queryBox(box(glm::vec3(0.0f), 2.0f), result);
+		EXPECT_TRUE(result.empty());
+		grid.queryBox(box(glm::vec3(50.0f, 0.0f, 0.0f), 2.0f), result);
+		EXPECT_EQ(result, std::vector<int>({ 1 }));
+
+		EXPECT_TRUE(grid.remove(1));
+		EXPECT_FALSE(grid.contains(1));
+		EXPECT_FALSE(grid.remove(1));
+		result.clear();
+		grid.queryBox(box(glm::vec3(50.0f, 0.0f, 0.0f), 2.0f), result);
+		EXPECT_TRUE(result.empty());
+	}
+
+	TEST_F(SpatialGridTest, entrySpanningManyCellsIsReportedOnce)
+	{
+		grid.set(7, box(glm::vec3(0.0f), 30.0f));
+		grid.queryBox(box(glm::vec3(0.0f), 40.0f), result);
+		EXPECT_EQ(result, std::vector<int>({ 7 }));
+		result.clear();
+		grid.queryRay(glm::vec3(-50.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 100.0f, result);
+		EXPECT_EQ(result, std::vector<int>({ 7 }));
+	}
+
+	TEST_F(SpatialGridTest, negativeCoordinates)
+	{
+		grid.set(3, box(glm::vec3(-0.5f, -8.5f, -16.5f), 0.25f));
+		grid.queryBox(box(glm::vec3(-0.5f, -8.5f, -16.5f), 0.1f), result);
+		EXPECT_EQ(result, std::vector<int>({ 3 }));
+	}
+
+	TEST_F(SpatialGridTest, clearRemovesEverything)
+	{
+		addRandomBoxes(100);
+		grid.clear();
+		EXPECT_EQ(grid.size(), 0u);
+		grid.queryBox(box(glm::vec3(0.0f), 200.0f), result);
+		EXPECT_TRUE(result.empty());
+	}
+
+	TEST_F(SpatialGridTest, queryBoxMatchesBruteForce)
+	{
+		addRandomBoxes(2000);
+		for (const float halfSize : { 0.5f, 5.0f, 30.0f, 500.0f }) {
+			const AABB query = box(glm::vec3(10.0f, -20.0f, 5.0f), halfSize);
+			std::vector<int> expected;
+			for (int i = 0; i < static_cast<int>(boxes.size()); ++i) {
+				if (overlaps(boxes[i], query))
+					expected.push_back(i);
+			}
+			result.clear();
+			grid.queryBox(query, result);
+			EXPECT_EQ(sorted(result), expected) << "half size " << halfSize;
+		}
+	}
+
+	TEST_F(SpatialGridTest, querySphereMatchesBruteForce)
+	{
+		addRandomBoxes(2000);
+		const glm::vec3 center(-30.0f, 10.0f, 0.0f);
+		for (const float radius : { 0.0f, 3.0f, 25.0f }) {
+			std::vector<int> expected;
+			for (int i = 0; i < static_cast<int>(boxes.size()); ++i) {
+				const glm::vec3 offset = glm::clamp(center, boxes[i].min, boxes[i].max) - center;
+				if (glm::dot(offset, offset) <= radius * radius)
+					expected.push_back(i);
+			}
+			result.clear();
+			grid.querySphere(center, radius, result);
+			EXPECT_EQ(sorted(result), expected) << "radius " << radius;
+		}
+	}
+
+	TEST_F(SpatialGridTest, queryRayMatchesBruteForceInHitOrder)
+	{
+		addRandomBoxes(2000);
+		const glm::vec3 origin(-120.0f, -3.0f, 7.0f);
+		const glm::vec3 direction = glm::normalize(glm::vec3(1.0f, 0.1f, -0.05f));
+		std::vector<int> expected;
+		for (int i = 0; i < static_cast<int>(boxes.size()); ++i) {
+			if (rayDistance(boxes[i], origin, direction, 250.0f) >= 0.0f)
+				expected.push_back(i);
+		}
+		grid.queryRay(origin, direction, 250.0f, result);
+		ASSERT_FALSE(expected.empty());
+		EXPECT_EQ(sorted(result), expected);
+		for (std::size_t i = 1; i < result.size(); ++i) {
+			EXPECT_LE(rayDistance(boxes[result[i - 1]], origin, direction, 250.0f),
+				rayDistance(boxes[result[i]], origin, direction, 250.0f));
+		}
+	}
+
+	// Walk ends where the cells with entries end, even when the ray does not
+	TEST_F(SpatialGridTest, infiniteRayStopsAtLastEntry)
+	{
+		addRandomBoxes(200);
+		const float infinity = std::numeric_limits<float>::infinity();
+		const glm::vec3 origin(-120.0f, 0.5f, 0.5f);
+		std::vector<int> expected;
+		for (int i = 0; i < static_cast<int>(boxes.size()); ++i) {
+			if (rayDistance(boxes[i], origin, glm::vec3(1.0f, 0.0f, 0.0f), infinity) >= 0.0f)
+				expected.push_back(i);
+		}
+		grid.queryRay(origin, glm::vec3(1.0f, 0.0f, 0.0f), infinity, result);
+		EXPECT_EQ(sorted(result), expected);
+
+		// Pointing away from every entry, and passing next to them on an axis the ray does not move on
+		result.clear();
+		grid.queryRay(origin, glm::vec3(-1.0f, 0.0f, 0.0f), infinity, result);
+		grid.queryRay(glm::vec3(0.0f, 500.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), infinity, result);
+		grid.queryRay(glm::vec3(0.0f, 500.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), infinity, result);
+		EXPECT_TRUE(result.empty());
+
+		// Grid emptied by removals does not keep the old extent
+		for (int i = 0; i < static_cast<int>(boxes.size()); ++i) { grid.remove(i); }
+		grid.set(0, box(glm::vec3(1000.0f, 0.5f, 0.5f), 1.0f));
+		grid.queryRay(origin, glm::vec3(1.0f, 0.0f, 0.0f), infinity, result);
+		EXPECT_EQ(result, std::vector<int>{ 0 });
+	}
+
+#ifdef NDEBUG
+	TEST_F(SpatialGridTest, zeroDirectionFindsNothing) { // This test breaks precondition and therefore cannot be run in debug mode
+		addRandomBoxes(200);
+		grid.queryRay(boxes[0].min, glm::vec3(0.0f), std::numeric_limits<float>::infinity(), result);
+		EXPECT_TRUE(result.empty());
+	}
+#endif // RELEASE
+
+	// Build and query time of grids of chunk sized boxes, like the chunk index of WorldManager
+	class SpatialGridBenchmark : public ::testing::TestWithParam<int> {};
+
+	TEST_P(SpatialGridBenchmark, buildAndQuery)
+	{
+		const int count = GetParam();
+		const int edge = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(count))));
+		Grid grid(64.0f);
+		const auto timeMs = [](auto func) {
+			const auto start = std::chrono::steady_clock::now();
+			func();
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		};
+
+		const double buildMs = timeMs([&]() {
+			for (int i = 0; i < count; ++i) {
+				const glm::vec3 min(static_cast<float>(i % edge * 16), static_cast<float>(i / edge % edge * 16),
+					static_cast<float>(i / (edge * edge) * 16));
+				grid.set(i, AABB{ min, min + glm::vec3(16.0f) });
+			}
+		});
+		ASSERT_EQ(grid.size(), static_cast<std::size_t>(count));
+
+		// Sphere around a viewer inside the grid, like the view distance query
+		const int queries = 100;
+		std::vector<int> result;
+		std::size_t found = 0;
+		const glm::vec3 center(edge * 8.0f);
+		const double sphereMs = timeMs([&]() {
+			for (int i = 0; i < queries; ++i) {
+				result.clear();
+				grid.querySphere(center + glm::vec3(static_cast<float>(i)), 128.0f, result);
+				found += result.size();
+			}
+		}) / queries;
+		const double rayMs = timeMs([&]() {
+			for (int i = 0; i < queries; ++i) {
+				result.clear();
+				grid.queryRay(center, glm::vec3(1.0f, 0.3f, static_cast<float>(i) / queries), 256.0f, result);
+				found += result.size();
+			}
+		}) / queries;
+		EXPECT_GT(found, 0u);
+
+		std::cout << "  " << count << " entries: build " << buildMs << " ms, sphere query " << sphereMs
+			<< " ms, ray query " << rayMs << " ms" << std::endl;
+	}
+	INSTANTIATE_TEST_CASE_P(SpatialGridBenchmark, SpatialGridBenchmark, ::testing::Values(10000, 100000, 1000000));
+}
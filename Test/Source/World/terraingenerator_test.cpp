@@ -0,0 +1,181 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <vector>
+
+#include "Utility/threadpool.h"
+#include "World/terraingenerator.h"
+
+//Hide functions from other files
+namespace {
+
+	const int SIZE = Chunk::SIZE;
+	const int VOLUME = Chunk::VOLUME;
+
+	// FNV-1a over the blocks of generated chunks, empty chunks hash as a single marker byte
+	class ChunkHash {
+	public:
+		void add(const Chunk* chunk)
+		{
+			if (chunk == nullptr) {
+				addByte(0xFF);
+				return;
+			}
+			const BlockId* data = chunk->getData();
+			for (int i = 0; i < VOLUME; ++i) { addByte(data[i]); }
+		}
+
+		uint64_t get() const { return m_hash; }
+
+	private:
+		uint64_t m_hash = 14695981039346656037ull;
+
+		void addByte(uint8_t byte)
+		{
+			m_hash ^= byte;
+			m_hash *= 1099511628211ull;
+		}
+	};
+
+	// All chunk coordinates of a square area of columns, over every chunk layer the generator can fill
+	std::vector<ChunkCoord> areaCoords(const TerrainGenerator& generator, int radius)
+	{
+		std::vector<ChunkCoord> coords;
+		for (int x = -radius; x < radius; ++x) {
+			for (int z = -radius; z < radius; ++z) {
+				for (int y = generator.getMinChunkY(); y <= generator.getMaxChunkY(); ++y) { coords.push_back(ChunkCoord(x, y, z)); }
+			}
+		}
+		return coords;
+	}
+
+	/**
+	 * \brief Used to generate chunks on a pool and hash them in coordinate order
+	 * \param generator Terrain generator
+	 * \param coords Chunks to generate
+	 * \param threadCount Count of pool threads, 0 to generate on the calling thread
+	 * \return Hash of the generated chunks
+	 */
+	uint64_t generateArea(const TerrainGenerator& generator, const std::vector<ChunkCoord>& coords, unsigned int threadCount)
+	{
+		std::vector<std::unique_ptr<Chunk>> chunks(coords.size());
+		if (threadCount == 0) {
+			for (std::size_t i = 0; i < coords.size(); ++i) { chunks[i] = generator.generateChunk(coords[i]); }
+		}
+		else {
+			// Submit in reverse order so that the completion order differs from the single threaded one
+			ThreadPool pool(threadCount);
+			std::vector<std::future<std::unique_ptr<Chunk>>> futures(coords.size());
+			for (std::size_t i = coords.size(); i-- > 0;) {
+				const ChunkCoord coord = coords[i];
+				futures[i] = pool.submit([&generator, coord]() { return generator.generateChunk(coord); });
+			}
+			for (std::size_t i = 0; i < coords.size(); ++i) { chunks[i] = futures[i].get(); }
+		}
+
+		ChunkHash hash;
+		for (const auto& chunk : chunks) { hash.add(chunk.get()); }
+		return hash.get();
+	}
+
+	class TerrainGeneratorTest : public ::testing::Test {
+	protected:
+		TerrainGeneratorTest() : generator(TerrainGenerator::Settings()) {}
+
+		TerrainGenerator generator;
+	};
+
+	TEST_F(TerrainGeneratorTest, heightStaysInRange)
+	{
+		const auto& settings = generator.getSettings();
+		int minHeight = settings.baseHeight;
+		int maxHeight = settings.baseHeight;
+		for (int x = -200; x < 200; x += 3) {
+			for (int z = -200; z < 200; z += 3) {
+				const int height = generator.getHeight(x, z);
+				minHeight = std::min(minHeight, height);
+				maxHeight = std::max(maxHeight, height);
+			}
+		}
+		EXPECT_GE(minHeight, settings.baseHeight - settings.amplitude);
+		EXPECT_LE(maxHeight, settings.baseHeight + settings.amplitude);
+
+		// Terrain is not flat
+		EXPECT_LT(minHeight, maxHeight);
+	}
+
+	TEST_F(TerrainGeneratorTest, chunksMatchHeights)
+	{
+		for (const auto& coord : areaCoords(generator, 2)) {
+			const auto chunk = generator.generateChunk(coord);
+			const auto origin = World::toWorldPos(coord);
+			for (int x = 0; x < SIZE; ++x) {
+				for (int z = 0; z < SIZE; ++z) {
+					const int height = generator.getHeight(origin.x + x, origin.z + z);
+					for (int y = 0; y < SIZE; ++y) {
+						const int worldY = origin.y + y;
+						const BlockId block = chunk ? chunk->getBlock(x, y, z) : static_cast<BlockId>(AIR);
+						const bool solid = worldY <= height && worldY >= generator.getSettings().bottom;
+						ASSERT_EQ(block != AIR, solid) << "block " << origin.x + x << ", " << worldY << ", " << origin.z + z;
+					}
+				}
+			}
+		}
+	}
+
+	TEST_F(TerrainGeneratorTest, usesSeveralTerrainTypes)
+	{
+		std::vector<bool> found(TERRAIN_TYPE_COUNT, false);
+		for (const auto& coord : areaCoords(generator, 8)) {
+			const auto chunk = generator.generateChunk(coord);
+			if (chunk == nullptr)
+				continue;
+			const BlockId* data = chunk->getData();
+			for (int i = 0; i < VOLUME; ++i) { found[data[i]] = true; }
+		}
+		EXPECT_TRUE(found[GRASS]);
+		EXPECT_TRUE(found[DIRT]);
+		EXPECT_TRUE(found[STONE]);
+		EXPECT_TRUE(found[SAND] || found[SNOW]);
+	}
+
+	TEST_F(TerrainGeneratorTest, chunksOutsideLayersAreEmpty)
+	{
+		EXPECT_EQ(generator.generateChunk(ChunkCoord(0, generator.getMaxChunkY() + 1, 0)), nullptr);
+		EXPECT_EQ(generator.generateChunk(ChunkCoord(0, generator.getMinChunkY() - 1, 0)), nullptr);
+	}
+
+	TEST_F(TerrainGeneratorTest, seedSelectsTerrain)
+	{
+		TerrainGenerator::Settings settings;
+		settings.seed = generator.getSettings().seed + 1;
+		const TerrainGenerator other(settings);
+		const TerrainGenerator same(generator.getSettings());
+
+		const auto coords = areaCoords(generator, 2);
+		EXPECT_EQ(generateArea(generator, coords, 0), generateArea(same, coords, 0));
+		EXPECT_NE(generateArea(generator, coords, 0), generateArea(other, coords, 0));
+	}
+
+	// Same seed must give bit identical chunks regardless of thread count, and the chunks/s rate shows scaling
+	TEST(TerrainGeneratorBenchmark, chunksPerSecondAcrossThreads)
+	{
+		const TerrainGenerator generator{ TerrainGenerator::Settings() };
+		const auto coords = areaCoords(generator, 12);
+		const uint64_t expected = generateArea(generator, coords, 0);
+
+		const unsigned int maxThreads = std::max(4u, ThreadPool::getDefaultThreadCount());
+		for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+			const auto start = std::chrono::steady_clock::now();
+			const uint64_t hash = generateArea(generator, coords, threads);
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			EXPECT_EQ(hash, expected) << threads << " threads";
+			std::cout << "  " << threads << " threads: " << coords.size() / seconds << " chunks/s" << std::endl;
+		}
+	}
+}
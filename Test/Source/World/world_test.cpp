@@ -0,0 +1,228 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "Object/terrain.h"
+#include "World/chunk.h"
+#include "World/world.h"
+
+//Hide functions from other files
+namespace {
+
+	class ChunkTest : public ::testing::Test {
+	protected:
+		Chunk chunk;
+	};
+
+	class WorldTest : public ::testing::Test {
+	protected:
+		World world;
+	};
+
+	// Block positions around chunk borders on both sides of origin, paired with their chunk and local coordinate
+	class WorldCoordParamTest : public ::testing::TestWithParam<std::tuple<int, int, int>> {};
+
+	// Test Chunk
+	TEST_F(ChunkTest, newChunkIsEmpty)
+	{
+		EXPECT_TRUE(chunk.isEmpty());
+		EXPECT_EQ(chunk.getSolidCount(), 0u);
+		for (int i = 0; i < Chunk::VOLUME; ++i) { ASSERT_EQ(chunk.getData()[i], AIR); }
+	}
+
+	TEST_F(ChunkTest, setAndGetBlock)
+	{
+		chunk.setBlock(0, 0, 0, GRASS);
+		chunk.setBlock(Chunk::SIZE - 1, Chunk::SIZE - 1, Chunk::SIZE - 1, SNOW);
+		chunk.setBlock(3, 7, 11, STONE);
+		EXPECT_EQ(chunk.getBlock(0, 0, 0), GRASS);
+		EXPECT_EQ(chunk.getBlock(Chunk::SIZE - 1, Chunk::SIZE - 1, Chunk::SIZE - 1), SNOW);
+		EXPECT_EQ(chunk.getBlock(3, 7, 11), STONE);
+		EXPECT_EQ(chunk.getBlock(11, 7, 3), AIR);
+		EXPECT_EQ(chunk.getSolidCount(), 3u);
+		EXPECT_FALSE(chunk.isEmpty());
+	}
+
+	TEST_F(ChunkTest, overwriteBlockKeepsSolidCount)
+	{
+		chunk.setBlock(1, 2, 3, DIRT);
+		chunk.setBlock(1, 2, 3, SAND);
+		EXPECT_EQ(chunk.getBlock(1, 2, 3), SAND);
+		EXPECT_EQ(chunk.getSolidCount(), 1u);
+		chunk.setBlock(1, 2, 3, AIR);
+		EXPECT_TRUE(chunk.isEmpty());
+	}
+
+	TEST_F(ChunkTest, fillAndClear)
+	{
+		chunk.fill(DIRT);
+		EXPECT_EQ(chunk.getSolidCount(), static_cast<unsigned int>(Chunk::VOLUME));
+		EXPECT_EQ(chunk.getBlock(5, 5, 5), DIRT);
+		chunk.fill(AIR);
+		EXPECT_TRUE(chunk.isEmpty());
+	}
+
+	TEST_F(ChunkTest, indexRunsXFastestThenZThenY)
+	{
+		const int size = Chunk::SIZE;
+		EXPECT_EQ(Chunk::index(1, 0, 0), 1);
+		EXPECT_EQ(Chunk::index(0, 0, 1), size);
+		EXPECT_EQ(Chunk::index(0, 1, 0), size * size);
+		chunk.setBlock(2, 3, 4, GRASS);
+		EXPECT_EQ(chunk.getData()[Chunk::index(2, 3, 4)], GRASS);
+	}
+
+	TEST_F(ChunkTest, isInside)
+	{
+		EXPECT_TRUE(Chunk::isInside(0, 0, 0));
+		EXPECT_TRUE(Chunk::isInside(Chunk::SIZE - 1, Chunk::SIZE - 1, Chunk::SIZE - 1));
+		EXPECT_FALSE(Chunk::isInside(-1, 0, 0));
+		EXPECT_FALSE(Chunk::isInside(0, Chunk::SIZE, 0));
+		EXPECT_FALSE(Chunk::isInside(0, 0, Chunk::SIZE));
+	}
+
+	// Test coordinate conversions, division has to round towards negative infinity
+	TEST_P(WorldCoordParamTest, toChunkCoordAndLocalPos)
+	{
+		const int pos = std::get<0>(GetParam());
+		const int chunkCoord = std::get<1>(GetParam());
+		const int local = std::get<2>(GetParam());
+		EXPECT_EQ(World::toChunkCoord(glm::ivec3(pos, pos, pos)), ChunkCoord(chunkCoord, chunkCoord, chunkCoord));
+		EXPECT_EQ(World::toLocalPos(glm::ivec3(pos, pos, pos)), glm::ivec3(local, local, local));
+		EXPECT_EQ(World::toWorldPos(ChunkCoord(chunkCoord, chunkCoord, chunkCoord)) + glm::ivec3(local, local, local),
+			glm::ivec3(pos, pos, pos));
+	}
+	INSTANTIATE_TEST_CASE_P(WorldCoordParamTest, WorldCoordParamTest, ::testing::Values(
+		std::make_tuple(0, 0, 0),
+		std::make_tuple(1, 0, 1),
+		std::make_tuple(Chunk::SIZE - 1, 0, Chunk::SIZE - 1),
+		std::make_tuple(Chunk::SIZE, 1, 0),
+		std::make_tuple(-1, -1, Chunk::SIZE - 1),
+		std::make_tuple(-Chunk::SIZE, -1, 0),
+		std::make_tuple(-Chunk::SIZE - 1, -2, Chunk::SIZE - 1),
+		std::make_tuple(-3 * Chunk::SIZE, -3, 0)));
+
+	// Test World
+	TEST_F(WorldTest, emptyWorldReturnsAir)
+	{
+		EXPECT_EQ(world.getBlock(glm::ivec3(0, 0, 0)), AIR);
+		EXPECT_EQ(world.getBlock(glm::ivec3(-100, 5, 100)), AIR);
+		EXPECT_EQ(world.getChunkCount(), 0u);
+	}
+
+	TEST_F(WorldTest, setAndGetBlockOnBothSidesOfOrigin)
+	{
+		world.setBlock(glm::ivec3(0, 0, 0), GRASS);
+		world.setBlock(glm::ivec3(-1, -1, -1), DIRT);
+		world.setBlock(glm::ivec3(-17, 3, 40), STONE);
+		EXPECT_EQ(world.getBlock(glm::ivec3(0, 0, 0)), GRASS);
+		EXPECT_EQ(world.getBlock(glm::ivec3(-1, -1, -1)), DIRT);
+		EXPECT_EQ(world.getBlock(glm::ivec3(-17, 3, 40)), STONE);
+		EXPECT_EQ(world.getBlock(glm::ivec3(-16, 3, 40)), AIR);
+		EXPECT_EQ(world.getChunkCount(), 3u);
+		EXPECT_EQ(world.getBlockCount(), 3u);
+		ASSERT_NE(world.getChunk(ChunkCoord(-1, -1, -1)), nullptr);
+		EXPECT_EQ(world.getChunk(ChunkCoord(-1, -1, -1))->getBlock(Chunk::SIZE - 1, Chunk::SIZE - 1, Chunk::SIZE - 1), DIRT);
+	}
+
+	TEST_F(WorldTest, chunkIsRemovedWhenItBecomesEmpty)
+	{
+		world.setBlock(glm::ivec3(-5, 0, 0), SAND);
+		EXPECT_EQ(world.getChunkCount(), 1u);
+		world.setBlock(glm::ivec3(-5, 0, 0), AIR);
+		EXPECT_EQ(world.getChunkCount(), 0u);
+		EXPECT_EQ(world.getChunk(ChunkCoord(-1, 0, 0)), nullptr);
+	}
+
+	TEST_F(WorldTest, settingAirToMissingChunkDoesNotCreateIt)
+	{
+		world.setBlock(glm::ivec3(3, 3, 3), AIR);
+		EXPECT_EQ(world.getChunkCount(), 0u);
+	}
+
+	TEST_F(WorldTest, forEachBlockVisitsEverySolidBlock)
+	{
+		const std::vector<glm::ivec3> positions = { glm::ivec3(0, 0, 0), glm::ivec3(-1, 2, -3), glm::ivec3(20, -20, 5) };
+		for (const auto& pos : positions) { world.setBlock(pos, SNOW); }
+
+		std::vector<glm::ivec3> visited;
+		world.forEachBlock([&visited](const glm::ivec3& pos, BlockId id) {
+			EXPECT_EQ(id, SNOW);
+			visited.push_back(pos);
+		});
+		ASSERT_EQ(visited.size(), positions.size());
+		for (const auto& pos : positions) { EXPECT_NE(std::find(visited.begin(), visited.end(), pos), visited.end()); }
+	}
+
+	TEST_F(WorldTest, setChunkWithEmptyChunkRemovesChunk)
+	{
+		world.setBlock(glm::ivec3(1, 1, 1), GRASS);
+		world.setChunk(ChunkCoord(0, 0, 0), std::make_unique<Chunk>());
+		EXPECT_EQ(world.getChunkCount(), 0u);
+	}
+
+	TEST_F(WorldTest, takeChunkPassesOwnership)
+	{
+		world.setBlock(glm::ivec3(1, 1, 1), GRASS);
+		auto chunk = world.takeChunk(ChunkCoord(0, 0, 0));
+		ASSERT_NE(chunk, nullptr);
+		EXPECT_EQ(chunk->getBlock(1, 1, 1), GRASS);
+		EXPECT_EQ(world.getChunkCount(), 0u);
+		EXPECT_EQ(world.takeChunk(ChunkCoord(0, 0, 0)), nullptr);
+	}
+
+	TEST_F(WorldTest, chunkBoundsIncludeHalfBlockBorder)
+	{
+		const AABB bounds = World::getChunkBounds(ChunkCoord(-1, 0, 1));
+		EXPECT_EQ(bounds.min, glm::vec3(-Chunk::SIZE - 0.5f, -0.5f, Chunk::SIZE - 0.5f));
+		EXPECT_EQ(bounds.max, glm::vec3(-0.5f, Chunk::SIZE - 0.5f, 2 * Chunk::SIZE - 0.5f));
+	}
+
+	// Compare chunk storage to the per cube Terrain objects it replaced
+	TEST(WorldBenchmark, memoryAndIterationAgainstObjectVector)
+	{
+		const int size = 64;
+		const int height = 16;
+		World world;
+		std::vector<std::unique_ptr<Terrain>> objects;
+		auto model = std::make_shared<ModelManager::ModelHandle>(ModelManager::ModelHandle{ ModelManager::READY, nullptr });
+		auto texture = std::make_shared<ModelManager::TextureHandle>(ModelManager::TextureHandle{ ModelManager::READY, 0 });
+		for (int y = 0; y < height; ++y) {
+			for (int z = 0; z < size; ++z) {
+				for (int x = 0; x < size; ++x) {
+					world.setBlock(glm::ivec3(x, y, z), GRASS);
+					objects.push_back(std::make_unique<Terrain>(model, texture,
+						Transform(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z), 0, 0, 0)));
+				}
+			}
+		}
+		ASSERT_EQ(world.getBlockCount(), objects.size());
+
+		const auto objectMemory = objects.capacity() * sizeof(std::unique_ptr<Terrain>) + objects.size() * sizeof(Terrain);
+		const auto timeMs = [](auto func) {
+			const auto start = std::chrono::steady_clock::now();
+			func();
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		};
+
+		glm::vec3 objectSum(0.0f);
+		const double objectMs = timeMs([&]() {
+			for (const auto& object : objects) { objectSum += object->transform.position; }
+		});
+		glm::vec3 worldSum(0.0f);
+		const double worldMs = timeMs([&]() {
+			world.forEachBlock([&worldSum](const glm::ivec3& pos, BlockId) { worldSum += glm::vec3(pos); });
+		});
+		EXPECT_EQ(objectSum, worldSum);
+		EXPECT_LT(world.getMemoryUsage(), objectMemory);
+
+		std::cout << "  " << objects.size() << " blocks: objects " << objectMemory / 1024 << " KiB, "
+			<< objectMs << " ms per iteration; chunks " << world.getMemoryUsage() / 1024 << " KiB, "
+			<< worldMs << " ms per iteration" << std::endl;
+	}
+}
@@ -0,0 +1,178 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "World/worldquery.h"
+
+//Hide functions from other files
+namespace {
+
+	const float EPSILON = 0.01f;
+
+	// Box of the player, one block wide and two blocks high, standing with its feet at position
+	AABB playerBox(const glm::vec3& feet)
+	{
+		return AABB{ feet + glm::vec3(-0.3f, 0.0f, -0.3f), feet + glm::vec3(0.3f, 1.8f, 0.3f) };
+	}
+
+	class WorldQueryTest : public ::testing::Test {
+	protected:
+		World world;
+		worldQuery::RaycastHit hit;
+
+		// Fills blocks x and z in [-size, size] at height y. Block top face is at y + 0.5
+		void addFloor(int y, int size, BlockId type = STONE)
+		{
+			for (int x = -size; x <= size; ++x) {
+				for (int z = -size; z <= size; ++z) { world.setBlock(glm::ivec3(x, y, z), type); }
+			}
+		}
+	};
+
+	TEST_F(WorldQueryTest, raycastEmptyWorldMisses)
+	{
+		EXPECT_FALSE(worldQuery::raycast(world, glm::vec3(0.0f), glm::vec3(1.0f, 0.2f, 0.3f), 100.0f, hit));
+	}
+
+	TEST_F(WorldQueryTest, raycastHitsFirstBlockWithNormalAndDistance)
+	{
+		world.setBlock(glm::ivec3(5, 0, 0), DIRT);
+		world.setBlock(glm::ivec3(8, 0, 0), STONE);
+
+		ASSERT_TRUE(worldQuery::raycast(world, glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 100.0f, hit));
+		EXPECT_EQ(hit.block, glm::ivec3(5, 0, 0));
+		EXPECT_EQ(hit.normal, glm::ivec3(-1, 0, 0));
+		EXPECT_NEAR(hit.distance, 4.5f, EPSILON);
+		EXPECT_EQ(hit.type, DIRT);
+	}
+
+	TEST_F(WorldQueryTest, raycastDirectionDoesNotNeedNormalizing)
+	{
+		world.setBlock(glm::ivec3(0, -3, 0), GRASS);
+		ASSERT_TRUE(worldQuery::raycast(world, glm::vec3(0.0f), glm::vec3(0.0f, -10.0f, 0.0f), 100.0f, hit));
+		EXPECT_EQ(hit.normal, glm::ivec3(0, 1, 0));
+		EXPECT_NEAR(hit.distance, 2.5f, EPSILON);
+	}
+
+	TEST_F(WorldQueryTest, raycastStopsAtMaxDistance)
+	{
+		world.setBlock(glm::ivec3(0, 0, -10), STONE);
+		EXPECT_FALSE(worldQuery::raycast(world, glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 9.0f, hit));
+		EXPECT_TRUE(worldQuery::raycast(world, glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 10.0f, hit));
+	}
+
+	TEST_F(WorldQueryTest, raycastStartingInsideBlockHasZeroNormal)
+	{
+		world.setBlock(glm::ivec3(0, 0, 0), SAND);
+		ASSERT_TRUE(worldQuery::raycast(world, glm::vec3(0.1f), glm::vec3(1.0f, 0.0f, 0.0f), 10.0f, hit));
+		EXPECT_EQ(hit.block, glm::ivec3(0, 0, 0));
+		EXPECT_EQ(hit.normal, glm::ivec3(0));
+		EXPECT_EQ(hit.distance, 0.0f);
+	}
+
+	TEST_F(WorldQueryTest, raycastCrossesChunkBordersOnDiagonal)
+	{
+		// Ray through negative chunk coordinates passes several chunk borders before the hit
+		world.setBlock(glm::ivec3(-40, -40, -40), SNOW);
+		ASSERT_TRUE(worldQuery::raycast(world, glm::vec3(0.0f), glm::vec3(-1.0f), 100.0f, hit));
+		EXPECT_EQ(hit.block, glm::ivec3(-40, -40, -40));
+		EXPECT_EQ(hit.normal[0] + hit.normal[1] + hit.normal[2], 1);
+		EXPECT_NEAR(hit.distance, 39.5f * std::sqrt(3.0f), EPSILON);
+	}
+
+	TEST_F(WorldQueryTest, sweepLandsOnFloor)
+	{
+		addFloor(0, 3);
+		const auto result = worldQuery::sweep(world, playerBox(glm::vec3(0.0f, 2.0f, 0.0f)), glm::vec3(0.0f, -5.0f, 0.0f));
+		EXPECT_NEAR(result.motion.y, -1.5f, EPSILON);
+		EXPECT_TRUE(result.blocked[1]);
+		EXPECT_FALSE(result.blocked[0]);
+		EXPECT_FALSE(result.blocked[2]);
+	}
+
+	TEST_F(WorldQueryTest, sweepSlidesAlongWall)
+	{
+		addFloor(0, 5);
+		for (int y = 1; y <= 3; ++y) {
+			for (int z = -5; z <= 5; ++z) { world.setBlock(glm::ivec3(2, y, z), STONE); }
+		}
+
+		// Walking diagonally into the wall keeps the motion along it
+		const auto result = worldQuery::sweep(world, playerBox(glm::vec3(0.0f, 0.5f, 0.0f)), glm::vec3(3.0f, 0.0f, 2.0f));
+		EXPECT_TRUE(result.blocked[0]);
+		EXPECT_NEAR(result.motion.x, 1.5f - 0.3f, EPSILON);
+		EXPECT_FALSE(result.blocked[2]);
+		EXPECT_EQ(result.motion.z, 2.0f);
+		EXPECT_EQ(result.motion.y, 0.0f);
+	}
+
+	TEST_F(WorldQueryTest, sweepResultDoesNotOverlapSolid)
+	{
+		addFloor(0, 4);
+		world.setBlock(glm::ivec3(-2, 1, 0), STONE);
+		const AABB start = playerBox(glm::vec3(0.0f, 0.5f, 0.0f));
+		ASSERT_FALSE(worldQuery::overlapsSolid(world, start));
+
+		const auto result = worldQuery::sweep(world, start, glm::vec3(-4.0f, -1.0f, 0.0f));
+		const AABB end{ start.min + result.motion, start.max + result.motion };
+		EXPECT_FALSE(worldQuery::overlapsSolid(world, end));
+		EXPECT_TRUE(result.blocked[0]);
+		EXPECT_TRUE(result.blocked[1]);
+	}
+
+	TEST_F(WorldQueryTest, overlapsSolidIgnoresTouching)
+	{
+		world.setBlock(glm::ivec3(0, 0, 0), STONE);
+		EXPECT_TRUE(worldQuery::overlapsSolid(world, AABB{ glm::vec3(0.4f), glm::vec3(1.0f) }));
+		EXPECT_FALSE(worldQuery::overlapsSolid(world, AABB{ glm::vec3(0.5f), glm::vec3(1.0f) }));
+	}
+
+	// Query cost in a dense world: a solid ground of 256x256 blocks with random pillars on top
+	TEST(WorldQueryBenchmark, raycastAndSweepInDenseWorld)
+	{
+		World world;
+		std::mt19937 random(42);
+		std::uniform_int_distribution<int> height(0, 6);
+		for (int x = -128; x < 128; ++x) {
+			for (int z = -128; z < 128; ++z) {
+				for (int y = -8; y <= 0; ++y) { world.setBlock(glm::ivec3(x, y, z), STONE); }
+				const int top = height(random) == 0 ? height(random) : 0;
+				for (int y = 1; y <= top; ++y) { world.setBlock(glm::ivec3(x, y, z), DIRT); }
+			}
+		}
+
+		const int queries = 100000;
+		std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+		std::vector<glm::vec3> directions;
+		for (int i = 0; i < queries; ++i) {
+			const float a = angle(random);
+			directions.push_back(glm::vec3(std::cos(a), -0.2f, std::sin(a)));
+		}
+
+		int hits = 0;
+		worldQuery::RaycastHit hit;
+		auto start = std::chrono::steady_clock::now();
+		for (const auto& direction : directions) {
+			if (worldQuery::raycast(world, glm::vec3(0.0f, 8.0f, 0.0f), direction, 64.0f, hit))
+				++hits;
+		}
+		const double raycastUs = std::chrono::duration<double, std::micro>(
+			std::chrono::steady_clock::now() - start).count() / queries;
+
+		float moved = 0.0f;
+		start = std::chrono::steady_clock::now();
+		for (const auto& direction : directions) {
+			moved += worldQuery::sweep(world, playerBox(glm::vec3(0.0f, 7.5f, 0.0f)), direction * 0.5f).motion.x;
+		}
+		const double sweepUs = std::chrono::duration<double, std::micro>(
+			std::chrono::steady_clock::now() - start).count() / queries;
+
+		EXPECT_GT(hits, 0);
+		std::cout << "  raycast " << raycastUs << " us, sweep " << sweepUs << " us per query (" << hits << " hits, "
+			<< moved << ")" << std::endl;
+	}
+}
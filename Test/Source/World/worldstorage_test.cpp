@@ -0,0 +1,326 @@
+#include "3rdParty/gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "World/chunkcodec.h"
+#include "World/terraingenerator.h"
+#include "World/worldstorage.h"
+
+//Hide functions from other files
+namespace {
+
+	const std::string DIRECTORY = "../Data/Test/WorldStorage/";
+	const int VOLUME = Chunk::VOLUME;
+	const std::streamoff HEADER_SIZE = 8;	// Magic and version before the chunk table
+	const std::streamoff ENTRY_SIZE = 8;	// Offset and size of one chunk payload
+	const std::streamoff DATA_START = HEADER_SIZE + 512 * ENTRY_SIZE;	// Payloads start after the table
+	const std::streamoff COMPACT_DEAD_BYTES = 64 * 1024;				// Replaced payloads kept before compaction
+
+	bool sameBlocks(const Chunk& lhs, const Chunk& rhs)
+	{
+		return std::memcmp(lhs.getData(), rhs.getData(), VOLUME * sizeof(BlockId)) == 0;
+	}
+
+	// Chunk with random blocks of the given types
+	Chunk randomChunk(unsigned int seed, BlockId typeCount)
+	{
+		std::mt19937 random(seed);
+		std::uniform_int_distribution<int> type(0, typeCount - 1);
+		std::vector<BlockId> blocks(VOLUME);
+		for (auto& block : blocks) { block = static_cast<BlockId>(type(random)); }
+		Chunk chunk;
+		chunk.assign(blocks.data());
+		return chunk;
+	}
+
+	// Chunk with layers of ground, like generated terrain
+	Chunk layeredChunk()
+	{
+		Chunk chunk;
+		const int size = Chunk::SIZE;
+		for (int y = 0; y < size / 2; ++y) {
+			for (int z = 0; z < size; ++z) {
+				for (int x = 0; x < size; ++x) { chunk.setBlock(x, y, z, y < 4 ? STONE : (y < 7 ? DIRT : GRASS)); }
+			}
+		}
+		return chunk;
+	}
+
+	class ChunkCodecTest : public ::testing::Test {
+	protected:
+		std::vector<uint8_t> encoded;
+		Chunk decoded;
+
+		void roundTrip(const Chunk& chunk)
+		{
+			encoded.clear();
+			chunkCodec::encode(chunk, encoded);
+			ASSERT_TRUE(chunkCodec::decode(encoded.data(), encoded.size(), decoded));
+			EXPECT_TRUE(sameBlocks(chunk, decoded));
+		}
+	};
+
+	TEST_F(ChunkCodecTest, uniformChunkNeedsOnlyPalette)
+	{
+		Chunk chunk;
+		chunk.fill(STONE);
+		roundTrip(chunk);
+		EXPECT_LT(encoded.size(), 8u);
+	}
+
+	TEST_F(ChunkCodecTest, layeredChunkIsRunLengthEncoded)
+	{
+		roundTrip(layeredChunk());
+		EXPECT_LT(encoded.size(), 64u);
+	}
+
+	TEST_F(ChunkCodecTest, noisyChunkIsBitPacked)
+	{
+		// Two types pack to one bit per block, all types to a byte or less
+		roundTrip(randomChunk(1, 2));
+		EXPECT_LE(encoded.size(), VOLUME / 8u + 16u);
+		roundTrip(randomChunk(2, TERRAIN_TYPE_COUNT));
+		EXPECT_LE(encoded.size(), VOLUME / 2u + 16u);
+	}
+
+	TEST_F(ChunkCodecTest, invalidDataIsRejected)
+	{
+		const Chunk original = randomChunk(3, 4);
+		chunkCodec::encode(original, encoded);
+		decoded.fill(SNOW);
+
+		// Truncated data at any length fails and leaves chunk untouched
+		for (std::size_t size = 0; size < encoded.size(); size += 97) {
+			EXPECT_FALSE(chunkCodec::decode(encoded.data(), size, decoded)) << "size " << size;
+		}
+		EXPECT_FALSE(chunkCodec::decode(encoded.data(), encoded.size() - 1, decoded));
+		EXPECT_EQ(decoded.getSolidCount(), static_cast<unsigned int>(VOLUME));
+		EXPECT_EQ(decoded.getBlock(0, 0, 0), SNOW);
+
+		// Unknown encoding byte
+		std::vector<uint8_t> garbage(encoded.size(), 0xEE);
+		EXPECT_FALSE(chunkCodec::decode(garbage.data(), garbage.size(), decoded));
+	}
+
+	class WorldStorageTest : public ::testing::Test {
+	protected:
+
+		// Function called before every TEST_F call, removes regions left by earlier runs
+		void SetUp() override
+		{
+			for (int x = -2; x <= 2; ++x) {
+				for (int y = -2; y <= 2; ++y) {
+					for (int z = -2; z <= 2; ++z) { std::remove(regionPath(WorldStorage::RegionCoord(x, y, z)).c_str()); }
+				}
+			}
+		}
+
+		static std::string regionPath(const WorldStorage::RegionCoord& region)
+		{
+			return DIRECTORY + "r." + std::to_string(region.x) + "." + std::to_string(region.y) + "."
+				+ std::to_string(region.z) + ".region";
+		}
+
+		// Offset of chunk's table entry in its region file
+		static std::streamoff entryOffset(const ChunkCoord& coord)
+		{
+			const int size = WorldStorage::REGION_SIZE;
+			const auto local = coord - WorldStorage::toRegion(coord) * size;
+			return HEADER_SIZE + (local.x + size * (local.z + size * local.y)) * ENTRY_SIZE;
+		}
+
+		// Overwrites bytes of a region file
+		static void patch(const ChunkCoord& coord, std::streamoff offset, const std::vector<uint8_t>& bytes)
+		{
+			std::fstream file(regionPath(WorldStorage::toRegion(coord)), std::ios::in | std::ios::out | std::ios::binary);
+			ASSERT_TRUE(file.is_open());
+			file.seekp(offset);
+			file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		}
+	};
+
+	TEST_F(WorldStorageTest, chunkNeverSavedIsNotStored)
+	{
+		WorldStorage storage(DIRECTORY);
+		std::unique_ptr<Chunk> chunk;
+		EXPECT_EQ(storage.loadChunk(ChunkCoord(0, 0, 0), chunk), WorldStorage::NOT_STORED);
+		EXPECT_EQ(chunk, nullptr);
+	}
+
+	TEST_F(WorldStorageTest, regionCoordinatesRoundDown)
+	{
+		EXPECT_EQ(WorldStorage::toRegion(ChunkCoord(0, 7, 8)), WorldStorage::RegionCoord(0, 0, 1));
+		EXPECT_EQ(WorldStorage::toRegion(ChunkCoord(-1, -8, -9)), WorldStorage::RegionCoord(-1, -1, -2));
+	}
+
+	TEST_F(WorldStorageTest, roundTrip)
+	{
+		const ChunkCoord coords[] = { ChunkCoord(0, 0, 0), ChunkCoord(7, 1, 3), ChunkCoord(-1, -1, -1), ChunkCoord(-9, 2, 5) };
+		const Chunk chunks[] = { layeredChunk(), randomChunk(4, 2), randomChunk(5, TERRAIN_TYPE_COUNT), layeredChunk() };
+		{
+			WorldStorage storage(DIRECTORY);
+			std::vector<std::pair<ChunkCoord, const Chunk*>> save;
+			for (int i = 0; i < 4; ++i) { save.emplace_back(coords[i], &chunks[i]); }
+			save.emplace_back(ChunkCoord(1, 0, 0), nullptr);
+			ASSERT_TRUE(storage.saveChunks(save));
+		}
+
+		// New storage maps the files written by the first one
+		WorldStorage storage(DIRECTORY);
+		std::unique_ptr<Chunk> loaded;
+		for (int i = 0; i < 4; ++i) {
+			ASSERT_EQ(storage.loadChunk(coords[i], loaded), WorldStorage::STORED) << i;
+			ASSERT_NE(loaded, nullptr);
+			EXPECT_TRUE(sameBlocks(*loaded, chunks[i])) << i;
+		}
+
+		// Empty chunk is known to be empty, its neighbour was never saved
+		EXPECT_EQ(storage.loadChunk(ChunkCoord(1, 0, 0), loaded), WorldStorage::STORED);
+		EXPECT_EQ(loaded, nullptr);
+		EXPECT_EQ(storage.loadChunk(ChunkCoord(2, 0, 0), loaded), WorldStorage::NOT_STORED);
+	}
+
+	TEST_F(WorldStorageTest, savingAgainReplacesChunk)
+	{
+		WorldStorage storage(DIRECTORY);
+		const Chunk first = randomChunk(6, 3);
+		const Chunk second = layeredChunk();
+		std::unique_ptr<Chunk> loaded;
+
+		ASSERT_TRUE(storage.saveChunks({ { ChunkCoord(2, 2, 2), &first } }));
+		ASSERT_EQ(storage.loadChunk(ChunkCoord(2, 2, 2), loaded), WorldStorage::STORED);
+		EXPECT_TRUE(sameBlocks(*loaded, first));
+
+		ASSERT_TRUE(storage.saveChunks({ { ChunkCoord(2, 2, 2), &second } }));
+		ASSERT_EQ(storage.loadChunk(ChunkCoord(2, 2, 2), loaded), WorldStorage::STORED);
+		EXPECT_TRUE(sameBlocks(*loaded, second));
+	}
+
+	TEST_F(WorldStorageTest, corruptEntryDoesNotAffectOthers)
+	{
+		const ChunkCoord truncated(0, 0, 0);
+		const ChunkCoord outside(1, 0, 0);
+		const ChunkCoord intact(2, 0, 0);
+		const Chunk chunk = randomChunk(7, 4);
+		{
+			WorldStorage storage(DIRECTORY);
+			ASSERT_TRUE(storage.saveChunks({ { truncated, &chunk }, { outside, &chunk }, { intact, &chunk } }));
+		}
+
+		// Payload size of one entry is cut to a byte and the other entry points past the end of file
+		patch(truncated, entryOffset(truncated) + 4, { 1, 0, 0, 0 });
+		patch(outside, entryOffset(outside), { 0, 0, 0, 0x7F });
+
+		WorldStorage storage(DIRECTORY);
+		std::unique_ptr<Chunk> loaded;
+		EXPECT_EQ(storage.loadChunk(truncated, loaded), WorldStorage::CORRUPT);
+		EXPECT_EQ(loaded, nullptr);
+		EXPECT_EQ(storage.loadChunk(outside, loaded), WorldStorage::CORRUPT);
+		EXPECT_EQ(loaded, nullptr);
+		ASSERT_EQ(storage.loadChunk(intact, loaded), WorldStorage::STORED);
+		EXPECT_TRUE(sameBlocks(*loaded, chunk));
+	}
+
+	TEST_F(WorldStorageTest, corruptHeaderMakesRegionCorrupt)
+	{
+		const Chunk chunk = layeredChunk();
+		{
+			WorldStorage storage(DIRECTORY);
+			ASSERT_TRUE(storage.saveChunks({ { ChunkCoord(-3, -3, -3), &chunk } }));
+		}
+		patch(ChunkCoord(-3, -3, -3), 0, { 'X' });
+
+		WorldStorage storage(DIRECTORY);
+		std::unique_ptr<Chunk> loaded;
+		EXPECT_EQ(storage.loadChunk(ChunkCoord(-3, -3, -3), loaded), WorldStorage::CORRUPT);
+		EXPECT_FALSE(storage.saveChunks({ { ChunkCoord(-3, -3, -3), &chunk } }));
+	}
+
+	// Saving one chunk over and over reclaims the space of its old payloads, and keeps the other chunks
+	TEST_F(WorldStorageTest, savingRepeatedlyCompactsRegion)
+	{
+		const ChunkCoord edited(1, 1, 1);
+		const ChunkCoord kept(2, 1, 1);
+		const ChunkCoord empty(3, 1, 1);
+		const Chunk keptChunk = randomChunk(8, 4);
+		const auto path = regionPath(WorldStorage::toRegion(edited));
+		Chunk last;
+		std::streamoff largest = 0;
+		{
+			WorldStorage storage(DIRECTORY);
+			ASSERT_TRUE(storage.saveChunks({ { kept, &keptChunk }, { empty, nullptr } }));
+			for (unsigned int i = 0; i < 200; ++i) {
+				last = randomChunk(100 + i, TERRAIN_TYPE_COUNT);
+				ASSERT_TRUE(storage.saveChunks({ { edited, &last } }));
+				std::ifstream file(path, std::ios::binary | std::ios::ate);
+				largest = std::max(largest, static_cast<std::streamoff>(file.tellg()));
+			}
+		}
+
+		// Appending only would need room for all 200 payloads
+		const std::streamoff payload = VOLUME / 2 + 16;
+		EXPECT_LT(largest, DATA_START + COMPACT_DEAD_BYTES + 4 * payload);
+
+		WorldStorage storage(DIRECTORY);
+		std::unique_ptr<Chunk> loaded;
+		ASSERT_EQ(storage.loadChunk(edited, loaded), WorldStorage::STORED);
+		ASSERT_NE(loaded, nullptr);
+		EXPECT_TRUE(sameBlocks(*loaded, last));
+		ASSERT_EQ(storage.loadChunk(kept, loaded), WorldStorage::STORED);
+		ASSERT_NE(loaded, nullptr);
+		EXPECT_TRUE(sameBlocks(*loaded, keptChunk));
+		EXPECT_EQ(storage.loadChunk(empty, loaded), WorldStorage::STORED);
+		EXPECT_EQ(loaded, nullptr);
+		EXPECT_EQ(storage.loadChunk(ChunkCoord(4, 1, 1), loaded), WorldStorage::NOT_STORED);
+	}
+
+	// Loading a generated world of over a million blocks from region files, compared to generating it again
+	class WorldStorageBenchmark : public WorldStorageTest {};
+
+	TEST_F(WorldStorageBenchmark, loadAgainstGenerate)
+	{
+		const TerrainGenerator generator{ TerrainGenerator::Settings() };
+		std::vector<ChunkCoord> coords;
+		for (int x = -8; x < 8; ++x) {
+			for (int z = -8; z < 8; ++z) {
+				for (int y = generator.getMinChunkY(); y <= generator.getMaxChunkY(); ++y) { coords.push_back(ChunkCoord(x, y, z)); }
+			}
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::unique_ptr<Chunk>> generated;
+		for (const auto& coord : coords) { generated.push_back(generator.generateChunk(coord)); }
+		const double generateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::vector<std::pair<ChunkCoord, const Chunk*>> save;
+		for (std::size_t i = 0; i < coords.size(); ++i) { save.emplace_back(coords[i], generated[i].get()); }
+		ASSERT_TRUE(WorldStorage(DIRECTORY).saveChunks(save));
+
+		// Fresh storage, so the time includes mapping the region files
+		WorldStorage storage(DIRECTORY);
+		std::vector<std::unique_ptr<Chunk>> loaded(coords.size());
+		start = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < coords.size(); ++i) {
+			ASSERT_EQ(storage.loadChunk(coords[i], loaded[i]), WorldStorage::STORED);
+		}
+		const double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		for (std::size_t i = 0; i < coords.size(); ++i) {
+			ASSERT_EQ(loaded[i] == nullptr, generated[i] == nullptr);
+			if (loaded[i] != nullptr)
+				ASSERT_TRUE(sameBlocks(*loaded[i], *generated[i]));
+		}
+		std::cout << "  " << coords.size() * VOLUME << " blocks: generate " << generateMs << " ms, load "
+			<< loadMs << " ms" << std::endl;
+
+		// Storage is only worth it if loading a saved world beats generating it again
+		EXPECT_LT(loadMs, generateMs);
+	}
+}